@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Forward declare zlib's file handle, keeping zlib out of this header
+struct gzFile_s;
+
+namespace simeng {
+
+/** Records basic block vectors (BBVs); the number of instructions executed in
+ * each basic block over fixed-length intervals of a program's execution. These
+ * profiles are consumed by SimPoint, which clusters the intervals to select a
+ * representative subset for detailed simulation.
+ *
+ * Each interval is written as a single line in SimPoint's text format,
+ * `T:<id>:<count> :<id>:<count> ...`, where block IDs are numbered from 1 in
+ * the order blocks are first executed. Intervals are streamed to the output as
+ * they complete. If the output path ends in `.gz`, it is gzip compressed and
+ * should be passed to SimPoint with `-inputVectorsGzipped`. */
+class BBVProfiler {
+ public:
+  /** Construct a profiler writing a vector every `intervalLength`
+   * instructions to the file at `path`. */
+  BBVProfiler(const std::string& path, uint64_t intervalLength);
+
+  /** Write the final, partially complete interval and close the output. */
+  ~BBVProfiler();
+
+  BBVProfiler(const BBVProfiler&) = delete;
+  BBVProfiler& operator=(const BBVProfiler&) = delete;
+
+  /** Record the execution of `instructions` instructions in the basic block
+   * starting at `address`. Instructions falling beyond the end of the current
+   * interval are counted towards the next. */
+  void record(uint64_t address, uint64_t instructions);
+
+  /** Get the number of intervals written so far. */
+  uint64_t getIntervalCount() const;
+
+ private:
+  /** Write the vector of the current interval, then start a new one. */
+  void endInterval();
+
+  /** The output file. */
+  gzFile_s* file_ = nullptr;
+
+  /** The number of instructions in each interval. */
+  uint64_t intervalLength_;
+
+  /** The number of instructions recorded in the current interval. */
+  uint64_t intervalInstructions_ = 0;
+
+  /** The number of intervals written. */
+  uint64_t intervalCount_ = 0;
+
+  /** The ID of each basic block, keyed by its start address. */
+  std::unordered_map<uint64_t, uint32_t> blockIds_;
+
+  /** The instruction count of each block in the current interval, indexed by
+   * block ID. */
+  std::vector<uint64_t> counts_;
+
+  /** The IDs of the blocks executed in the current interval, in the order they
+   * were first executed within it. */
+  std::vector<uint32_t> executedBlocks_;
+
+  /** A reusable buffer holding the text of an interval's vector. */
+  std::string line_;
+};
+
+}  // namespace simeng
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "simeng/RegisterValue.hh"
+#include "simeng/arch/ProcessStateChange.hh"
+
+namespace simeng {
+
+/** A checkpoint file holds the architectural and OS state of a simulated
+ * process, followed by its process image.
+ *
+ * |-----------------| <- 0x0
+ * |     Header      |    magic, version, ISA, image offset and size
+ * |-----------------|
+ * |      State      |    written by each component in turn
+ * |-----------------| <- image offset, aligned to 64KiB
+ * |  Process image  |    pages of zeroes are left as holes in the file
+ * |-----------------|
+ *
+ * As the image is stored page-aligned, a restored process maps it directly
+ * from the file with private, copy-on-write semantics. Pages are then only read
+ * from disk when first touched, and are never written back, allowing many
+ * simulations to be started from the same checkpoint. */
+
+/** Accumulates simulation state, then writes it to a checkpoint file. */
+class CheckpointWriter {
+ public:
+  /** Construct a writer for a simulation of the ISA named `isa`. */
+  CheckpointWriter(const std::string& isa);
+
+  /** Append a trivially copyable value to the checkpoint state. */
+  template <typename T>
+  void write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable values may be written directly");
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    state_.insert(state_.end(), bytes, bytes + sizeof(T));
+  }
+
+  /** Append a string to the checkpoint state. */
+  void write(const std::string& value);
+
+  /** Append a register value to the checkpoint state. */
+  void write(const RegisterValue& value);
+
+  /** Append a set of register changes to the checkpoint state. Memory changes
+   * are not supported. */
+  void write(const arch::ProcessStateChange& value);
+
+  /** Write the accumulated state and the `imageSize` byte process image at
+   * `image` to the checkpoint file at `path`. */
+  void save(const std::string& path, const char* image,
+            uint64_t imageSize) const;
+
+ private:
+  /** The name of the ISA being simulated. */
+  std::string isa_;
+
+  /** The serialised simulation state. */
+  std::vector<char> state_;
+};
+
+/** Reads simulation state back from a checkpoint file, in the order it was
+ * written. */
+class CheckpointReader {
+ public:
+  /** Open the checkpoint file at `path`, reading its state into memory. */
+  CheckpointReader(const std::string& path);
+
+  /** Read a trivially copyable value from the checkpoint state. */
+  template <typename T>
+  void read(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable values may be read directly");
+    readBytes(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+
+  /** Read a string from the checkpoint state. */
+  void read(std::string& value);
+
+  /** Read a register value from the checkpoint state. */
+  void read(RegisterValue& value);
+
+  /** Read a set of register changes from the checkpoint state. */
+  void read(arch::ProcessStateChange& value);
+
+  /** Get the name of the ISA the checkpoint was taken from. */
+  const std::string& getISA() const;
+
+  /** Get the size of the process image. */
+  uint64_t getImageSize() const;
+
+  /** Map the process image privately from the checkpoint file, such that
+   * writes are never reflected in the file. The mapping is released once the
+   * last copy of the returned pointer is destroyed. */
+  std::shared_ptr<char> mapImage() const;
+
+ private:
+  /** Copy the next `size` bytes of checkpoint state to `dest`. */
+  void readBytes(char* dest, uint64_t size);
+
+  /** The path of the checkpoint file. */
+  std::string path_;
+
+  /** The name of the ISA the checkpoint was taken from. */
+  std::string isa_;
+
+  /** The offset of the process image within the file. */
+  uint64_t imageOffset_ = 0;
+
+  /** The size of the process image. */
+  uint64_t imageSize_ = 0;
+
+  /** The serialised simulation state. */
+  std::vector<char> state_;
+
+  /** The offset of the next value to read from `state_`. */
+  uint64_t position_ = 0;
+};
+
+}  // namespace simeng
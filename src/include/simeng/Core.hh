@@ -21,13 +21,12 @@ class ExceptionHandler;
 class Core {
  public:
   Core(memory::MemoryInterface& dataMemory, const arch::Architecture& isa,
-       const std::vector<RegisterFileStructure>& regFileStructure)
+       const std::vector<RegisterFileStructure>& regFileStructure,
+       ryml::ConstNodeRef config = config::SimInfo::getConfig())
       : dataMemory_(dataMemory),
         isa_(isa),
         registerFileSet_(regFileStructure),
-        clockFrequency_(
-            config::SimInfo::getConfig()["Core"]["Clock-Frequency-GHz"]
-                .as<float>()) {}
+        clockFrequency_(config["Core"]["Clock-Frequency-GHz"].as<float>()) {}
 
   virtual ~Core() {}
 
@@ -37,6 +36,31 @@ class Core {
   /** Check whether the program has halted. */
   virtual bool hasHalted() const = 0;
 
+  /** Retrieve the number of upcoming ticks in which this core is certain to
+   * do nothing but count the cycle, provided its memory interfaces complete no
+   * requests. Returns 0 if this is unknown, and UINT64_MAX if the core will
+   * remain idle until a request completes or a thread is scheduled onto it. */
+  virtual uint64_t getIdleTicks() const { return 0; }
+
+  /** Advance the core by `ticks` ticks, which must not exceed
+   * `getIdleTicks()`, leaving it and its statistics as though `tick` had been
+   * called for each. */
+  virtual void skipTicks(uint64_t ticks) {
+    for (uint64_t i = 0; i < ticks; i++) tick();
+  }
+
+  /** Begin executing software thread `tid` from address `pc`, after applying
+   * the register values held in `registers`. Only valid once the core has
+   * halted, which leaves it idle until a thread is scheduled onto it. */
+  virtual void schedule(int64_t tid, uint64_t pc,
+                        const arch::ProcessStateChange& registers) = 0;
+
+  /** Halt the core, abandoning the software thread it is running. */
+  void halt() { hasHalted_ = true; }
+
+  /** Retrieve the ID of the software thread scheduled onto this core. */
+  int64_t getThreadId() const { return threadId_; }
+
   /** Retrieve the architectural register file set. */
   virtual const ArchitecturalRegisterFileSet& getArchitecturalRegisterFileSet()
       const = 0;
@@ -113,6 +137,10 @@ class Core {
   /** Whether or not the core has halted. */
   bool hasHalted_ = false;
 
+  /** The ID of the software thread scheduled onto this core. The first thread
+   * of a process shares its ID with the process. */
+  int64_t threadId_ = 0;
+
   /** Clock frequency of core in GHz */
   float clockFrequency_ = 0.0f;
 };
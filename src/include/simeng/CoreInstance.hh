@@ -1,20 +1,29 @@
 #pragma once
 
+#include <optional>
 #include <string>
 
 #include "simeng/AlwaysNotTakenPredictor.hh"
+#include "simeng/Checkpoint.hh"
 #include "simeng/Core.hh"
 #include "simeng/Elf.hh"
 #include "simeng/GenericPredictor.hh"
 #include "simeng/PerceptronPredictor.hh"
 #include "simeng/SpecialFileDirGen.hh"
+#include "simeng/TagePredictor.hh"
 #include "simeng/arch/Architecture.hh"
 #include "simeng/arch/aarch64/Architecture.hh"
 #include "simeng/arch/riscv/Architecture.hh"
 #include "simeng/config/SimInfo.hh"
 #include "simeng/kernel/Linux.hh"
+#include "simeng/memory/CacheMemoryInterface.hh"
+#include "simeng/memory/ExclusiveMonitor.hh"
 #include "simeng/memory/FixedLatencyMemoryInterface.hh"
 #include "simeng/memory/FlatMemoryInterface.hh"
+#include "simeng/memory/NextLinePrefetcher.hh"
+#include "simeng/memory/PageGenerations.hh"
+#include "simeng/memory/StreamPrefetcher.hh"
+#include "simeng/memory/StridePrefetcher.hh"
 #include "simeng/models/emulation/Core.hh"
 #include "simeng/models/inorder/Core.hh"
 #include "simeng/models/outoforder/Core.hh"
@@ -49,6 +58,13 @@ class CoreInstance {
   CoreInstance(char* assembledSource, size_t sourceSize,
                ryml::ConstNodeRef config = config::SimInfo::getConfig());
 
+  /** CoreInstance resuming the process held in `checkpoint`, as saved by
+   * `saveCheckpoint`. The configuration may describe a different core model to
+   * the one the checkpoint was taken with, but must use the same ISA and number
+   * of cores. */
+  CoreInstance(CheckpointReader& checkpoint,
+               ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
   ~CoreInstance();
 
   /** Set the SimEng L1 instruction cache memory. */
@@ -62,14 +78,45 @@ class CoreInstance {
    * process and memory interfaces have been instantiated. */
   void createCore();
 
-  /** Getter for the create core object. */
+  /** Getter for the create core object. With multiple cores, this is the
+   * core the process' main thread starts on. */
   std::shared_ptr<simeng::Core> getCore() const;
 
+  /** Getter for all created core objects, indexed by core ID. */
+  const std::vector<std::shared_ptr<simeng::Core>>& getCores() const;
+
+  /** Getter for the emulation core used to fast-forward between the detailed
+   * intervals of a sampled simulation. It shares the architecture and process
+   * memory of the first core, and is only created when sampling is enabled;
+   * otherwise a nullptr is returned. */
+  std::shared_ptr<simeng::Core> getFunctionalCore() const;
+
   /** Getter for the create data memory object. */
-  std::shared_ptr<simeng::memory::MemoryInterface> getDataMemory() const;
+  std::shared_ptr<simeng::memory::MemoryInterface> getDataMemory(
+      uint16_t coreId = 0) const;
 
   /** Getter for the create instruction memory object. */
-  std::shared_ptr<simeng::memory::MemoryInterface> getInstructionMemory() const;
+  std::shared_ptr<simeng::memory::MemoryInterface> getInstructionMemory(
+      uint16_t coreId = 0) const;
+
+  /** Place any threads created by the process onto idle cores, and halt every
+   * core once the process has exited. Should be called once per cycle. */
+  void scheduleThreads();
+
+  /** Check whether every core has halted and no threads remain to be
+   * scheduled. */
+  bool hasHalted() const;
+
+  /** Save the architectural state of every core, along with the kernel state
+   * and process image, to a checkpoint file at `path`. Only supported in
+   * emulation mode. Returns false without saving if a core is part-way through
+   * an instruction, in which case the cores should be ticked and the save
+   * retried. */
+  bool saveCheckpoint(const std::string& path) const;
+
+  /** Capture the value of every architectural register of `core`, as a state
+   * change which replaces them when applied to another core. */
+  arch::ProcessStateChange getRegisterState(const Core& core) const;
 
   /** Getter for a shared pointer to the created process image. */
   std::shared_ptr<char> getProcessImage() const;
@@ -86,12 +133,20 @@ class CoreInstance {
   void generateCoreModel(std::string executablePath,
                          std::vector<std::string> executableArgs);
 
+  /** Construct the memory interfaces and, unless they are to be supplied
+   * externally, the cores, once the process has been created. */
+  void generateMemoryAndCore();
+
   /** Construct the SimEng linux process object from command line arguments.
    * Empty command line arguments denote the usage of hardcoded
    * instructions held in the hex_ array. */
   void createProcess(std::string executablePath,
                      std::vector<std::string> executableArgs);
 
+  /** Construct the SimEng linux process object, and the kernel state above it,
+   * from a checkpoint. */
+  void restoreProcess(CheckpointReader& checkpoint);
+
   /** Construct the process memory from the generated process_ object. */
   void createProcessMemory();
 
@@ -101,12 +156,20 @@ class CoreInstance {
   /** Construct the SimEng L1 data cache memory. */
   void createL1DataMemory(const memory::MemInterfaceType type);
 
+  /** Get the cache level below the L1 caches of core `core`, creating the
+   * lower levels of the hierarchy on first use. Returns null if the L1 caches
+   * are backed directly by main memory. */
+  std::shared_ptr<memory::Cache> getCacheBelowL1(uint16_t core);
+
   /** Construct the special file directory. */
   void createSpecialFileDirectory();
 
   /** The config file describing the modelled core to be created. */
   ryml::ConstNodeRef config_;
 
+  /** The number of cores to create, all sharing the same process. */
+  const uint16_t coreCount_;
+
   /** The SimEng Linux kernel object. */
   simeng::kernel::Linux kernel_;
 
@@ -128,29 +191,58 @@ class CoreInstance {
   /** The process memory space. */
   std::shared_ptr<char> processMemory_;
 
+  /** The software thread each core was running when the checkpoint being
+   * restored was taken, indexed by core ID; empty for idle cores. Applied to
+   * the cores once created. */
+  std::vector<std::optional<kernel::LinuxThreadContext>> restoredThreads_;
+
   /** Whether or not the dataMemory_ must be set manually. */
   bool setDataMemory_ = false;
 
   /** Whether or not the instructionMemory_ must be set manually. */
   bool setInstructionMemory_ = false;
 
-  /** Reference to the SimEng architecture object. */
-  std::unique_ptr<simeng::arch::Architecture> arch_ = nullptr;
+  /** The SimEng architecture objects, one per core. */
+  std::vector<std::unique_ptr<simeng::arch::Architecture>> archs_;
+
+  /** The exclusive monitor shared by the cores' architectures; null when
+   * simulating a single core, whose exclusive stores always succeed. */
+  std::unique_ptr<memory::ExclusiveMonitor> exclusiveMonitor_;
+
+  /** The record of writes to process memory shared by the cores'
+   * architectures, through which cached code is kept current. */
+  std::unique_ptr<memory::PageGenerations> pageGenerations_;
 
-  /** Reference to the SimEng branch predictor object. */
-  std::unique_ptr<simeng::BranchPredictor> predictor_ = nullptr;
+  /** The SimEng branch predictor objects, one per core. */
+  std::vector<std::unique_ptr<simeng::BranchPredictor>> predictors_;
 
-  /** Reference to the SimEng port allocator object. */
-  std::unique_ptr<simeng::pipeline::PortAllocator> portAllocator_ = nullptr;
+  /** The SimEng port allocator objects, one per core. */
+  std::vector<std::unique_ptr<simeng::pipeline::PortAllocator>>
+      portAllocators_;
 
-  /** Reference to the SimEng core object. */
-  std::shared_ptr<simeng::Core> core_ = nullptr;
+  /** The SimEng core objects, indexed by core ID. */
+  std::vector<std::shared_ptr<simeng::Core>> cores_;
 
-  /** Reference to the SimEng data memory object. */
-  std::shared_ptr<simeng::memory::MemoryInterface> dataMemory_ = nullptr;
+  /** The emulation core used to fast-forward a sampled simulation. */
+  std::shared_ptr<simeng::Core> functionalCore_ = nullptr;
 
-  /** Reference to the SimEng instruction memory object. */
-  std::shared_ptr<simeng::memory::MemoryInterface> instructionMemory_ = nullptr;
+  /** The flat instruction and data memory objects of the functional core. */
+  std::shared_ptr<simeng::memory::MemoryInterface> functionalInstructionMemory_;
+  std::shared_ptr<simeng::memory::MemoryInterface> functionalDataMemory_;
+
+  /** The SimEng data memory objects, one per core. */
+  std::vector<std::shared_ptr<simeng::memory::MemoryInterface>> dataMemories_;
+
+  /** The SimEng instruction memory objects, one per core. */
+  std::vector<std::shared_ptr<simeng::memory::MemoryInterface>>
+      instructionMemories_;
+
+  /** The L2 caches below the Cache memory interfaces, one per core. */
+  std::vector<std::shared_ptr<simeng::memory::Cache>> l2Caches_;
+
+  /** The last-level cache shared by the Cache memory interfaces of every core.
+   */
+  std::shared_ptr<simeng::memory::Cache> lastLevelCache_;
 };
 
 }  // namespace simeng
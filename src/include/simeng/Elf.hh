@@ -49,9 +49,15 @@ struct Elf64_Phdr {
 /** A processed Executable and Linkable Format (ELF) file. */
 class Elf {
  public:
-  Elf(std::string path, char** imagePointer);
+  /** Parse the headers of the ELF file at `path`. */
+  Elf(std::string path);
   ~Elf();
 
+  /** Copy the loadable segments into `image` at their virtual addresses.
+   * `image` must hold at least `getProcessImageSize()` bytes, and is expected
+   * to be zero-initialised. */
+  void load(char* image) const;
+
   /** Returns the process image size */
   uint64_t getProcessImageSize() const;
 
@@ -72,6 +78,9 @@ class Elf {
   uint64_t getNumPhdr() const;
 
  private:
+  /** The path of the ELF file */
+  std::string path_;
+
   /** The entry point of the program */
   uint64_t entryPoint_;
 
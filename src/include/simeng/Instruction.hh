@@ -4,6 +4,8 @@
 
 #include "capstone/capstone.h"
 #include "simeng/BranchPredictor.hh"
+#include "simeng/IntrusivePtr.hh"
+#include "simeng/Pool.hh"
 #include "simeng/Register.hh"
 #include "simeng/RegisterValue.hh"
 #include "simeng/memory/MemoryInterface.hh"
@@ -26,11 +28,24 @@ struct ExecutionInfo {
 };
 
 /** An abstract instruction definition.
- * Each supported ISA should provide a derived implementation of this class. */
-class Instruction {
+ * Each supported ISA should provide a derived implementation of this class.
+ *
+ * Instructions are owned through `IntrusivePtr` handles, whose reference count
+ * is not atomic; the micro-ops of a core never leave the host thread ticking
+ * it. Their storage is recycled through a `SizeClassPool`, as one is created
+ * for every micro-op fetched. */
+class Instruction : public RefCounted {
  public:
   virtual ~Instruction(){};
 
+  static void* operator new(size_t bytes) {
+    return SizeClassPool::allocate(bytes);
+  }
+
+  static void operator delete(void* ptr, size_t bytes) noexcept {
+    SizeClassPool::deallocate(ptr, bytes);
+  }
+
   /** Retrieve the source registers this instruction reads. */
   virtual const span<Register> getSourceRegisters() const = 0;
 
@@ -99,6 +114,11 @@ class Instruction {
   /** Is this a branch operation? */
   virtual bool isBranch() const = 0;
 
+  /** Is this an exclusive or atomic memory access? Exclusive loads reserve the
+   * memory they read, while exclusive stores and atomic read-modify-writes
+   * write memory through the exclusive monitor. */
+  virtual bool isAtomic() const = 0;
+
   /** Retrieve the instruction group this instruction belongs to. */
   virtual uint16_t getGroup() const = 0;
 
@@ -116,6 +136,28 @@ class Instruction {
    * latency and throughput, and the set of ports which support it. */
   virtual void setExecutionInfo(const ExecutionInfo& info) = 0;
 
+  /** Create a copy of this instruction in its current state. Used to
+   * instantiate fresh micro-ops from previously decoded templates. */
+  virtual IntrusivePtr<Instruction> clone() const = 0;
+
+  /** Return the instruction to the state it was decoded in, discarding any
+   * operands, results, memory accesses and exception since supplied or
+   * produced, such that it may be executed again. Only valid for an
+   * instruction which raised no exception when decoded. */
+  virtual void reset() {
+    executed_ = false;
+    canCommit_ = false;
+    waitingCommit_ = false;
+    flushed_ = false;
+    exceptionEncountered_ = false;
+    memoryAddresses_.clear();
+    memoryData_.clear();
+    dataPending_ = 0;
+    holdsReservation_ = false;
+    branchAddress_ = 0;
+    branchTaken_ = false;
+  }
+
   /** Set this instruction's sequence ID. */
   void setSequenceId(uint64_t seqId) { sequenceId_ = seqId; }
 
@@ -128,6 +170,12 @@ class Instruction {
   /** Retrieve this instruction's instruction ID. */
   uint64_t getInstructionId() const { return instructionId_; }
 
+  /** Set the ID this instruction is recorded under in a pipeline trace. */
+  void setTraceId(uint64_t traceId) { traceId_ = traceId; }
+
+  /** Retrieve this instruction's pipeline trace ID; 0 if it is not traced. */
+  uint64_t getTraceId() const { return traceId_; }
+
   /** Set this instruction's instruction memory address. */
   void setInstructionAddress(uint64_t address) {
     instructionAddress_ = address;
@@ -207,6 +255,10 @@ class Instruction {
   /** Is this the last uop in the possible sequence of decoded uops? */
   bool isLastMicroOp() const { return isLastMicroOp_; }
 
+  /** Did this exclusive store or atomic hold its reservation when executed,
+   * and so write memory? */
+  bool holdsReservation() const { return holdsReservation_; }
+
   /** Get arbitrary micro-operation index. */
   int getMicroOpIndex() const { return microOpIndex_; }
 
@@ -245,6 +297,10 @@ class Instruction {
    * newer instruction. */
   uint64_t sequenceId_ = 0;
 
+  /** The ID this instruction is recorded under in a pipeline trace; 0 if it is
+   * not traced. */
+  uint64_t traceId_ = 0;
+
   /** The location in memory of this instruction was decoded at. */
   uint64_t instructionAddress_ = 0;
 
@@ -282,6 +338,10 @@ class Instruction {
   /** The number of data items that still need to be supplied. */
   uint8_t dataPending_ = 0;
 
+  /** Whether this exclusive store or atomic held its reservation when
+   * executed. */
+  bool holdsReservation_ = false;
+
   // Branches
   /** The predicted branching result. */
   BranchPrediction prediction_ = {false, 0};
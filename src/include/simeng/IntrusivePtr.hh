@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace simeng {
+
+template <class T>
+class IntrusivePtr;
+
+/** A base class for objects owned through `IntrusivePtr`, holding their
+ * reference count within the object itself. The count is not atomic, so an
+ * object must only be referenced from one host thread at a time. A copy of an
+ * object starts with no references, regardless of those held to the
+ * original. */
+class RefCounted {
+ public:
+  RefCounted() noexcept = default;
+  RefCounted(const RefCounted&) noexcept {}
+  RefCounted& operator=(const RefCounted&) noexcept { return *this; }
+
+ protected:
+  ~RefCounted() = default;
+
+ private:
+  template <class T>
+  friend class IntrusivePtr;
+
+  /** The number of `IntrusivePtr`s referencing the object. */
+  mutable uint32_t references_ = 0;
+};
+
+/** A handle sharing ownership of an object derived from `RefCounted`, which is
+ * deleted once the last handle referencing it is destroyed or reset. Unlike
+ * `std::shared_ptr`, the count lives in the object and is updated without
+ * atomic operations, and no separate control block is allocated. The object
+ * must be created with `new`, or `makeIntrusive`; an `IntrusivePtr` may be
+ * constructed from a raw pointer to an object already owned by others. */
+template <class T>
+class IntrusivePtr {
+ public:
+  using element_type = T;
+
+  IntrusivePtr() noexcept = default;
+
+  IntrusivePtr(std::nullptr_t) noexcept {}
+
+  /** Take a reference to the object at `ptr`, which may be null. */
+  explicit IntrusivePtr(T* ptr) noexcept : ptr_(ptr) { acquire(); }
+
+  IntrusivePtr(const IntrusivePtr& other) noexcept : ptr_(other.ptr_) {
+    acquire();
+  }
+
+  IntrusivePtr(IntrusivePtr&& other) noexcept
+      : ptr_(std::exchange(other.ptr_, nullptr)) {}
+
+  template <class U>
+  IntrusivePtr(const IntrusivePtr<U>& other) noexcept : ptr_(other.get()) {
+    acquire();
+  }
+
+  template <class U>
+  IntrusivePtr(IntrusivePtr<U>&& other) noexcept : ptr_(other.release()) {}
+
+  ~IntrusivePtr() { drop(); }
+
+  IntrusivePtr& operator=(const IntrusivePtr& other) noexcept {
+    // Take the new reference first, in case both refer to the same object
+    T* ptr = other.ptr_;
+    if (ptr) ptr->references_++;
+    drop();
+    ptr_ = ptr;
+    return *this;
+  }
+
+  IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+    if (this != &other) {
+      drop();
+      ptr_ = std::exchange(other.ptr_, nullptr);
+    }
+    return *this;
+  }
+
+  IntrusivePtr& operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+
+  /** Drop the reference held, if any. */
+  void reset() noexcept {
+    drop();
+    ptr_ = nullptr;
+  }
+
+  /** Get the object referenced; null if there is none. */
+  T* get() const noexcept { return ptr_; }
+
+  T& operator*() const noexcept { return *ptr_; }
+
+  T* operator->() const noexcept { return ptr_; }
+
+  explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+  /** Get the number of handles referencing the object; 0 if there is none. */
+  uint32_t use_count() const noexcept { return ptr_ ? ptr_->references_ : 0; }
+
+ private:
+  template <class U>
+  friend class IntrusivePtr;
+
+  /** Give up the reference held without dropping it, returning the object. */
+  T* release() noexcept { return std::exchange(ptr_, nullptr); }
+
+  /** Count the reference to `ptr_`. */
+  void acquire() noexcept {
+    if (ptr_) ptr_->references_++;
+  }
+
+  /** Drop the reference to `ptr_`, deleting the object if it was the last. */
+  void drop() noexcept {
+    if (ptr_ && --ptr_->references_ == 0) delete ptr_;
+  }
+
+  /** The object referenced; null if there is none. */
+  T* ptr_ = nullptr;
+};
+
+/** Create an object of type `T` from `args`, owned by the returned handle. */
+template <class T, class... Args>
+IntrusivePtr<T> makeIntrusive(Args&&... args) {
+  return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+template <class T, class U>
+bool operator==(const IntrusivePtr<T>& a, const IntrusivePtr<U>& b) noexcept {
+  return a.get() == b.get();
+}
+
+template <class T, class U>
+bool operator!=(const IntrusivePtr<T>& a, const IntrusivePtr<U>& b) noexcept {
+  return a.get() != b.get();
+}
+
+template <class T>
+bool operator==(const IntrusivePtr<T>& a, std::nullptr_t) noexcept {
+  return !a;
+}
+
+template <class T>
+bool operator==(std::nullptr_t, const IntrusivePtr<T>& a) noexcept {
+  return !a;
+}
+
+template <class T>
+bool operator!=(const IntrusivePtr<T>& a, std::nullptr_t) noexcept {
+  return static_cast<bool>(a);
+}
+
+template <class T>
+bool operator!=(std::nullptr_t, const IntrusivePtr<T>& a) noexcept {
+  return static_cast<bool>(a);
+}
+
+}  // namespace simeng
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "simeng/CoreInstance.hh"
+
+namespace simeng {
+
+/** A simulation driver which ticks the cores of a `CoreInstance` across
+ * several host threads. Each host thread owns a fixed subset of the cores,
+ * along with their private L1 memory interfaces, and ticks them independently
+ * for up to `quantum` cycles. All host threads then synchronise, at which point
+ * new software threads are scheduled and termination is checked.
+ *
+ * Each core owns its architecture, and with it the caches of decoded and split
+ * instructions. Shared state is limited to the process memory, which memory
+ * interfaces access with the relaxed atomics of `memory::copyShared` as cores
+ * would on real hardware, the `memory::ExclusiveMonitor` through which
+ * exclusive stores and atomics write it, and the kernel, whose syscalls are
+ * serialised through `kernel::Linux::getMutex()`. A larger quantum reduces
+ * synchronisation overhead at the cost of delaying the placement of newly
+ * created threads by up to `quantum` cycles. As the interleaving of cores'
+ * memory accesses within a quantum depends on host timing, results of
+ * workloads which communicate through memory may vary between runs. */
+class ParallelCoreDriver {
+ public:
+  /** Construct a driver ticking the cores of `coreInstance` on up to
+   * `hostThreads` host threads, synchronising every `quantum` cycles. */
+  ParallelCoreDriver(CoreInstance& coreInstance, uint16_t hostThreads,
+                     uint64_t quantum);
+
+  /** Tick the cores until every thread of the simulated process has finished.
+   * Returns the number of cycles simulated. */
+  uint64_t run();
+
+ private:
+  /** The work carried out by each host thread; repeatedly tick the cores
+   * owned by `worker` for a quantum, then synchronise with the other host
+   * threads. */
+  void work(uint16_t worker);
+
+  /** Tick the cores owned by `worker` for up to `quantum_` cycles, stopping
+   * early once all of them are idle. Cycles in which none of the cores or
+   * their memory interfaces would do more than count the cycle are skipped
+   * rather than ticked. Returns the number of cycles ticked. */
+  uint64_t tickQuantum(uint16_t worker);
+
+  /** Advance the cores owned by `worker`, and their memory interfaces, by a
+   * single tick, or by skipping up to `maxTicks` ticks if all of them are
+   * idle. Returns the number of cycles advanced. */
+  uint64_t advance(uint16_t worker, uint64_t maxTicks);
+
+  /** Retrieve the number of upcoming cycles in which none of the cores owned
+   * by `worker`, nor their memory interfaces, would do more than count the
+   * cycle. */
+  uint64_t getIdleTicks(uint16_t worker) const;
+
+  /** Check whether every core owned by `worker` has halted with no
+   * outstanding data memory requests. */
+  bool isIdle(uint16_t worker) const;
+
+  /** Wait until every host thread has completed the current quantum, with
+   * `worker` having ticked for `ticks` cycles. The last host thread to arrive
+   * performs the synchronisation work before releasing the others. */
+  void synchronise(uint16_t worker, uint64_t ticks);
+
+  /** Bring the cores of host threads which stopped early up to the end of the
+   * quantum, schedule newly created threads, and determine whether the
+   * simulation has finished. Called by a single host thread while all others
+   * are waiting. */
+  void endQuantum();
+
+  /** The core instance holding the cores to tick. */
+  CoreInstance& coreInstance_;
+
+  /** The number of host threads in use, including the calling thread. */
+  const uint16_t workerCount_;
+
+  /** The maximum number of cycles ticked between synchronisations. */
+  const uint64_t quantum_;
+
+  /** The IDs of the cores owned by each host thread. */
+  std::vector<std::vector<uint16_t>> workerCores_;
+
+  /** The instruction memory of each core, indexed by core ID. */
+  std::vector<memory::MemoryInterface*> instructionMemories_;
+
+  /** The data memory of each core, indexed by core ID. */
+  std::vector<memory::MemoryInterface*> dataMemories_;
+
+  /** Guards the synchronisation state below. */
+  std::mutex mutex_;
+
+  /** Signals the completion of a quantum to waiting host threads. */
+  std::condition_variable quantumDone_;
+
+  /** The number of host threads yet to complete the current quantum. */
+  uint16_t waiting_;
+
+  /** The number of quanta completed; used by waiting host threads to detect
+   * the end of the current quantum. */
+  uint64_t generation_ = 0;
+
+  /** The largest number of cycles ticked by any host thread in the current
+   * quantum. */
+  uint64_t quantumTicks_ = 0;
+
+  /** The number of cycles ticked by each host thread in the current quantum.
+   */
+  std::vector<uint64_t> workerTicks_;
+
+  /** The number of cycles simulated. */
+  uint64_t iterations_ = 0;
+
+  /** Whether every thread of the simulated process has finished. */
+  bool finished_ = false;
+};
+
+}  // namespace simeng
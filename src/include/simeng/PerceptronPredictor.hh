@@ -1,7 +1,6 @@
 #pragma once
 
 #include <deque>
-#include <map>
 #include <vector>
 
 #include "simeng/BranchPredictor.hh"
@@ -44,31 +43,104 @@ class PerceptronPredictor : public BranchPredictor {
   void flush(uint64_t address) override;
 
  private:
-  /** Returns the dot product of a perceptron and a history vector.  Used to
-   * determine a direction prediction */
-  int64_t getDotProduct(const std::vector<int8_t>& perceptron,
-                        uint64_t history);
+  /** An in-flight prediction. */
+  struct Prediction {
+    /** The address of the branch. */
+    uint64_t address;
+    /** The global history the prediction was made with. */
+    uint64_t history;
+    /** The dot product the direction was predicted from. */
+    int32_t output;
+    /** Whether the branch pushed to or popped from the RAS, and the value
+     * popped. */
+    bool rasPush;
+    bool rasPop;
+    uint64_t rasValue;
+    /** Whether the outcome of the branch has been supplied. */
+    bool resolved;
+    /** Whether the branch has been flushed. */
+    bool flushed;
+  };
+
+  /** Expands `history` into `historySigns_`, holding +1 for each taken branch
+   * and -1 for each not-taken one, followed by 0 for the padding. */
+  void expandHistory(uint64_t history);
+
+  /** Returns the dot product of the perceptron at `index` and the history
+   * expanded into `historySigns_`. Used to determine a direction prediction */
+  int32_t getDotProduct(uint64_t index) const;
+
+  /** Get the perceptron weights of the BTB entry at `index`. */
+  int8_t* perceptron(uint64_t index);
+  const int8_t* perceptron(uint64_t index) const;
+
+  /** Record a new in-flight prediction, discarding the oldest if full. */
+  Prediction& allocatePrediction();
+
+  /** Get the in-flight prediction `age` predictions younger than the
+   * oldest. */
+  Prediction& inFlight(size_t age);
+
+  /** The maximum number of in-flight predictions recorded. */
+  static constexpr size_t maxInFlight_ = 1024;
+
+  /** The alignment of each perceptron, in bytes. */
+  static constexpr size_t perceptronAlignment_ = 64;
 
   /** The length in bits of the BTB index; BTB will have 2^bits entries. */
   uint64_t btbBits_;
 
-  /** A 2^bits length vector of pairs containing a perceptron with
-   * globalHistoryLength_ + 1 inputs, and a branch target.
-   * The perceptrons are used to provide a branch direction prediction by
-   * taking a dot product with the global history, as described
-   * in Jiminez and Lin */
-  std::vector<std::pair<std::vector<int8_t>, uint64_t>> btb_;
+  /** The history weights of the 2^bits perceptrons of the BTB, each with
+   * globalHistoryLength_ weights. The perceptrons are used to provide a branch
+   * direction prediction by taking a dot product with the global history, as
+   * described in Jiminez and Lin. Weight `i` of each applies to the `i`th most
+   * recent branch. Each perceptron is padded with zero weights to
+   * `perceptronStride_` bytes and starts `weightsOffset_` bytes into the
+   * storage, aligning them to `perceptronAlignment_` bytes. */
+  std::vector<int8_t> weights_;
 
-  /** The previous hashed index for an address. */
-  std::map<uint64_t, uint64_t> btbHistory_;
+  /** The bias weight of each perceptron. */
+  std::vector<int8_t> biases_;
+
+  /** The number of bytes between consecutive perceptrons. */
+  size_t perceptronStride_;
+
+  /** The offset of the first perceptron into `weights_`. */
+  size_t weightsOffset_;
+
+  /** The branch target of each BTB entry. */
+  std::vector<uint64_t> targets_;
+
+  /** The history expanded for the most recent dot product or training, one
+   * entry per perceptron weight. */
+  std::vector<int8_t> historySigns_;
+
+  /** The in-flight predictions in the order they were made, oldest first from
+   * `oldest_`. */
+  std::vector<Prediction> inFlight_;
+
+  /** The slot of the oldest in-flight prediction. */
+  size_t oldest_ = 0;
+
+  /** The number of in-flight predictions. */
+  size_t inFlightCount_ = 0;
+
+  /** The number of in-flight predictions, from the oldest, known to be
+   * resolved or flushed; the search for a prediction to update starts after
+   * them. */
+  size_t resolvedCount_ = 0;
 
   /** An n-bit history of previous branch directions where n is equal to
-   * globalHistoryLength_. */
+   * globalHistoryLength_. The most recent direction is held in the lowest
+   * bit. */
   uint64_t globalHistory_ = 0;
 
   /** The number of previous branch directions recorded globally. */
   uint64_t globalHistoryLength_;
 
+  /** A mask of the globalHistoryLength_ bits of the global history. */
+  uint64_t globalHistoryMask_;
+
   /** The magnitude of the dot product of the perceptron and the global history,
    * below which the perceptron's weight must be updated */
   uint64_t trainingThreshold_;
@@ -76,11 +148,6 @@ class PerceptronPredictor : public BranchPredictor {
   /** A return address stack. */
   std::deque<uint64_t> ras_;
 
-  /** RAS history with instruction address as the keys. A non-zero value
-   * represents the target prediction for a return instruction and a 0 entry for
-   * a branch-and-link instruction. */
-  std::map<uint64_t, uint64_t> rasHistory_;
-
   /** The size of the RAS. */
   uint64_t rasSize_;
 };
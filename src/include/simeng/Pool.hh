@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <utility>
 #include <vector>
@@ -80,6 +83,153 @@ class fixedPool_ {
   std::vector<void*> ptrs;
 };
 
+/** A pool of `chunk_size` byte chunks shared by every host thread. Each thread
+ * allocates from, and releases to, a free list of its own without
+ * synchronisation. When a thread exits, its free list is handed to a depot
+ * shared by all threads, from which a thread whose list runs dry draws before
+ * allocating more memory. Chunks may therefore be released by any thread at
+ * any point in the program's lifetime, including once the thread which
+ * allocated them has exited, and the memory held is bounded by the peak demand
+ * rather than by the number of threads created. Memory is never returned to the
+ * free store. */
+template <size_t chunk_size, size_t initial_size = 64>
+class threadPool_ {
+  static_assert(initial_size && (initial_size & (initial_size - 1)) == 0 &&
+                "initial_size is not a power of 2");
+
+ public:
+  /** Allocate `chunk_size` bytes. If allocation fails, it returns nullptr. */
+  static void* allocate() noexcept {
+    Local& local = getLocal();
+    if (local.head) return std::exchange(local.head, next(local.head));
+    return refill(local);
+  }
+
+  /** Return memory at `ptr` of size `chunk_size` bytes to the calling
+   * thread's free list. Passing nullptr is a nop. */
+  static void deallocate(void* ptr) noexcept {
+    if (!ptr) return;
+    Local& local = getLocal();
+    if (local.exited) {
+      // The thread's list has already been handed over, so give the chunk
+      // straight to the depot
+      next(ptr) = nullptr;
+      Depot& depot = getDepot();
+      std::lock_guard<std::mutex> lock(depot.mutex);
+      depot.lists.push_back(ptr);
+      return;
+    }
+    if (!local.head) registerExit();
+    next(ptr) = local.head;
+    local.head = ptr;
+  }
+
+ private:
+  /** The free chunks and growth of a thread. Trivially destructible, so that
+   * it remains usable by the destructors which run as the thread exits. */
+  struct Local {
+    /** The head of the thread's free list. */
+    void* head = nullptr;
+    /** The number of chunks in the next block allocated. */
+    size_t blockChunks = initial_size;
+    /** Whether the thread has handed its free list to the depot. */
+    bool exited = false;
+  };
+
+  /** The free lists of exited threads, and every block allocated. */
+  struct Depot {
+    std::mutex mutex;
+    std::vector<void*> lists;
+    std::vector<void*> blocks;
+  };
+
+  /** Hands the thread's free list to the depot when destroyed at thread
+   * exit. */
+  struct ExitHandler {
+    ~ExitHandler() {
+      Local& local = getLocal();
+      Depot& depot = getDepot();
+      std::lock_guard<std::mutex> lock(depot.mutex);
+      if (local.head) depot.lists.push_back(local.head);
+      local.head = nullptr;
+      local.exited = true;
+    }
+  };
+
+  /** The space reserved for each chunk, keeping chunks aligned and able to
+   * hold a free list link. */
+  static constexpr size_t stride_ =
+      (std::max(chunk_size, sizeof(void*)) + alignof(std::max_align_t) - 1) &
+      ~(alignof(std::max_align_t) - 1);
+
+  /** Get the free list link stored in the free chunk at `ptr`. */
+  static void*& next(void* ptr) { return *reinterpret_cast<void**>(ptr); }
+
+  static Local& getLocal() {
+    thread_local Local local;
+    return local;
+  }
+
+  /** Get the depot, which is deliberately leaked so that it outlives every
+   * thread and static object. */
+  static Depot& getDepot() {
+    static Depot* depot = new Depot();
+    return *depot;
+  }
+
+  /** Arrange for the thread's free list to be handed over when it exits. */
+  static void registerExit() {
+    thread_local ExitHandler handler;
+    (void)handler;
+  }
+
+  /** Allocate a chunk once the thread's free list is empty, refilling it from
+   * the depot or a newly allocated block. */
+  static void* refill(Local& local) noexcept {
+    if (!local.exited) registerExit();
+    Depot& depot = getDepot();
+    std::lock_guard<std::mutex> lock(depot.mutex);
+    void* list = nullptr;
+    if (!depot.lists.empty()) {
+      list = depot.lists.back();
+      depot.lists.pop_back();
+    } else {
+      list = grow(local, depot);
+      if (!list) return nullptr;
+    }
+    void* chunk = std::exchange(list, next(list));
+    if (!local.exited) {
+      local.head = list;
+    } else if (list) {
+      depot.lists.push_back(list);
+    }
+    return chunk;
+  }
+
+  /** Allocate a block of chunks, returning them as a free list. Called with
+   * the depot's mutex held. */
+  static void* grow(Local& local, Depot& depot) noexcept {
+    char* block = static_cast<char*>(
+        ::operator new(stride_ * local.blockChunks, std::nothrow));
+    if (!block) return nullptr;
+    try {
+      depot.blocks.push_back(block);
+    } catch (...) {
+      ::operator delete(block);
+      return nullptr;
+    }
+
+    void* list = nullptr;
+    for (size_t i = local.blockChunks; i-- > 0;) {
+      void* chunk = block + i * stride_;
+      next(chunk) = list;
+      list = chunk;
+    }
+    local.blockChunks <<= 1;
+    return list;
+  }
+};
+
 /** The class Pool is general-purpose memory pool implementation. It consists of
  * a collection of pools that serve requests for different chunk sizes.
  *
@@ -156,4 +306,60 @@ class Pool {
   fixedPool_<256, 1024> pool256;
 };
 
+/** Serves allocations of up to 4096 bytes from the `threadPool_` of the
+ * smallest power of two size class, of at least 64 bytes, which holds them,
+ * and larger ones from the free store. Intended for the class-specific
+ * `operator new` and `operator delete` of polymorphic types created at a high
+ * rate, such as the micro-ops flowing through a pipeline, whose sized
+ * deallocation receives the size of the most-derived object. As for
+ * `threadPool_`, memory may be released from any host thread. */
+class SizeClassPool {
+ public:
+  /** Allocate `bytes` with alignment `alignof(std::max_align_t)`. */
+  static void* allocate(size_t bytes) {
+    void* ptr;
+    if (bytes <= 64) {
+      ptr = threadPool_<64>::allocate();
+    } else if (bytes <= 128) {
+      ptr = threadPool_<128>::allocate();
+    } else if (bytes <= 256) {
+      ptr = threadPool_<256>::allocate();
+    } else if (bytes <= 512) {
+      ptr = threadPool_<512>::allocate();
+    } else if (bytes <= 1024) {
+      ptr = threadPool_<1024>::allocate();
+    } else if (bytes <= 2048) {
+      ptr = threadPool_<2048>::allocate();
+    } else if (bytes <= 4096) {
+      ptr = threadPool_<4096>::allocate();
+    } else {
+      return ::operator new(bytes);
+    }
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+  }
+
+  /** Release the memory of `bytes` at `ptr`, which must be the size it was
+   * allocated with. Passing nullptr is a nop. */
+  static void deallocate(void* ptr, size_t bytes) noexcept {
+    if (bytes <= 64) {
+      threadPool_<64>::deallocate(ptr);
+    } else if (bytes <= 128) {
+      threadPool_<128>::deallocate(ptr);
+    } else if (bytes <= 256) {
+      threadPool_<256>::deallocate(ptr);
+    } else if (bytes <= 512) {
+      threadPool_<512>::deallocate(ptr);
+    } else if (bytes <= 1024) {
+      threadPool_<1024>::deallocate(ptr);
+    } else if (bytes <= 2048) {
+      threadPool_<2048>::deallocate(ptr);
+    } else if (bytes <= 4096) {
+      threadPool_<4096>::deallocate(ptr);
+    } else {
+      ::operator delete(ptr);
+    }
+  }
+};
+
 }  // namespace simeng
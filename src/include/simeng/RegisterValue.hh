@@ -2,6 +2,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <memory>
@@ -10,17 +11,65 @@
 
 namespace simeng {
 
-/** Global memory pool used by RegisterValue class. */
-extern Pool pool;
-
 /** A class that holds an arbitrary region of immutable data, providing casting
  * and data accessor functions. For values smaller than or equal to
  * `MAX_LOCAL_BYTES`, this data is held in a local value, otherwise memory is
- * allocated and the data is stored there. */
+ * drawn from a memory pool and the data is stored there. As the data is
+ * immutable, copies share the same pooled memory, which is reclaimed once the
+ * last copy is destroyed. The share count is atomic, so copies may be made and
+ * destroyed on different threads. */
 class RegisterValue {
  public:
   RegisterValue();
 
+  RegisterValue(const RegisterValue& other) : bytes(other.bytes) {
+    if (isLocal()) {
+      std::memcpy(value, other.value, MAX_LOCAL_BYTES);
+    } else {
+      ptr = other.ptr;
+      retain();
+    }
+  }
+
+  RegisterValue(RegisterValue&& other) noexcept : bytes(other.bytes) {
+    if (isLocal()) {
+      std::memcpy(value, other.value, MAX_LOCAL_BYTES);
+    } else {
+      ptr = other.ptr;
+      other.bytes = 0;
+    }
+  }
+
+  RegisterValue& operator=(const RegisterValue& other) {
+    if (this != &other) {
+      release();
+      bytes = other.bytes;
+      if (isLocal()) {
+        std::memcpy(value, other.value, MAX_LOCAL_BYTES);
+      } else {
+        ptr = other.ptr;
+        retain();
+      }
+    }
+    return *this;
+  }
+
+  RegisterValue& operator=(RegisterValue&& other) noexcept {
+    if (this != &other) {
+      release();
+      bytes = other.bytes;
+      if (isLocal()) {
+        std::memcpy(value, other.value, MAX_LOCAL_BYTES);
+      } else {
+        ptr = other.ptr;
+        other.bytes = 0;
+      }
+    }
+    return *this;
+  }
+
+  ~RegisterValue() { release(); }
+
   /** Create a new RegisterValue from a value of arbitrary type (except
    * pointers), zero-extending the allocated memory space to the specified
    * number of bytes (defaulting to the size of the template type). */
@@ -37,15 +86,11 @@ class RegisterValue {
                                    0);
       }
     } else {
-      void* data = pool.allocate(bytes);
-      std::memset(data, 0, bytes);
+      this->ptr = allocate(bytes);
+      std::memset(this->ptr, 0, bytes);
 
-      T* view = reinterpret_cast<T*>(data);
+      T* view = reinterpret_cast<T*>(this->ptr);
       view[0] = value;
-
-      this->ptr = std::shared_ptr<char>(
-          static_cast<char*>(data),
-          [bytes](void* ptr) { pool.deallocate(ptr, bytes); });
     }
   }
 
@@ -59,10 +104,9 @@ class RegisterValue {
     if (isLocal()) {
       dest = this->value;
     } else {
-      dest = static_cast<char*>(pool.allocate(capacity));
+      this->ptr = allocate(capacity);
+      dest = this->ptr;
       std::memset(dest, 0, capacity);
-      this->ptr = std::shared_ptr<char>(
-          dest, [capacity](void* ptr) { pool.deallocate(ptr, capacity); });
     }
     assert(dest && "Attempted to dereference a NULL pointer");
     std::memcpy(dest, ptr, bytes);
@@ -98,7 +142,7 @@ class RegisterValue {
     if (isLocal()) {
       return reinterpret_cast<const T*>(value);
     } else {
-      return reinterpret_cast<const T*>(ptr.get());
+      return reinterpret_cast<const T*>(ptr);
     }
   }
 
@@ -117,18 +161,48 @@ class RegisterValue {
   /** Check whether the value is held locally or behind a pointer. */
   constexpr bool isLocal() const { return bytes <= MAX_LOCAL_BYTES; }
 
+  /** Allocate pooled memory for `bytes` bytes of data, with a share count of
+   * one. */
+  static char* allocate(uint16_t bytes);
+
+  /** Return the pooled memory holding `bytes` bytes of data at `ptr`. */
+  static void deallocate(char* ptr, uint16_t bytes);
+
+  /** Get the share count stored ahead of the pooled data. */
+  std::atomic<uint32_t>& shareCount() const {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(ptr - HEADER_BYTES);
+  }
+
+  /** Register an additional holder of the pooled data. A new holder is copied
+   * from an existing one, so needs no ordering. */
+  void retain() const { shareCount().fetch_add(1, std::memory_order_relaxed); }
+
+  /** Drop this holder of any pooled data, reclaiming the memory if it was the
+   * last. */
+  void release() {
+    if (!isLocal() &&
+        shareCount().fetch_sub(1, std::memory_order_acq_rel) == 1)
+      deallocate(ptr, bytes);
+  }
+
   /** The maximum number of bytes that can be held locally. */
   static constexpr uint16_t MAX_LOCAL_BYTES = 16;
 
+  /** The number of bytes reserved ahead of pooled data for its share count.
+   * Sized to keep the data aligned as the pool's chunks are. */
+  static constexpr uint16_t HEADER_BYTES = alignof(std::max_align_t);
+
   /** The number of bytes held. */
   uint16_t bytes = 0;
 
-  /** The underlying pointer each instance references. */
-  std::shared_ptr<char> ptr;
+  union {
+    /** The pooled data each instance references, when not held locally. */
+    char* ptr;
 
-  /** The underlying local member value. Aligned to 8 bytes to prevent
-   * potential alignment issue when casting. */
-  alignas(8) char value[MAX_LOCAL_BYTES];
+    /** The underlying local member value. Aligned to 8 bytes to prevent
+     * potential alignment issue when casting. */
+    alignas(8) char value[MAX_LOCAL_BYTES];
+  };
 };
 
 inline bool operator==(const RegisterValue& lhs, const RegisterValue& rhs) {
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "simeng/CoreInstance.hh"
+
+namespace simeng {
+
+/** A simulation driver which estimates the performance of a workload from a
+ * sample of it simulated in detail. The workload is fast-forwarded on the
+ * functional emulation core of a `CoreInstance`, switching to its outoforder
+ * core for each detailed interval. Each interval begins with a warm-up period,
+ * which brings the branch predictor and pipeline into a representative state
+ * and is excluded from measurement.
+ *
+ * Intervals are either placed periodically, taking `Detail-Length`
+ * instructions from every `Interval-Length`, or at the representative
+ * intervals chosen by SimPoint from the workload's basic block vectors. The
+ * statistics of the measured instructions are then extrapolated across the
+ * whole workload, weighted by SimPoint's cluster weights where available.
+ *
+ * Architectural register state is carried across each switch; memory is shared
+ * by both cores. With `Functional-Warming` enabled, every fetch and data access
+ * made while fast-forwarding also warms the outoforder core's TLBs, caches and
+ * prefetchers, so that each interval starts with them in a representative
+ * state. Otherwise they are left as the previous interval left them, and the
+ * samples are reported as taken cold. Only single-threaded workloads on a
+ * single core are supported. */
+class SamplingDriver {
+ public:
+  /** Construct a driver for the cores of `coreInstance`, which must have been
+   * created with sampling enabled in `config`. */
+  SamplingDriver(CoreInstance& coreInstance,
+                 ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
+  /** Tick the cores until the simulated process has finished. Returns the
+   * number of cycles ticked across both cores. */
+  uint64_t run();
+
+  /** Retrieve a map of statistics estimated for the whole workload. */
+  std::map<std::string, std::string> getStats() const;
+
+ private:
+  /** The stages each detailed interval moves through. */
+  enum class Phase { FastForward, Warmup, Measure, Drain };
+
+  /** A detailed interval to be measured. */
+  struct Interval {
+    /** The retired instruction count at which measurement begins. */
+    uint64_t start;
+
+    /** The weight of this interval in the estimate. */
+    double weight;
+  };
+
+  /** The statistics measured across a detailed interval. */
+  struct Measurement {
+    /** The weight of this interval in the estimate. */
+    double weight;
+
+    /** The change in each of the outoforder core's counters. */
+    std::map<std::string, uint64_t> deltas;
+  };
+
+  /** Read the intervals chosen by SimPoint from `simPointPath`, along with
+   * their weights from `weightsPath` if provided. */
+  void readSimPoints(const std::string& simPointPath,
+                     const std::string& weightsPath);
+
+  /** Select the next interval to measure, skipping any which have already been
+   * passed. */
+  void nextInterval();
+
+  /** Get the number of instructions retired across both cores. */
+  uint64_t getRetiredCount() const;
+
+  /** Get the integer-valued statistics of the outoforder core. */
+  std::map<std::string, uint64_t> getCounters() const;
+
+  /** Move the running thread from the functional core to the outoforder core.
+   * Returns false if the functional core is part-way through an instruction.
+   */
+  bool switchToDetailed();
+
+  /** Move the running thread from the outoforder core to the functional core.
+   * Returns false if the outoforder core could not yet be suspended. */
+  bool switchToFunctional();
+
+  /** Warm the outoforder core's TLBs and memory hierarchy with an access of
+   * `target` by the functional core. */
+  void warm(models::emulation::AccessType type, uint64_t pc,
+            const memory::MemoryAccessTarget& target);
+
+  /** The core instance holding the cores to tick. */
+  CoreInstance& coreInstance_;
+
+  /** The emulation core used to fast-forward. */
+  Core& functionalCore_;
+
+  /** The outoforder core used for detailed intervals. */
+  Core& detailedCore_;
+
+  /** Whether intervals are placed periodically rather than by SimPoint. */
+  bool periodic_;
+
+  /** The number of instructions between the starts of consecutive intervals.
+   */
+  uint64_t intervalLength_;
+
+  /** The number of instructions measured in each interval. */
+  uint64_t detailLength_;
+
+  /** The number of instructions simulated in detail ahead of each
+   * measurement. */
+  uint64_t warmupLength_;
+
+  /** Whether the outoforder core's TLBs and memory hierarchy are warmed while
+   * fast-forwarding. */
+  bool functionalWarming_;
+
+  /** The intervals chosen by SimPoint, in program order. */
+  std::vector<Interval> simPoints_;
+
+  /** The index of the next periodic interval or SimPoint. */
+  uint64_t nextIndex_ = 0;
+
+  /** The interval currently being simulated or awaited. */
+  Interval interval_ = {0, 0.0};
+
+  /** Whether any intervals remain to be measured. */
+  bool hasInterval_ = false;
+
+  /** The current phase of simulation. */
+  Phase phase_ = Phase::FastForward;
+
+  /** The outoforder core's counters when the current measurement began. */
+  std::map<std::string, uint64_t> startCounters_;
+
+  /** The completed measurements. */
+  std::vector<Measurement> measurements_;
+
+  /** The number of cycles ticked across both cores. */
+  uint64_t iterations_ = 0;
+};
+
+}  // namespace simeng
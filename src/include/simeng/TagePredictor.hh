@@ -0,0 +1,238 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "simeng/BranchPredictor.hh"
+#include "simeng/config/SimInfo.hh"
+
+namespace simeng {
+
+/** A TAGE branch predictor implementing the direction predictor described in
+ * Seznec and Michaud ("A case for (partially) TAgged GEometric history length
+ * branch prediction", Journal of Instruction-Level Parallelism 8 (2006) --
+ * https://jilp.org/vol8/v8paper1.pdf), alongside the ITTAGE indirect target
+ * predictor of Seznec ("A 64-Kbytes ITTAGE indirect branch predictor", 2nd
+ * JILP Workshop on Computer Architecture Competitions (2011)).
+ * The following predictors have been included:
+ *
+ * - A bimodal base predictor of 2-bit saturating counters, backed by tagged
+ * tables indexed with global histories of geometrically increasing length.
+ * The matching table with the longest history provides the direction.
+ *
+ * - Tagged target tables over the same histories, backed by a Branch Target
+ * Buffer (BTB), for branches whose target is not known when fetched.
+ *
+ * - A Return Address Stack (RAS) is also in use.
+ *
+ * The global history is updated speculatively with each prediction. Each
+ * prediction is recorded with the history it was made with, so that the
+ * history is repaired once a misprediction is reported to `update`, or once the
+ * branch is flushed.
+ */
+class TagePredictor : public BranchPredictor {
+ public:
+  /** Initialise predictor models. */
+  TagePredictor(ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
+  /** Generate a branch prediction for the supplied instruction address, a
+   * branch type, and a known branch offset; defaults to 0 meaning offset is not
+   * known. Returns a branch direction and branch target address. */
+  BranchPrediction predict(uint64_t address, BranchType type,
+                           int64_t knownOffset = 0) override;
+
+  /** Updates appropriate predictor model objects based on the address and
+   * outcome of the branch instruction, repairing the global history if the
+   * branch was mispredicted. */
+  void update(uint64_t address, bool taken, uint64_t targetAddress,
+              BranchType type) override;
+
+  /** Discards the youngest in-flight prediction for the address, and any
+   * younger, rewinding the global history and RAS to before it. Does nothing
+   * if no prediction for the address is in flight. */
+  void flush(uint64_t address) override;
+
+ private:
+  /** An entry of a tagged direction table. */
+  struct TaggedEntry {
+    /** The tag of the branch and history which allocated the entry. */
+    uint16_t tag = 0;
+    /** A signed 3-bit saturating counter; the branch is predicted taken when
+     * it is not negative. */
+    int8_t counter = 0;
+    /** A 2-bit counter of how useful the entry has been. */
+    uint8_t useful = 0;
+  };
+
+  /** An entry of a tagged target table. */
+  struct TargetEntry {
+    /** The tag of the branch and history which allocated the entry. */
+    uint16_t tag = 0;
+    /** The predicted target. */
+    uint64_t target = 0;
+    /** A 2-bit counter of confidence in the target. */
+    uint8_t confidence = 0;
+    /** A 1-bit flag of whether the entry has been useful. */
+    uint8_t useful = 0;
+  };
+
+  /** A global history of `length` bits folded into `width` bits, maintained
+   * as a circular shift register as the history is extended. */
+  struct FoldedHistory {
+    /** The length of the global history folded. */
+    uint16_t length;
+    /** The number of bits the history is folded into. */
+    uint8_t width;
+    /** The current folded value. */
+    uint32_t value = 0;
+  };
+
+  /** An in-flight prediction. Predictions are retired once they, and every
+   * older prediction, are resolved. */
+  struct Prediction {
+    /** The address of the branch. */
+    uint64_t address;
+    /** The predicted direction and target. */
+    BranchPrediction prediction;
+    /** The direction table providing the prediction; -1 for the base
+     * predictor. */
+    int8_t provider;
+    /** The directions predicted by the provider and alternate tables. */
+    bool providerTaken;
+    bool alternateTaken;
+    /** Whether the target was predicted rather than known, and the target
+     * table providing it; -1 for the BTB. */
+    bool indirect;
+    int8_t targetProvider;
+    /** Whether the branch pushed to or popped from the RAS, and the value
+     * popped. */
+    bool rasPush;
+    bool rasPop;
+    uint64_t rasValue;
+    /** The number of global history bits recorded before the prediction. */
+    uint64_t historyLength;
+    /** The path history before the prediction. */
+    uint16_t pathHistory;
+    /** Whether the outcome of the branch has been supplied. */
+    bool resolved;
+    /** Whether the prediction was rolled back by an older misprediction, and
+     * remains only to be matched by a flush. */
+    bool squashed;
+  };
+
+  /** Compute the table indices and tags for `address` from the folded
+   * histories `folds` and path history `path`. */
+  void computeIndices(uint64_t address, const uint32_t* folds, uint16_t path);
+
+  /** Record a new in-flight prediction, discarding the oldest if full. Returns
+   * its slot. */
+  size_t allocatePrediction();
+
+  /** Append a branch outcome to the global and path histories. */
+  void pushHistory(bool taken, uint64_t address);
+
+  /** Restore the histories to those saved with the prediction in `slot`. */
+  void restoreHistory(size_t slot);
+
+  /** Undo the RAS operation of `prediction`. */
+  void rewindRas(const Prediction& prediction);
+
+  /** Train the direction tables with the outcome of `prediction`. */
+  void trainDirection(const Prediction& prediction, bool taken);
+
+  /** Train the target tables with the resolved target of `prediction`. */
+  void trainTarget(const Prediction& prediction, uint64_t target);
+
+  /** Get the tagged direction table entry at `index` of `table`. */
+  TaggedEntry& taggedEntry(size_t table, uint32_t index);
+
+  /** Get the tagged target table entry at `index` of `table`. */
+  TargetEntry& targetEntry(size_t table, uint32_t index);
+
+  /** Get the next value of a pseudo-random sequence, used to spread
+   * allocations across tables. */
+  uint32_t nextRandom();
+
+  /** The maximum number of in-flight predictions recorded. */
+  static constexpr size_t maxInFlight_ = 1024;
+
+  /** The number of tagged direction tables. */
+  size_t tables_;
+
+  /** The number of tagged target tables. */
+  size_t targetTables_;
+
+  /** The number of index bits of the base table, the tagged direction tables,
+   * the tagged target tables, and the BTB. */
+  uint8_t baseBits_;
+  uint8_t tableBits_;
+  uint8_t targetTableBits_;
+  uint8_t btbBits_;
+
+  /** The number of bits in the tags of the tagged tables. */
+  uint8_t tagBits_;
+
+  /** The base predictor's 2-bit saturating counters. */
+  std::vector<uint8_t> base_;
+
+  /** The tagged direction tables, stored consecutively. */
+  std::vector<TaggedEntry> tagged_;
+
+  /** The tagged target tables, stored consecutively. */
+  std::vector<TargetEntry> targets_;
+
+  /** The most recent target of each branch, indexed by address. */
+  std::vector<uint64_t> btb_;
+
+  /** The global history of branch directions, as a circular buffer of one
+   * entry per bit indexed by `historyLength_`. */
+  std::vector<uint8_t> history_;
+
+  /** The number of bits recorded in the global history. */
+  uint64_t historyLength_ = 0;
+
+  /** A 16-bit history of the address bits of recent branches. */
+  uint16_t pathHistory_ = 0;
+
+  /** The global history folded for the index and two tags of each direction
+   * table, followed by those of each target table. */
+  std::vector<FoldedHistory> folds_;
+
+  /** The in-flight predictions, oldest first from `oldest_`. */
+  std::vector<Prediction> inFlight_;
+
+  /** The folded histories saved with each in-flight prediction. */
+  std::vector<uint32_t> savedFolds_;
+
+  /** The slot of the oldest in-flight prediction. */
+  size_t oldest_ = 0;
+
+  /** The number of in-flight predictions. */
+  size_t inFlightCount_ = 0;
+
+  /** The direction and target table indices and tags most recently
+   * computed. */
+  std::vector<uint32_t> indices_;
+  std::vector<uint16_t> tags_;
+  std::vector<uint32_t> targetIndices_;
+  std::vector<uint16_t> targetTags_;
+
+  /** A 4-bit signed counter of whether the alternate prediction is more
+   * accurate than a newly allocated provider entry. */
+  int8_t useAltOnNewAlloc_ = 0;
+
+  /** The number of direction updates, used to periodically age the useful
+   * counters. */
+  uint64_t updates_ = 0;
+
+  /** The state of the pseudo-random sequence. */
+  uint32_t random_ = 0x2545F491;
+
+  /** A return address stack. */
+  std::deque<uint64_t> ras_;
+
+  /** The size of the RAS. */
+  uint16_t rasSize_;
+};
+
+}  // namespace simeng
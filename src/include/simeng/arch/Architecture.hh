@@ -8,11 +8,13 @@
 #include "simeng/Instruction.hh"
 #include "simeng/arch/ProcessStateChange.hh"
 #include "simeng/kernel/Linux.hh"
+#include "simeng/memory/ExclusiveMonitor.hh"
 #include "simeng/memory/MemoryInterface.hh"
+#include "simeng/memory/PageGenerations.hh"
 
 namespace simeng {
 
-using MacroOp = std::vector<std::shared_ptr<Instruction>>;
+using MacroOp = std::vector<IntrusivePtr<Instruction>>;
 
 namespace arch {
 
@@ -24,6 +26,13 @@ struct ExceptionResult {
   uint64_t instructionAddress;
   /** Any changes to apply to the process state. */
   ProcessStateChange stateChange;
+  /** Whether the software thread has exited, leaving the core idle once the
+   * state changes have been applied. */
+  bool threadExited = false;
+  /** Whether the software thread has gone to sleep on a futex, leaving the
+   * core idle once the state changes have been applied. The kernel holds its
+   * state until it is woken. */
+  bool threadWaiting = false;
 };
 
 /** An abstract multi-cycle exception handler interface. Should be ticked each
@@ -56,6 +65,13 @@ class Architecture {
                             uint64_t instructionAddress,
                             MacroOp& output) const = 0;
 
+  /** Write into `output` a macro-op standing in for the instruction at
+   * `instructionAddress`, whose bytes could not be read from instruction
+   * memory. It raises an instruction fetch exception once it reaches
+   * execution, and so only once it is known to be on the correct path. */
+  virtual void predecodeFault(uint64_t instructionAddress,
+                              MacroOp& output) const = 0;
+
   /** Returns a zero-indexed register tag for a system register encoding. */
   virtual int32_t getSystemRegisterTag(uint16_t reg) const = 0;
 
@@ -65,7 +81,7 @@ class Architecture {
    * may be ticked until the exception is resolved, and results then
    * obtained. */
   virtual std::shared_ptr<ExceptionHandler> handleException(
-      const std::shared_ptr<Instruction>& instruction, const Core& core,
+      const IntrusivePtr<Instruction>& instruction, const Core& core,
       memory::MemoryInterface& memory) const = 0;
 
   /** Retrieve the initial process state. */
@@ -81,6 +97,89 @@ class Architecture {
   virtual void updateSystemTimerRegisters(RegisterFileSet* regFile,
                                           const uint64_t iterations) const = 0;
 
+  /** Returns a vector of {size, number} pairs describing the available
+   * architectural registers. */
+  const std::vector<RegisterFileStructure>& getArchRegStruct() const {
+    return archRegStruct_;
+  }
+
+  /** Returns a vector of {size, number} pairs describing the available
+   * physical registers. */
+  const std::vector<RegisterFileStructure>& getPhysRegStruct() const {
+    return physRegStruct_;
+  }
+
+  /** Returns a vector of the quantities of physical registers available in
+   * each register file. */
+  const std::vector<uint16_t>& getPhysRegQuantities() const {
+    return physRegQuantities_;
+  }
+
+  /** Share `monitor` between the cores running the process, this architecture
+   * belonging to the core with ID `coreId`. Without a monitor, exclusive
+   * stores always succeed and are written as any other store, as with a
+   * single core. */
+  void setExclusiveMonitor(memory::ExclusiveMonitor* monitor, uint16_t coreId) {
+    exclusiveMonitor_ = monitor;
+    coreId_ = coreId;
+  }
+
+  /** Check whether an exclusive monitor is shared with other cores, through
+   * which exclusive stores and atomics must write memory. */
+  bool hasExclusiveMonitor() const { return exclusiveMonitor_ != nullptr; }
+
+  /** Reserve `target`, read as `value` by an exclusive load or atomic. */
+  void reserve(const memory::MemoryAccessTarget& target,
+               const RegisterValue& value) const {
+    if (exclusiveMonitor_) exclusiveMonitor_->reserve(coreId_, target, value);
+  }
+
+  /** Check whether this core still holds a reservation of `target`, and so
+   * whether an exclusive store to it may succeed. */
+  bool holdsReservation(const memory::MemoryAccessTarget& target) const {
+    return !exclusiveMonitor_ ||
+           exclusiveMonitor_->holdsReservation(coreId_, target);
+  }
+
+  /** Write the data of exclusive store or atomic `uop` to memory through the
+   * exclusive monitor. An exclusive store which had lost its reservation when
+   * executed writes nothing. Returns false if the reservation has been lost
+   * since, in which case nothing was written and `uop` must be re-executed. */
+  bool storeExclusive(const Instruction& uop) const {
+    if (!uop.holdsReservation()) return true;
+    const auto& targets = uop.getGeneratedAddresses();
+    const auto& data = uop.getData();
+    for (size_t i = 0; i < targets.size(); i++) {
+      if (!exclusiveMonitor_->store(coreId_, targets[i], data[i])) return false;
+      if (pageGenerations_) pageGenerations_->recordWrite(targets[i]);
+    }
+    return true;
+  }
+
+  /** Record a store by this core to `target`, clearing the reservations other
+   * cores hold on it and marking stale any copies of it cached as code. */
+  void recordStore(const memory::MemoryAccessTarget& target) const {
+    if (exclusiveMonitor_) exclusiveMonitor_->recordStore(coreId_, target);
+    if (pageGenerations_) pageGenerations_->recordWrite(target);
+  }
+
+  /** Share `generations` between the cores running the process, recording
+   * the writes of this architecture's core to it. */
+  void setPageGenerations(memory::PageGenerations* generations) {
+    pageGenerations_ = generations;
+  }
+
+  /** Retrieve the record of writes to process memory shared by the cores
+   * running the process; null if there is none. */
+  memory::PageGenerations* getPageGenerations() const {
+    return pageGenerations_;
+  }
+
+  /** Clear this core's reservation, as when it is given a new thread. */
+  void clearReservation() const {
+    if (exclusiveMonitor_) exclusiveMonitor_->clearReservation(coreId_);
+  }
+
  protected:
   /** A Capstone decoding library handle, for decoding instructions. */
   csh capstoneHandle_;
@@ -98,6 +197,28 @@ class Architecture {
   /** A map to hold the relationship between instruction opcode and
    * user-defined execution information. */
   std::unordered_map<uint16_t, ExecutionInfo> opcodeExecutionInfo_;
+
+  /** The architectural register file structure, as derived from the config
+   * this architecture was constructed with. */
+  std::vector<RegisterFileStructure> archRegStruct_;
+
+  /** The physical register file structure, as derived from the config this
+   * architecture was constructed with. */
+  std::vector<RegisterFileStructure> physRegStruct_;
+
+  /** The quantities of physical registers in each register file. */
+  std::vector<uint16_t> physRegQuantities_;
+
+  /** The exclusive monitor shared by the cores running the process; null if
+   * there is none. */
+  memory::ExclusiveMonitor* exclusiveMonitor_ = nullptr;
+
+  /** The ID of the core this architecture belongs to. */
+  uint16_t coreId_ = 0;
+
+  /** The record of writes to process memory shared by the cores running the
+   * process; null if there is none. */
+  memory::PageGenerations* pageGenerations_ = nullptr;
 };
 
 }  // namespace arch
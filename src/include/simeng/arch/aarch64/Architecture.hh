@@ -29,6 +29,11 @@ class Architecture : public arch::Architecture {
                     uint64_t instructionAddress,
                     MacroOp& output) const override;
 
+  /** Write into `output` a macro-op raising an instruction abort for the
+   * instruction at `instructionAddress`, which could not be fetched. */
+  void predecodeFault(uint64_t instructionAddress,
+                      MacroOp& output) const override;
+
   /** Returns a zero-indexed register tag for a system register encoding.
    * Returns -1 in the case that the system register has no mapping. */
   int32_t getSystemRegisterTag(uint16_t reg) const override;
@@ -38,7 +43,7 @@ class Architecture : public arch::Architecture {
    * Returns a smart pointer to an `ExceptionHandler` which may be ticked until
    * the exception is resolved, and results then obtained. */
   std::shared_ptr<arch::ExceptionHandler> handleException(
-      const std::shared_ptr<simeng::Instruction>& instruction, const Core& core,
+      const IntrusivePtr<simeng::Instruction>& instruction, const Core& core,
       memory::MemoryInterface& memory) const override;
 
   /** Retrieve the initial process state. */
@@ -15,7 +15,7 @@ class ExceptionHandler : public simeng::arch::ExceptionHandler {
  public:
   /** Create an exception handler with references to the instruction that caused
    * the exception, along with the core model object and process memory. */
-  ExceptionHandler(const std::shared_ptr<simeng::Instruction>& instruction,
+  ExceptionHandler(const IntrusivePtr<simeng::Instruction>& instruction,
                    const Core& core, memory::MemoryInterface& memory,
                    kernel::Linux& linux);
 
@@ -68,6 +68,10 @@ class ExceptionHandler : public simeng::arch::ExceptionHandler {
    * exception results. */
   bool concludeSyscall(ProcessStateChange& stateChange);
 
+  /** Capture the calling thread's registers, such that it may later resume
+   * from the instruction following the syscall with a return value of 0. */
+  kernel::LinuxThreadContext saveThread() const;
+
   /** Sets a generic fatal result and returns true. */
   bool fatal();
 
@@ -50,6 +50,7 @@ enum class InstructionException {
   ExecutionNotYetImplemented,
   AliasNotYetImplemented,
   MisalignedPC,
+  InstructionAbort,
   DataAbort,
   SupervisorCall,
   HypervisorCall,
@@ -259,7 +260,9 @@ enum class InsnType : uint32_t {
   /** Is a store data operation. */
   isStoreData = 1 << 13,
   /** Is a branch operation. */
-  isBranch = 1 << 14
+  isBranch = 1 << 14,
+  /** Is an exclusive or atomic memory access. */
+  isAtomic = 1 << 15
 };
 
 /** A basic Armv9.2-a implementation of the `Instruction` interface. */
@@ -343,6 +346,11 @@ class Instruction : public simeng::Instruction {
   /** Is this a branch operation? */
   bool isBranch() const override;
 
+  /** Is this an exclusive or atomic memory access? Exclusive loads reserve the
+   * memory they read, while exclusive stores and atomic read-modify-writes
+   * write memory through the exclusive monitor. */
+  bool isAtomic() const override;
+
   /** Retrieve the instruction group this instruction belongs to. */
   uint16_t getGroup() const override;
 
@@ -360,6 +368,13 @@ class Instruction : public simeng::Instruction {
    * latency and throughput, and the set of ports which support it. */
   void setExecutionInfo(const ExecutionInfo& info) override;
 
+  /** Create a copy of this instruction in its current state. */
+  IntrusivePtr<simeng::Instruction> clone() const override;
+
+  /** Return the instruction to the state it was decoded in. Operands read
+   * from the zero register are kept, as their value never changes. */
+  void reset() override;
+
   /** Retrieve the instruction's metadata. */
   const InstructionMetadata& getMetadata() const;
 
@@ -35,6 +35,7 @@ enum class InstructionException {
   ExecutionNotYetImplemented,
   AliasNotYetImplemented,
   MisalignedPC,
+  InstructionAbort,
   DataAbort,
   SupervisorCall,
   HypervisorCall,
@@ -158,6 +159,11 @@ class Instruction : public simeng::Instruction {
   /** Is this a branch operation? */
   bool isBranch() const override;
 
+  /** Is this an exclusive or atomic memory access? Load-reserved instructions
+   * reserve the memory they read, while store-conditional and AMO
+   * instructions write memory through the exclusive monitor. */
+  bool isAtomic() const override;
+
   /** Retrieve the instruction group this instruction belongs to. */
   uint16_t getGroup() const override;
 
@@ -175,6 +181,13 @@ class Instruction : public simeng::Instruction {
    * latency and throughput, and the set of ports which support it. */
   void setExecutionInfo(const ExecutionInfo& info) override;
 
+  /** Create a copy of this instruction in its current state. */
+  IntrusivePtr<simeng::Instruction> clone() const override;
+
+  /** Return the instruction to the state it was decoded in. Operands read
+   * from the zero register are kept, as their value never changes. */
+  void reset() override;
+
   /** Retrieve the instruction's metadata. */
   const InstructionMetadata& getMetadata() const;
 
@@ -69,6 +69,12 @@ class ModelConfig {
    * all expectations on the values of passed/created config files. */
   void setExpectations(bool isDefault = false);
 
+  /** Add the expectations describing a cache level to the `section`
+   * expectation, with the given default geometry and timing. */
+  void addCacheExpectations(std::string section, uint64_t size,
+                            uint16_t associativity, uint16_t hitLatency,
+                            uint16_t mshrs);
+
   /** A utility function to recursively iterate over all instances of
    * ExpectationNode in `expectations` and the values within the config file,
    * calling ExpectationNode validate functionality on each associated config
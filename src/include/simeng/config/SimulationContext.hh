@@ -0,0 +1,204 @@
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "simeng/Instruction.hh"
+#include "simeng/RegisterFileSet.hh"
+#include "simeng/arch/aarch64/ArchInfo.hh"
+#include "simeng/arch/riscv/ArchInfo.hh"
+#include "simeng/config/ModelConfig.hh"
+#include "simeng/config/yaml/ryml.hh"
+
+#define DEFAULT_STR "Default"
+
+namespace simeng {
+namespace config {
+
+/** Enum representing the possible simulation modes. */
+enum class SimulationMode { Emulation, InOrderPipelined, Outoforder };
+
+/** A SimulationContext class holding the validated model config of a single
+ * simulation, along with the frequently queried values derived from it. Each
+ * simulation is constructed from its own context, so any number of differently
+ * configured simulations may exist within one process. The context must
+ * outlive every simulation object constructed from it. */
+class SimulationContext {
+ public:
+  /** Construct a context holding the default config for the AArch64 ISA. */
+  SimulationContext() {
+    validatedConfig_ = modelConfig_.getConfig();
+    extractValues();
+  }
+
+  /** Construct a context from the YAML model config file at `path`. */
+  explicit SimulationContext(std::string path)
+      : modelConfig_(path), configFilePath_(path) {
+    validatedConfig_ = modelConfig_.getConfig();
+    extractValues();
+  }
+
+  SimulationContext(const SimulationContext&) = delete;
+  SimulationContext& operator=(const SimulationContext&) = delete;
+
+  /** A getter function to retrieve the ryml::Tree representing the underlying
+   * model config file. */
+  ryml::ConstNodeRef getConfig() const { return validatedConfig_.crootref(); }
+
+  /** A setter function to set the model config file from a path to a YAML file.
+   */
+  void setConfig(std::string path) {
+    // Recreate the model config instance from the YAML file path
+    modelConfig_ = ModelConfig(path);
+
+    // Update config path to be the passed path
+    configFilePath_ = path;
+
+    // Update the validated config file
+    validatedConfig_ = modelConfig_.getConfig();
+    extractValues();
+  }
+
+  /** A function to add additional config values to the model config file. */
+  void addToConfig(std::string configAdditions) {
+    modelConfig_.addConfigOptions(configAdditions);
+    // Replace the validated config with new instance with the supplied
+    // additional values
+    validatedConfig_ = modelConfig_.getConfig();
+    // Update previously extracted values from the config file
+    extractValues();
+  }
+
+  /** A function to generate a default config file based on a passed ISA. */
+  void generateDefault(ISA isa, bool force = false) {
+    if (isa == ISA::AArch64)
+      modelConfig_.reGenerateDefault(ISA::AArch64, force);
+    else if (isa == ISA::RV64)
+      modelConfig_.reGenerateDefault(ISA::RV64, force);
+
+    // Update config path to be the default string
+    configFilePath_ = DEFAULT_STR;
+
+    // Replace the validated config with the new default config
+    validatedConfig_ = modelConfig_.getConfig();
+    // Update previously extracted values from the config file
+    extractValues();
+  }
+
+  /** A getter function to retrieve the config file path. */
+  const std::string& getConfigPath() const { return configFilePath_; }
+
+  /** A getter function to retrieve the simulation mode. */
+  SimulationMode getSimMode() const { return mode_; }
+
+  /** A getter function to retrieve the simulation mode as a string. */
+  const std::string& getSimModeStr() const { return modeStr_; }
+
+  /** A getter function to retrieve which ISA the simulation is using. */
+  ISA getISA() const { return isa_; }
+
+  /** A getter function to retrieve which ISA the simulation is using in a
+   * string format. */
+  const std::string& getISAString() const { return isaString_; }
+
+  /** A getter function to retrieve a vector of {size, number} pairs describing
+   * the available architectural registers. */
+  const std::vector<simeng::RegisterFileStructure>& getArchRegStruct() const {
+    return archInfo_->getArchRegStruct();
+  }
+
+  /** A getter function to retrieve a vector of {size, number} pairs describing
+   * the available physical registers. */
+  const std::vector<simeng::RegisterFileStructure>& getPhysRegStruct() const {
+    return archInfo_->getPhysRegStruct();
+  }
+
+  /** A getter function to retrieve a vector of uint16_t values describing
+   * the quantities of physical registers available. */
+  const std::vector<uint16_t>& getPhysRegQuantities() const {
+    return archInfo_->getPhysRegQuantities();
+  }
+
+  /** A getter function to retrieve a vector of Capstone sysreg enums for
+   * all the system registers that should be utilised in simulation. */
+  const std::vector<uint64_t>& getSysRegVec() const {
+    return archInfo_->getSysRegEnums();
+  }
+
+  /** A getter function to retrieve whether or not the special files
+   * directories should be generated. */
+  bool getGenSpecFiles() const { return genSpecialFiles_; }
+
+  /** A utility function to rebuild/construct member variables/classes. For use
+   * if the configuration used changes during simulation (e.g. during the
+   * execution of a test suite). */
+  void reBuild() { extractValues(); }
+
+ private:
+  /** A function to extract various values from the generated config file to
+   * populate frequently queried model config values. */
+  void extractValues() {
+    // Get ISA type and set the corresponding ArchInfo class
+    isaString_ = validatedConfig_["Core"]["ISA"].as<std::string>();
+    if (isaString_ == "AArch64") {
+      isa_ = ISA::AArch64;
+      archInfo_ = std::make_unique<arch::aarch64::ArchInfo>(
+          arch::aarch64::ArchInfo(validatedConfig_));
+    } else if (isaString_ == "rv64") {
+      isa_ = ISA::RV64;
+      archInfo_ = std::make_unique<arch::riscv::ArchInfo>(
+          arch::riscv::ArchInfo(validatedConfig_));
+    }
+
+    // Get Simulation mode
+    std::string mode =
+        validatedConfig_["Core"]["Simulation-Mode"].as<std::string>();
+    if (mode == "emulation") {
+      mode_ = SimulationMode::Emulation;
+      modeStr_ = "Emulation";
+    } else if (mode == "inorderpipelined") {
+      mode_ = SimulationMode::InOrderPipelined;
+      modeStr_ = "In-Order Pipelined";
+    } else if (mode == "outoforder") {
+      mode_ = SimulationMode::Outoforder;
+      modeStr_ = "Out-of-Order";
+    }
+
+    // Get if the special files directory should be created
+    genSpecialFiles_ =
+        validatedConfig_["CPU-Info"]["Generate-Special-Dir"].as<bool>();
+  }
+
+  /** The validated model config file represented as a ryml:Tree. */
+  ryml::Tree validatedConfig_;
+
+  /** The ModelConfig instance used to create and maintain the model config
+   * file. */
+  ModelConfig modelConfig_;
+
+  /** The path of the model config file. Defaults to "Default". */
+  std::string configFilePath_ = DEFAULT_STR;
+
+  /** The simulation mode. */
+  SimulationMode mode_;
+
+  /** The simulation mode in a string format. */
+  std::string modeStr_;
+
+  /** The instruction set architecture being simulated. */
+  ISA isa_;
+
+  /** The instruction set architecture being simulated in a string format. */
+  std::string isaString_;
+
+  /** Instance of an ArchInfo class used to store architecture specific
+   * configuration options. */
+  std::unique_ptr<arch::ArchInfo> archInfo_;
+
+  /** A bool representing if the special file directory should be created. */
+  bool genSpecialFiles_;
+};
+
+}  // namespace config
+}  // namespace simeng
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
 #include <vector>
 
+#include "simeng/Checkpoint.hh"
+#include "simeng/arch/ProcessStateChange.hh"
 #include "simeng/kernel/LinuxProcess.hh"
 #include "simeng/version.hh"
 
@@ -83,11 +89,16 @@ struct LinuxProcessState {
   std::vector<vm_area_struct> contiguousAllocations;
   /** Non-Contiguous memory allocations from the mmap system call. */
   std::vector<vm_area_struct> nonContiguousAllocations;
+  /** The process image backing the process' memory. */
+  std::shared_ptr<char> processImage;
+  /** The size of the process image. */
+  uint64_t processImageSize;
 
   // Thread state
-  // TODO: Support multiple threads per process
-  /** The clear_child_tid value. */
-  uint64_t clearChildTid = 0;
+  /** The clear_child_tid value of each live thread, indexed by thread ID. */
+  std::unordered_map<int64_t, uint64_t> clearChildTids;
+  /** The ID to assign to the next thread created. */
+  int64_t nextTid;
 
   /** The virtual file descriptor mapping table. */
   std::vector<int64_t> fileDescriptorTable;
@@ -126,16 +137,38 @@ struct linux_dirent64 {
   char* d_name;       // Filename (null-terminated)
 };
 
+/** A thread created by the clone syscall which is waiting for a core to run
+ * on. */
+struct LinuxThreadContext {
+  /** The thread ID. */
+  int64_t tid;
+  /** The address of the first instruction the thread executes. */
+  uint64_t pc;
+  /** The register values the thread starts with. */
+  arch::ProcessStateChange registers;
+};
+
 /** A Linux kernel syscall emulation implementation, which mimics the responses
    to Linux system calls. */
 class Linux {
  public:
-  Linux(const std::string specialFiledirPath)
-      : specialFilesDir_(specialFiledirPath) {}
+  /** Construct a kernel using the special files held in `specialFiledirPath`,
+   * running processes across `coreCount` cores. */
+  Linux(const std::string specialFiledirPath, uint16_t coreCount = 1)
+      : specialFilesDir_(specialFiledirPath), coreCount_(coreCount) {}
 
   /** Create a new Linux process running above this kernel. */
   void createProcess(const LinuxProcess& process);
 
+  /** Write the state of the kernel and its process to `checkpoint`. Open host
+   * files are recorded by path, access mode and offset. */
+  void checkpoint(CheckpointWriter& checkpoint) const;
+
+  /** Replace the state of the kernel and its process, as created by
+   * `createProcess`, with that held in `checkpoint`. Files open at the time of
+   * the checkpoint are re-opened and repositioned. */
+  void restore(CheckpointReader& checkpoint);
+
   /** Retrieve the initial stack pointer. */
   uint64_t getInitialStackPointer() const;
 
@@ -143,6 +176,50 @@ class Linux {
    * `addr` if reasonable, and returns the program break. */
   int64_t brk(uint64_t addr);
 
+  /** clone syscall: create a new thread in the current process, which will
+   * begin executing from the pc and registers of `thread` once a core becomes
+   * available. Only thread creation is supported; requests which would create
+   * a new process return -ENOSYS. Returns the new thread's ID on success. */
+  int64_t clone(uint64_t flags, uint64_t childTidPtr,
+                LinuxThreadContext thread);
+
+  /** Check whether any threads created by `clone` or woken from a futex are
+   * waiting for a core. */
+  bool hasPendingThreads() const;
+
+  /** Remove and return the thread which has waited longest for a core. */
+  LinuxThreadContext takePendingThread();
+
+  /** exit syscall: terminate thread `tid`. Returns the thread's
+   * clear_child_tid address, at which the caller must write zero, or 0 if
+   * none was set. A thread waiting on the address, such as one joining `tid`,
+   * is woken. */
+  uint64_t exitThread(int64_t tid);
+
+  /** exit_group syscall: terminate all threads of the process. */
+  void exitGroup();
+
+  /** Check whether the process has terminated through exit_group. */
+  bool hasExited() const;
+
+  /** Retrieve the mutex guarding the kernel's state. Exception handlers hold it
+   * while invoking syscalls, so that cores ticked on separate host threads
+   * never modify the kernel concurrently. */
+  std::mutex& getMutex() { return mutex_; }
+
+  /** futex syscall: wait on or wake threads waiting on the futex word at
+   * `uaddr`. A wait returns -EAGAIN if the word no longer holds `val`.
+   * Otherwise, the calling thread is placed on the word's wait queue, with
+   * the state returned by `saveCaller`, and must not run again until woken;
+   * a wait with a non-zero `timeout` is not modelled, and instead returns 0
+   * at once as a spurious wake-up. A wake moves up to `val` waiting threads
+   * onto the queue of threads awaiting a core, returning the number woken.
+   * The bitset variants only wait on or wake threads sharing a bit of `val3`.
+   * Returns -ENOSYS for unsupported operations. */
+  int64_t futex(uint64_t uaddr, int op, uint32_t val, uint64_t timeout,
+                uint32_t val3,
+                const std::function<LinuxThreadContext()>& saveCaller);
+
   /** clock_gettime syscall: get the time of specified clock `clkId`, using
    * the system timer `systemTimer` (with nanosecond accuracy). Returns 0 on
    * success, and puts the retrieved time in the `seconds` and `nanoseconds`
@@ -181,8 +258,6 @@ class Linux {
   int64_t getgid() const;
   /** getegid syscall: get the process owner's effective group ID. */
   int64_t getegid() const;
-  /** gettid syscall: get the process owner's thread ID. */
-  int64_t gettid() const;
 
   /** gettimeofday syscall: get the current time, using the system timer
    * `systemTimer` (with nanosecond accuracy). Returns 0 on success, and puts
@@ -217,8 +292,9 @@ class Linux {
   /** set a process's CPU affinity mask. */
   int64_t schedSetAffinity(pid_t pid, size_t cpusetsize, uint64_t mask);
 
-  /** set_tid_address syscall: set clear_child_tid value for calling thread. */
-  int64_t setTidAddress(uint64_t tidptr);
+  /** set_tid_address syscall: set clear_child_tid value for calling thread
+   * `tid`. */
+  int64_t setTidAddress(int64_t tid, uint64_t tidptr);
 
   /** getdents64 syscall: read several linux_dirent structures from directory
    * referred to by open file into a buffer. */
@@ -239,6 +315,15 @@ class Linux {
   /** The maximum size of a filesystem path. */
   static const size_t LINUX_PATH_MAX = 4096;
 
+  /** Flags for the clone syscall, as defined by the Linux kernel in
+   * include/uapi/linux/sched.h */
+  static const uint64_t LINUX_CLONE_VM = 0x00000100;
+  static const uint64_t LINUX_CLONE_SETTLS = 0x00080000;
+  static const uint64_t LINUX_CLONE_PARENT_SETTID = 0x00100000;
+  static const uint64_t LINUX_CLONE_CHILD_CLEARTID = 0x00200000;
+  static const uint64_t LINUX_CLONE_CHILD_SETTID = 0x01000000;
+  static const uint64_t LINUX_CLONE_THREAD = 0x00010000;
+
  private:
   /** Resturn correct Dirfd depending on given pathname abd dirfd given to
    * syscall. */
@@ -248,6 +333,10 @@ class Linux {
    * to point to the SimEng equivalent. */
   std::string getSpecialFile(const std::string filename);
 
+  /** Zero the `length` bytes of process memory at `addr` unmapped by munmap,
+   * returning the host memory behind them. */
+  void releaseMappedMemory(uint64_t addr, size_t length);
+
   /** The state of the user-space processes running above the kernel. */
   std::vector<LinuxProcessState> processStates_;
 
@@ -259,6 +348,37 @@ class Linux {
 
   /** Vector of all currently supported special file paths & files.*/
   std::vector<std::string> supportedSpecialFiles_;
+
+  /** The number of cores threads may be scheduled onto. */
+  const uint16_t coreCount_;
+
+  /** Threads created by clone or woken from a futex which have yet to be
+   * scheduled onto a core. */
+  std::deque<LinuxThreadContext> pendingThreads_;
+
+  /** A thread waiting on a futex word. */
+  struct FutexWaiter {
+    /** The state the thread resumes from once woken. */
+    LinuxThreadContext thread;
+    /** The bitset the thread waits with; a wake must share a bit of it. */
+    uint32_t bitset;
+  };
+
+  /** Wake up to `count` threads waiting on the futex word at `uaddr` with a
+   * bitset sharing a bit of `bitset`, in the order they began waiting.
+   * Returns the number of threads woken. */
+  int64_t futexWake(uint64_t uaddr, uint32_t count, uint32_t bitset);
+
+  /** The threads waiting on each futex word, indexed by address, in the order
+   * they began waiting. */
+  std::unordered_map<uint64_t, std::deque<FutexWaiter>> futexWaiters_;
+
+  /** Whether the process has terminated through exit_group. Set under
+   * `mutex_` by the core making the syscall, but read by others without it. */
+  std::atomic<bool> exited_ = false;
+
+  /** Serialises syscalls made by cores running on different host threads. */
+  std::mutex mutex_;
 };
 
 }  // namespace kernel
@@ -2,6 +2,7 @@
 
 #include <memory>
 
+#include "simeng/Checkpoint.hh"
 #include "simeng/Elf.hh"
 #include "simeng/config/SimInfo.hh"
 
@@ -36,6 +37,16 @@ enum labels {
  * multiple. */
 uint64_t alignToBoundary(uint64_t value, uint64_t boundary);
 
+/** Reserve a zero-initialised process image of `size` bytes. Host memory is
+ * only committed to the pages of the image as they are first written, so the
+ * resident size of a process scales with the memory it touches rather than
+ * its configured heap and stack sizes. */
+std::shared_ptr<char> reserveProcessImage(uint64_t size);
+
+/** Zero the `size` bytes at `offset` into a process image created by
+ * `reserveProcessImage`, returning any host pages they wholly cover. */
+void releaseProcessMemory(char* image, uint64_t offset, uint64_t size);
+
 /** The initial state of a Linux process, constructed from a binary executable.
  *
  * The constructed process follows a typical layout:
@@ -57,6 +68,9 @@ uint64_t alignToBoundary(uint64_t value, uint64_t boundary);
  * |               |
  * |---------------| <- 0x0
  *
+ * Virtual addresses map one-to-one onto offsets into the process image, which
+ * is reserved with `reserveProcessImage` so that the unused space between
+ * regions costs no host memory.
  */
 class LinuxProcess {
  public:
@@ -71,6 +85,11 @@ class LinuxProcess {
   LinuxProcess(span<char> instructions,
                ryml::ConstNodeRef config = config::SimInfo::getConfig());
 
+  /** Construct a Linux process from the state held in `checkpoint`, mapping
+   * its process image copy-on-write. */
+  LinuxProcess(CheckpointReader& checkpoint,
+               ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
   ~LinuxProcess();
 
   /** Get the address of the start of the heap region. */
@@ -103,6 +122,10 @@ class LinuxProcess {
   /** Check whether the process image was created successfully. */
   bool isValid() const;
 
+  /** Write the layout of the process to `checkpoint`. The process image itself
+   * is supplied separately when the checkpoint is saved. */
+  void checkpoint(CheckpointWriter& checkpoint) const;
+
  private:
   /** The size of the stack, in bytes. */
   const uint64_t STACK_SIZE;
@@ -110,8 +133,11 @@ class LinuxProcess {
   /** The space to reserve for the heap, in bytes. */
   const uint64_t HEAP_SIZE;
 
+  /** The number of cores the process' threads may be scheduled onto. */
+  const uint16_t CORE_COUNT;
+
   /** Create and populate the initial process stack. */
-  void createStack(char** processImage);
+  void createStack(char* processImage);
 
   /** The entry point of the process. */
   uint64_t entryPoint_ = 0;
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "simeng/config/SimInfo.hh"
+
+namespace simeng {
+
+namespace memory {
+
+/** The policies available for choosing a line to evict from a full set. */
+enum class ReplacementPolicy { LRU, FIFO, Random };
+
+/** A timing model of a single set-associative cache level. Caches only hold
+ * tags; the data itself always resides in the process memory, so the model
+ * determines when an access completes but never what it returns.
+ *
+ * Accesses are timed as they are made rather than ticked through the
+ * hierarchy. A miss reserves an MSHR and looks up the next level at the cycle
+ * it would be sent, installing the line with the cycle its fill returns; later
+ * accesses to the line complete no earlier than that cycle. Dirty evictions
+ * are posted to the next level without delaying the access that caused them.
+ *
+ * Tags are held in a single contiguous array, with the ways of each set
+ * adjacent, so a lookup scans one short run of memory. */
+class Cache {
+ public:
+  /** Construct a cache from its `config` section, backed by `nextLevel`, or by
+   * main memory with an access latency of `memoryLatency` cycles if null. A
+   * `shared` cache may be accessed concurrently by cores ticked on different
+   * host threads. */
+  Cache(const std::string& name, ryml::ConstNodeRef config,
+        std::shared_ptr<Cache> nextLevel, uint16_t memoryLatency,
+        bool shared = false);
+
+  /** Access the line holding `address` at `cycle`, returning the cycle at
+   * which the access completes. */
+  uint64_t access(uint64_t address, bool write, uint64_t cycle);
+
+  /** Prefetch the line holding `address` at `cycle` on behalf of prefetcher
+   * `source`, numbered from 1. Returns false if the prefetch was dropped,
+   * either because the line is already held or in flight, or because no MSHR
+   * is free. */
+  bool prefetch(uint64_t address, uint64_t cycle, uint8_t source);
+
+  /** Bring the line holding `address` into the state an access at `cycle`
+   * would leave it in, as if the line had long since been filled. Used to
+   * warm the cache with the accesses of a workload run functionally, so is
+   * neither timed nor counted in the statistics, and reserves no MSHR. */
+  void warm(uint64_t address, bool write, uint64_t cycle);
+
+  /** Get the line size of this cache in bytes. */
+  uint16_t getLineSize() const;
+
+  /** Get the number of demand accesses which missed. */
+  uint64_t getMisses() const;
+
+  /** Get the number of lines prefetched by `source` which were later used by
+   * a demand access. */
+  uint64_t getUsefulPrefetches(uint8_t source) const;
+
+  /** Add the statistics of this cache, and those of the levels below it, to
+   * `stats`. */
+  void getStats(std::map<std::string, std::string>& stats) const;
+
+ private:
+  /** Find the way of `set` holding `line`, returning -1 on a miss. */
+  int64_t findWay(uint64_t set, uint64_t line) const;
+
+  /** Choose the way of `set` to evict. */
+  uint64_t chooseVictim(uint64_t set);
+
+  /** Free the MSHRs of misses which have completed by `cycle`. */
+  void releaseMshrs(uint64_t cycle);
+
+  /** Install `line` in way `index` at `cycle`, writing back the line it
+   * evicts, and fetch it from the level below at `sendAt`. Returns the cycle
+   * the fill completes. */
+  uint64_t fill(uint64_t index, uint64_t line, uint64_t sendAt,
+                uint64_t cycle);
+
+  /** Post a write of `line` to the level below at `cycle`. */
+  void writeBelow(uint64_t line, uint64_t cycle);
+
+  /** The name of this cache, used to prefix its statistics. */
+  std::string name_;
+
+  /** The number of sets. */
+  uint64_t sets_;
+
+  /** The number of ways in each set. */
+  uint16_t ways_;
+
+  /** The line size in bytes. */
+  uint16_t lineSize_;
+
+  /** The number of bits addressing a byte within a line. */
+  uint8_t lineShift_;
+
+  /** The number of cycles taken to look up this cache. */
+  uint16_t hitLatency_;
+
+  /** The number of misses which may be outstanding at once. */
+  uint16_t mshrCount_;
+
+  /** Whether writes are held in the cache until evicted, rather than written
+   * through to the level below. */
+  bool writeBack_;
+
+  /** Whether a write miss allocates the line. */
+  bool writeAllocate_;
+
+  /** The policy used to choose a line to evict. */
+  ReplacementPolicy policy_;
+
+  /** The level below this cache; null if backed by main memory. */
+  std::shared_ptr<Cache> nextLevel_;
+
+  /** The latency of main memory, if this is the last level. */
+  uint16_t memoryLatency_;
+
+  /** The line address held by each way, indexed by `set * ways_ + way`. An
+   * all-ones value marks an invalid way. */
+  std::vector<uint64_t> tags_;
+
+  /** The cycle each way's line was filled or last used, for the replacement
+   * policy. */
+  std::vector<uint64_t> stamps_;
+
+  /** The cycle each way's fill completes. */
+  std::vector<uint64_t> readyAt_;
+
+  /** Whether each way holds modified data. */
+  std::vector<bool> dirty_;
+
+  /** The prefetcher which brought each way's line in and has yet to see it
+   * used, or 0 if there is none. */
+  std::vector<uint8_t> prefetchSource_;
+
+  /** The number of useful prefetches made by each prefetcher, indexed by
+   * source - 1. */
+  std::vector<uint64_t> usefulPrefetches_;
+
+  /** The cycle each outstanding miss completes, one entry per busy MSHR. */
+  std::vector<uint64_t> mshrs_;
+
+  /** The state of the random replacement policy's generator. */
+  uint64_t randomState_ = 0x9E3779B97F4A7C15;
+
+  /** Whether accesses must be serialised by `mutex_`. */
+  bool shared_;
+
+  /** Serialises accesses to a shared cache. */
+  mutable std::mutex mutex_;
+
+  /** Statistics. */
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t mshrHits_ = 0;
+  uint64_t writebacks_ = 0;
+  uint64_t mshrStalls_ = 0;
+};
+
+}  // namespace memory
+}  // namespace simeng
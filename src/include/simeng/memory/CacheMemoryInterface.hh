@@ -0,0 +1,142 @@
+#pragma once
+
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "simeng/memory/Cache.hh"
+#include "simeng/memory/MemoryInterface.hh"
+#include "simeng/memory/Prefetcher.hh"
+
+namespace simeng {
+
+namespace memory {
+
+/** A request in flight through a cache hierarchy. */
+struct CacheMemoryInterfaceRequest {
+  /** The cycle count this request will be ready at. */
+  uint64_t readyAt;
+
+  /** The order in which the request was made, so that requests ready in the
+   * same cycle complete in order. */
+  uint64_t sequence;
+
+  /** Is this a write request? */
+  bool write;
+
+  /** The memory target to access. */
+  MemoryAccessTarget target;
+
+  /** A unique request identifier for read operations. */
+  uint64_t requestId;
+
+  /** Order requests by the cycle they are ready at, for a min-heap. */
+  bool operator>(const CacheMemoryInterfaceRequest& other) const {
+    return readyAt != other.readyAt ? readyAt > other.readyAt
+                                    : sequence > other.sequence;
+  }
+};
+
+/** A memory interface timing each request by its path through a hierarchy of
+ * caches, beginning at an L1 cache private to this interface. Data is read
+ * from the process memory when a read completes; writes update the process
+ * memory immediately, so later reads never observe stale data regardless of
+ * the order in which requests complete. */
+class CacheMemoryInterface : public MemoryInterface {
+ public:
+  /** Construct an interface to `memory` through `cache`, which `prefetchers`
+   * fill in response to the loads made through it. */
+  CacheMemoryInterface(
+      char* memory, size_t size, std::shared_ptr<Cache> cache,
+      std::vector<std::unique_ptr<Prefetcher>> prefetchers = {});
+
+  /** Queue a read request from the supplied target location, completing once
+   * every line it touches is available.
+   *
+   * The caller can optionally provide an ID that will be attached to completed
+   * read results.
+   */
+  void requestRead(const MemoryAccessTarget& target,
+                   uint64_t requestId = 0) override;
+  /** Write `data` to the target location, queueing the request to occupy the
+   * hierarchy until the lines it touches have been written. */
+  void requestWrite(const MemoryAccessTarget& target,
+                    const RegisterValue& data) override;
+  /** Retrieve all completed requests. */
+  const span<MemoryReadResult> getCompletedReads() const override;
+
+  /** Clear the completed reads. */
+  void clearCompletedReads() override;
+
+  /** Returns true if there are any outstanding memory requests in-flight. */
+  bool hasPendingRequests() const override;
+
+  /** Train each prefetcher on the load at `pc`, prefetching the lines they
+   * propose into the L1 cache. */
+  void observeLoad(uint64_t pc, const MemoryAccessTarget& target) override;
+
+  /** Warm every line `target` touches in the hierarchy, training the
+   * prefetchers on reads and warming the lines they propose in turn. */
+  void warm(uint64_t pc, const MemoryAccessTarget& target,
+            bool write) override;
+
+  /** Retrieve the hit and miss statistics of each level of the hierarchy, and
+   * the accuracy and coverage of each prefetcher. Accuracy is the proportion
+   * of a prefetcher's prefetches later used by a demand access; coverage is
+   * the proportion of the misses the L1 cache would otherwise have taken which
+   * its prefetches removed. */
+  std::map<std::string, std::string> getStats() const override;
+
+  /** Tick the memory model to complete any requests now ready. */
+  void tick() override;
+
+  /** Retrieve the number of ticks before the earliest pending request
+   * completes, or UINT64_MAX if none are pending. */
+  uint64_t getIdleTicks() const override;
+
+  /** Advance the tick counter by `ticks` ticks, in which no request may
+   * complete. */
+  void skipTicks(uint64_t ticks) override;
+
+ private:
+  /** Access every line `target` touches, returning the cycle the last of them
+   * is available. */
+  uint64_t accessLines(const MemoryAccessTarget& target, bool write);
+
+  /** The array representing the memory system to access. */
+  char* memory_;
+
+  /** The size of accessible memory. */
+  size_t size_;
+
+  /** The L1 cache requests are made to. */
+  std::shared_ptr<Cache> cache_;
+
+  /** The prefetchers filling `cache_`. Each is identified to the cache by its
+   * index + 1. */
+  std::vector<std::unique_ptr<Prefetcher>> prefetchers_;
+
+  /** The number of prefetches each prefetcher has issued to the cache. */
+  std::vector<uint64_t> prefetchesIssued_;
+
+  /** The candidate lines proposed by a prefetcher, reused between loads. */
+  std::vector<uint64_t> candidates_;
+
+  /** A vector containing all completed read requests. */
+  std::vector<MemoryReadResult> completedReads_;
+
+  /** The requests in flight, ordered by the cycle they complete. */
+  std::priority_queue<CacheMemoryInterfaceRequest,
+                      std::vector<CacheMemoryInterfaceRequest>,
+                      std::greater<CacheMemoryInterfaceRequest>>
+      pendingRequests_;
+
+  /** The number of requests made. */
+  uint64_t requestCount_ = 0;
+
+  /** The number of times this interface has been ticked. */
+  uint64_t tickCounter_ = 0;
+};
+
+}  // namespace memory
+}  // namespace simeng
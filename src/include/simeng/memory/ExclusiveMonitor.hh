@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "simeng/RegisterValue.hh"
+#include "simeng/memory/MemoryAccessTarget.hh"
+
+namespace simeng {
+
+namespace memory {
+
+/** A global exclusive monitor, shared by every core running a process, which
+ * gives exclusive stores and atomic read-modify-writes their atomicity across
+ * cores.
+ *
+ * Exclusive loads, and the reads of atomics, reserve the memory they read for
+ * their core. A reservation covers the `granuleSize` bytes holding its address,
+ * and is cleared by any store to that granule recorded by another core. The
+ * write of an exclusive store or atomic is performed here, as a single
+ * compare-and-write on the process memory, and only succeeds if its core
+ * still holds a reservation of the same memory and that memory still holds
+ * the value read. A write from another core which lands before it has been
+ * recorded therefore still causes the exclusive store to fail. */
+class ExclusiveMonitor {
+ public:
+  /** Construct a monitor for `coreCount` cores sharing the `memorySize` bytes
+   * of process memory at `memory`. */
+  ExclusiveMonitor(char* memory, uint64_t memorySize, uint16_t coreCount);
+
+  /** Reserve `target` for `core`, having read `value` from it, replacing any
+   * reservation the core already held. */
+  void reserve(uint16_t core, const MemoryAccessTarget& target,
+               const RegisterValue& value);
+
+  /** Check whether `core` holds a reservation of `target`. */
+  bool holdsReservation(uint16_t core, const MemoryAccessTarget& target) const;
+
+  /** Write `data` to `target` for `core`, if the core still holds a
+   * reservation of `target` and the memory still holds the value reserved.
+   * The core's reservation is cleared either way, and on success so are those
+   * of other cores on the same granule. Returns whether `data` was written. */
+  bool store(uint16_t core, const MemoryAccessTarget& target,
+             const RegisterValue& data);
+
+  /** Record a store by `core` to `target`, clearing the reservations other
+   * cores hold on the granules it writes to. */
+  void recordStore(uint16_t core, const MemoryAccessTarget& target);
+
+  /** Clear any reservation held by `core`. */
+  void clearReservation(uint16_t core);
+
+  /** The size in bytes of the aligned granule covered by a reservation. */
+  static constexpr uint64_t granuleSize = 64;
+
+ private:
+  /** A reservation held by a core. */
+  struct Reservation {
+    /** Whether the reservation is held. */
+    bool valid = false;
+    /** The memory reserved. */
+    MemoryAccessTarget target;
+    /** The value read from the reserved memory. */
+    RegisterValue value;
+  };
+
+  /** Write `data` to `target` if it still holds `expected`, as a single
+   * atomic compare-and-swap where the access allows. Returns whether `data`
+   * was written. Must be called with `mutex_` held. */
+  bool compareAndWrite(const MemoryAccessTarget& target,
+                       const RegisterValue& expected,
+                       const RegisterValue& data);
+
+  /** Clear the reservations of cores other than `core` whose granule overlaps
+   * `target`. Must be called with `mutex_` held. */
+  void clearOverlapping(uint16_t core, const MemoryAccessTarget& target);
+
+  /** Clear `reservation`. Must be called with `mutex_` held. */
+  void clear(Reservation& reservation);
+
+  /** The process memory. */
+  char* memory_;
+
+  /** The size of the process memory in bytes. */
+  uint64_t memorySize_;
+
+  /** The reservation of each core, indexed by core ID. */
+  std::vector<Reservation> reservations_;
+
+  /** The number of reservations held, letting stores skip the lock while
+   * none are. */
+  std::atomic<uint32_t> activeReservations_ = 0;
+
+  /** Guards the reservations, and serialises exclusive writes. */
+  mutable std::mutex mutex_;
+};
+
+}  // namespace memory
+}  // namespace simeng
@@ -65,6 +65,14 @@ class FixedLatencyMemoryInterface : public MemoryInterface {
   /** Tick the memory model to process the request queue. */
   void tick() override;
 
+  /** Retrieve the number of ticks before the earliest pending request
+   * completes, or UINT64_MAX if none are pending. */
+  uint64_t getIdleTicks() const override;
+
+  /** Advance the tick counter by `ticks` ticks, in which no request may
+   * complete. */
+  void skipTicks(uint64_t ticks) override;
+
  private:
   /** The array representing the memory system to access. */
   char* memory_;
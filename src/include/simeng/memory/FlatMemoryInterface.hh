@@ -32,9 +32,19 @@ class FlatMemoryInterface : public MemoryInterface {
   /** Returns true if there are any outstanding memory requests in-flight. */
   bool hasPendingRequests() const override;
 
+  /** Retrieve the flat memory array, which may be accessed directly as all
+   * requests complete with zero latency. */
+  span<char> getDirectMemory() const override;
+
   /** Tick: do nothing */
   void tick() override;
 
+  /** Requests complete as they are made, so this interface is always idle. */
+  uint64_t getIdleTicks() const override;
+
+  /** Skip ticks: do nothing */
+  void skipTicks(uint64_t ticks) override;
+
  private:
   /** The array representing the flat memory system to access. */
   char* memory_;
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <map>
+#include <string>
+
 #include "simeng/RegisterValue.hh"
 #include "simeng/memory/MemoryReadResult.hh"
 #include "simeng/span.hh"
@@ -12,6 +16,7 @@ namespace memory {
 enum class MemInterfaceType {
   Flat,     // A zero access latency interface
   Fixed,    // A fixed, non-zero, access latency interface
+  Cache,    // An interface timed by a modelled cache hierarchy
   External  // An interface generated outside of the standard SimEng
             // instantiation
 };
@@ -29,7 +34,8 @@ class MemoryInterface {
    */
   virtual void requestRead(const MemoryAccessTarget& target,
                            uint64_t requestId = 0) = 0;
-  /** Request a write of `data` to the target location. */
+  /** Request a write of `data` to the target location. An empty `data`
+   * requests only the timing of a write already made to the memory. */
   virtual void requestWrite(const MemoryAccessTarget& target,
                             const RegisterValue& data) = 0;
   /** Retrieve all completed read requests. */
@@ -41,12 +47,45 @@ class MemoryInterface {
   /** Returns true if there are any outstanding memory requests in-flight. */
   virtual bool hasPendingRequests() const = 0;
 
+  /** Retrieve the memory backing this interface for direct, synchronous
+   * access. Only interfaces which complete every request with zero latency
+   * may expose their backing memory; all others return an empty span, and
+   * must be accessed through `requestRead` and `requestWrite`. */
+  virtual span<char> getDirectMemory() const { return {}; }
+
+  /** Notify the memory system that the load at `pc` has requested `target`,
+   * allowing any prefetchers behind this interface to train on the stream of
+   * demand loads. */
+  virtual void observeLoad(uint64_t pc, const MemoryAccessTarget& target) {}
+
+  /** Bring the memory system into the state it would be left in had the
+   * instruction at `pc` read or written `target` long ago, without timing a
+   * request or counting it in the statistics. Used to keep the memory system
+   * of a detailed core warm while its workload runs on a functional one. */
+  virtual void warm(uint64_t pc, const MemoryAccessTarget& target,
+                    bool write) {}
+
+  /** Retrieve a map of statistics describing the memory system behind this
+   * interface. */
+  virtual std::map<std::string, std::string> getStats() const { return {}; }
+
   /** Tick the memory interface to allow it to process internal tasks.
    *
    * TODO: Move ticking out of the memory interface and into a central "memory
    * system" covering a set of related interfaces.
    */
   virtual void tick() = 0;
+
+  /** Retrieve the number of upcoming ticks in which this interface is certain
+   * to complete no request, assuming no new requests are made. Returns 0 if
+   * this is unknown, and UINT64_MAX if nothing is in flight. */
+  virtual uint64_t getIdleTicks() const { return 0; }
+
+  /** Advance the interface by `ticks` ticks, which must not exceed
+   * `getIdleTicks()`, as though `tick` had been called for each. */
+  virtual void skipTicks(uint64_t ticks) {
+    for (uint64_t i = 0; i < ticks; i++) tick();
+  }
 };
 
 }  // namespace memory
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "simeng/config/SimInfo.hh"
+#include "simeng/memory/Prefetcher.hh"
+
+namespace simeng {
+
+namespace memory {
+
+/** A next-line prefetcher. Each time the demand stream moves onto a new line,
+ * the following `Next-Line-Degree` lines are prefetched. */
+class NextLinePrefetcher : public Prefetcher {
+ public:
+  /** Construct a next-line prefetcher for a cache of `lineSize` byte lines. */
+  NextLinePrefetcher(uint16_t lineSize,
+                     ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
+  /** Prefetch the lines following `address` if it lies on a different line to
+   * the previous load. */
+  void observe(uint64_t pc, uint64_t address,
+               std::vector<uint64_t>& prefetches) override;
+
+  std::string getName() const override { return "nextline"; }
+
+ private:
+  /** The line size in bytes. */
+  uint16_t lineSize_;
+
+  /** The number of lines prefetched ahead of each new line. */
+  uint16_t degree_;
+
+  /** The line most recently loaded from. */
+  uint64_t lastLine_ = ~0ull;
+};
+
+}  // namespace memory
+}  // namespace simeng
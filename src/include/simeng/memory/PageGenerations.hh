@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "simeng/memory/MemoryAccessTarget.hh"
+
+namespace simeng {
+
+namespace memory {
+
+/** A record of writes to the pages of process memory, shared by every core
+ * running a process, through which a core caching decoded code learns of
+ * writes to it made by other cores and by syscalls.
+ *
+ * Each page holds a generation, advanced by every recorded write to the page
+ * once a core has begun watching it. A core caching code notes the generation
+ * of its pages before reading them, and discards the code should the
+ * generation have moved on by the time it is next used. Writes are recorded
+ * after being made, so a cached copy is never mistaken for current; as with
+ * other accesses to shared memory, a write from a core on another host thread
+ * may go unnoticed until the cores next synchronise. */
+class PageGenerations {
+ public:
+  /** Construct a record of writes to `memorySize` bytes of process memory. */
+  PageGenerations(uint64_t memorySize);
+
+  /** Begin recording writes to `page`, if not already, and retrieve its
+   * current generation. */
+  uint32_t watch(uint64_t page);
+
+  /** Retrieve the current generation of `page`. */
+  uint32_t get(uint64_t page) const;
+
+  /** Record a write to `target`, advancing the generation of each watched
+   * page it covers. Pages beyond the end of memory are ignored. */
+  void recordWrite(const MemoryAccessTarget& target);
+
+  /** The size in bytes of a page. */
+  static constexpr uint64_t pageSize = 4096;
+
+ private:
+  /** The number of pages of process memory. */
+  uint64_t pageCount_;
+
+  /** Whether writes to each page are being recorded, indexed by page. */
+  std::unique_ptr<std::atomic<bool>[]> watched_;
+
+  /** The generation of each page, indexed by page. */
+  std::unique_ptr<std::atomic<uint32_t>[]> generations_;
+};
+
+}  // namespace memory
+}  // namespace simeng
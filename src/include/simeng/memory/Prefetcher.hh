@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace simeng {
+
+namespace memory {
+
+/** An abstract data prefetcher. Prefetchers train on the stream of demand
+ * loads made to a cache, proposing lines to bring into it ahead of their use.
+ * A prefetcher only proposes candidates; the cache filters out lines it
+ * already holds and drops prefetches when it has no free MSHR. */
+class Prefetcher {
+ public:
+  virtual ~Prefetcher(){};
+
+  /** Train on a demand load of `address` by the instruction at `pc`,
+   * appending the address of each line to prefetch to `prefetches`. */
+  virtual void observe(uint64_t pc, uint64_t address,
+                       std::vector<uint64_t>& prefetches) = 0;
+
+  /** Get the name prefixing this prefetcher's statistics. */
+  virtual std::string getName() const = 0;
+};
+
+}  // namespace memory
+}  // namespace simeng
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "simeng/RegisterValue.hh"
+
+namespace simeng {
+
+namespace memory {
+
+/** Move one `T` from `src` to `dest` with relaxed atomic accesses. */
+template <class T>
+inline void copyAtomic_(char* dest, const char* src) {
+  __atomic_store_n(reinterpret_cast<T*>(dest),
+                   __atomic_load_n(reinterpret_cast<const T*>(src),
+                                   __ATOMIC_RELAXED),
+                   __ATOMIC_RELAXED);
+}
+
+/** Copy `size` bytes from `src` to `dest`, where either may be process memory
+ * shared with cores ticked on other host threads. Every byte is moved with a
+ * relaxed atomic access, so concurrent accesses are not data races. Accesses
+ * of up to 8 bytes which are naturally aligned are moved as a single atomic,
+ * giving the single-copy atomicity the simulated ISAs guarantee. On common
+ * hosts these compile to the same plain loads and stores as `memcpy`. */
+inline void copyShared(char* dest, const char* src, size_t size) {
+  // Both sides are aligned to `n` only if their combined low bits are
+  uintptr_t alignment =
+      reinterpret_cast<uintptr_t>(dest) | reinterpret_cast<uintptr_t>(src);
+  switch (size) {
+    case 2:
+      if (alignment % 2 == 0) return copyAtomic_<uint16_t>(dest, src);
+      break;
+    case 4:
+      if (alignment % 4 == 0) return copyAtomic_<uint32_t>(dest, src);
+      break;
+    case 8:
+      if (alignment % 8 == 0) return copyAtomic_<uint64_t>(dest, src);
+      break;
+  }
+
+  size_t i = 0;
+  if (alignment % 8 == 0) {
+    for (; i + 8 <= size; i += 8) copyAtomic_<uint64_t>(dest + i, src + i);
+  }
+  for (; i < size; i++) copyAtomic_<uint8_t>(dest + i, src + i);
+}
+
+/** Read `size` bytes of shared process memory at `src` into a new
+ * RegisterValue, as `copyShared`. */
+inline RegisterValue readShared(const char* src, uint16_t size) {
+  // A RegisterValue's data is immutable once constructed, so the bytes are
+  // staged in a buffer first; one large enough for any SVE or SME access is
+  // kept on the stack
+  constexpr uint16_t stackBytes = 256;
+  if (size <= stackBytes) {
+    alignas(8) char buffer[stackBytes];
+    copyShared(buffer, src, size);
+    return RegisterValue(static_cast<const char*>(buffer), size);
+  }
+  std::unique_ptr<uint64_t[]> buffer(new uint64_t[(size + 7) / 8]);
+  char* data = reinterpret_cast<char*>(buffer.get());
+  copyShared(data, src, size);
+  return RegisterValue(data, size);
+}
+
+/** Write the first `size` bytes of `data` to shared process memory at `dest`,
+ * as `copyShared`. */
+inline void writeShared(char* dest, const RegisterValue& data, size_t size) {
+  copyShared(dest, data.getAsVector<char>(), size);
+}
+
+}  // namespace memory
+}  // namespace simeng
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "simeng/config/SimInfo.hh"
+#include "simeng/memory/Prefetcher.hh"
+
+namespace simeng {
+
+namespace memory {
+
+/** A stream tracked by a stream prefetcher. */
+struct StreamTableEntry {
+  /** Whether this entry is tracking a stream. */
+  bool valid = false;
+
+  /** The line most recently loaded from by the stream. */
+  uint64_t lastLine = 0;
+
+  /** The direction the stream moves through memory: 1 or -1 once trained,
+   * and 0 while its direction is unknown. */
+  int64_t direction = 0;
+
+  /** The number of consecutive loads which moved the stream in `direction`,
+   * saturating at 2. The stream is trained once this reaches 2. */
+  uint8_t confidence = 0;
+
+  /** The furthest line ahead of the stream already prefetched. */
+  uint64_t head = 0;
+
+  /** When this entry was last used, for replacement. */
+  uint64_t lastUsed = 0;
+};
+
+/** A stream prefetcher detecting sequences of loads moving through nearby
+ * lines in one direction, regardless of the instructions making them. A load
+ * within `Stream-Distance` lines of a tracked stream advances it; otherwise a
+ * new stream is allocated in place of the least recently used. Once a stream
+ * has moved twice in the same direction, the prefetcher runs ahead of it,
+ * keeping up to `Stream-Distance` lines in flight and prefetching at most
+ * `Stream-Degree` of them per load. */
+class StreamPrefetcher : public Prefetcher {
+ public:
+  /** Construct a stream prefetcher for a cache of `lineSize` byte lines. */
+  StreamPrefetcher(uint16_t lineSize,
+                   ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
+  /** Advance or allocate the stream `address` belongs to, prefetching ahead
+   * of it if trained. */
+  void observe(uint64_t pc, uint64_t address,
+               std::vector<uint64_t>& prefetches) override;
+
+  std::string getName() const override { return "stream"; }
+
+ private:
+  /** The line size in bytes. */
+  uint16_t lineSize_;
+
+  /** How far ahead of a stream, in lines, it is prefetched. */
+  uint16_t distance_;
+
+  /** The maximum number of lines prefetched per load. */
+  uint16_t degree_;
+
+  /** The streams being tracked. */
+  std::vector<StreamTableEntry> streams_;
+
+  /** The number of loads observed, used to timestamp stream accesses. */
+  uint64_t loads_ = 0;
+};
+
+}  // namespace memory
+}  // namespace simeng
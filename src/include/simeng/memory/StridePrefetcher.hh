@@ -0,0 +1,56 @@
+#pragma once
+
+#include "simeng/config/SimInfo.hh"
+#include "simeng/memory/Prefetcher.hh"
+
+namespace simeng {
+
+namespace memory {
+
+/** An entry of a stride prefetcher's reference prediction table. */
+struct StrideTableEntry {
+  /** The address of the load instruction owning this entry. */
+  uint64_t pc = ~0ull;
+
+  /** The address the load last accessed. */
+  uint64_t lastAddress = 0;
+
+  /** The distance between the load's last two addresses. */
+  int64_t stride = 0;
+
+  /** A 2-bit saturating counter of how often the stride has repeated; the
+   * load's stride is only prefetched along while it is non-zero. */
+  uint8_t confidence = 0;
+};
+
+/** A stride prefetcher using a PC-indexed reference prediction table (RPT).
+ * Each load instruction is tracked by a direct-mapped table entry recording
+ * the last address it accessed and the stride between its accesses. Once a
+ * load has repeated its stride, the next `Stride-Degree` strides ahead of it
+ * are prefetched. */
+class StridePrefetcher : public Prefetcher {
+ public:
+  /** Construct a stride prefetcher for a cache of `lineSize` byte lines. */
+  StridePrefetcher(uint16_t lineSize,
+                   ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
+  /** Update the table entry of the load at `pc`, prefetching along its stride
+   * if it is predictable. */
+  void observe(uint64_t pc, uint64_t address,
+               std::vector<uint64_t>& prefetches) override;
+
+  std::string getName() const override { return "stride"; }
+
+ private:
+  /** The line size in bytes. */
+  uint16_t lineSize_;
+
+  /** The number of strides prefetched ahead of a predictable load. */
+  uint16_t degree_;
+
+  /** The reference prediction table. */
+  std::vector<StrideTableEntry> table_;
+};
+
+}  // namespace memory
+}  // namespace simeng
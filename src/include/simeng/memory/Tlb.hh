@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace simeng {
+
+namespace memory {
+
+/** A timing model of a single set-associative translation lookaside buffer
+ * level. SimEng maps virtual addresses directly onto the process image, so a
+ * TLB never changes an address; it only determines when the translation of
+ * one becomes available.
+ *
+ * As with `Cache`, lookups are timed as they are made. A miss looks up the
+ * next level, or walks the page table if there is none, installing the entry
+ * with the cycle the translation returns. Lookups of a page whose translation
+ * is still outstanding complete with it, and are counted as neither hits nor
+ * misses. Entries are replaced least recently used. */
+class Tlb {
+ public:
+  /** Construct a TLB of `entries` entries in sets of `associativity` ways,
+   * translating pages of `pageSize` bytes. Misses look up `nextLevel`, or walk
+   * the page table for `walkLatency` cycles if it is null. */
+  Tlb(const std::string& name, uint32_t entries, uint16_t associativity,
+      uint16_t hitLatency, uint64_t pageSize, std::shared_ptr<Tlb> nextLevel,
+      uint16_t walkLatency);
+
+  /** Translate `address` at `cycle`, returning the cycle at which the
+   * translation is available. */
+  uint64_t translate(uint64_t address, uint64_t cycle);
+
+  /** Bring the entry translating `address` into the state a lookup at `cycle`
+   * would leave it in, as if its translation had long since returned. Used to
+   * warm the TLB with the accesses of a workload run functionally, so is
+   * neither timed nor counted in the statistics. */
+  void warm(uint64_t address, uint64_t cycle);
+
+  /** Get the page size in bytes. */
+  uint64_t getPageSize() const;
+
+  /** Add the statistics of this TLB, and those of the levels below it, to
+   * `stats`. */
+  void getStats(std::map<std::string, std::string>& stats) const;
+
+ private:
+  /** Choose the entry to replace in the set starting at index `base`; an
+   * invalid way, or else the least recently used. Returns its index. */
+  uint64_t chooseVictim(uint64_t base) const;
+
+  /** The name of this TLB, used to prefix its statistics. */
+  std::string name_;
+
+  /** The number of sets. */
+  uint32_t sets_;
+
+  /** The number of ways in each set. */
+  uint16_t ways_;
+
+  /** The number of cycles taken to look up this TLB. */
+  uint16_t hitLatency_;
+
+  /** The number of bits addressing a byte within a page. */
+  uint8_t pageShift_;
+
+  /** The level below this TLB; null if misses walk the page table. */
+  std::shared_ptr<Tlb> nextLevel_;
+
+  /** The number of cycles taken to walk the page table. */
+  uint16_t walkLatency_;
+
+  /** The page number held by each way, indexed by `set * ways_ + way`. An
+   * all-ones value marks an invalid way. */
+  std::vector<uint64_t> pages_;
+
+  /** The cycle each way was filled or last used, for LRU replacement. */
+  std::vector<uint64_t> stamps_;
+
+  /** The cycle each way's translation becomes available. */
+  std::vector<uint64_t> readyAt_;
+
+  /** Statistics. */
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+};
+
+}  // namespace memory
+}  // namespace simeng
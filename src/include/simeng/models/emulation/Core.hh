@@ -1,10 +1,16 @@
 #pragma once
 
+#include <functional>
 #include <map>
+#include <memory>
 #include <queue>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "simeng/ArchitecturalRegisterFileSet.hh"
+#include "simeng/BBVProfiler.hh"
 #include "simeng/Core.hh"
 #include "simeng/arch/Architecture.hh"
 #include "simeng/span.hh"
@@ -13,6 +19,48 @@ namespace simeng {
 namespace models {
 namespace emulation {
 
+/** A pre-decoded instruction held within a translated basic block. */
+struct TranslatedInstruction {
+  /** The micro-ops the instruction was decoded into. These are reset and
+   * executed again each time the block is run. */
+  MacroOp microOps;
+
+  /** The number of bytes the instruction occupies in memory. */
+  uint8_t size;
+};
+
+/** A translated basic block; a sequence of pre-decoded instructions starting
+ * at a given address and ending with a branch, an instruction which raised an
+ * exception when executed, or the start of another translated block. An
+ * instruction which raised an exception when decoded is never translated. */
+struct BasicBlock {
+  /** The pre-decoded instructions of the block, in program order. */
+  std::vector<TranslatedInstruction> instructions;
+
+  /** The address of the first byte following the block. */
+  uint64_t endAddress = 0;
+
+  /** The block most recently executed after this one, cached to avoid a
+   * translation cache lookup when control flow repeats. */
+  BasicBlock* successor = nullptr;
+
+  /** The start address of `successor`. */
+  uint64_t successorAddress = 0;
+
+  /** The blocks whose `successor` is this block, whose links are cleared
+   * should this block be discarded. */
+  std::vector<BasicBlock*> predecessors;
+
+  /** Each page the block's instructions were read from, paired with its
+   * generation before they were read. The block is stale once any of these
+   * pages has moved on to a later generation. */
+  std::vector<std::pair<uint64_t, uint32_t>> pageGenerations;
+};
+
+/** The kinds of memory access reported to an emulation core's access
+ * observer. */
+enum class AccessType { Fetch, Load, Store };
+
 /** An emulation-style core model. Executes each instruction in turn. */
 class Core : public simeng::Core {
  public:
@@ -21,14 +69,38 @@ class Core : public simeng::Core {
    * use. */
   Core(memory::MemoryInterface& instructionMemory,
        memory::MemoryInterface& dataMemory, uint64_t entryPoint,
-       uint64_t programByteLength, const arch::Architecture& isa);
+       uint64_t programByteLength, const arch::Architecture& isa,
+       ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
+  /** Record the basic block in progress, if profiling. */
+  ~Core();
 
-  /** Tick the core. */
+  /** Tick the core, processing at most one micro-op. */
   void tick() override;
 
+  /** Tick the core repeatedly until it reaches the end of the active basic
+   * block, or must wait for memory or an exception. Returns the number of
+   * ticks taken. Unlike `tick()`, this leaves the core ahead of anything
+   * ticked alongside it, so is only for drivers which tick nothing else
+   * meanwhile. */
+  uint64_t tickBlock();
+
   /** Check whether the program has halted. */
   bool hasHalted() const override;
 
+  /** Retrieve the number of upcoming ticks in which the core will only count
+   * the cycle: unbounded while halted, or while an exception or a load waits
+   * for memory, and 0 otherwise. */
+  uint64_t getIdleTicks() const override;
+
+  /** Advance the core by `ticks` idle ticks. */
+  void skipTicks(uint64_t ticks) override;
+
+  /** Begin executing software thread `tid` from address `pc`, after applying
+   * the register values held in `registers`. */
+  void schedule(int64_t tid, uint64_t pc,
+                const arch::ProcessStateChange& registers) override;
+
   /** Retrieve the architectural register file set. */
   const ArchitecturalRegisterFileSet& getArchitecturalRegisterFileSet()
       const override;
@@ -39,19 +111,94 @@ class Core : public simeng::Core {
   /** Retrieve a map of statistics to report. */
   std::map<std::string, std::string> getStats() const override;
 
+  /** Check whether the core is between instructions, with no partially
+   * executed instruction, exception or memory access outstanding. Only then
+   * is its state fully described by its registers and program counter. */
+  bool isBetweenInstructions() const;
+
+  /** Retrieve the address of the next instruction to execute. */
+  uint64_t getProgramCounter() const;
+
+  /** Report every instruction fetched, and every address loaded from or
+   * stored to, to `observer` along with the address of the instruction
+   * making the access. */
+  void setAccessObserver(
+      std::function<void(AccessType type, uint64_t pc,
+                         const memory::MemoryAccessTarget& target)>
+          observer);
+
  private:
+  /** Tick the core, processing at most one micro-op. Returns true if the
+   * next tick would continue the active basic block. */
+  bool advance();
+
+  /** Fetch, issue and execute the next micro-op. Returns true if the next
+   * micro-op continues the active basic block. */
+  bool step();
+
+  /** Supply the next micro-ops, either from the active translated block or
+   * from instruction memory. Returns false if instruction memory has yet to
+   * supply the bytes required. */
+  bool fetch();
+
+  /** Check whether the next micro-op continues the active translated block,
+   * and could be processed without waiting. */
+  bool canContinue() const;
+
+  /** Request the instruction at the current PC from instruction memory,
+   * unless it can be supplied by the translation cache. */
+  void requestFetch();
+
+  /** Check whether the code `block` was translated from has been written to
+   * since, by this core or any other, discarding the block if so. */
+  bool isStale(const BasicBlock& block);
+
+  /** Add a freshly decoded instruction to the basic block currently being
+   * translated, starting a new block if none is in progress. */
+  void translate(uint64_t address, uint8_t size);
+
+  /** Complete translation of the in-progress basic block and insert it into
+   * the translation cache. */
+  void finaliseTranslation();
+
+  /** Record `successor`, starting at `address`, as the block which followed
+   * `block` most recently. */
+  void linkSuccessor(BasicBlock& block, BasicBlock* successor,
+                     uint64_t address);
+
+  /** Discard the translated block starting at `address`, if any, unlinking it
+   * from the blocks which precede and succeed it. */
+  void removeBlock(uint64_t address);
+
+  /** Discard any translated blocks which overlap a page written to by the
+   * memory access `target`. */
+  void invalidateTranslations(const memory::MemoryAccessTarget& target);
+
+  /** Discard any translated blocks which overlap the pages `firstPage` to
+   * `lastPage` inclusive. */
+  void invalidatePages(uint64_t firstPage, uint64_t lastPage);
+
   /** Execute an instruction. */
-  void execute(std::shared_ptr<Instruction>& uop);
+  void execute(IntrusivePtr<Instruction>& uop);
 
   /** Handle an encountered exception. */
-  void handleException(const std::shared_ptr<Instruction>& instruction);
+  void handleException(const IntrusivePtr<Instruction>& instruction);
 
   /** Process an active exception handler. */
   void processExceptionHandler();
 
+  /** Record the basic block ended by a branch with the BBV profiler, and start
+   * the next at the current PC. */
+  void endBasicBlock();
+
   /** A memory interface to access instructions. */
   memory::MemoryInterface& instructionMemory_;
 
+  /** The data memory backing `dataMemory_`, if it permits direct access.
+   * When non-empty, loads and stores bypass the request interface and complete
+   * within the tick they are issued in. */
+  span<char> directMemory_;
+
   /** An architectural register file set, serving as a simple wrapper around the
    * register file set. */
   ArchitecturalRegisterFileSet architecturalRegisterFileSet_;
@@ -60,7 +207,12 @@ class Core : public simeng::Core {
   MacroOp macroOp_;
 
   /** An internal buffer for storing one or more uops. */
-  std::queue<std::shared_ptr<Instruction>> microOps_;
+  std::queue<IntrusivePtr<Instruction>> microOps_;
+
+  /** An unexecuted copy of the exclusive store or atomic being processed,
+   * executed in its place should its write through the exclusive monitor
+   * fail. */
+  IntrusivePtr<Instruction> exclusiveRetry_;
 
   /** The previously generated addresses. */
   std::vector<simeng::memory::MemoryAccessTarget> previousAddresses_;
@@ -79,6 +231,53 @@ class Core : public simeng::Core {
 
   /** The number of branches executed. */
   uint64_t branchesExecuted_ = 0;
+
+  /** The translation cache, mapping a start address to a translated basic
+   * block. */
+  std::unordered_map<uint64_t, BasicBlock> translationCache_;
+
+  /** A mapping from each page containing translated code to the start
+   * addresses of the blocks overlapping it. Used to invalidate blocks upon a
+   * write to a code page. */
+  std::unordered_map<uint64_t, std::vector<uint64_t>> codePages_;
+
+  /** The translated block currently supplying instructions, if any. */
+  BasicBlock* activeBlock_ = nullptr;
+
+  /** The index of the next instruction to supply from `activeBlock_`. */
+  size_t blockIndex_ = 0;
+
+  /** The basic block currently being translated from fetched instructions. */
+  BasicBlock pendingBlock_;
+
+  /** The start address of `pendingBlock_`. */
+  uint64_t pendingBlockAddress_ = 0;
+
+  /** Whether a basic block is currently being translated. */
+  bool translating_ = false;
+
+  /** The pages covered by the outstanding instruction memory read, paired
+   * with their generations before it was requested. */
+  std::vector<std::pair<uint64_t, uint32_t>> fetchPages_;
+
+  /** The number of instructions supplied by the translation cache. */
+  uint64_t translationHits_ = 0;
+
+  /** The number of basic blocks translated. */
+  uint64_t blocksTranslated_ = 0;
+
+  /** The function notified of each memory access; empty if none. */
+  std::function<void(AccessType, uint64_t, const memory::MemoryAccessTarget&)>
+      accessObserver_;
+
+  /** The basic block vector profiler, if enabled. */
+  std::unique_ptr<BBVProfiler> bbvProfiler_;
+
+  /** The start address of the basic block being executed. */
+  uint64_t basicBlockAddress_ = 0;
+
+  /** The number of instructions executed before the current basic block. */
+  uint64_t basicBlockStart_ = 0;
 };
 
 }  // namespace emulation
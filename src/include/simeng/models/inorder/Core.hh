@@ -23,7 +23,8 @@ class Core : public simeng::Core {
   Core(memory::MemoryInterface& instructionMemory,
        memory::MemoryInterface& dataMemory, uint64_t processMemorySize,
        uint64_t entryPoint, const arch::Architecture& isa,
-       BranchPredictor& branchPredictor);
+       BranchPredictor& branchPredictor,
+       ryml::ConstNodeRef config = config::SimInfo::getConfig());
 
   /** Tick the core. Ticks each of the pipeline stages sequentially, then ticks
    * the buffers between them. Checks for and executes pipeline flushes at the
@@ -33,6 +34,19 @@ class Core : public simeng::Core {
   /** Check whether the program has halted. */
   bool hasHalted() const override;
 
+  /** Retrieve the number of upcoming ticks in which the core will only count
+   * the cycle: unbounded while halted or while an exception waits for memory,
+   * and 0 otherwise. */
+  uint64_t getIdleTicks() const override;
+
+  /** Advance the core by `ticks` idle ticks. */
+  void skipTicks(uint64_t ticks) override;
+
+  /** Begin executing software thread `tid` from address `pc`, after applying
+   * the register values held in `registers`. */
+  void schedule(int64_t tid, uint64_t pc,
+                const arch::ProcessStateChange& registers) override;
+
   /** Retrieve the architectural register file set. */
   const ArchitecturalRegisterFileSet& getArchitecturalRegisterFileSet()
       const override;
@@ -45,7 +59,7 @@ class Core : public simeng::Core {
 
  private:
   /** Raise an exception to the core, providing the generating instruction. */
-  void raiseException(const std::shared_ptr<Instruction>& instruction);
+  void raiseException(const IntrusivePtr<Instruction>& instruction);
 
   /** Handle an exception raised during the cycle. */
   void handleException();
@@ -54,13 +68,13 @@ class Core : public simeng::Core {
   void processExceptionHandler();
 
   /** Handle requesting/execution of a load instruction. */
-  void handleLoad(const std::shared_ptr<Instruction>& instruction);
+  void handleLoad(const IntrusivePtr<Instruction>& instruction);
 
   /** Load and supply memory data requested by an instruction. */
-  void loadData(const std::shared_ptr<Instruction>& instruction);
+  void loadData(const IntrusivePtr<Instruction>& instruction);
 
   /** Store data supplied by an instruction to memory. */
-  void storeData(const std::shared_ptr<Instruction>& instruction);
+  void storeData(const IntrusivePtr<Instruction>& instruction);
 
   /** Forward operands to the most recently decoded instruction. */
   void forwardOperands(const span<Register>& destinations,
@@ -80,10 +94,10 @@ class Core : public simeng::Core {
   pipeline::PipelineBuffer<MacroOp> fetchToDecodeBuffer_;
 
   /** The buffer between decode and execute. */
-  pipeline::PipelineBuffer<std::shared_ptr<Instruction>> decodeToExecuteBuffer_;
+  pipeline::PipelineBuffer<IntrusivePtr<Instruction>> decodeToExecuteBuffer_;
 
   /** The buffer between execute and writeback. */
-  std::vector<pipeline::PipelineBuffer<std::shared_ptr<Instruction>>>
+  std::vector<pipeline::PipelineBuffer<IntrusivePtr<Instruction>>>
       completionSlots_;
 
   /** The fetch unit; fetches instructions from memory. */
@@ -106,7 +120,12 @@ class Core : public simeng::Core {
   bool exceptionGenerated_ = false;
 
   /** A pointer to the instruction responsible for generating the exception. */
-  std::shared_ptr<Instruction> exceptionGeneratingInstruction_;
+  IntrusivePtr<Instruction> exceptionGeneratingInstruction_;
+
+  /** An exclusive store or atomic whose write through the exclusive monitor
+   * failed during the cycle, and which must be fetched again; null if none
+   * failed. */
+  IntrusivePtr<Instruction> failedExclusive_;
 };
 
 }  // namespace inorder
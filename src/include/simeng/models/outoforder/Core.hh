@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+
 #include "simeng/ArchitecturalRegisterFileSet.hh"
 #include "simeng/Core.hh"
 #include "simeng/pipeline/DecodeUnit.hh"
@@ -9,6 +11,7 @@
 #include "simeng/pipeline/LoadStoreQueue.hh"
 #include "simeng/pipeline/MappedRegisterFileSet.hh"
 #include "simeng/pipeline/PipelineBuffer.hh"
+#include "simeng/pipeline/PipelineTracer.hh"
 #include "simeng/pipeline/PortAllocator.hh"
 #include "simeng/pipeline/RegisterAliasTable.hh"
 #include "simeng/pipeline/RenameUnit.hh"
@@ -39,6 +42,46 @@ class Core : public simeng::Core {
   /** Check whether the program has halted. */
   bool hasHalted() const override;
 
+  /** Retrieve the number of upcoming ticks in which the core will only count
+   * the cycle. Besides while halted or while an exception waits for memory,
+   * the pipeline is idle once every stage is stalled or empty back to fetch
+   * and the only instructions in flight are waiting on memory reads. */
+  uint64_t getIdleTicks() const override;
+
+  /** Advance the core by `ticks` idle ticks, counting the stalls of each
+   * pipeline stage as `tick` would have. */
+  void skipTicks(uint64_t ticks) override;
+
+  /** Begin executing software thread `tid` from address `pc`, after applying
+   * the register values held in `registers`. */
+  void schedule(int64_t tid, uint64_t pc,
+                const arch::ProcessStateChange& registers) override;
+
+  /** Halt the core at the boundary of its oldest uncommitted instruction,
+   * discarding every in-flight instruction so that the architectural register
+   * file set holds only committed state. Returns the address of the next
+   * instruction to execute, which may be passed to `schedule` to resume. Fails
+   * while an exception is being handled or the oldest instruction is not at a
+   * macro-op boundary, in which case the core should be ticked and the call
+   * retried. */
+  std::optional<uint64_t> suspend();
+
+  /** Advance a halted core by `ticks` ticks in which its thread ran on
+   * another core. Unlike `skipTicks`, the clocks its TLBs are looked up
+   * against move on too, so entries warmed meanwhile age as they would have
+   * had the core run the thread itself. */
+  void skipHaltedTicks(uint64_t ticks);
+
+  /** Warm the instruction TLB and memory of a halted core with the fetch of
+   * `target` by the core its thread runs on. */
+  void warmFetch(const memory::MemoryAccessTarget& target);
+
+  /** Warm the data TLB and memory of a halted core with the access of
+   * `target` by the instruction at `pc`, made by the core its thread runs
+   * on. */
+  void warmData(uint64_t pc, const memory::MemoryAccessTarget& target,
+                bool write);
+
   /** Retrieve the architectural register file set. */
   const ArchitecturalRegisterFileSet& getArchitecturalRegisterFileSet()
       const override;
@@ -51,7 +94,7 @@ class Core : public simeng::Core {
 
  private:
   /** Raise an exception to the core, providing the generating instruction. */
-  void raiseException(const std::shared_ptr<Instruction>& instruction);
+  void raiseException(const IntrusivePtr<Instruction>& instruction);
 
   /** Handle an exception raised during the cycle. */
   void handleException();
@@ -62,6 +105,13 @@ class Core : public simeng::Core {
   /** Inspect units and flush pipelines if required. */
   void flushIfNeeded();
 
+  /** Record the uops which entered each pipeline stage this cycle with the
+   * pipeline tracer. */
+  void traceCycle();
+
+  /** The memory interface instructions are fetched from. */
+  memory::MemoryInterface& instructionMemory_;
+
   const std::vector<simeng::RegisterFileStructure> physicalRegisterStructures_;
 
   const std::vector<uint16_t> physicalRegisterQuantities_;
@@ -76,21 +126,44 @@ class Core : public simeng::Core {
   pipeline::PipelineBuffer<MacroOp> fetchToDecodeBuffer_;
 
   /** The buffer between decode and rename. */
-  pipeline::PipelineBuffer<std::shared_ptr<Instruction>> decodeToRenameBuffer_;
+  pipeline::PipelineBuffer<IntrusivePtr<Instruction>> decodeToRenameBuffer_;
 
   /** The buffer between rename and dispatch/issue. */
-  pipeline::PipelineBuffer<std::shared_ptr<Instruction>>
-      renameToDispatchBuffer_;
+  pipeline::PipelineBuffer<IntrusivePtr<Instruction>> renameToDispatchBuffer_;
 
   /** The issue ports; single-width buffers between issue and execute. */
-  std::vector<pipeline::PipelineBuffer<std::shared_ptr<Instruction>>>
-      issuePorts_;
+  std::vector<pipeline::PipelineBuffer<IntrusivePtr<Instruction>>> issuePorts_;
 
   /** The completion slots; single-width buffers between execute and writeback.
    */
-  std::vector<pipeline::PipelineBuffer<std::shared_ptr<Instruction>>>
+  std::vector<pipeline::PipelineBuffer<IntrusivePtr<Instruction>>>
       completionSlots_;
 
+  /** The second-level TLB shared by the instruction and data TLBs; null if not
+   * modelled. */
+  std::shared_ptr<memory::Tlb> l2Tlb_;
+
+  /** The instruction TLB used by fetch; null if not modelled. */
+  std::shared_ptr<memory::Tlb> instructionTlb_;
+
+  /** The data TLB used by the load/store queue; null if not modelled. */
+  std::shared_ptr<memory::Tlb> dataTlb_;
+
+  /** The memory dependence predictor used by the load/store queue; null if not
+   * modelled. */
+  std::unique_ptr<pipeline::StoreSetPredictor> storeSetPredictor_;
+
+  /** The cache of pre-decoded instructions used by fetch; null if not
+   * modelled. */
+  std::unique_ptr<pipeline::MicroOpCache> microOpCache_;
+
+  /** The per-uop pipeline trace; null if not written. */
+  std::unique_ptr<pipeline::PipelineTracer> tracer_;
+
+  /** The uops awaiting dispatch at the start of the cycle, noted while
+   * tracing to find those the dispatch/issue unit accepts. */
+  std::vector<IntrusivePtr<Instruction>> dispatchInput_;
+
   /** The fetch unit; fetches instructions from memory. */
   pipeline::FetchUnit fetchUnit_;
 
@@ -133,7 +206,7 @@ class Core : public simeng::Core {
   bool exceptionGenerated_ = false;
 
   /** A pointer to the instruction responsible for generating the exception. */
-  std::shared_ptr<Instruction> exceptionGeneratingInstruction_;
+  IntrusivePtr<Instruction> exceptionGeneratingInstruction_;
 };
 
 }  // namespace outoforder
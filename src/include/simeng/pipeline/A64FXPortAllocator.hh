@@ -44,6 +44,12 @@ class A64FXPortAllocator : public PortAllocator {
   /** Tick the port allocator to allow it to process internal tasks. */
   void tick() override;
 
+  /** Advance the port allocator by `ticks` idle ticks. Its state is derived
+   * afresh each tick from the reservation station occupancy, which can't
+   * change while no instruction is dispatched or issued, so a single tick
+   * suffices. */
+  void skipTicks(uint64_t ticks) override;
+
  private:
   /** A mapping from issue ports to instruction attribute */
   uint8_t attributeMapping(const std::vector<uint16_t>& ports);
@@ -39,6 +39,10 @@ class BalancedPortAllocator : public PortAllocator {
   /** Tick the port allocator to allow it to process internal tasks. */
   void tick() override;
 
+  /** Advance the port allocator by `ticks` idle ticks; it holds no state
+   * updated by ticking. */
+  void skipTicks(uint64_t ticks) override;
+
  private:
   /** The instruction group support matrix. An instruction-group-indexed map
    * containing lists of the ports that support each instruction group. */
@@ -15,13 +15,17 @@ class DecodeUnit {
   /** Constructs a decode unit with references to input/output buffers and the
    * current branch predictor. */
   DecodeUnit(PipelineBuffer<MacroOp>& input,
-             PipelineBuffer<std::shared_ptr<Instruction>>& output,
+             PipelineBuffer<IntrusivePtr<Instruction>>& output,
              BranchPredictor& predictor);
 
   /** Ticks the decode unit. Breaks macro-ops into uops, and performs early
    * branch misprediction checks. */
   void tick();
 
+  /** Check whether ticking this unit would do nothing, as both its input and
+   * output are stalled. */
+  bool isIdle() const;
+
   /** Check whether the core should be flushed this cycle. */
   bool shouldFlush() const;
 
@@ -40,9 +44,9 @@ class DecodeUnit {
   /** A buffer of macro-ops to split into uops. */
   PipelineBuffer<MacroOp>& input_;
   /** An internal buffer for storing one or more uops. */
-  std::deque<std::shared_ptr<Instruction>> microOps_;
+  std::deque<IntrusivePtr<Instruction>> microOps_;
   /** A buffer for writing decoded uops into. */
-  PipelineBuffer<std::shared_ptr<Instruction>>& output_;
+  PipelineBuffer<IntrusivePtr<Instruction>>& output_;
 
   /** A reference to the current branch predictor. */
   BranchPredictor& predictor_;
@@ -1,11 +1,9 @@
 #pragma once
 
-#include <deque>
-#include <initializer_list>
-#include <queue>
-#include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "simeng/Instruction.hh"
 #include "simeng/config/SimInfo.hh"
@@ -19,9 +17,9 @@ namespace pipeline {
 struct ReservationStationPort {
   /** Issue port this port maps to */
   uint16_t issuePort;
-  /** Queue of instructions that are ready to be
-   * issued */
-  std::deque<std::shared_ptr<Instruction>> ready;
+  /** Bitmask of the reservation station entries holding instructions that are
+   * ready to be issued to this port */
+  std::vector<uint64_t> ready;
 };
 
 /** A reservation station */
@@ -34,16 +32,25 @@ struct ReservationStation {
   uint16_t currentSize;
   /** Issue ports belonging to reservation station */
   std::vector<ReservationStationPort> ports;
+  /** Index of this station's first entry within the unit's entries. A
+   * multiple of 64, such that the station's entries begin a bitmask word. */
+  uint32_t offset;
+  /** Bitmask of the occupied entries */
+  std::vector<uint64_t> occupied;
 };
 
 /** An entry in the reservation station. */
-struct dependencyEntry {
+struct ReservationStationEntry {
   /** The instruction to execute. */
-  std::shared_ptr<Instruction> uop;
+  IntrusivePtr<Instruction> uop;
   /** The port to issue to. */
   uint16_t port;
-  /** The operand waiting on a value. */
-  uint16_t operandIndex;
+  /** The position of the instruction in dispatch order; the oldest ready
+   * instruction is issued first. */
+  uint64_t age;
+  /** The operands still waiting on a value, with the registers supplying
+   * them. */
+  std::vector<std::pair<Register, uint16_t>> pendingOperands;
 };
 
 /** A dispatch/issue unit for an out-of-order pipelined processor. Reads
@@ -55,8 +62,8 @@ class DispatchIssueUnit {
    * the register file, the port allocator, and a description of the number of
    * physical registers the scoreboard needs to reflect. */
   DispatchIssueUnit(
-      PipelineBuffer<std::shared_ptr<Instruction>>& fromRename,
-      std::vector<PipelineBuffer<std::shared_ptr<Instruction>>>& issuePorts,
+      PipelineBuffer<IntrusivePtr<Instruction>>& fromRename,
+      std::vector<PipelineBuffer<IntrusivePtr<Instruction>>>& issuePorts,
       const RegisterFileSet& registerFileSet, PortAllocator& portAllocator,
       const std::vector<uint16_t>& physicalRegisterStructure,
       ryml::ConstNodeRef config = config::SimInfo::getConfig());
@@ -69,6 +76,14 @@ class DispatchIssueUnit {
    * it. */
   void issue();
 
+  /** Check whether ticking this unit and issuing would do nothing but count a
+   * stall, as no instructions are arriving and none are ready to issue. */
+  bool isIdle() const;
+
+  /** Advance the unit by `ticks` ticks, in which it must be idle, counting the
+   * issue stall each would have recorded. */
+  void skipTicks(uint64_t ticks);
+
   /** Forwards operands and performs register reads for the currently queued
    * instruction. */
   void forwardOperands(const span<Register>& destinations,
@@ -97,32 +112,53 @@ class DispatchIssueUnit {
   void getRSSizes(std::vector<uint64_t>&) const;
 
  private:
+  /** Get the index of `reg` within the scoreboard and dependency matrix. */
+  size_t registerIndex(const Register& reg) const;
+
+  /** Find the entry of `rs` holding the oldest instruction flagged in
+   * `ready`, returning its index within the station, or -1 if none are. */
+  int32_t selectOldest(const ReservationStation& rs,
+                       const std::vector<uint64_t>& ready) const;
+
+  /** Remove the flushed instruction held in entry `slot` of `rs`. */
+  void squash(ReservationStation& rs, uint16_t slot);
+
   /** A buffer of instructions to dispatch and read operands for. */
-  PipelineBuffer<std::shared_ptr<Instruction>>& input_;
+  PipelineBuffer<IntrusivePtr<Instruction>>& input_;
 
   /** Ports to the execution units, for writing ready instructions to. */
-  std::vector<PipelineBuffer<std::shared_ptr<Instruction>>>& issuePorts_;
+  std::vector<PipelineBuffer<IntrusivePtr<Instruction>>>& issuePorts_;
 
   /** A reference to the physical register file set. */
   const RegisterFileSet& registerFileSet_;
 
-  /** The register availability scoreboard. */
-  std::vector<std::vector<bool>> scoreboard_;
+  /** The register availability scoreboard, indexed by `registerIndex`. */
+  std::vector<bool> scoreboard_;
+
+  /** The index of the first register of each type within the scoreboard and
+   * dependency matrix. */
+  std::vector<uint32_t> registerOffsets_;
 
   /** Reservation stations */
   std::vector<ReservationStation> reservationStations_;
 
+  /** The entries of all reservation stations. Those of a station begin at its
+   * `offset`. */
+  std::vector<ReservationStationEntry> entries_;
+
   /** A mapping from port to RS port */
   std::vector<std::pair<uint16_t, uint16_t>> portMapping_;
 
-  /** A dependency matrix, containing all the instructions waiting on an
-   * operand. For a register `{type,tag}`, the vector of dependents may be found
-   * at `dependencyMatrix[type][tag]`. */
-  std::vector<std::vector<std::vector<dependencyEntry>>> dependencyMatrix_;
+  /** The number of 64-bit words in each row of the dependency matrix. */
+  size_t matrixWidth_;
+
+  /** A dependency bit-matrix, holding a row for each physical register with a
+   * bit set for each entry waiting on it. The row of a register begins at
+   * word `registerIndex(reg) * matrixWidth_`. */
+  std::vector<uint64_t> dependencyMatrix_;
 
-  /** A map to collect flushed instructions for each reservation station. */
-  std::unordered_map<uint16_t, std::unordered_set<std::shared_ptr<Instruction>>>
-      flushed_;
+  /** The number of instructions dispatched so far, used to age entries. */
+  uint64_t dispatched_ = 0;
 
   /** Records the number of instructions dispatched for each reservation station
    * within a cycle. */
@@ -14,7 +14,7 @@ namespace pipeline {
  * indication of when it's reached the front of the execution pipeline. */
 struct ExecutionUnitPipelineEntry {
   /** The instruction queued for execution. */
-  std::shared_ptr<Instruction> insn;
+  IntrusivePtr<Instruction> insn;
   /** The tick number this instruction will reach the front of the queue at. */
   uint64_t readyAt;
 };
@@ -27,12 +27,12 @@ class ExecuteUnit {
    * the currently used branch predictor, and handlers for forwarding operands,
    * loads/stores, and exceptions. */
   ExecuteUnit(
-      PipelineBuffer<std::shared_ptr<Instruction>>& input,
-      PipelineBuffer<std::shared_ptr<Instruction>>& output,
+      PipelineBuffer<IntrusivePtr<Instruction>>& input,
+      PipelineBuffer<IntrusivePtr<Instruction>>& output,
       std::function<void(span<Register>, span<RegisterValue>)> forwardOperands,
-      std::function<void(const std::shared_ptr<Instruction>&)> handleLoad,
-      std::function<void(const std::shared_ptr<Instruction>&)> handleStore,
-      std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
+      std::function<void(const IntrusivePtr<Instruction>&)> handleLoad,
+      std::function<void(const IntrusivePtr<Instruction>&)> handleStore,
+      std::function<void(const IntrusivePtr<Instruction>&)> raiseException,
       BranchPredictor& predictor, bool pipelined = true,
       const std::vector<uint16_t>& blockingGroups = {});
 
@@ -41,6 +41,13 @@ class ExecuteUnit {
    * present. */
   void tick();
 
+  /** Check whether ticking this unit would do nothing but count the cycle, as
+   * it holds no instructions and none are arriving. */
+  bool isIdle() const;
+
+  /** Advance the unit by `ticks` ticks, in which it must be idle. */
+  void skipTicks(uint64_t ticks);
+
   /** Query whether a branch misprediction was discovered this cycle. */
   bool shouldFlush() const;
 
@@ -72,24 +79,24 @@ class ExecuteUnit {
  private:
   /** Execute the supplied uop, write it into the output buffer, and forward
    * results back to dispatch/issue. */
-  void execute(std::shared_ptr<Instruction>& uop);
+  void execute(IntrusivePtr<Instruction>& uop);
 
   /** A buffer of instructions to execute. */
-  PipelineBuffer<std::shared_ptr<Instruction>>& input_;
+  PipelineBuffer<IntrusivePtr<Instruction>>& input_;
 
   /** A buffer for writing executed instructions into. */
-  PipelineBuffer<std::shared_ptr<Instruction>>& output_;
+  PipelineBuffer<IntrusivePtr<Instruction>>& output_;
 
   /** A function handle called when forwarding operands. */
   std::function<void(span<Register>, span<RegisterValue>)> forwardOperands_;
 
   /** A function handle called after generating the addresses for a load. */
-  std::function<void(const std::shared_ptr<Instruction>&)> handleLoad_;
+  std::function<void(const IntrusivePtr<Instruction>&)> handleLoad_;
   /** A function handle called after acquiring the data for a store. */
-  std::function<void(const std::shared_ptr<Instruction>&)> handleStore_;
+  std::function<void(const IntrusivePtr<Instruction>&)> handleStore_;
 
   /** A function handle called upon exception generation. */
-  std::function<void(const std::shared_ptr<Instruction>&)> raiseException_;
+  std::function<void(const IntrusivePtr<Instruction>&)> raiseException_;
 
   /** A reference to the branch predictor, for updating with prediction results.
    */
@@ -110,7 +117,7 @@ class ExecuteUnit {
 
   /** A queue to hold blocked instructions of a similar group type to
    * blockingGroup_. */
-  std::deque<std::shared_ptr<Instruction>> operationsStalled_;
+  std::deque<IntrusivePtr<Instruction>> operationsStalled_;
 
   /** Whether the core should be flushed after this cycle. */
   bool shouldFlush_ = false;
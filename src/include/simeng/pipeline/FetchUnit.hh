@@ -1,9 +1,12 @@
 #pragma once
 
+#include <deque>
 #include <queue>
 
 #include "simeng/arch/Architecture.hh"
 #include "simeng/memory/MemoryInterface.hh"
+#include "simeng/memory/Tlb.hh"
+#include "simeng/pipeline/MicroOpCache.hh"
 #include "simeng/pipeline/PipelineBuffer.hh"
 
 namespace simeng {
@@ -33,15 +36,37 @@ struct loopBufferEntry {
 };
 
 /** A fetch and pre-decode unit for a pipelined processor. Responsible for
- * reading instruction memory and maintaining the program counter. */
+ * reading instruction memory and maintaining the program counter.
+ *
+ * By default, branches are predicted once pre-decoded, and fetch stops at each
+ * branch predicted taken. If given a fetch target queue, the unit is instead
+ * decoupled: a prediction stage runs ahead of fetch, identifying branches with
+ * a branch target buffer (BTB) and queueing the ranges of instructions to
+ * fetch, whose blocks are prefetched while queued. Fetch then follows the
+ * queue, crossing predicted-taken branches within a cycle. Branches missing
+ * from the BTB are found on pre-decode, and re-steer the prediction stage.
+ *
+ * If given a micro-op cache, instructions found in it are supplied from it
+ * rather than pre-decoded. While the fetch buffer is empty and the instruction
+ * at the PC is cached, the unit also bypasses instruction memory, supplying
+ * consecutive cached instructions up to the cache's width. */
 class FetchUnit {
  public:
   /** Construct a fetch unit with a reference to an output buffer, the ISA, and
-   * the current branch predictor, and information on the instruction memory. */
+   * the current branch predictor, and information on the instruction memory.
+   * If an instruction TLB is supplied, each fetch block waits for its
+   * translation before being requested. A non-zero `targetQueueSize` decouples
+   * the unit, with a BTB of `btbEntries` entries and up to `targetsPerCycle`
+   * fetch targets consumed each cycle. If a micro-op cache is supplied, it
+   * holds the instructions pre-decoded. */
   FetchUnit(PipelineBuffer<MacroOp>& output,
             memory::MemoryInterface& instructionMemory,
             uint64_t programByteLength, uint64_t entryPoint, uint16_t blockSize,
-            const arch::Architecture& isa, BranchPredictor& branchPredictor);
+            const arch::Architecture& isa, BranchPredictor& branchPredictor,
+            memory::Tlb* instructionTlb = nullptr,
+            uint16_t targetQueueSize = 0, uint16_t btbEntries = 0,
+            uint16_t targetsPerCycle = 1,
+            MicroOpCache* microOpCache = nullptr);
 
   ~FetchUnit();
 
@@ -49,6 +74,22 @@ class FetchUnit {
    * current program counter. */
   void tick();
 
+  /** Check whether ticking this unit and requesting from the PC would do
+   * nothing but count the cycle: the unit has halted, or its output is stalled
+   * and it already holds enough data for the next instruction. */
+  bool isIdle() const;
+
+  /** Advance the unit by `ticks` ticks, in which it must be idle. */
+  void skipTicks(uint64_t ticks);
+
+  /** Advance the unit's clock by `ticks` ticks in which its core was halted,
+   * such that TLB entries warmed meanwhile age as they would have. */
+  void skipHaltedTicks(uint64_t ticks);
+
+  /** Warm the instruction TLB and memory with the fetch of `target`, made
+   * while the core was halted. */
+  void warm(const memory::MemoryAccessTarget& target);
+
   /** Function handle to retrieve branch that represents loop boundary. */
   void registerLoopBoundary(uint64_t branchAddress);
 
@@ -66,10 +107,132 @@ class FetchUnit {
    * branch. */
   uint64_t getBranchStalls() const;
 
+  /** Retrieve the number of cycles a fetch was held back waiting for its
+   * translation. */
+  uint64_t getTranslationStalls() const;
+
+  /** Retrieve the number of branches pre-decoded which the prediction stage
+   * had not identified from the BTB. */
+  uint64_t getBtbMisses() const;
+
+  /** Check whether the unit is decoupled by a fetch target queue. */
+  bool isDecoupled() const;
+
   /** Clear the loop buffer. */
   void flushLoopBuffer();
 
  private:
+  /** An entry of the BTB used by the prediction stage. */
+  struct BtbEntry {
+    /** The address of the branch; all ones if the entry is invalid. */
+    uint64_t address = ~0ull;
+    /** The type of the branch. */
+    BranchType type;
+    /** The known offset of the branch target; 0 if not known. */
+    int64_t knownOffset;
+    /** The size of the branch instruction. */
+    uint16_t size;
+  };
+
+  /** A range of instructions predicted to be fetched in sequence, ending at
+   * the end of a fetch block or at a branch predicted taken. */
+  struct FetchTarget {
+    /** The address of the first byte of the range. */
+    uint64_t start;
+    /** The address after the last byte of the range. */
+    uint64_t end;
+    /** Whether all of the blocks covering the range have been requested. */
+    bool requested;
+    /** The predictions made for the branches in the range, in order. */
+    std::vector<std::pair<uint64_t, BranchPrediction>> predictions;
+  };
+
+  /** A fetch block held for the fetch targets. */
+  struct FetchBlock {
+    /** The address of the block; all ones if the slot is unused. */
+    uint64_t address = ~0ull;
+    /** Whether the block has been requested from memory. */
+    bool requested = false;
+    /** Whether the block's data has arrived. */
+    bool ready = false;
+    /** Whether the block could not be read; it holds no data. */
+    bool faulted = false;
+    /** The cycle the block's translation is available; 0 if it has yet to be
+     * looked up. */
+    uint64_t translationReadyAt = 0;
+    /** The cycle the block was last allocated or read, for LRU replacement. */
+    uint64_t lastUsed = 0;
+  };
+
+  /** Pre-decode the instruction at `address` from the `bytesAvailable` bytes
+   * at `ptr` into `output`, or supply it from the micro-op cache. Returns the
+   * number of bytes consumed, or 0 if more are needed. */
+  uint8_t predecode(const void* ptr, uint16_t bytesAvailable, uint64_t address,
+                    MacroOp& output);
+
+  /** Supply the output buffer with the cached instructions from the PC,
+   * bypassing instruction memory. Returns `false` if the instruction at the PC
+   * is not cached. */
+  bool supplyFromMicroOpCache();
+
+  /** Check whether the next cycle can supply instructions from the micro-op
+   * cache without reading instruction memory. */
+  bool canBypassMemory() const;
+
+  /** Tick a decoupled unit, running its fetch stage and then its prediction
+   * stage. */
+  void tickDecoupled();
+
+  /** Supply the output buffer with the instructions held in the loop buffer.
+   */
+  void supplyFromLoopBuffer();
+
+  /** Pre-decode the instructions of the fetch targets at the head of the
+   * queue, correcting the prediction stage if it missed a branch. */
+  void fetchTargets();
+
+  /** Predict the next fetch target and add it to the queue, if there is space.
+   */
+  void predictFetchTarget();
+
+  /** Supply `output` with a macro-op raising a fault for the instruction at
+   * the PC, which could not be read, and stop fetching until the PC is
+   * updated. */
+  void supplyFetchFault(MacroOp& output);
+
+  /** Request the blocks of queued fetch targets from memory. */
+  void prefetchTargets();
+
+  /** Record a pre-decoded instruction in the loop buffer, and update its
+   * state. Returns `true` if the loop buffer begins supplying. */
+  bool updateLoopBuffer(const MacroOp& macroOp, const uint8_t* encoding,
+                        uint16_t bytesRead);
+
+  /** Copy the data of completed reads into the held blocks awaiting it. */
+  void receiveBlocks();
+
+  /** Check whether every block covering a fetch target has arrived. */
+  bool isTargetReady(const FetchTarget& target) const;
+
+  /** Append the instructions of the fetch target at the head of the queue to
+   * the fetch buffer, and remove it from the queue. */
+  void loadTarget();
+
+  /** Discard the queued fetch targets and the predictions of fetched
+   * instructions after the PC, flushing their predictions youngest first, and
+   * forget any fault ending the fetch buffer. */
+  void discardTargets();
+
+  /** Find the held block at `address`; returns -1 if none is held. */
+  int findBlock(uint64_t address) const;
+
+  /** Get the BTB entry which would hold the branch at `address`. */
+  BtbEntry& btbEntry(uint64_t address);
+
+  /** Get the fetch target `index` entries after the head of the queue. */
+  FetchTarget& queuedTarget(size_t index);
+  const FetchTarget& queuedTarget(size_t index) const;
+
   /** An output buffer connecting this unit to the decode unit. */
   PipelineBuffer<MacroOp>& output_;
 
@@ -105,6 +268,21 @@ class FetchUnit {
   /** The number of cycles fetch terminated early due to a predicted branch. */
   uint64_t branchStalls_ = 0;
 
+  /** The instruction TLB translating fetch blocks; null if translation is not
+   * modelled. */
+  memory::Tlb* instructionTlb_;
+
+  /** The number of times this unit has been ticked. */
+  uint64_t tickCounter_ = 0;
+
+  /** The cycle the translation of the next block to fetch is available, or 0
+   * if it has yet to be looked up. */
+  uint64_t translationReadyAt_ = 0;
+
+  /** The number of cycles a fetch was held back waiting for its translation.
+   */
+  uint64_t translationStalls_ = 0;
+
   /** The size of a fetch block, in bytes. */
   uint16_t blockSize_;
 
@@ -118,6 +296,55 @@ class FetchUnit {
   /** The amount of data currently in the fetch buffer. */
   uint16_t bufferedBytes_ = 0;
 
+  /** The fetch target queue; empty if the unit is not decoupled. Targets are
+   * held in a ring from `targetHead_`. */
+  std::vector<FetchTarget> targetQueue_;
+
+  /** The position of the oldest queued fetch target. */
+  size_t targetHead_ = 0;
+
+  /** The number of queued fetch targets. */
+  size_t targetCount_ = 0;
+
+  /** The address the prediction stage will predict from next. */
+  uint64_t predictionPc_ = 0;
+
+  /** Whether the prediction stage is running; it pauses while the loop buffer
+   * is supplying. */
+  bool predicting_ = true;
+
+  /** Whether the fetch buffer ends where a block could not be read. Once the
+   * buffered instructions are fetched, the next raises a fault. */
+  bool fetchFaulted_ = false;
+
+  /** Whether the macro-op raising a fetch fault has been supplied; fetch stops
+   * until the PC is updated. */
+  bool faultSupplied_ = false;
+
+  /** The predictions of the branches in the fetch buffer, in order. */
+  std::deque<std::pair<uint64_t, BranchPrediction>> bufferedPredictions_;
+
+  /** The BTB used by the prediction stage, direct mapped by address. */
+  std::vector<BtbEntry> btb_;
+
+  /** The maximum number of fetch targets consumed each cycle. */
+  uint16_t targetsPerCycle_;
+
+  /** The number of bytes the fetch buffer can hold. */
+  uint16_t bufferCapacity_;
+
+  /** The blocks held for the fetch targets, with their data stored
+   * consecutively in `blockData_`. */
+  std::vector<FetchBlock> blocks_;
+  std::vector<uint8_t> blockData_;
+
+  /** The number of branches pre-decoded which the prediction stage had not
+   * identified from the BTB. */
+  uint64_t btbMisses_ = 0;
+
+  /** The cache of pre-decoded instructions; null if none is modelled. */
+  MicroOpCache* microOpCache_;
+
   /** Let the following PipelineFetchUnitTest derived classes be a friend of
    * this class to allow proper testing of 'tick' function. */
   friend class PipelineFetchUnitTest_invalidMinBytesAtEndOfBuffer_Test;
@@ -5,10 +5,15 @@
 #include <map>
 #include <queue>
 #include <unordered_map>
+#include <vector>
 
 #include "simeng/Instruction.hh"
+#include "simeng/arch/Architecture.hh"
 #include "simeng/memory/MemoryInterface.hh"
+#include "simeng/memory/Tlb.hh"
 #include "simeng/pipeline/PipelineBuffer.hh"
+#include "simeng/pipeline/RequestWheel.hh"
+#include "simeng/pipeline/StoreSetPredictor.hh"
 
 namespace simeng {
 namespace pipeline {
@@ -16,12 +21,41 @@ namespace pipeline {
 /** The memory access types which are processed. */
 enum accessType { LOAD = 0, STORE };
 
-/** A requestQueue_ entry. */
-struct requestEntry {
-  /** The memory address(es) to be accessed. */
-  std::queue<simeng::memory::MemoryAccessTarget> reqAddresses;
-  /** The instruction sending the request(s). */
-  std::shared_ptr<Instruction> insn;
+
+/** A load access reading bytes written by older, uncommitted stores. Each byte
+ * is taken from the youngest older store writing to it, or from memory if
+ * there is none; the bytes are merged as their sources supply them. */
+struct forwardingEntry {
+  /** The load instruction. */
+  IntrusivePtr<Instruction> load;
+  /** The access made by the load. */
+  simeng::memory::MemoryAccessTarget target;
+  /** The sequence ID of the store supplying each byte, or `UINT64_MAX` for
+   * bytes read from memory. */
+  std::vector<uint64_t> sources;
+  /** The merged data. */
+  std::vector<char> data;
+  /** The number of stores, plus one for memory if any bytes are read from it,
+   * yet to supply their bytes. */
+  uint16_t pendingSources = 0;
+  /** Whether the memory read for this access is outstanding. */
+  bool awaitingMemory = false;
+  /** Whether the memory read for this access failed. */
+  bool faulted = false;
+};
+
+/** A storeQueue_ entry. */
+struct storeQueueEntry {
+  /** The store instruction. */
+  IntrusivePtr<Instruction> insn;
+  /** The data to be stored. */
+  span<const simeng::RegisterValue> data;
+  /** Whether the store has generated its addresses. */
+  bool started = false;
+  /** The load accesses awaiting data from this store. */
+  std::vector<std::shared_ptr<forwardingEntry>> conflictions;
+  /** The loads held back by a predicted dependence on this store. */
+  std::vector<IntrusivePtr<Instruction>> deferredLoads;
 };
 
 /** A load store queue (known as "load/store buffers" or "memory order buffer").
@@ -30,32 +64,44 @@ class LoadStoreQueue {
  public:
   /** Constructs a combined load/store queue model, simulating a shared queue
    * for both load and store instructions, supplying completion slots for loads
-   * and an operand forwarding handler. */
+   * and an operand forwarding handler. If a data TLB is supplied, requests are
+   * held back until their translations are available. If a store set
+   * predictor is supplied, loads predicted to depend on an older store wait
+   * for its addresses to be generated. If an architecture is supplied, stores
+   * are recorded with its exclusive monitor, if any. */
   LoadStoreQueue(
       unsigned int maxCombinedSpace, memory::MemoryInterface& memory,
-      span<PipelineBuffer<std::shared_ptr<Instruction>>> completionSlots,
+      span<PipelineBuffer<IntrusivePtr<Instruction>>> completionSlots,
       std::function<void(span<Register>, span<RegisterValue>)> forwardOperands,
-      std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
+      std::function<void(const IntrusivePtr<Instruction>&)> raiseException,
       bool exclusive = false, uint16_t loadBandwidth = UINT16_MAX,
       uint16_t storeBandwidth = UINT16_MAX,
       uint16_t permittedRequests = UINT16_MAX,
       uint16_t permittedLoads = UINT16_MAX,
-      uint16_t permittedStores = UINT16_MAX);
+      uint16_t permittedStores = UINT16_MAX, memory::Tlb* dataTlb = nullptr,
+      StoreSetPredictor* storeSetPredictor = nullptr,
+      const arch::Architecture* isa = nullptr);
 
   /** Constructs a split load/store queue model, simulating discrete queues for
    * load and store instructions, supplying completion slots for loads and an
-   * operand forwarding handler. */
+   * operand forwarding handler. If a data TLB is supplied, requests are held
+   * back until their translations are available. If a store set predictor is
+   * supplied, loads predicted to depend on an older store wait for its
+   * addresses to be generated. If an architecture is supplied, stores are
+   * recorded with its exclusive monitor, if any. */
   LoadStoreQueue(
       unsigned int maxLoadQueueSpace, unsigned int maxStoreQueueSpace,
       memory::MemoryInterface& memory,
-      span<PipelineBuffer<std::shared_ptr<Instruction>>> completionSlots,
+      span<PipelineBuffer<IntrusivePtr<Instruction>>> completionSlots,
       std::function<void(span<Register>, span<RegisterValue>)> forwardOperands,
-      std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
+      std::function<void(const IntrusivePtr<Instruction>&)> raiseException,
       bool exclusive = false, uint16_t loadBandwidth = UINT16_MAX,
       uint16_t storeBandwidth = UINT16_MAX,
       uint16_t permittedRequests = UINT16_MAX,
       uint16_t permittedLoads = UINT16_MAX,
-      uint16_t permittedStores = UINT16_MAX);
+      uint16_t permittedStores = UINT16_MAX, memory::Tlb* dataTlb = nullptr,
+      StoreSetPredictor* storeSetPredictor = nullptr,
+      const arch::Architecture* isa = nullptr);
 
   /** Retrieve the available space for load uops. For combined queue this is the
    * total remaining space. */
@@ -70,24 +116,37 @@ class LoadStoreQueue {
   unsigned int getTotalSpace() const;
 
   /** Add a load uop to the queue. */
-  void addLoad(const std::shared_ptr<Instruction>& insn);
+  void addLoad(const IntrusivePtr<Instruction>& insn);
 
-  /** Add a store uop to the queue. */
-  void addStore(const std::shared_ptr<Instruction>& insn);
+  /** Add a store-address uop to the queue. */
+  void addStore(const IntrusivePtr<Instruction>& insn);
 
-  /** Add the load instruction's memory requests to the requestQueue_. */
-  void startLoad(const std::shared_ptr<Instruction>& insn);
+  /** Add the load instruction's memory requests to the requestQueue_. Bytes
+   * written by older stores are forwarded from them when they commit rather
+   * than read from memory. */
+  void startLoad(const IntrusivePtr<Instruction>& insn);
+
+  /** Record the addresses generated by a store, making it visible to the
+   * confliction detection of younger loads, and start any loads waiting for
+   * it. */
+  void startStore(const IntrusivePtr<Instruction>& insn);
 
   /** Supply the data to be stored by a store operation. */
-  void supplyStoreData(const std::shared_ptr<Instruction>& insn);
+  void supplyStoreData(const IntrusivePtr<Instruction>& insn);
 
   /** Commit and write the oldest store instruction to memory, removing it from
    * the store queue. Returns `true` if memory disambiguation has discovered a
    * memory order violation during the commit. */
-  bool commitStore(const std::shared_ptr<Instruction>& uop);
+  bool commitStore(const IntrusivePtr<Instruction>& uop);
+
+  /** Write the data of the exclusive store or atomic `uop` through the
+   * exclusive monitor, ahead of committing it. Returns false if another core
+   * has written to its memory since it was read, in which case nothing was
+   * written and `uop` must be executed again. */
+  bool writeExclusive(const Instruction& uop);
 
   /** Remove the oldest load instruction from the load queue. */
-  void commitLoad(const std::shared_ptr<Instruction>& uop);
+  void commitLoad(const IntrusivePtr<Instruction>& uop);
 
   /** Remove all flushed instructions from the queues. */
   void purgeFlushed();
@@ -98,31 +157,56 @@ class LoadStoreQueue {
   /** Process received load data and send any completed loads for writeback. */
   void tick();
 
+  /** Check whether ticking this queue would do nothing but count the cycle:
+   * no memory request is waiting to be sent, and no load has completed or
+   * received data. Loads already sent to memory may still be outstanding. */
+  bool isIdle() const;
+
+  /** Advance the queue by `ticks` ticks, in which it must be idle and the
+   * memory interface must complete no reads. */
+  void skipTicks(uint64_t ticks);
+
+  /** Advance the queue's clock by `ticks` ticks in which its core was halted,
+   * such that TLB entries warmed meanwhile age as they would have. Any
+   * request still waiting becomes due. */
+  void skipHaltedTicks(uint64_t ticks);
+
+  /** Warm the data TLB and memory with the access of `target` by the
+   * instruction at `pc`, made while the core was halted. */
+  void warm(uint64_t pc, const memory::MemoryAccessTarget& target,
+            bool write);
+
   /** Retrieve the load instruction associated with the most recently discovered
    * memory order violation. */
-  std::shared_ptr<Instruction> getViolatingLoad() const;
+  IntrusivePtr<Instruction> getViolatingLoad() const;
+
+  /** Retrieve the number of cycles request issue was held back waiting for a
+   * translation. */
+  uint64_t getTranslationStalls() const;
+
+  /** Retrieve the number of loads held back by a predicted dependence on an
+   * older store. */
+  uint64_t getPredictedDependences() const;
 
  private:
   /** The load queue: holds in-flight load instructions. */
-  std::deque<std::shared_ptr<Instruction>> loadQueue_;
+  std::deque<IntrusivePtr<Instruction>> loadQueue_;
 
-  /** The store queue: holds in-flight store instructions with its associated
-   * data. */
-  std::deque<std::pair<std::shared_ptr<Instruction>,
-                       span<const simeng::RegisterValue>>>
-      storeQueue_;
+  /** The store queue: holds in-flight store instructions with their
+   * associated data, in program order. */
+  std::deque<storeQueueEntry> storeQueue_;
 
   /** Slots to write completed load instructions into for writeback. */
-  span<PipelineBuffer<std::shared_ptr<Instruction>>> completionSlots_;
+  span<PipelineBuffer<IntrusivePtr<Instruction>>> completionSlots_;
 
   /** Map of loads that have requested their data, keyed by sequence ID. */
-  std::unordered_map<uint64_t, std::shared_ptr<Instruction>> requestedLoads_;
+  std::unordered_map<uint64_t, IntrusivePtr<Instruction>> requestedLoads_;
 
   /** A function handler to call to forward the results of a completed load. */
   std::function<void(span<Register>, span<RegisterValue>)> forwardOperands_;
 
   /** A function handle called upon exception generation. */
-  std::function<void(const std::shared_ptr<Instruction>&)> raiseException_;
+  std::function<void(const IntrusivePtr<Instruction>&)> raiseException_;
 
   /** The maximum number of loads that can be in-flight. Undefined if this
    * is a combined queue. */
@@ -148,36 +232,74 @@ class LoadStoreQueue {
   /** Retrieve the total memory uop space available for a combined queue. */
   unsigned int getCombinedSpace() const;
 
+  /** Find the store queue entry of the store with sequence ID `seqId`,
+   * returning null if there is none. */
+  storeQueueEntry* findStore(uint64_t seqId);
+
+  /** Find the older stores writing to the bytes `target` of `load` reads,
+   * registering the access with the store queue entry of each. Returns null if
+   * no older store writes to them. */
+  std::shared_ptr<forwardingEntry> forwardFromStores(
+      const IntrusivePtr<Instruction>& load,
+      const simeng::memory::MemoryAccessTarget& target);
+
+  /** Whether all bytes of the `loadReq` access of `load` which overlap
+   * `storeReq` are forwarded from the store with sequence ID `storeSeqId`, or
+   * from a younger store. */
+  bool isForwarded(const IntrusivePtr<Instruction>& load,
+                   const simeng::memory::MemoryAccessTarget& loadReq,
+                   const simeng::memory::MemoryAccessTarget& storeReq,
+                   uint64_t storeSeqId) const;
+
+  /** Supply the merged data of a forwarded access to its load. */
+  void supplyForwardedData(const forwardingEntry& entry);
+
+  /** Supply `data` read from `address` to `load`, and execute it if it has
+   * all of its data. */
+  void supplyLoadData(const IntrusivePtr<Instruction>& load, uint64_t address,
+                      const RegisterValue& data);
+
+  /** Remove a store from storeIndex_. */
+  void unindexStore(const IntrusivePtr<Instruction>& store);
+
+  /** Check whether `uop` writes memory through an exclusive monitor shared
+   * with other cores. Such a write may not happen at all, so no load forwards
+   * from it. */
+  bool writesExclusively(const Instruction& uop) const;
+
+  /** Look up the translation of every page `target` touches in the data TLB,
+   * returning the cycle they are all available. */
+  uint64_t translate(const memory::MemoryAccessTarget& target);
+
   /** A pointer to process memory. */
   memory::MemoryInterface& memory_;
 
   /** The load instruction associated with the most recently discovered memory
    * order violation. */
-  std::shared_ptr<Instruction> violatingLoad_ = nullptr;
+  IntrusivePtr<Instruction> violatingLoad_ = nullptr;
 
   /** The number of times this unit has been ticked. */
   uint64_t tickCounter_ = 0;
 
-  /** A map to hold load instructions that are stalled due to a detected
-   * memory reordering confliction. First key is a store's sequence id and the
-   * second key the conflicting address. The value takes the form of a vector of
-   * pairs containing a pointer to the conflicted load and the size of the data
-   * needed at that address by the load. */
-  std::unordered_map<
-      uint64_t,
-      std::unordered_map<
-          uint64_t,
-          std::vector<std::pair<std::shared_ptr<Instruction>, uint16_t>>>>
-      conflictionMap_;
+  /** The forwarded accesses of each load, keyed by its sequence ID. */
+  std::unordered_map<uint64_t, std::vector<std::shared_ptr<forwardingEntry>>>
+      forwardedLoads_;
+
+  /** An index of the stores in the store queue whose addresses have been
+   * generated, keyed by each aligned block of addresses they write to. */
+  std::unordered_map<uint64_t, std::vector<IntrusivePtr<Instruction>>>
+      storeIndex_;
 
-  /** A map between LSQ cycles and load requests ready on that cycle. */
-  std::map<uint64_t, std::deque<requestEntry>> requestLoadQueue_;
+  /** A timing wheel of load requests, ordered by the LSQ cycle they are
+   * ready on. */
+  RequestWheel requestLoadQueue_;
 
-  /** A map between LSQ cycles and store requests ready on that cycle. */
-  std::map<uint64_t, std::deque<requestEntry>> requestStoreQueue_;
+  /** A timing wheel of store requests, ordered by the LSQ cycle they are
+   * ready on. */
+  RequestWheel requestStoreQueue_;
 
   /** A queue of completed loads ready for writeback. */
-  std::queue<std::shared_ptr<Instruction>> completedLoads_;
+  std::queue<IntrusivePtr<Instruction>> completedLoads_;
 
   /** Whether the LSQ can only process loads xor stores within a cycle. */
   bool exclusive_;
@@ -193,6 +315,33 @@ class LoadStoreQueue {
 
   /** The number of loads and stores permitted per cycle. */
   std::array<uint16_t, 2> reqLimits_;
+
+  /** The data TLB translating request addresses; null if translation is not
+   * modelled. */
+  memory::Tlb* dataTlb_;
+
+  /** The cycle the translation of the next request to issue is available, or
+   * 0 if it has yet to be looked up. */
+  uint64_t translationReadyAt_ = 0;
+
+  /** The instruction whose request is waiting for `translationReadyAt_`; null
+   * if no translation is outstanding. */
+  const Instruction* translationInsn_ = nullptr;
+
+  /** The number of cycles request issue was held back waiting for a
+   * translation. */
+  uint64_t translationStalls_ = 0;
+
+  /** The memory dependence predictor; null if loads are started as soon as
+   * their addresses are generated. */
+  StoreSetPredictor* storeSetPredictor_;
+
+  /** The number of loads held back by a predicted dependence. */
+  uint64_t predictedDependences_ = 0;
+
+  /** The architecture whose exclusive monitor stores are recorded with; null
+   * if there is none. */
+  const arch::Architecture* isa_;
 };
 
 }  // namespace pipeline
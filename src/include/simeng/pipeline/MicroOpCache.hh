@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "simeng/arch/Architecture.hh"
+#include "simeng/config/SimInfo.hh"
+
+namespace simeng {
+namespace pipeline {
+
+/** A set-associative cache of pre-decoded instructions, indexed by
+ * instruction address. Each entry holds unexecuted copies of the micro-ops an
+ * instruction was pre-decoded into, which are copied again each time the
+ * instruction is supplied, so that the architecture need not decode it again.
+ * Entries are replaced least recently used. */
+class MicroOpCache {
+ public:
+  /** Construct a micro-op cache, reading its size from the Micro-Op-Cache
+   * section of `config`. */
+  MicroOpCache(ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
+  /** Supply copies of the micro-ops cached for the instruction at `address` to
+   * `output`. Returns the size of the instruction in bytes, or 0 if it isn't
+   * cached or is larger than `bytesAvailable`. Each lookup is counted as a hit
+   * or a miss. */
+  uint8_t supply(uint64_t address, uint16_t bytesAvailable, MacroOp& output);
+
+  /** Check whether the instruction at `address` is cached, without counting
+   * the lookup or updating the replacement state. */
+  bool contains(uint64_t address) const;
+
+  /** Cache the micro-ops `macroOp` pre-decoded from the `size`-byte
+   * instruction at `address`, replacing the least recently used way of its
+   * set. */
+  void fill(uint64_t address, const MacroOp& macroOp, uint8_t size);
+
+  /** Invalidate the ways holding an instruction overlapping the `size` bytes
+   * written from `address`, so that modified code is decoded again. */
+  void invalidate(uint64_t address, uint16_t size);
+
+  /** Get the maximum number of instructions supplied each cycle when fetch
+   * bypasses instruction memory. */
+  uint16_t getWidth() const;
+
+  /** Add the statistics of this cache to `stats`. */
+  void getStats(std::map<std::string, std::string>& stats) const;
+
+ private:
+  /** A way of the cache. */
+  struct Entry {
+    /** The address of the instruction held; all ones if the way is invalid.
+     */
+    uint64_t address = ~0ull;
+    /** The size of the instruction in bytes. */
+    uint8_t size = 0;
+    /** The lookup count when the way was filled or last used, for LRU
+     * replacement. */
+    uint64_t lastUsed = 0;
+    /** Unexecuted copies of the instruction's micro-ops. */
+    MacroOp macroOp;
+  };
+
+  /** Get the index of the first way of the set holding `address`. */
+  size_t getSet(uint64_t address) const;
+
+  /** The number of sets. */
+  size_t sets_;
+
+  /** The number of ways in each set. */
+  uint16_t ways_;
+
+  /** The maximum number of instructions supplied each cycle. */
+  uint16_t width_;
+
+  /** The ways of each set, indexed by `set * ways_ + way`. */
+  std::vector<Entry> entries_;
+
+  /** The number of supplies and fills made, used to order the ways for
+   * replacement. */
+  uint64_t accesses_ = 0;
+
+  /** Statistics. Hits and misses count the lookups which did and did not
+   * supply an instruction. */
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t invalidations_ = 0;
+};
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "simeng/Instruction.hh"
+
+namespace simeng {
+namespace pipeline {
+
+/** The text formats a pipeline trace may be converted to. */
+enum class PipelineTraceFormat { Konata, O3PipeView };
+
+/** The events recorded for a traced uop, in pipeline order. */
+enum class PipelineEvent : uint8_t {
+  Fetch,
+  Decode,
+  Rename,
+  Dispatch,
+  Issue,
+  Complete,
+  Commit,
+  Flush
+};
+
+/** Records the cycle in which each uop passes through each stage of the
+ * outoforder pipeline, and whether it was committed or flushed, for viewing
+ * with Konata or gem5's O3PipeView.
+ *
+ * Uops start being traced when fetched while the trace window is open; from
+ * cycle `startCycle` for `cycleCount` cycles, and from the `startInstruction`th
+ * retired instruction for `instructionCount` instructions. A count of 0 leaves
+ * that side of the window unbounded. Uops traced before the window closes
+ * continue to be followed until they leave the pipeline. A traced uop which
+ * leaves the pipeline without committing, either being marked as flushed or
+ * no longer held by any unit, is recorded as flushed.
+ *
+ * Events are buffered as fixed-size binary records and streamed to
+ * `<path>.bin`, keeping formatting out of the simulation. Once tracing ends,
+ * the records are converted to the requested text format at `path` and the
+ * binary file removed. */
+class PipelineTracer {
+ public:
+  /** Construct a tracer writing a trace in `format` to the file at `path`,
+   * over the cycle and instruction window described. */
+  PipelineTracer(const std::string& path, PipelineTraceFormat format,
+                 uint64_t startCycle, uint64_t cycleCount,
+                 uint64_t startInstruction, uint64_t instructionCount);
+
+  /** Convert the trace, if not yet done. */
+  ~PipelineTracer();
+
+  PipelineTracer(const PipelineTracer&) = delete;
+  PipelineTracer& operator=(const PipelineTracer&) = delete;
+
+  /** Start cycle `cycle`, `retired` instructions having been retired so far.
+   * Traced uops which left the pipeline without committing in the previous
+   * cycle are recorded as flushed in it. The cycles since the last call, if
+   * more than one, are treated as idle. */
+  void tick(uint64_t cycle, uint64_t retired);
+
+  /** Start tracing `uop`, fetched this cycle as the `microOpIndex`th uop of
+   * its macro-op, if the window is open. */
+  void fetch(const IntrusivePtr<Instruction>& uop, uint32_t microOpIndex);
+
+  /** Record `event` for `uop` in this cycle. Ignored if the uop is not traced,
+   * or has already passed a later event. */
+  void record(const IntrusivePtr<Instruction>& uop, PipelineEvent event);
+
+  /** Get the number of uops traced. */
+  uint64_t getTracedCount() const;
+
+  /** Write the remaining records and convert them to the text format. Uops
+   * still in flight are left open by Konata, and reported as flushed by
+   * O3PipeView. Further events are ignored. */
+  void finish();
+
+ private:
+  /** A binary trace record. */
+  struct Record {
+    /** The cycle of the event. */
+    uint64_t cycle;
+    /** The trace ID of the uop. */
+    uint64_t id;
+    /** The address of the uop's instruction; only set for fetch events. */
+    uint64_t address;
+    /** The index of the uop within its macro-op; only set for fetch events. */
+    uint32_t microOpIndex;
+    /** The event recorded. */
+    PipelineEvent event;
+  };
+
+  /** A uop being traced. */
+  struct TracedUop {
+    /** The uop; null once it has left the pipeline. */
+    IntrusivePtr<Instruction> uop;
+    /** The latest event recorded for it. */
+    PipelineEvent last;
+  };
+
+  /** Append a record of `event` for the uop traced as `id`. */
+  void write(uint64_t id, PipelineEvent event, uint64_t address = 0,
+             uint32_t microOpIndex = 0);
+
+  /** Write the buffered records to the binary file. */
+  void writeRecords();
+
+  /** Convert the records of `binary` to Konata's text format. */
+  void convertKonata(std::ifstream& binary);
+
+  /** Convert the records of `binary` to gem5's O3PipeView text format. */
+  void convertO3PipeView(std::ifstream& binary);
+
+  /** Read the next record of `binary` into `record`, returning false once
+   * none remain. */
+  bool readRecord(std::ifstream& binary, Record& record);
+
+  /** The path of the text trace. */
+  std::string path_;
+
+  /** The path of the intermediate binary trace. */
+  std::string binaryPath_;
+
+  /** The text format to convert to. */
+  PipelineTraceFormat format_;
+
+  /** The output streams of the text and binary traces. */
+  std::ofstream output_;
+  std::ofstream binary_;
+
+  /** The first cycle of the window, and its length; 0 if unbounded. */
+  uint64_t startCycle_;
+  uint64_t cycleCount_;
+
+  /** The retired instruction count opening the window, and the number of
+   * instructions it spans; 0 if unbounded. */
+  uint64_t startInstruction_;
+  uint64_t instructionCount_;
+
+  /** Whether the window is open, and whether it has since closed. */
+  bool windowOpen_ = false;
+  bool windowClosed_ = false;
+
+  /** Whether the trace has been converted. */
+  bool finished_ = false;
+
+  /** The current cycle. */
+  uint64_t cycle_ = 0;
+
+  /** The uops traced since the oldest still in flight, indexed by their trace
+   * ID less `firstTracedId_`. */
+  std::deque<TracedUop> traced_;
+
+  /** The trace ID of the first entry of `traced_`. */
+  uint64_t firstTracedId_ = 1;
+
+  /** The records not yet written to the binary file. */
+  std::vector<Record> records_;
+
+  /** The number of records buffered before they are written. */
+  static constexpr size_t bufferedRecords_ = 4096;
+};
+
+}  // namespace pipeline
+}  // namespace simeng
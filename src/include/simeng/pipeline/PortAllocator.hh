@@ -37,6 +37,12 @@ class PortAllocator {
 
   /** Tick the port allocator to allow it to process internal tasks. */
   virtual void tick() = 0;
+
+  /** Advance the port allocator by `ticks` ticks in which no instruction is
+   * dispatched or issued, as though `tick` had been called for each. */
+  virtual void skipTicks(uint64_t ticks) {
+    for (uint64_t i = 0; i < ticks; i++) tick();
+  }
 };
 
 }  // namespace pipeline
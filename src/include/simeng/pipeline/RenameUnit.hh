@@ -16,8 +16,8 @@ class RenameUnit {
  public:
   /** Construct a rename unit with a reference to input/output buffers, the
    * reorder buffer, and the register alias table. */
-  RenameUnit(PipelineBuffer<std::shared_ptr<Instruction>>& input,
-             PipelineBuffer<std::shared_ptr<Instruction>>& output,
+  RenameUnit(PipelineBuffer<IntrusivePtr<Instruction>>& input,
+             PipelineBuffer<IntrusivePtr<Instruction>>& output,
              ReorderBuffer& rob, RegisterAliasTable& rat, LoadStoreQueue& lsq,
              uint16_t registerTypes);
 
@@ -25,6 +25,15 @@ class RenameUnit {
    * space. */
   void tick();
 
+  /** Check whether ticking this unit would do nothing but count a stall: its
+   * input is stalled, and either its output is stalled or the oldest uop
+   * awaiting renaming is held back by a resource only commit can free. */
+  bool isIdle() const;
+
+  /** Advance the unit by `ticks` ticks, in which it must be idle, counting the
+   * stall each would have recorded. */
+  void skipTicks(uint64_t ticks);
+
   /** Retrieve the number of cycles this unit stalled due to an inability to
    * allocate enough destination registers. */
   uint64_t getAllocationStalls() const;
@@ -42,11 +51,19 @@ class RenameUnit {
   uint64_t getStoreQueueStalls() const;
 
  private:
+  /** What holds back the oldest uop awaiting renaming. */
+  enum class Stall { None, ROB, LoadQueue, StoreQueue, Allocation, Serialize };
+
+  /** Identify what would hold back the oldest uop awaiting renaming were the
+   * unit ticked now. Returns `Stall::None` if it would be renamed, or if no
+   * uop is waiting. */
+  Stall findStall() const;
+
   /** A buffer of instructions to rename. */
-  PipelineBuffer<std::shared_ptr<Instruction>>& input_;
+  PipelineBuffer<IntrusivePtr<Instruction>>& input_;
 
   /** A buffer to write renamed instructions to. */
-  PipelineBuffer<std::shared_ptr<Instruction>>& output_;
+  PipelineBuffer<IntrusivePtr<Instruction>>& output_;
 
   /** The reorder buffer. */
   ReorderBuffer& reorderBuffer_;
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <deque>
 #include <functional>
+#include <vector>
 
 #include "simeng/Instruction.hh"
 #include "simeng/pipeline/LoadStoreQueue.hh"
@@ -26,33 +26,56 @@ struct latestBranch {
 /** Check if the instruction ID is less/greater than a given value used by
  *  binary_search. */
 struct idCompare {
-  bool operator()(const std::shared_ptr<Instruction>& first,
+  bool operator()(const IntrusivePtr<Instruction>& first,
                   const uint64_t second) {
     return first->getInstructionId() < second;
   }
 
   bool operator()(const uint64_t first,
-                  const std::shared_ptr<Instruction>& second) {
+                  const IntrusivePtr<Instruction>& second) {
     return first < second->getInstructionId();
   }
 };
 
+/** The micro-ops of a single macro-op held in the ROB. */
+struct MicroOpGroup {
+  /** The instruction ID shared by the micro-ops. */
+  uint64_t insnId;
+
+  /** The position of the first micro-op in the ROB's reservation order. */
+  uint64_t first;
+
+  /** The number of micro-ops reserved so far. */
+  uint16_t size;
+
+  /** The number of leading micro-ops seen waiting to commit. */
+  uint16_t waiting;
+
+  /** Whether the last micro-op has been reserved. */
+  bool complete;
+};
+
 /** A Reorder Buffer (ROB) implementation. Contains an in-order queue of
- * in-flight instructions. */
+ * in-flight instructions, held in a ring buffer alongside a ring of the
+ * macro-op groups they belong to. Instruction IDs are never reused, so those
+ * of in-flight groups increase from the oldest and a group is found from its
+ * ID by binary search. */
 class ReorderBuffer {
  public:
   /** Constructs a reorder buffer of maximum size `maxSize`, supplying a
    * reference to the register alias table. */
   ReorderBuffer(
       unsigned int maxSize, RegisterAliasTable& rat, LoadStoreQueue& lsq,
-      std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
+      std::function<void(const IntrusivePtr<Instruction>&)> raiseException,
       std::function<void(uint64_t branchAddress)> sendLoopBoundary,
       BranchPredictor& predictor, uint16_t loopBufSize,
       uint16_t loopDetectionThreshold);
 
   /** Add the provided instruction to the ROB. */
-  void reserve(const std::shared_ptr<Instruction>& insn);
+  void reserve(const IntrusivePtr<Instruction>& insn);
 
+  /** Set the micro-ops of the macro-op with ID `insnId` ready to commit if
+   * all have been reserved and are waiting to commit. */
   void commitMicroOps(uint64_t insnId);
 
   /** Commit and remove up to `maxCommitSize` instructions. */
@@ -64,6 +87,10 @@ class ReorderBuffer {
   /** Retrieve the current size of the ROB. */
   unsigned int size() const;
 
+  /** Retrieve the oldest in-flight instruction, or a nullptr if the ROB is
+   * empty. */
+  IntrusivePtr<Instruction> getHead() const;
+
   /** Retrieve the current amount of free space in the ROB. */
   unsigned int getFreeSpace() const;
 
@@ -85,6 +112,11 @@ class ReorderBuffer {
   /** Get the number of speculated loads which violated load-store ordering. */
   uint64_t getViolatingLoadsCount() const;
 
+  /** Set a function to call with each instruction as it is committed, before
+   * any exception it raises. */
+  void setCommitObserver(
+      std::function<void(const IntrusivePtr<Instruction>&)> observer);
+
  private:
   /** A reference to the register alias table. */
   RegisterAliasTable& rat_;
@@ -96,19 +128,53 @@ class ReorderBuffer {
   unsigned int maxSize_;
 
   /** A function to call upon exception generation. */
-  std::function<void(std::shared_ptr<Instruction>)> raiseException_;
+  std::function<void(IntrusivePtr<Instruction>)> raiseException_;
 
   /** A function to send an instruction at a detected loop boundary. */
   std::function<void(uint64_t branchAddress)> sendLoopBoundary_;
 
+  /** A function to call with each committed instruction; empty if none has
+   * been set. */
+  std::function<void(const IntrusivePtr<Instruction>&)> commitObserver_;
+
   /** Whether or not a loop has been detected. */
   bool loopDetected_ = false;
 
   /** A reference to the current branch predictor. */
   BranchPredictor& predictor_;
 
-  /** The buffer containing in-flight instructions. */
-  std::deque<std::shared_ptr<Instruction>> buffer_;
+  /** Remove the oldest in-flight instruction. */
+  void popHead();
+
+  /** Get the instruction at position `pos` in reservation order. */
+  IntrusivePtr<Instruction>& at(uint64_t pos);
+
+  /** Get the group at position `index` from the oldest in-flight group. */
+  MicroOpGroup& group(uint64_t index);
+
+  /** Get the position from the oldest of the in-flight group with ID
+   * `insnId`; `groupCount_` if there is none. */
+  size_t findGroup(uint64_t insnId);
+
+  /** The ring buffer containing in-flight instructions, indexed by their
+   * position in reservation order modulo `maxSize_`. */
+  std::vector<IntrusivePtr<Instruction>> buffer_;
+
+  /** The position of the oldest in-flight instruction. */
+  uint64_t head_ = 0;
+
+  /** The position the next reserved instruction will take. */
+  uint64_t tail_ = 0;
+
+  /** The ring buffer of in-flight macro-op groups, oldest first from
+   * `groupHead_`. */
+  std::vector<MicroOpGroup> groups_;
+
+  /** The index of the oldest group within `groups_`. */
+  size_t groupHead_ = 0;
+
+  /** The number of in-flight groups. */
+  size_t groupCount_ = 0;
 
   /** Whether the core should be flushed after the most recent commit. */
   bool shouldFlush_ = false;
@@ -136,7 +202,8 @@ class ReorderBuffer {
   uint64_t seqId_ = 0;
 
   /** The next available instruction ID. Used to identify in-order groups of
-   * micro-operations. */
+   * micro-operations. Never rewound by a flush, so that the IDs of flushed
+   * instructions are not given to those reserved after them. */
   uint64_t insnId_ = 0;
 
   /** The number of instructions committed. */
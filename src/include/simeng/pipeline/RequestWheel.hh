@@ -0,0 +1,84 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "simeng/Instruction.hh"
+#include "simeng/memory/MemoryInterface.hh"
+
+namespace simeng {
+namespace pipeline {
+
+/** A requestQueue_ entry. */
+struct requestEntry {
+  /** The memory address(es) to be accessed. */
+  std::vector<simeng::memory::MemoryAccessTarget> reqAddresses;
+  /** The index of the next address in `reqAddresses` to request. */
+  size_t nextAddress = 0;
+  /** The instruction sending the request(s). */
+  IntrusivePtr<Instruction> insn;
+  /** The cycle the requests become ready to send. */
+  uint64_t readyAt = 0;
+};
+
+/** A timing wheel of memory requests waiting to become ready. Entries are
+ * placed into the slot of the cycle they become ready on, and moved in cycle
+ * order into a ready queue as the wheel is advanced, where they remain until
+ * all of their requests have been sent. Entries are drawn from a pool and
+ * recycled once removed, so that scheduling requests doesn't allocate. The
+ * wheel doubles in size if an entry is ready further ahead than it spans. */
+class RequestWheel {
+ public:
+  /** Construct a wheel spanning `slots` cycles, which must be a power of 2. */
+  RequestWheel(size_t slots = 64);
+
+  /** Add an entry for `insn` ready on cycle `readyAt`, returning it so that
+   * its addresses can be added. The reference is valid until the next
+   * insertion. */
+  requestEntry& insert(uint64_t readyAt, const IntrusivePtr<Instruction>& insn);
+
+  /** Move the entries ready on or before `cycle` into the ready queue. */
+  void advance(uint64_t cycle);
+
+  /** Whether any entries are ready. */
+  bool hasReady() const;
+
+  /** Get the oldest ready entry. */
+  requestEntry& front();
+
+  /** Remove the oldest ready entry. */
+  void popFront();
+
+  /** Whether the wheel holds no entries. */
+  bool empty() const;
+
+  /** Remove all entries whose instruction has been flushed. */
+  void removeFlushed();
+
+ private:
+  /** Return the entry at `index` to the pool. */
+  void release(uint32_t index);
+
+  /** The pool of entries. */
+  std::vector<requestEntry> entries_;
+
+  /** The indices of the unused entries in the pool. */
+  std::vector<uint32_t> freeEntries_;
+
+  /** The indices of the entries becoming ready on each cycle, in insertion
+   * order, indexed by the cycle modulo the number of slots. */
+  std::vector<std::vector<uint32_t>> slots_;
+
+  /** The indices of the ready entries, oldest first. */
+  std::deque<uint32_t> ready_;
+
+  /** The first cycle whose slot is yet to be moved into the ready queue. */
+  uint64_t nextCycle_ = 0;
+
+  /** The number of entries held, ready or not. */
+  size_t size_ = 0;
+};
+
+}  // namespace pipeline
+}  // namespace simeng
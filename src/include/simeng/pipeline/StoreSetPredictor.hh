@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "simeng/config/SimInfo.hh"
+
+namespace simeng {
+namespace pipeline {
+
+/** A store set memory dependence predictor. Loads and the stores they have
+ * previously read stale data ahead of are placed into the same store set,
+ * identified through a PC-indexed store set ID table (SSIT). The last fetched
+ * store table (LFST) records the most recent in-flight store of each set,
+ * which a load of the set is predicted to depend on. The SSIT is cleared every
+ * `Clear-Interval` predictions so that dependences which no longer occur are
+ * forgotten. */
+class StoreSetPredictor {
+ public:
+  /** Construct a store set predictor, reading its table sizes from the
+   * Memory-Dependence-Predictor section of `config`. */
+  StoreSetPredictor(ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
+  /** Record the store at `pc` with sequence ID `seqId` entering the pipeline,
+   * making it the last fetched store of its set. */
+  void addStore(uint64_t pc, uint64_t seqId);
+
+  /** Record the store at `pc` with sequence ID `seqId` generating its
+   * addresses, after which loads need no longer wait for it. */
+  void storeIssued(uint64_t pc, uint64_t seqId);
+
+  /** Predict the store the load at `pc` depends on, returning its sequence ID,
+   * or `UINT64_MAX` if the load is predicted independent. */
+  uint64_t predictDependence(uint64_t pc);
+
+  /** Train the predictor with a memory order violation between the load at
+   * `loadPC` and the store at `storePC`, placing both in the same set. */
+  void train(uint64_t loadPC, uint64_t storePC);
+
+ private:
+  /** Get the SSIT entry for the instruction at `pc`. */
+  uint16_t& getSetId(uint64_t pc);
+
+  /** The store set ID table; `invalidSet` marks entries without a set. */
+  std::vector<uint16_t> setIds_;
+
+  /** The last fetched store table, holding the sequence ID of the most recent
+   * in-flight store of each set, or `UINT64_MAX` if there is none. */
+  std::vector<uint64_t> lastStores_;
+
+  /** The number of predictions between clears of the SSIT. */
+  uint64_t clearInterval_;
+
+  /** The number of predictions made since the SSIT was last cleared. */
+  uint64_t predictions_ = 0;
+
+  /** The SSIT value of an instruction without a store set. */
+  static constexpr uint16_t invalidSet = UINT16_MAX;
+};
+
+}  // namespace pipeline
+}  // namespace simeng
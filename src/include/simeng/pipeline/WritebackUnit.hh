@@ -15,7 +15,7 @@ class WritebackUnit {
  public:
   /** Constructs a writeback unit with references to an input buffer and
    * register file to write to. */
-  WritebackUnit(std::vector<PipelineBuffer<std::shared_ptr<Instruction>>>&
+  WritebackUnit(std::vector<PipelineBuffer<IntrusivePtr<Instruction>>>&
                     completionSlots,
                 RegisterFileSet& registerFileSet,
                 std::function<void(uint64_t insnId)> flagMicroOpCommits);
@@ -23,12 +23,16 @@ class WritebackUnit {
   /** Tick the writeback unit to perform its operation for this cycle. */
   void tick();
 
+  /** Check whether ticking this unit would do nothing, as no completion slot
+   * holds an instruction. */
+  bool isIdle() const;
+
   /** Retrieve a count of the number of instructions retired. */
   uint64_t getInstructionsWrittenCount() const;
 
  private:
   /** Buffers of completed instructions to process. */
-  std::vector<PipelineBuffer<std::shared_ptr<Instruction>>>& completionSlots_;
+  std::vector<PipelineBuffer<IntrusivePtr<Instruction>>>& completionSlots_;
 
   /** The register file set to write results into. */
   RegisterFileSet& registerFileSet_;
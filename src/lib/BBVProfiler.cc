@@ -0,0 +1,67 @@
+#include "simeng/BBVProfiler.hh"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace simeng {
+
+BBVProfiler::BBVProfiler(const std::string& path, uint64_t intervalLength)
+    : intervalLength_(intervalLength) {
+  // Compress the output only if requested by its extension; the `T` mode
+  // writes the file without gzip encoding
+  bool compress =
+      path.size() > 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+  file_ = gzopen(path.c_str(), compress ? "wb" : "wbT");
+  if (file_ == nullptr) {
+    std::cerr << "[SimEng:BBVProfiler] Could not open " << path
+              << " for writing" << std::endl;
+    exit(1);
+  }
+  // Block IDs are numbered from 1, leaving index 0 unused
+  counts_.push_back(0);
+}
+
+BBVProfiler::~BBVProfiler() {
+  if (intervalInstructions_ > 0) endInterval();
+  gzclose(file_);
+}
+
+void BBVProfiler::record(uint64_t address, uint64_t instructions) {
+  if (instructions == 0) return;
+
+  auto [iter, inserted] = blockIds_.try_emplace(address, counts_.size());
+  uint32_t id = iter->second;
+  if (inserted) counts_.push_back(0);
+
+  // Split the block's instructions across interval boundaries, so that every
+  // interval covers exactly `intervalLength_` instructions
+  while (instructions > 0) {
+    uint64_t count =
+        std::min(instructions, intervalLength_ - intervalInstructions_);
+    if (counts_[id] == 0) executedBlocks_.push_back(id);
+    counts_[id] += count;
+    intervalInstructions_ += count;
+    instructions -= count;
+    if (intervalInstructions_ == intervalLength_) endInterval();
+  }
+}
+
+uint64_t BBVProfiler::getIntervalCount() const { return intervalCount_; }
+
+void BBVProfiler::endInterval() {
+  line_ = "T";
+  for (uint32_t id : executedBlocks_) {
+    line_ += ":" + std::to_string(id) + ":" + std::to_string(counts_[id]) + " ";
+    counts_[id] = 0;
+  }
+  line_ += "\n";
+  gzwrite(file_, line_.data(), line_.size());
+
+  executedBlocks_.clear();
+  intervalInstructions_ = 0;
+  intervalCount_++;
+}
+
+}  // namespace simeng
@@ -0,0 +1,224 @@
+#include "simeng/Checkpoint.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace simeng {
+
+/** Identifies a file as a SimEng checkpoint. */
+const char CHECKPOINT_MAGIC[8] = {'S', 'I', 'M', 'E', 'N', 'G', 'C', 'P'};
+
+/** The checkpoint format version; incremented on incompatible changes. */
+const uint32_t CHECKPOINT_VERSION = 2;
+
+/** The alignment of the process image within the file. A multiple of every
+ * common host page size, so that the image may always be mapped. */
+const uint64_t IMAGE_ALIGNMENT = 64 * 1024;
+
+/** The granularity at which zeroed regions of the image are omitted. */
+const uint64_t IMAGE_PAGE_SIZE = 4096;
+
+CheckpointWriter::CheckpointWriter(const std::string& isa) : isa_(isa) {}
+
+void CheckpointWriter::write(const std::string& value) {
+  write<uint64_t>(value.size());
+  state_.insert(state_.end(), value.begin(), value.end());
+}
+
+void CheckpointWriter::write(const RegisterValue& value) {
+  write<uint16_t>(value.size());
+  if (value.size() == 0) return;
+  const char* bytes = value.getAsVector<char>();
+  state_.insert(state_.end(), bytes, bytes + value.size());
+}
+
+void CheckpointWriter::write(const arch::ProcessStateChange& value) {
+  assert(value.memoryAddresses.empty() &&
+         "Memory changes cannot be written to a checkpoint");
+  write(value.type);
+  write<uint64_t>(value.modifiedRegisters.size());
+  for (size_t i = 0; i < value.modifiedRegisters.size(); i++) {
+    write(value.modifiedRegisters[i].type);
+    write(value.modifiedRegisters[i].tag);
+    write(value.modifiedRegisterValues[i]);
+  }
+}
+
+void CheckpointWriter::save(const std::string& path, const char* image,
+                            uint64_t imageSize) const {
+  // Assemble the header, which records where the image begins
+  std::vector<char> header(CHECKPOINT_MAGIC,
+                           CHECKPOINT_MAGIC + sizeof(CHECKPOINT_MAGIC));
+  auto append = [&header](const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    header.insert(header.end(), bytes, bytes + size);
+  };
+  uint64_t isaSize = isa_.size();
+  uint64_t stateSize = state_.size();
+  uint64_t headerSize = sizeof(CHECKPOINT_MAGIC) + sizeof(CHECKPOINT_VERSION) +
+                        sizeof(isaSize) + isaSize + 3 * sizeof(uint64_t);
+  uint64_t imageOffset =
+      ((headerSize + stateSize + IMAGE_ALIGNMENT - 1) / IMAGE_ALIGNMENT) *
+      IMAGE_ALIGNMENT;
+  append(&CHECKPOINT_VERSION, sizeof(CHECKPOINT_VERSION));
+  append(&isaSize, sizeof(isaSize));
+  append(isa_.data(), isaSize);
+  append(&stateSize, sizeof(stateSize));
+  append(&imageOffset, sizeof(imageOffset));
+  append(&imageSize, sizeof(imageSize));
+
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    std::cerr << "[SimEng:Checkpoint] Could not create checkpoint file "
+              << path << ": " << strerror(errno) << std::endl;
+    exit(1);
+  }
+
+  auto writeAt = [&](const char* data, uint64_t size, uint64_t offset) {
+    while (size > 0) {
+      ssize_t written = ::pwrite(fd, data, size, offset);
+      if (written < 0) {
+        std::cerr << "[SimEng:Checkpoint] Could not write checkpoint file "
+                  << path << ": " << strerror(errno) << std::endl;
+        exit(1);
+      }
+      data += written;
+      size -= written;
+      offset += written;
+    }
+  };
+
+  writeAt(header.data(), header.size(), 0);
+  writeAt(state_.data(), state_.size(), header.size());
+
+  // Only write pages of the image holding non-zero data, leaving holes in the
+  // file which read back as zeroes. Most of the heap, mmap and stack regions
+  // are typically untouched
+  static const char zeroPage[IMAGE_PAGE_SIZE] = {};
+  for (uint64_t page = 0; page < imageSize; page += IMAGE_PAGE_SIZE) {
+    uint64_t size = std::min(IMAGE_PAGE_SIZE, imageSize - page);
+    if (std::memcmp(image + page, zeroPage, size) != 0) {
+      writeAt(image + page, size, imageOffset + page);
+    }
+  }
+
+  // Extend the file over any trailing zero pages
+  if (::ftruncate(fd, imageOffset + imageSize) != 0) {
+    std::cerr << "[SimEng:Checkpoint] Could not size checkpoint file " << path
+              << ": " << strerror(errno) << std::endl;
+    exit(1);
+  }
+  ::close(fd);
+}
+
+CheckpointReader::CheckpointReader(const std::string& path) : path_(path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "[SimEng:Checkpoint] Could not open checkpoint file " << path
+              << std::endl;
+    exit(1);
+  }
+
+  char magic[sizeof(CHECKPOINT_MAGIC)];
+  uint32_t version = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  if (!file || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+      version != CHECKPOINT_VERSION) {
+    std::cerr << "[SimEng:Checkpoint] " << path
+              << " is not a compatible SimEng checkpoint" << std::endl;
+    exit(1);
+  }
+
+  uint64_t isaSize = 0;
+  uint64_t stateSize = 0;
+  file.read(reinterpret_cast<char*>(&isaSize), sizeof(isaSize));
+  isa_.resize(isaSize);
+  file.read(isa_.data(), isaSize);
+  file.read(reinterpret_cast<char*>(&stateSize), sizeof(stateSize));
+  file.read(reinterpret_cast<char*>(&imageOffset_), sizeof(imageOffset_));
+  file.read(reinterpret_cast<char*>(&imageSize_), sizeof(imageSize_));
+  state_.resize(stateSize);
+  file.read(state_.data(), stateSize);
+  if (!file) {
+    std::cerr << "[SimEng:Checkpoint] Checkpoint file " << path
+              << " is truncated" << std::endl;
+    exit(1);
+  }
+}
+
+void CheckpointReader::read(std::string& value) {
+  uint64_t size = 0;
+  read(size);
+  value.resize(size);
+  readBytes(value.data(), size);
+}
+
+void CheckpointReader::read(RegisterValue& value) {
+  uint16_t size = 0;
+  read(size);
+  if (size == 0) {
+    value = RegisterValue();
+    return;
+  }
+  std::vector<char> bytes(size);
+  readBytes(bytes.data(), size);
+  value = RegisterValue(bytes.data(), size);
+}
+
+void CheckpointReader::read(arch::ProcessStateChange& value) {
+  uint64_t count = 0;
+  read(value.type);
+  read(count);
+  value.modifiedRegisters.resize(count);
+  value.modifiedRegisterValues.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    read(value.modifiedRegisters[i].type);
+    read(value.modifiedRegisters[i].tag);
+    read(value.modifiedRegisterValues[i]);
+  }
+}
+
+const std::string& CheckpointReader::getISA() const { return isa_; }
+
+uint64_t CheckpointReader::getImageSize() const { return imageSize_; }
+
+std::shared_ptr<char> CheckpointReader::mapImage() const {
+  int fd = ::open(path_.c_str(), O_RDONLY);
+  void* image = MAP_FAILED;
+  if (fd >= 0) {
+    image = ::mmap(nullptr, imageSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                   fd, imageOffset_);
+    // The mapping remains valid once the file is closed
+    ::close(fd);
+  }
+  if (image == MAP_FAILED) {
+    std::cerr << "[SimEng:Checkpoint] Could not map the process image from "
+              << path_ << ": " << strerror(errno) << std::endl;
+    exit(1);
+  }
+
+  uint64_t size = imageSize_;
+  return std::shared_ptr<char>(static_cast<char*>(image),
+                               [size](char* ptr) { ::munmap(ptr, size); });
+}
+
+void CheckpointReader::readBytes(char* dest, uint64_t size) {
+  if (position_ + size > state_.size()) {
+    std::cerr << "[SimEng:Checkpoint] Checkpoint file " << path_
+              << " holds less state than expected" << std::endl;
+    exit(1);
+  }
+  std::memcpy(dest, state_.data() + position_, size);
+  position_ += size;
+}
+
+}  // namespace simeng
@@ -6,16 +6,20 @@ CoreInstance::CoreInstance(std::string executablePath,
                            std::vector<std::string> executableArgs,
                            ryml::ConstNodeRef config)
     : config_(config),
+      coreCount_(config_["CPU-Info"]["Core-Count"].as<uint16_t>()),
       kernel_(kernel::Linux(
-          config_["CPU-Info"]["Special-File-Dir-Path"].as<std::string>())) {
+          config_["CPU-Info"]["Special-File-Dir-Path"].as<std::string>(),
+          coreCount_)) {
   generateCoreModel(executablePath, executableArgs);
 }
 
 CoreInstance::CoreInstance(char* assembledSource, size_t sourceSize,
                            ryml::ConstNodeRef config)
     : config_(config),
+      coreCount_(config_["CPU-Info"]["Core-Count"].as<uint16_t>()),
       kernel_(kernel::Linux(
-          config_["CPU-Info"]["Special-File-Dir-Path"].as<std::string>())),
+          config_["CPU-Info"]["Special-File-Dir-Path"].as<std::string>(),
+          coreCount_)),
       source_(assembledSource),
       sourceSize_(sourceSize),
       assembledSource_(true) {
@@ -24,6 +28,17 @@ CoreInstance::CoreInstance(char* assembledSource, size_t sourceSize,
   generateCoreModel("", std::vector<std::string>{});
 }
 
+CoreInstance::CoreInstance(CheckpointReader& checkpoint,
+                           ryml::ConstNodeRef config)
+    : config_(config),
+      coreCount_(config_["CPU-Info"]["Core-Count"].as<uint16_t>()),
+      kernel_(kernel::Linux(
+          config_["CPU-Info"]["Special-File-Dir-Path"].as<std::string>(),
+          coreCount_)) {
+  restoreProcess(checkpoint);
+  generateMemoryAndCore();
+}
+
 CoreInstance::~CoreInstance() {
   if (source_) {
     delete[] source_;
@@ -33,6 +48,10 @@ CoreInstance::~CoreInstance() {
 void CoreInstance::generateCoreModel(std::string executablePath,
                                      std::vector<std::string> executableArgs) {
   createProcess(executablePath, executableArgs);
+  generateMemoryAndCore();
+}
+
+void CoreInstance::generateMemoryAndCore() {
   // Check to see if either of the instruction or data memory interfaces should
   // be created. Don't create the core if either interface is marked as External
   // as they must be set manually prior to the core's creation.
@@ -44,6 +63,8 @@ void CoreInstance::generateCoreModel(std::string executablePath,
   memory::MemInterfaceType dType = memory::MemInterfaceType::Flat;
   if (dType_string == "Fixed") {
     dType = memory::MemInterfaceType::Fixed;
+  } else if (dType_string == "Cache") {
+    dType = memory::MemInterfaceType::Cache;
   } else if (dType_string == "External") {
     dType = memory::MemInterfaceType::External;
   }
@@ -61,9 +82,21 @@ void CoreInstance::generateCoreModel(std::string executablePath,
   memory::MemInterfaceType iType = memory::MemInterfaceType::Flat;
   if (iType_string == "Fixed") {
     iType = memory::MemInterfaceType::Fixed;
+  } else if (iType_string == "Cache") {
+    iType = memory::MemInterfaceType::Cache;
   } else if (iType_string == "External") {
     iType = memory::MemInterfaceType::External;
   }
+
+  // Externally constructed memory interfaces are only supported for a single
+  // core
+  if (coreCount_ > 1 && (dType == memory::MemInterfaceType::External ||
+                         iType == memory::MemInterfaceType::External)) {
+    std::cerr << "[SimEng:CoreInstance] `External` memory interfaces are not "
+                 "supported when simulating more than one core."
+              << std::endl;
+    exit(1);
+  }
   // Create instruction memory if appropriate
   if (iType == memory::MemInterfaceType::External) {
     setInstructionMemory_ = true;
@@ -127,6 +160,45 @@ void CoreInstance::createProcess(std::string executablePath,
   return;
 }
 
+void CoreInstance::restoreProcess(CheckpointReader& checkpoint) {
+  std::string isa = config_["Core"]["ISA"].as<std::string>();
+  if (checkpoint.getISA() != isa) {
+    std::cerr << "[SimEng:CoreInstance] Cannot restore a checkpoint of an "
+              << checkpoint.getISA() << " process with the " << isa
+              << " ISA" << std::endl;
+    exit(1);
+  }
+
+  // Map the process image from the checkpoint, then restore the kernel's view
+  // of the process over the default state created for it
+  process_ = std::make_unique<kernel::LinuxProcess>(checkpoint, config_);
+  createProcessMemory();
+  kernel_.createProcess(*process_.get());
+  kernel_.restore(checkpoint);
+
+  // Read the thread running on each core, to be applied once they are created
+  uint16_t coreCount = 0;
+  checkpoint.read(coreCount);
+  if (coreCount != coreCount_) {
+    std::cerr << "[SimEng:CoreInstance] Checkpoint was taken with " << coreCount
+              << " cores, but " << coreCount_ << " are configured"
+              << std::endl;
+    exit(1);
+  }
+  restoredThreads_.resize(coreCount_);
+  for (auto& thread : restoredThreads_) {
+    bool running = false;
+    checkpoint.read(running);
+    if (!running) continue;
+    thread.emplace();
+    checkpoint.read(thread->tid);
+    checkpoint.read(thread->pc);
+    checkpoint.read(thread->registers);
+  }
+
+  return;
+}
+
 void CoreInstance::createProcessMemory() {
   // Get the process image and its size
   processMemory_ = process_->getProcessImage();
@@ -137,21 +209,33 @@ void CoreInstance::createProcessMemory() {
 
 void CoreInstance::createL1InstructionMemory(
     const memory::MemInterfaceType type) {
-  // Create a L1I cache instance based on type supplied
-  if (type == memory::MemInterfaceType::Flat) {
-    instructionMemory_ = std::make_shared<memory::FlatMemoryInterface>(
-        processMemory_.get(), processMemorySize_);
-  } else if (type == memory::MemInterfaceType::Fixed) {
-    uint16_t accessLat =
-        config_["LSQ-L1-Interface"]["Access-Latency"].as<uint16_t>();
-    instructionMemory_ = std::make_shared<memory::FixedLatencyMemoryInterface>(
-        processMemory_.get(), processMemorySize_, accessLat);
-  } else {
-    std::cerr
-        << "[SimEng:CoreInstance] Unsupported memory interface type used in "
-           "createL1InstructionMemory()."
-        << std::endl;
-    exit(1);
+  // Create a L1I cache instance per core based on type supplied. Each
+  // instance is a private view of the shared process memory
+  for (uint16_t i = 0; i < coreCount_; i++) {
+    if (type == memory::MemInterfaceType::Flat) {
+      instructionMemories_.push_back(
+          std::make_shared<memory::FlatMemoryInterface>(processMemory_.get(),
+                                                        processMemorySize_));
+    } else if (type == memory::MemInterfaceType::Fixed) {
+      uint16_t accessLat =
+          config_["LSQ-L1-Interface"]["Access-Latency"].as<uint16_t>();
+      instructionMemories_.push_back(
+          std::make_shared<memory::FixedLatencyMemoryInterface>(
+              processMemory_.get(), processMemorySize_, accessLat));
+    } else if (type == memory::MemInterfaceType::Cache) {
+      auto l1i = std::make_shared<memory::Cache>(
+          "l1i", config_["L1-Instruction-Memory"], getCacheBelowL1(i),
+          config_["Main-Memory"]["Access-Latency"].as<uint16_t>());
+      instructionMemories_.push_back(
+          std::make_shared<memory::CacheMemoryInterface>(
+              processMemory_.get(), processMemorySize_, l1i));
+    } else {
+      std::cerr
+          << "[SimEng:CoreInstance] Unsupported memory interface type used in "
+             "createL1InstructionMemory()."
+          << std::endl;
+      exit(1);
+    }
   }
 
   return;
@@ -163,49 +247,95 @@ void CoreInstance::setL1InstructionMemory(
          "setL1InstructionMemory(...) called but the interface was created by "
          "the CoreInstance class.");
   // Set the L1I cache instance to use
-  instructionMemory_ = memRef;
+  instructionMemories_ = {memRef};
   return;
 }
 
 void CoreInstance::createL1DataMemory(const memory::MemInterfaceType type) {
-  // Create a L1D cache instance based on type supplied
-  if (type == memory::MemInterfaceType::Flat) {
-    dataMemory_ = std::make_shared<memory::FlatMemoryInterface>(
-        processMemory_.get(), processMemorySize_);
-  } else if (type == memory::MemInterfaceType::Fixed) {
-    uint16_t accessLat =
-        config_["LSQ-L1-Interface"]["Access-Latency"].as<uint16_t>();
-    dataMemory_ = std::make_shared<memory::FixedLatencyMemoryInterface>(
-        processMemory_.get(), processMemorySize_, accessLat);
-  } else {
-    std::cerr << "[SimEng:CoreInstance] Unsupported memory interface type used "
-                 "in createL1DataMemory()."
-              << std::endl;
-    exit(1);
+  // Create a L1D cache instance per core based on type supplied. Each
+  // instance is a private view of the shared process memory
+  for (uint16_t i = 0; i < coreCount_; i++) {
+    if (type == memory::MemInterfaceType::Flat) {
+      dataMemories_.push_back(std::make_shared<memory::FlatMemoryInterface>(
+          processMemory_.get(), processMemorySize_));
+    } else if (type == memory::MemInterfaceType::Fixed) {
+      uint16_t accessLat =
+          config_["LSQ-L1-Interface"]["Access-Latency"].as<uint16_t>();
+      dataMemories_.push_back(
+          std::make_shared<memory::FixedLatencyMemoryInterface>(
+              processMemory_.get(), processMemorySize_, accessLat));
+    } else if (type == memory::MemInterfaceType::Cache) {
+      auto l1d = std::make_shared<memory::Cache>(
+          "l1d", config_["L1-Data-Memory"], getCacheBelowL1(i),
+          config_["Main-Memory"]["Access-Latency"].as<uint16_t>());
+      // Each core trains its own prefetchers on its own loads
+      std::vector<std::unique_ptr<memory::Prefetcher>> prefetchers;
+      uint16_t lineSize = l1d->getLineSize();
+      if (config_["Data-Prefetcher"]["Next-Line"].as<bool>())
+        prefetchers.push_back(std::make_unique<memory::NextLinePrefetcher>(
+            lineSize, config_));
+      if (config_["Data-Prefetcher"]["Stride"].as<bool>())
+        prefetchers.push_back(
+            std::make_unique<memory::StridePrefetcher>(lineSize, config_));
+      if (config_["Data-Prefetcher"]["Stream"].as<bool>())
+        prefetchers.push_back(
+            std::make_unique<memory::StreamPrefetcher>(lineSize, config_));
+      dataMemories_.push_back(std::make_shared<memory::CacheMemoryInterface>(
+          processMemory_.get(), processMemorySize_, l1d,
+          std::move(prefetchers)));
+    } else {
+      std::cerr
+          << "[SimEng:CoreInstance] Unsupported memory interface type used "
+             "in createL1DataMemory()."
+          << std::endl;
+      exit(1);
+    }
   }
 
   return;
 }
 
+std::shared_ptr<memory::Cache> CoreInstance::getCacheBelowL1(uint16_t core) {
+  uint16_t memoryLatency =
+      config_["Main-Memory"]["Access-Latency"].as<uint16_t>();
+  // The last-level cache is shared by every core, so may be accessed from
+  // several host threads at once
+  if (!lastLevelCache_ &&
+      config_["Last-Level-Cache"]["Size"].as<uint64_t>() > 0) {
+    lastLevelCache_ = std::make_shared<memory::Cache>(
+        "llc", config_["Last-Level-Cache"], nullptr, memoryLatency,
+        coreCount_ > 1);
+  }
+  if (config_["L2-Cache"]["Size"].as<uint64_t>() == 0) return lastLevelCache_;
+
+  // Each core's L2 cache is shared by its L1 instruction and data caches
+  if (l2Caches_.size() <= core) l2Caches_.resize(core + 1);
+  if (!l2Caches_[core]) {
+    l2Caches_[core] = std::make_shared<memory::Cache>(
+        "l2", config_["L2-Cache"], lastLevelCache_, memoryLatency);
+  }
+  return l2Caches_[core];
+}
+
 void CoreInstance::setL1DataMemory(
     std::shared_ptr<memory::MemoryInterface> memRef) {
   assert(setDataMemory_ &&
          "setL1DataMemory(...) called but the interface was created by the "
          "CoreInstance class.");
   // Set the L1D cache instance to use
-  dataMemory_ = memRef;
+  dataMemories_ = {memRef};
   return;
 }
 
 void CoreInstance::createCore() {
   // If memory interfaces must be manually set, ensure they have been
-  if (setDataMemory_ && (dataMemory_ == nullptr)) {
+  if (setDataMemory_ && dataMemories_.empty()) {
     std::cerr << "[SimEng:CoreInstance] Data memory not set. External Data "
                  "memory must be manually "
                  "set using the setL1DataMemory(...) function."
               << std::endl;
     exit(1);
-  } else if (setInstructionMemory_ && (instructionMemory_ == nullptr)) {
+  } else if (setInstructionMemory_ && instructionMemories_.empty()) {
     std::cerr << "[SimEng:CoreInstance] Instruction memory not set. External "
                  "instruction memory "
                  "interface must be manually set using the "
@@ -214,21 +344,6 @@ void CoreInstance::createCore() {
     exit(1);
   }
 
-  // Create the architecture, with knowledge of the OS
-  if (config::SimInfo::getISA() == config::ISA::RV64) {
-    arch_ = std::make_unique<arch::riscv::Architecture>(kernel_);
-  } else if (config::SimInfo::getISA() == config::ISA::AArch64) {
-    arch_ = std::make_unique<arch::aarch64::Architecture>(kernel_);
-  }
-
-  std::string predictorType =
-      config_["Branch-Predictor"]["Type"].as<std::string>();
-  if (predictorType == "Generic") {
-    predictor_ = std::make_unique<GenericPredictor>();
-  } else if (predictorType == "Perceptron") {
-    predictor_ = std::make_unique<PerceptronPredictor>();
-  }
-
   // Extract the port arrangement from the config file
   auto config_ports = config_["Ports"];
   std::vector<std::vector<uint16_t>> portArrangement(
@@ -241,27 +356,106 @@ void CoreInstance::createCore() {
       portArrangement[i].push_back(grp);
     }
   }
-  portAllocator_ =
-      std::make_unique<pipeline::BalancedPortAllocator>(portArrangement);
-
-  // Construct the core object based on the defined simulation mode
+  std::string predictorType =
+      config_["Branch-Predictor"]["Type"].as<std::string>();
   uint64_t entryPoint = process_->getEntryPoint();
-  if (config::SimInfo::getSimMode() == config::SimulationMode::Emulation) {
-    core_ = std::make_shared<models::emulation::Core>(
-        *instructionMemory_, *dataMemory_, entryPoint, processMemorySize_,
-        *arch_);
-  } else if (config::SimInfo::getSimMode() ==
-             config::SimulationMode::InOrderPipelined) {
-    core_ = std::make_shared<models::inorder::Core>(
-        *instructionMemory_, *dataMemory_, processMemorySize_, entryPoint,
-        *arch_, *predictor_);
-  } else if (config::SimInfo::getSimMode() ==
-             config::SimulationMode::Outoforder) {
-    core_ = std::make_shared<models::outoforder::Core>(
-        *instructionMemory_, *dataMemory_, processMemorySize_, entryPoint,
-        *arch_, *predictor_, *portAllocator_, config_);
+  // Derive the ISA and simulation mode from this instance's config rather
+  // than the process-wide SimInfo, so differently configured instances may
+  // coexist
+  std::string isaString = config_["Core"]["ISA"].as<std::string>();
+  std::string simMode = config_["Core"]["Simulation-Mode"].as<std::string>();
+
+  // Exclusive stores and atomics are made atomic across cores by a monitor
+  // shared between their architectures
+  if (coreCount_ > 1) {
+    exclusiveMonitor_ = std::make_unique<memory::ExclusiveMonitor>(
+        processMemory_.get(), processMemorySize_, coreCount_);
   }
 
+  // Writes by any core or syscall invalidate code cached from the memory
+  pageGenerations_ =
+      std::make_unique<memory::PageGenerations>(processMemorySize_);
+
+  for (uint16_t i = 0; i < coreCount_; i++) {
+    // Create the architecture, with knowledge of the OS
+    if (isaString == "rv64") {
+      archs_.push_back(
+          std::make_unique<arch::riscv::Architecture>(kernel_, config_));
+    } else if (isaString == "AArch64") {
+      archs_.push_back(
+          std::make_unique<arch::aarch64::Architecture>(kernel_, config_));
+    }
+    archs_.back()->setExclusiveMonitor(exclusiveMonitor_.get(), i);
+    archs_.back()->setPageGenerations(pageGenerations_.get());
+
+    if (predictorType == "Generic") {
+      predictors_.push_back(std::make_unique<GenericPredictor>(config_));
+    } else if (predictorType == "Perceptron") {
+      predictors_.push_back(std::make_unique<PerceptronPredictor>(config_));
+    } else if (predictorType == "TAGE") {
+      predictors_.push_back(std::make_unique<TagePredictor>(config_));
+    }
+
+    portAllocators_.push_back(
+        std::make_unique<pipeline::BalancedPortAllocator>(portArrangement));
+
+    // Construct the core object based on the defined simulation mode
+    memory::MemoryInterface& instructionMemory = *instructionMemories_[i];
+    memory::MemoryInterface& dataMemory = *dataMemories_[i];
+    arch::Architecture& isa = *archs_[i];
+    std::shared_ptr<Core> core;
+    if (simMode == "emulation") {
+      core = std::make_shared<models::emulation::Core>(
+          instructionMemory, dataMemory, entryPoint, processMemorySize_, isa,
+          config_);
+    } else if (simMode == "inorderpipelined") {
+      core = std::make_shared<models::inorder::Core>(
+          instructionMemory, dataMemory, processMemorySize_, entryPoint, isa,
+          *predictors_[i], config_);
+    } else if (simMode == "outoforder") {
+      core = std::make_shared<models::outoforder::Core>(
+          instructionMemory, dataMemory, processMemorySize_, entryPoint, isa,
+          *predictors_[i], *portAllocators_[i], config_);
+    }
+
+    // Only the first core runs the process' main thread; the rest idle until
+    // a thread is scheduled onto them
+    if (i > 0) core->halt();
+
+    // When restoring from a checkpoint, each core resumes the thread it was
+    // running, if any
+    if (!restoredThreads_.empty()) {
+      core->halt();
+      const auto& thread = restoredThreads_[i];
+      if (thread.has_value()) {
+        core->schedule(thread->tid, thread->pc, thread->registers);
+      }
+    }
+    cores_.push_back(core);
+  }
+
+  // A sampled simulation fast-forwards the first core's thread on an
+  // emulation core, sharing its architecture. It holds its own flat views of
+  // the process memory, so the detailed core's memory timing is unaffected
+  if (config_["Sampling"]["Mode"].as<std::string>() != "None") {
+    functionalInstructionMemory_ =
+        std::make_shared<memory::FlatMemoryInterface>(processMemory_.get(),
+                                                      processMemorySize_);
+    functionalDataMemory_ = std::make_shared<memory::FlatMemoryInterface>(
+        processMemory_.get(), processMemorySize_);
+    functionalCore_ = std::make_shared<models::emulation::Core>(
+        *functionalInstructionMemory_, *functionalDataMemory_, entryPoint,
+        processMemorySize_, *archs_[0], config_);
+    if (!restoredThreads_.empty()) {
+      functionalCore_->halt();
+      const auto& thread = restoredThreads_[0];
+      if (thread.has_value()) {
+        functionalCore_->schedule(thread->tid, thread->pc, thread->registers);
+      }
+    }
+  }
+  restoredThreads_.clear();
+
   createSpecialFileDirectory();
 
   return;
@@ -269,8 +463,8 @@ void CoreInstance::createCore() {
 
 void CoreInstance::createSpecialFileDirectory() {
   // Create the Special Files directory if indicated to do so in Config
-  if (config::SimInfo::getGenSpecFiles()) {
-    SpecialFileDirGen SFdir = SpecialFileDirGen();
+  if (config_["CPU-Info"]["Generate-Special-Dir"].as<bool>()) {
+    SpecialFileDirGen SFdir = SpecialFileDirGen(config_);
     // Remove any current special files dir
     SFdir.RemoveExistingSFDir();
     // Create new special files dir
@@ -281,7 +475,7 @@ void CoreInstance::createSpecialFileDirectory() {
 }
 
 std::shared_ptr<Core> CoreInstance::getCore() const {
-  if (core_ == nullptr) {
+  if (cores_.empty()) {
     std::cerr
         << "[SimEng:CoreInstance] Core object not constructed. If either data "
            "or instruction memory "
@@ -290,27 +484,117 @@ std::shared_ptr<Core> CoreInstance::getCore() const {
         << std::endl;
     exit(1);
   }
-  return core_;
+  return cores_[0];
 }
 
-std::shared_ptr<memory::MemoryInterface> CoreInstance::getDataMemory() const {
-  if (setDataMemory_ && (dataMemory_ == nullptr)) {
+const std::vector<std::shared_ptr<Core>>& CoreInstance::getCores() const {
+  return cores_;
+}
+
+std::shared_ptr<Core> CoreInstance::getFunctionalCore() const {
+  return functionalCore_;
+}
+
+std::shared_ptr<memory::MemoryInterface> CoreInstance::getDataMemory(
+    uint16_t coreId) const {
+  if (setDataMemory_ && dataMemories_.empty()) {
     std::cerr << "[SimEng:CoreInstance] `External` data memory object not set."
               << std::endl;
     exit(1);
   }
-  return dataMemory_;
+  return dataMemories_[coreId];
 }
 
-std::shared_ptr<memory::MemoryInterface> CoreInstance::getInstructionMemory()
-    const {
-  if (setInstructionMemory_ && (instructionMemory_ == nullptr)) {
+std::shared_ptr<memory::MemoryInterface> CoreInstance::getInstructionMemory(
+    uint16_t coreId) const {
+  if (setInstructionMemory_ && instructionMemories_.empty()) {
     std::cerr
         << "`[SimEng:CoreInstance] External` instruction memory object not set."
         << std::endl;
     exit(1);
   }
-  return instructionMemory_;
+  return instructionMemories_[coreId];
+}
+
+void CoreInstance::scheduleThreads() {
+  // Once the process has exited, no thread may continue to run
+  if (kernel_.hasExited()) {
+    for (auto& core : cores_) core->halt();
+    return;
+  }
+
+  // Place pending threads onto idle cores in core ID order, clearing any
+  // reservation left behind by the previous thread
+  for (uint16_t i = 0; i < cores_.size(); i++) {
+    if (!kernel_.hasPendingThreads()) return;
+    if (cores_[i]->hasHalted()) {
+      kernel::LinuxThreadContext thread = kernel_.takePendingThread();
+      archs_[i]->clearReservation();
+      cores_[i]->schedule(thread.tid, thread.pc, thread.registers);
+    }
+  }
+}
+
+bool CoreInstance::hasHalted() const {
+  if (kernel_.hasPendingThreads() && !kernel_.hasExited()) return false;
+  for (const auto& core : cores_) {
+    if (!core->hasHalted()) return false;
+  }
+  return true;
+}
+
+bool CoreInstance::saveCheckpoint(const std::string& path) const {
+  if (config_["Core"]["Simulation-Mode"].as<std::string>() != "emulation") {
+    std::cerr << "[SimEng:CoreInstance] Checkpoints may only be saved in "
+                 "emulation mode"
+              << std::endl;
+    exit(1);
+  }
+
+  // Every running core must be between instructions for its registers and
+  // program counter to capture its state
+  for (const auto& core : cores_) {
+    const auto& emulationCore =
+        static_cast<const models::emulation::Core&>(*core);
+    if (!core->hasHalted() && !emulationCore.isBetweenInstructions())
+      return false;
+  }
+
+  CheckpointWriter checkpoint(config_["Core"]["ISA"].as<std::string>());
+  process_->checkpoint(checkpoint);
+  kernel_.checkpoint(checkpoint);
+
+  // Record the thread running on each core, with the value of every
+  // architectural register
+  checkpoint.write(coreCount_);
+  for (size_t i = 0; i < cores_.size(); i++) {
+    const auto& core = cores_[i];
+    checkpoint.write<bool>(!core->hasHalted());
+    if (core->hasHalted()) continue;
+
+    checkpoint.write(core->getThreadId());
+    checkpoint.write(
+        static_cast<const models::emulation::Core&>(*core).getProgramCounter());
+    checkpoint.write(getRegisterState(*core));
+  }
+
+  checkpoint.save(path, processMemory_.get(), processMemorySize_);
+  return true;
+}
+
+arch::ProcessStateChange CoreInstance::getRegisterState(
+    const Core& core) const {
+  arch::ProcessStateChange registers = {arch::ChangeType::REPLACEMENT, {}, {}};
+  // Every core shares the same architectural register structure
+  const auto& regFileStruct = archs_[0]->getArchRegStruct();
+  const auto& regFile = core.getArchitecturalRegisterFileSet();
+  for (uint8_t type = 0; type < regFileStruct.size(); type++) {
+    for (uint16_t tag = 0; tag < regFileStruct[type].quantity; tag++) {
+      registers.modifiedRegisters.push_back({type, tag});
+      registers.modifiedRegisterValues.push_back(regFile.get({type, tag}));
+    }
+  }
+  return registers;
 }
 
 std::shared_ptr<char> CoreInstance::getProcessImage() const {
@@ -14,7 +14,7 @@ namespace simeng {
  * https://man7.org/linux/man-pages/man5/elf.5.html
  */
 
-Elf::Elf(std::string path, char** imagePointer) {
+Elf::Elf(std::string path) : path_(path) {
   std::ifstream file(path, std::ios::binary);
 
   if (!file.is_open()) {
@@ -165,7 +165,13 @@ Elf::Elf(std::string path, char** imagePointer) {
     }
   }
 
-  *imagePointer = (char*)malloc(processImageSize_ * sizeof(char));
+  file.close();
+  return;
+}
+
+void Elf::load(char* image) const {
+  std::ifstream file(path_, std::ios::binary);
+
   /**
    * The ELF Program header has a member called `p_type`, which represents
    * the kind of data or memory segments described by the program header.
@@ -174,18 +180,19 @@ Elf::Elf(std::string path, char** imagePointer) {
    * memory image.
    */
 
-  // Process headers; only observe LOAD sections for this basic implementation
+  // Process headers; only observe LOAD sections for this basic implementation.
+  // Any remainder of a segment's memory size beyond its file size (e.g. .bss)
+  // is left as the zeroes the image was created with
   for (const auto& header : pheaders_) {
     if (header.p_type == 1) {  // LOAD
       file.seekg(header.p_offset);
       // Read `p_filesz` bytes from `file` into the appropriate place in process
       // memory
-      file.read(*imagePointer + header.p_vaddr, header.p_filesz);
+      file.read(image + header.p_vaddr, header.p_filesz);
     }
   }
 
   file.close();
-  return;
 }
 
 Elf::~Elf() {}
@@ -0,0 +1,139 @@
+#include "simeng/ParallelCoreDriver.hh"
+
+#include <algorithm>
+#include <thread>
+
+namespace simeng {
+
+ParallelCoreDriver::ParallelCoreDriver(CoreInstance& coreInstance,
+                                       uint16_t hostThreads, uint64_t quantum)
+    : coreInstance_(coreInstance),
+      workerCount_(std::max<uint16_t>(
+          1, std::min<size_t>(hostThreads, coreInstance.getCores().size()))),
+      quantum_(std::max<uint64_t>(quantum, 1)),
+      workerCores_(workerCount_),
+      waiting_(workerCount_),
+      workerTicks_(workerCount_) {
+  // Distribute the cores between host threads in a round-robin fashion
+  for (size_t i = 0; i < coreInstance_.getCores().size(); i++) {
+    workerCores_[i % workerCount_].push_back(i);
+    instructionMemories_.push_back(
+        coreInstance_.getInstructionMemory(i).get());
+    dataMemories_.push_back(coreInstance_.getDataMemory(i).get());
+  }
+}
+
+uint64_t ParallelCoreDriver::run() {
+  finished_ = coreInstance_.hasHalted() && isIdle(0);
+  for (uint16_t worker = 1; worker < workerCount_ && finished_; worker++) {
+    finished_ = isIdle(worker);
+  }
+
+  // The calling thread acts as the first worker
+  std::vector<std::thread> threads;
+  for (uint16_t worker = 1; worker < workerCount_; worker++) {
+    threads.emplace_back(&ParallelCoreDriver::work, this, worker);
+  }
+  work(0);
+  for (auto& thread : threads) thread.join();
+
+  return iterations_;
+}
+
+void ParallelCoreDriver::work(uint16_t worker) {
+  while (!finished_) {
+    synchronise(worker, tickQuantum(worker));
+  }
+}
+
+uint64_t ParallelCoreDriver::tickQuantum(uint16_t worker) {
+  uint64_t ticks = 0;
+  while (ticks < quantum_ && !isIdle(worker)) {
+    ticks += advance(worker, quantum_ - ticks);
+  }
+  return ticks;
+}
+
+uint64_t ParallelCoreDriver::advance(uint16_t worker, uint64_t maxTicks) {
+  const auto& cores = coreInstance_.getCores();
+  // Skip to the next cycle in which something happens, up to the end of the
+  // quantum, when another host thread's cores may wake this worker's
+  uint64_t idleTicks = std::min(getIdleTicks(worker), maxTicks);
+  if (idleTicks > 0) {
+    for (uint16_t coreId : workerCores_[worker]) {
+      cores[coreId]->skipTicks(idleTicks);
+      instructionMemories_[coreId]->skipTicks(idleTicks);
+      dataMemories_[coreId]->skipTicks(idleTicks);
+    }
+    return idleTicks;
+  }
+
+  for (uint16_t coreId : workerCores_[worker]) {
+    cores[coreId]->tick();
+    instructionMemories_[coreId]->tick();
+    dataMemories_[coreId]->tick();
+  }
+  return 1;
+}
+
+uint64_t ParallelCoreDriver::getIdleTicks(uint16_t worker) const {
+  const auto& cores = coreInstance_.getCores();
+  uint64_t idleTicks = UINT64_MAX;
+  for (uint16_t coreId : workerCores_[worker]) {
+    idleTicks = std::min({idleTicks, cores[coreId]->getIdleTicks(),
+                          instructionMemories_[coreId]->getIdleTicks(),
+                          dataMemories_[coreId]->getIdleTicks()});
+  }
+  return idleTicks;
+}
+
+bool ParallelCoreDriver::isIdle(uint16_t worker) const {
+  const auto& cores = coreInstance_.getCores();
+  for (uint16_t coreId : workerCores_[worker]) {
+    if (!cores[coreId]->hasHalted() ||
+        dataMemories_[coreId]->hasPendingRequests())
+      return false;
+  }
+  return true;
+}
+
+void ParallelCoreDriver::synchronise(uint16_t worker, uint64_t ticks) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  quantumTicks_ = std::max(quantumTicks_, ticks);
+  workerTicks_[worker] = ticks;
+
+  if (--waiting_ == 0) {
+    // Last to arrive; complete the quantum and release the other host threads
+    endQuantum();
+    waiting_ = workerCount_;
+    generation_++;
+    quantumDone_.notify_all();
+    return;
+  }
+
+  uint64_t generation = generation_;
+  quantumDone_.wait(lock, [&] { return generation_ != generation; });
+}
+
+void ParallelCoreDriver::endQuantum() {
+  // The quantum lasts as long as the host thread which ticked the longest;
+  // all others stopped early as their cores were idle, so their clocks are
+  // brought up to the end of the quantum as though they had been ticked
+  for (uint16_t worker = 0; worker < workerCount_; worker++) {
+    for (uint64_t ticks = workerTicks_[worker]; ticks < quantumTicks_;) {
+      ticks += advance(worker, quantumTicks_ - ticks);
+    }
+  }
+  iterations_ += quantumTicks_;
+  quantumTicks_ = 0;
+
+  // Place any newly created threads onto idle cores
+  coreInstance_.scheduleThreads();
+
+  finished_ = coreInstance_.hasHalted();
+  for (uint16_t worker = 0; worker < workerCount_ && finished_; worker++) {
+    finished_ = isIdle(worker);
+  }
+}
+
+}  // namespace simeng
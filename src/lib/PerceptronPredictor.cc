@@ -1,31 +1,64 @@
 #include "simeng/PerceptronPredictor.hh"
 
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
 namespace simeng {
 
+namespace {
+
+/** The history signs of each value of a byte of history, least significant
+ * bit first. */
+constexpr std::array<std::array<int8_t, 8>, 256> expandedBytes = [] {
+  std::array<std::array<int8_t, 8>, 256> table = {};
+  for (size_t byte = 0; byte < 256; byte++) {
+    for (size_t bit = 0; bit < 8; bit++) {
+      table[byte][bit] = ((byte >> bit) & 1) ? 1 : -1;
+    }
+  }
+  return table;
+}();
+
+}  // namespace
+
 PerceptronPredictor::PerceptronPredictor(ryml::ConstNodeRef config)
     : btbBits_(config["Branch-Predictor"]["BTB-Tag-Bits"].as<uint64_t>()),
       globalHistoryLength_(
           config["Branch-Predictor"]["Global-History-Length"].as<uint64_t>()),
       rasSize_(config["Branch-Predictor"]["RAS-entries"].as<uint64_t>()) {
-  // Build BTB based on config options
-  uint32_t btbSize = (1 << btbBits_);
-  btb_.resize(btbSize);
+  // The global history is held in 64 bits, the length being bounded by the
+  // config validation
+  globalHistoryMask_ = (globalHistoryLength_ == 64)
+                           ? ~0ull
+                           : (1ull << globalHistoryLength_) - 1;
+
+  // Build BTB based on config options, padding each perceptron to a whole
+  // number of aligned blocks
+  uint64_t btbSize = (1ull << btbBits_);
+  perceptronStride_ = ((globalHistoryLength_ + perceptronAlignment_ - 1) /
+                       perceptronAlignment_) *
+                      perceptronAlignment_;
+  weights_.resize(btbSize * perceptronStride_ + perceptronAlignment_ - 1, 0);
+  weightsOffset_ = (perceptronAlignment_ -
+                    reinterpret_cast<uintptr_t>(weights_.data()) %
+                        perceptronAlignment_) %
+                   perceptronAlignment_;
   // Initialise perceptron values with 0 for the global history weights, and 1
   // for the bias weight; and initialise the target with 0 (i.e., unknown)
-  for (int i = 0; i < btbSize; i++) {
-    btb_[i].first.assign(globalHistoryLength_, 0);
-    btb_[i].first.push_back(1);
-    btb_[i].second = 0;
-  }
+  biases_.resize(btbSize, 1);
+  targets_.resize(btbSize, 0);
+
+  // Leave room for expanding the history a byte at a time
+  historySigns_.resize(perceptronStride_ + 8, 0);
+  inFlight_.resize(maxInFlight_);
 
   // Set up training threshold according to empirically determined formula
   trainingThreshold_ = (uint64_t)((1.93 * globalHistoryLength_) + 14);
 }
 
-PerceptronPredictor::~PerceptronPredictor() {
-  ras_.clear();
-  rasHistory_.clear();
-}
+PerceptronPredictor::~PerceptronPredictor() { ras_.clear(); }
 
 BranchPrediction PerceptronPredictor::predict(uint64_t address, BranchType type,
                                               int64_t knownOffset) {
@@ -33,24 +66,25 @@ BranchPrediction PerceptronPredictor::predict(uint64_t address, BranchType type,
   // the non-zero bits of the address, and then keep only the btbBits_ bits of
   // the output to keep it in bounds of the prediction table.
   uint64_t hashedIndex =
-      ((address >> 2) ^ globalHistory_) & ((1 << btbBits_) - 1);
+      ((address >> 2) ^ globalHistory_) & ((1ull << btbBits_) - 1);
 
-  // Store the global history for correct hashing in update() --
+  // Record the global history for correct hashing in update() --
   // needs to be global history and not the hashed index as hashing loses
   // information at longer global history lengths
-  btbHistory_[address] = globalHistory_;
-
-  // Retrieve the perceptron from the BTB
-  std::vector<int8_t> perceptron = btb_[hashedIndex].first;
+  Prediction& record = allocatePrediction();
+  record.address = address;
+  record.history = globalHistory_;
 
   // Get dot product of perceptron and history
-  int64_t Pout = getDotProduct(perceptron, globalHistory_);
+  expandHistory(globalHistory_);
+  int32_t Pout = getDotProduct(hashedIndex);
+  record.output = Pout;
   // Determine direction prediction based on its sign
   bool direction = (Pout >= 0);
 
   // Retrieve target prediction
   uint64_t target =
-      (knownOffset != 0) ? address + knownOffset : btb_[hashedIndex].second;
+      (knownOffset != 0) ? address + knownOffset : targets_[hashedIndex];
 
   BranchPrediction prediction = {direction, target};
 
@@ -63,7 +97,8 @@ BranchPrediction PerceptronPredictor::predict(uint64_t address, BranchType type,
     if (ras_.size() > 0) {
       prediction.target = ras_.back();
       // Record top of RAS used for target prediction
-      rasHistory_[address] = ras_.back();
+      record.rasPop = true;
+      record.rasValue = ras_.back();
       ras_.pop_back();
     }
   } else if (type == BranchType::SubroutineCall) {
@@ -74,7 +109,7 @@ BranchPrediction PerceptronPredictor::predict(uint64_t address, BranchType type,
     }
     ras_.push_back(address + 4);
     // Record that this address is a branch-and-link instruction
-    rasHistory_[address] = 0;
+    record.rasPush = true;
   } else if (type == BranchType::Conditional) {
     if (!prediction.taken) prediction.target = address + 4;
   }
@@ -83,78 +118,157 @@ BranchPrediction PerceptronPredictor::predict(uint64_t address, BranchType type,
 
 void PerceptronPredictor::update(uint64_t address, bool taken,
                                  uint64_t targetAddress, BranchType type) {
+  // Skip past the predictions which can no longer be updated
+  while (resolvedCount_ < inFlightCount_) {
+    const Prediction& record = inFlight(resolvedCount_);
+    if (!record.resolved && !record.flushed) break;
+    resolvedCount_++;
+  }
+
+  // Use the history and output of the oldest unresolved prediction of the
+  // branch
+  const Prediction* prediction = nullptr;
+  for (size_t i = resolvedCount_; i < inFlightCount_; i++) {
+    Prediction& record = inFlight(i);
+    if (record.address == address && !record.resolved && !record.flushed) {
+      record.resolved = true;
+      prediction = &record;
+      break;
+    }
+  }
+  uint64_t prevGlobalHistory = 0;
+  if (prediction != nullptr) {
+    prevGlobalHistory = prediction->history;
+  } else {
+    // Branches supplied without an outstanding prediction, such as those
+    // streamed from the loop buffer, reuse the history of their latest
+    // prediction, if any is still recorded
+    for (size_t i = inFlightCount_; i-- > 0;) {
+      const Prediction& record = inFlight(i);
+      if (record.address == address) {
+        prevGlobalHistory = record.history;
+        break;
+      }
+    }
+  }
+
   // Work out hash index
-  uint64_t prevGlobalHistory = btbHistory_[address];
   uint64_t hashedIndex =
-      ((address >> 2) ^ prevGlobalHistory) & ((1 << btbBits_) - 1);
-
-  std::vector<int8_t> perceptron = btb_[hashedIndex].first;
+      ((address >> 2) ^ prevGlobalHistory) & ((1ull << btbBits_) - 1);
 
   // Work out the most recent prediction
-  int64_t Pout = getDotProduct(perceptron, prevGlobalHistory);
+  expandHistory(prevGlobalHistory);
+  int32_t Pout = (prediction != nullptr) ? prediction->output
+                                         : getDotProduct(hashedIndex);
   bool directionPrediction = (Pout >= 0);
 
   // Update the perceptron if the prediction was wrong, or the dot product's
   // magnitude was not greater than the training threshold
-  if ((directionPrediction != taken) || (abs(Pout) < trainingThreshold_)) {
-    int8_t t = (taken) ? 1 : -1;
-
-    for (int i = 0; i < globalHistoryLength_; i++) {
-      int8_t xi =
-          ((prevGlobalHistory & (1 << ((globalHistoryLength_ - 1) - i))) == 0)
-              ? -1
-              : 1;
-      int8_t product_xi_t = xi * t;
-      // Make sure no overflow (+-127)
-      if (!(perceptron[i] == 127 && product_xi_t == 1) &&
-          !(perceptron[i] == -127 && product_xi_t == -1)) {
-        perceptron[i] += product_xi_t;
-      }
+  if ((directionPrediction != taken) ||
+      (static_cast<uint64_t>(std::abs(Pout)) < trainingThreshold_)) {
+    int16_t t = (taken) ? 1 : -1;
+    // Hold the bounds locally, as stores through int8_t pointers may alias
+    // members and would otherwise force them to be reloaded
+    int8_t* weights = perceptron(hashedIndex);
+    const int8_t* signs = historySigns_.data();
+    size_t stride = perceptronStride_;
+    // Move each weight towards agreeing with the outcome, saturating at +-127.
+    // The padding is left at 0 as its expanded history is 0
+    for (size_t i = 0; i < stride; i++) {
+      int16_t weight = weights[i] + t * signs[i];
+      weights[i] = static_cast<int8_t>(
+          std::max<int16_t>(-127, std::min<int16_t>(127, weight)));
     }
-    perceptron[globalHistoryLength_] += t;
+    int16_t bias = biases_[hashedIndex] + t;
+    biases_[hashedIndex] = static_cast<int8_t>(
+        std::max<int16_t>(-127, std::min<int16_t>(127, bias)));
   }
 
-  btb_[hashedIndex].first = perceptron;
-  btb_[hashedIndex].second = targetAddress;
+  targets_[hashedIndex] = targetAddress;
 
-  globalHistory_ =
-      ((globalHistory_ << 1) | taken) & ((1 << globalHistoryLength_) - 1);
+  globalHistory_ = ((globalHistory_ << 1) | taken) & globalHistoryMask_;
   return;
 }
 
 void PerceptronPredictor::flush(uint64_t address) {
-  // If address interacted with RAS, rewind entry
-  auto it = rasHistory_.find(address);
-  if (it != rasHistory_.end()) {
-    uint64_t target = it->second;
-    if (target != 0) {
+  // Find the youngest prediction of the branch
+  for (size_t i = inFlightCount_; i-- > 0;) {
+    Prediction& record = inFlight(i);
+    if (record.address != address || record.flushed) continue;
+    // If address interacted with RAS, rewind entry
+    if (record.rasPop) {
       // If history entry belongs to a return instruction, push target back onto
       // stack
       if (ras_.size() >= rasSize_) {
         ras_.pop_front();
       }
-      ras_.push_back(target);
-    } else {
+      ras_.push_back(record.rasValue);
+    } else if (record.rasPush) {
       // If history entry belongs to a branch-and-link instruction, pop target
       // off of stack
       if (ras_.size()) {
         ras_.pop_back();
       }
     }
-    rasHistory_.erase(it);
+    record.flushed = true;
+    break;
+  }
+  // Discard the flushed predictions at the young end
+  while (inFlightCount_ > 0 && inFlight(inFlightCount_ - 1).flushed) {
+    inFlightCount_--;
   }
+  resolvedCount_ = std::min(resolvedCount_, inFlightCount_);
 }
 
-int64_t PerceptronPredictor::getDotProduct(
-    const std::vector<int8_t>& perceptron, uint64_t history) {
-  int64_t Pout = perceptron[globalHistoryLength_];
-  for (int i = 0; i < globalHistoryLength_; i++) {
-    // Get branch direction for ith entry in the history
-    bool historyTaken =
-        ((history & (1 << ((globalHistoryLength_ - 1) - i))) != 0);
-    Pout += historyTaken ? perceptron[i] : (0 - perceptron[i]);
+void PerceptronPredictor::expandHistory(uint64_t history) {
+  int8_t* signs = historySigns_.data();
+  size_t length = globalHistoryLength_;
+  for (size_t i = 0; i < length; i += 8) {
+    std::memcpy(signs + i, expandedBytes[(history >> i) & 0xFF].data(), 8);
+  }
+  // Clear the signs expanded beyond the history, for the padding
+  std::memset(signs + length, 0, 8);
+}
+
+int32_t PerceptronPredictor::getDotProduct(uint64_t index) const {
+  // A branch-free multiply-accumulate over the whole padded perceptron, which
+  // the compiler can vectorise
+  const int8_t* weights = perceptron(index);
+  const int8_t* signs = historySigns_.data();
+  size_t stride = perceptronStride_;
+  int32_t Pout = biases_[index];
+  for (size_t i = 0; i < stride; i++) {
+    Pout += static_cast<int16_t>(weights[i]) * signs[i];
   }
   return Pout;
 }
 
+int8_t* PerceptronPredictor::perceptron(uint64_t index) {
+  return weights_.data() + weightsOffset_ + index * perceptronStride_;
+}
+
+const int8_t* PerceptronPredictor::perceptron(uint64_t index) const {
+  return weights_.data() + weightsOffset_ + index * perceptronStride_;
+}
+
+PerceptronPredictor::Prediction& PerceptronPredictor::allocatePrediction() {
+  if (inFlightCount_ == maxInFlight_) {
+    // Discard the oldest prediction
+    oldest_ = (oldest_ + 1) % maxInFlight_;
+    inFlightCount_--;
+    if (resolvedCount_ > 0) resolvedCount_--;
+  }
+  inFlightCount_++;
+  Prediction& record = inFlight(inFlightCount_ - 1);
+  record.rasPush = false;
+  record.rasPop = false;
+  record.resolved = false;
+  record.flushed = false;
+  return record;
+}
+
+PerceptronPredictor::Prediction& PerceptronPredictor::inFlight(size_t age) {
+  return inFlight_[(oldest_ + age) % maxInFlight_];
+}
+
 }  // namespace simeng
@@ -1,13 +1,54 @@
 #include "simeng/RegisterValue.hh"
 
 #include <cstring>
+#include <new>
 
 namespace simeng {
 
-Pool pool = Pool();
+namespace {
+
+/** The pool of chunks able to hold `bytes` bytes of data and their header. */
+template <size_t bytes, size_t headerBytes>
+using ChunkPool = threadPool_<bytes + headerBytes, 64>;
+
+}  // namespace
 
 RegisterValue::RegisterValue() : bytes(0) {}
 
+char* RegisterValue::allocate(uint16_t bytes) {
+  void* chunk;
+  if (bytes <= 32) {
+    chunk = ChunkPool<32, HEADER_BYTES>::allocate();
+  } else if (bytes <= 64) {
+    chunk = ChunkPool<64, HEADER_BYTES>::allocate();
+  } else if (bytes <= 128) {
+    chunk = ChunkPool<128, HEADER_BYTES>::allocate();
+  } else if (bytes <= 256) {
+    chunk = ChunkPool<256, HEADER_BYTES>::allocate();
+  } else {
+    chunk = ::operator new(bytes + HEADER_BYTES);
+  }
+  if (!chunk) throw std::bad_alloc();
+
+  new (chunk) std::atomic<uint32_t>(1);
+  return static_cast<char*>(chunk) + HEADER_BYTES;
+}
+
+void RegisterValue::deallocate(char* ptr, uint16_t bytes) {
+  void* chunk = ptr - HEADER_BYTES;
+  if (bytes <= 32) {
+    ChunkPool<32, HEADER_BYTES>::deallocate(chunk);
+  } else if (bytes <= 64) {
+    ChunkPool<64, HEADER_BYTES>::deallocate(chunk);
+  } else if (bytes <= 128) {
+    ChunkPool<128, HEADER_BYTES>::deallocate(chunk);
+  } else if (bytes <= 256) {
+    ChunkPool<256, HEADER_BYTES>::deallocate(chunk);
+  } else {
+    ::operator delete(chunk);
+  }
+}
+
 RegisterValue::operator bool() const { return (bytes > 0); }
 
 RegisterValue RegisterValue::zeroExtend(uint16_t fromBytes,
@@ -19,8 +60,8 @@ RegisterValue RegisterValue::zeroExtend(uint16_t fromBytes,
   auto extended = RegisterValue(0, toBytes);
 
   // Get the appropriate source/destination pointers and copy the data
-  const char* src = (isLocal() ? value : ptr.get());
-  char* dest = (extended.isLocal() ? extended.value : extended.ptr.get());
+  const char* src = (isLocal() ? value : ptr);
+  char* dest = (extended.isLocal() ? extended.value : extended.ptr);
 
   std::memcpy(dest, src, fromBytes);
 
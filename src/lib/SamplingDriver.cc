@@ -0,0 +1,322 @@
+#include "simeng/SamplingDriver.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+#include "simeng/models/emulation/Core.hh"
+#include "simeng/models/outoforder/Core.hh"
+
+namespace simeng {
+
+namespace {
+
+/** Retrieve the functional core of `coreInstance`, exiting if sampling was not
+ * enabled when it was created. */
+Core& getFunctionalCore(const CoreInstance& coreInstance) {
+  if (coreInstance.getFunctionalCore() == nullptr) {
+    std::cerr << "[SimEng:SamplingDriver] The core instance was not created "
+                 "for a sampled simulation"
+              << std::endl;
+    exit(1);
+  }
+  return *coreInstance.getFunctionalCore();
+}
+
+}  // namespace
+
+SamplingDriver::SamplingDriver(CoreInstance& coreInstance,
+                               ryml::ConstNodeRef config)
+    : coreInstance_(coreInstance),
+      functionalCore_(getFunctionalCore(coreInstance)),
+      detailedCore_(*coreInstance.getCore()),
+      periodic_(config["Sampling"]["Mode"].as<std::string>() == "Periodic"),
+      intervalLength_(config["Sampling"]["Interval-Length"].as<uint64_t>()),
+      detailLength_(config["Sampling"]["Detail-Length"].as<uint64_t>()),
+      warmupLength_(config["Sampling"]["Warmup-Length"].as<uint64_t>()),
+      functionalWarming_(
+          config["Sampling"]["Functional-Warming"].as<bool>()) {
+  if (!periodic_) {
+    // Each SimPoint covers a whole interval
+    detailLength_ = intervalLength_;
+    readSimPoints(config["Sampling"]["SimPoint-File"].as<std::string>(),
+                  config["Sampling"]["Weights-File"].as<std::string>());
+  }
+
+  if (functionalWarming_) {
+    static_cast<models::emulation::Core&>(functionalCore_)
+        .setAccessObserver([this](models::emulation::AccessType type,
+                                  uint64_t pc,
+                                  const memory::MemoryAccessTarget& target) {
+          warm(type, pc, target);
+        });
+  }
+
+  // Both cores start with the same thread; fast-forward it on the functional
+  // core until the first interval
+  detailedCore_.halt();
+  nextInterval();
+}
+
+void SamplingDriver::readSimPoints(const std::string& simPointPath,
+                                   const std::string& weightsPath) {
+  // Weights are listed as `<weight> <cluster>`, one per line
+  std::unordered_map<uint64_t, double> weights;
+  if (!weightsPath.empty()) {
+    std::ifstream weightsFile(weightsPath);
+    if (!weightsFile.is_open()) {
+      std::cerr << "[SimEng:SamplingDriver] Could not open SimPoint weights "
+                   "file "
+                << weightsPath << std::endl;
+      exit(1);
+    }
+    double weight;
+    uint64_t cluster;
+    while (weightsFile >> weight >> cluster) weights[cluster] = weight;
+  }
+
+  // SimPoints are listed as `<interval index> <cluster>`, one per line
+  std::ifstream simPointFile(simPointPath);
+  if (!simPointFile.is_open()) {
+    std::cerr << "[SimEng:SamplingDriver] Could not open SimPoint file "
+              << simPointPath << std::endl;
+    exit(1);
+  }
+  uint64_t index;
+  uint64_t cluster;
+  while (simPointFile >> index >> cluster) {
+    // Without a weights file, every SimPoint contributes equally
+    double weight = 1.0;
+    if (!weightsPath.empty()) {
+      auto itr = weights.find(cluster);
+      if (itr == weights.end()) {
+        std::cerr << "[SimEng:SamplingDriver] No weight given for SimPoint "
+                     "cluster "
+                  << cluster << std::endl;
+        exit(1);
+      }
+      weight = itr->second;
+    }
+    simPoints_.push_back({index * intervalLength_, weight});
+  }
+
+  std::sort(simPoints_.begin(), simPoints_.end(),
+            [](const Interval& a, const Interval& b) {
+              return a.start < b.start;
+            });
+}
+
+void SamplingDriver::nextInterval() {
+  uint64_t retired = getRetiredCount();
+  hasInterval_ = false;
+  if (periodic_) {
+    // Measurement starts after warming up at the beginning of each period.
+    // Skip any periods already passed by an overrunning interval
+    while (nextIndex_ * intervalLength_ + warmupLength_ < retired) nextIndex_++;
+    interval_ = {nextIndex_ * intervalLength_ + warmupLength_, 1.0};
+    hasInterval_ = true;
+  } else {
+    while (nextIndex_ < simPoints_.size() &&
+           simPoints_[nextIndex_].start < retired)
+      nextIndex_++;
+    if (nextIndex_ < simPoints_.size()) {
+      interval_ = simPoints_[nextIndex_];
+      hasInterval_ = true;
+    }
+  }
+  nextIndex_++;
+}
+
+uint64_t SamplingDriver::getRetiredCount() const {
+  return functionalCore_.getInstructionsRetiredCount() +
+         detailedCore_.getInstructionsRetiredCount();
+}
+
+std::map<std::string, uint64_t> SamplingDriver::getCounters() const {
+  std::map<std::string, uint64_t> counters;
+  for (const auto& [key, value] : detailedCore_.getStats()) {
+    if (!value.empty() &&
+        std::all_of(value.begin(), value.end(),
+                    [](unsigned char c) { return std::isdigit(c); })) {
+      counters[key] = std::stoull(value);
+    }
+  }
+  return counters;
+}
+
+bool SamplingDriver::switchToDetailed() {
+  auto& functionalCore = static_cast<models::emulation::Core&>(functionalCore_);
+  if (!functionalCore.isBetweenInstructions()) return false;
+
+  uint64_t pc = functionalCore.getProgramCounter();
+  functionalCore_.halt();
+  detailedCore_.schedule(functionalCore_.getThreadId(), pc,
+                         coreInstance_.getRegisterState(functionalCore_));
+  return true;
+}
+
+bool SamplingDriver::switchToFunctional() {
+  auto pc = static_cast<models::outoforder::Core&>(detailedCore_).suspend();
+  if (!pc.has_value()) return false;
+
+  // Complete the writes of committed stores before the functional core reads
+  // memory, discarding the responses to any abandoned loads and fetches
+  auto& dataMemory = *coreInstance_.getDataMemory();
+  auto& instructionMemory = *coreInstance_.getInstructionMemory();
+  while (dataMemory.hasPendingRequests()) dataMemory.tick();
+  while (instructionMemory.hasPendingRequests()) instructionMemory.tick();
+  dataMemory.clearCompletedReads();
+  instructionMemory.clearCompletedReads();
+
+  functionalCore_.schedule(detailedCore_.getThreadId(), pc.value(),
+                           coreInstance_.getRegisterState(detailedCore_));
+  return true;
+}
+
+void SamplingDriver::warm(models::emulation::AccessType type, uint64_t pc,
+                          const memory::MemoryAccessTarget& target) {
+  auto& detailedCore = static_cast<models::outoforder::Core&>(detailedCore_);
+  if (type == models::emulation::AccessType::Fetch) {
+    detailedCore.warmFetch(target);
+  } else {
+    detailedCore.warmData(pc, target,
+                          type == models::emulation::AccessType::Store);
+  }
+}
+
+uint64_t SamplingDriver::run() {
+  auto& instructionMemory = *coreInstance_.getInstructionMemory();
+  auto& dataMemory = *coreInstance_.getDataMemory();
+
+  while (true) {
+    uint64_t retired = getRetiredCount();
+    switch (phase_) {
+      case Phase::FastForward:
+        // Switch to the detailed core once warm-up of the next interval is
+        // due; the functional core may first need to finish an instruction
+        if (hasInterval_ && retired + warmupLength_ >= interval_.start &&
+            switchToDetailed())
+          phase_ = Phase::Warmup;
+        break;
+      case Phase::Warmup:
+        if (retired >= interval_.start) {
+          startCounters_ = getCounters();
+          phase_ = Phase::Measure;
+        }
+        break;
+      case Phase::Measure:
+        if (retired >= interval_.start + detailLength_) {
+          Measurement measurement = {interval_.weight, {}};
+          for (const auto& [key, value] : getCounters()) {
+            measurement.deltas[key] = value - startCounters_[key];
+          }
+          if (measurement.deltas["retired"] > 0)
+            measurements_.push_back(measurement);
+
+          // Remain on the detailed core if the next interval's warm-up is
+          // already due
+          nextInterval();
+          if (hasInterval_ && retired + warmupLength_ >= interval_.start)
+            phase_ = Phase::Warmup;
+          else
+            phase_ = Phase::Drain;
+        }
+        break;
+      case Phase::Drain:
+        if (switchToFunctional()) phase_ = Phase::FastForward;
+        break;
+    }
+
+    if (phase_ == Phase::FastForward) {
+      if (functionalCore_.hasHalted()) break;
+      // Nothing else is ticked alongside the functional core, so it runs a
+      // basic block at a time
+      uint64_t ticks =
+          static_cast<models::emulation::Core&>(functionalCore_).tickBlock();
+      iterations_ += ticks;
+      if (functionalWarming_) {
+        // Move the outoforder core's clocks on with the functional core's,
+        // such that the entries warmed age as they would have
+        static_cast<models::outoforder::Core&>(detailedCore_)
+            .skipHaltedTicks(ticks);
+        instructionMemory.skipTicks(ticks);
+        dataMemory.skipTicks(ticks);
+      }
+    } else {
+      if (detailedCore_.hasHalted() && !dataMemory.hasPendingRequests())
+        break;
+      detailedCore_.tick();
+      instructionMemory.tick();
+      dataMemory.tick();
+      iterations_++;
+    }
+  }
+
+  return iterations_;
+}
+
+std::map<std::string, std::string> SamplingDriver::getStats() const {
+  uint64_t retired = getRetiredCount();
+  if (measurements_.empty()) {
+    // The workload finished before any interval was measured
+    auto stats = functionalCore_.getStats();
+    stats["retired"] = std::to_string(retired);
+    stats["sampling.intervals"] = "0";
+    stats["sampling.warming"] = functionalWarming_ ? "functional" : "cold";
+    return stats;
+  }
+
+  // Extrapolate the weighted mean rate of each counter, per measured
+  // instruction, across every instruction retired
+  double totalWeight = 0.0;
+  std::map<std::string, double> rates;
+  for (const auto& measurement : measurements_) {
+    totalWeight += measurement.weight;
+    double instructions = measurement.deltas.at("retired");
+    for (const auto& [key, value] : measurement.deltas) {
+      rates[key] += measurement.weight * value / instructions;
+    }
+  }
+  std::map<std::string, std::string> stats;
+  for (const auto& [key, rate] : rates) {
+    stats[key] = std::to_string(
+        static_cast<uint64_t>(std::llround(rate / totalWeight * retired)));
+  }
+  stats["retired"] = std::to_string(retired);
+
+  double cpi = rates["cycles"] / totalWeight;
+  std::ostringstream ipcStr;
+  ipcStr << std::setprecision(2) << 1.0 / cpi;
+  stats["ipc"] = ipcStr.str();
+
+  stats["sampling.intervals"] = std::to_string(measurements_.size());
+  stats["sampling.warming"] = functionalWarming_ ? "functional" : "cold";
+  stats["sampling.detailed"] =
+      std::to_string(detailedCore_.getInstructionsRetiredCount());
+
+  // Periodic intervals form a systematic sample, so the 95% confidence
+  // interval of the CPI estimate follows from the variance between intervals
+  if (periodic_ && measurements_.size() > 1) {
+    double variance = 0.0;
+    for (const auto& measurement : measurements_) {
+      double intervalCpi =
+          static_cast<double>(measurement.deltas.at("cycles")) /
+          measurement.deltas.at("retired");
+      variance += (intervalCpi - cpi) * (intervalCpi - cpi);
+    }
+    variance /= measurements_.size() - 1;
+    double error =
+        100.0 * 1.96 * std::sqrt(variance / measurements_.size()) / cpi;
+    std::ostringstream errorStr;
+    errorStr << std::setprecision(3) << error << "%";
+    stats["sampling.cpi.error"] = errorStr.str();
+  }
+
+  return stats;
+}
+
+}  // namespace simeng
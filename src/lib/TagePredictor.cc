@@ -0,0 +1,461 @@
+#include "simeng/TagePredictor.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simeng {
+
+namespace {
+
+/** Get the `i`th of `count` history lengths in a geometric series from
+ * `minLength` to `maxLength`. */
+uint16_t geometricLength(size_t i, size_t count, uint16_t minLength,
+                         uint16_t maxLength) {
+  if (count == 1) return maxLength;
+  double ratio = static_cast<double>(maxLength) / minLength;
+  double exponent = static_cast<double>(i) / (count - 1);
+  return static_cast<uint16_t>(
+      std::lround(minLength * std::pow(ratio, exponent)));
+}
+
+}  // namespace
+
+TagePredictor::TagePredictor(ryml::ConstNodeRef config)
+    : tables_(config["Branch-Predictor"]["Tagged-Tables"].as<uint8_t>()),
+      targetTables_(
+          config["Branch-Predictor"]["Indirect-Tables"].as<uint8_t>()),
+      baseBits_(config["Branch-Predictor"]["Base-Table-Bits"].as<uint8_t>()),
+      tableBits_(
+          config["Branch-Predictor"]["Tagged-Table-Bits"].as<uint8_t>()),
+      targetTableBits_(
+          config["Branch-Predictor"]["Indirect-Table-Bits"].as<uint8_t>()),
+      btbBits_(config["Branch-Predictor"]["BTB-Tag-Bits"].as<uint8_t>()),
+      tagBits_(config["Branch-Predictor"]["Tag-Bits"].as<uint8_t>()),
+      rasSize_(config["Branch-Predictor"]["RAS-entries"].as<uint16_t>()) {
+  uint16_t maxLength =
+      config["Branch-Predictor"]["Global-History-Length"].as<uint16_t>();
+  uint16_t minLength = std::min(
+      config["Branch-Predictor"]["Min-History-Length"].as<uint16_t>(),
+      maxLength);
+
+  // Base predictor counters start weakly taken
+  base_.resize(1ull << baseBits_, 2);
+  tagged_.resize(tables_ << tableBits_);
+  targets_.resize(targetTables_ << targetTableBits_);
+  btb_.resize(1ull << btbBits_, 0);
+
+  // Fold the history of each table into its index and two tags of differing
+  // widths, so that the tags do not alias the same history bits
+  std::vector<uint16_t> lengths;
+  for (size_t i = 0; i < tables_; i++) {
+    uint16_t length = geometricLength(i, tables_, minLength, maxLength);
+    // Ensure each table sees a longer history than the last
+    if (!lengths.empty()) {
+      length = std::max<uint16_t>(length, lengths.back() + 1);
+    }
+    lengths.push_back(length);
+  }
+  std::vector<uint16_t> targetLengths;
+  for (size_t i = 0; i < targetTables_; i++) {
+    uint16_t length = geometricLength(i, targetTables_, minLength, maxLength);
+    if (!targetLengths.empty()) {
+      length = std::max<uint16_t>(length, targetLengths.back() + 1);
+    }
+    targetLengths.push_back(length);
+  }
+  for (uint16_t length : lengths) folds_.push_back({length, tableBits_});
+  for (uint16_t length : lengths) folds_.push_back({length, tagBits_});
+  for (uint16_t length : lengths) {
+    folds_.push_back({length, static_cast<uint8_t>(tagBits_ - 1)});
+  }
+  for (uint16_t length : targetLengths) {
+    folds_.push_back({length, targetTableBits_});
+  }
+  for (uint16_t length : targetLengths) folds_.push_back({length, tagBits_});
+  for (uint16_t length : targetLengths) {
+    folds_.push_back({length, static_cast<uint8_t>(tagBits_ - 1)});
+  }
+
+  // The history must retain the bits of the longest table beyond those of
+  // every in-flight prediction, any of which may be restored
+  uint16_t longest = std::max(lengths.empty() ? 0 : lengths.back(),
+                              targetLengths.empty() ? 0 : targetLengths.back());
+  size_t historySize = 1;
+  while (historySize <= longest + maxInFlight_) historySize <<= 1;
+  history_.resize(historySize, 0);
+
+  inFlight_.resize(maxInFlight_);
+  savedFolds_.resize(maxInFlight_ * folds_.size());
+  indices_.resize(tables_);
+  tags_.resize(tables_);
+  targetIndices_.resize(targetTables_);
+  targetTags_.resize(targetTables_);
+}
+
+BranchPrediction TagePredictor::predict(uint64_t address, BranchType type,
+                                        int64_t knownOffset) {
+  size_t slot = allocatePrediction();
+  Prediction& record = inFlight_[slot];
+  computeIndices(address, &savedFolds_[slot * folds_.size()], pathHistory_);
+
+  // Take the direction from the table with the longest matching history,
+  // falling back to the next longest match, then the base predictor
+  int8_t provider = -1;
+  int8_t alternate = -1;
+  for (size_t i = tables_; i-- > 0;) {
+    if (taggedEntry(i, indices_[i]).tag != tags_[i]) continue;
+    if (provider < 0) {
+      provider = i;
+    } else {
+      alternate = i;
+      break;
+    }
+  }
+  bool baseTaken = base_[(address >> 2) & ((1ull << baseBits_) - 1)] >= 2;
+  bool alternateTaken =
+      alternate < 0 ? baseTaken
+                    : taggedEntry(alternate, indices_[alternate]).counter >= 0;
+  bool providerTaken = baseTaken;
+  bool taken = baseTaken;
+  if (provider >= 0) {
+    const TaggedEntry& entry = taggedEntry(provider, indices_[provider]);
+    providerTaken = entry.counter >= 0;
+    taken = providerTaken;
+    // A newly allocated entry is often less accurate than the alternate
+    bool newEntry =
+        (entry.counter == 0 || entry.counter == -1) && entry.useful == 0;
+    if (newEntry && useAltOnNewAlloc_ >= 0) taken = alternateTaken;
+  }
+
+  // Branches with an unknown target use the target table with the longest
+  // matching history, falling back to the BTB
+  bool indirect = knownOffset == 0 && type != BranchType::Return;
+  int8_t targetProvider = -1;
+  uint64_t target = address + knownOffset;
+  if (knownOffset == 0) {
+    target = btb_[(address >> 2) & ((1ull << btbBits_) - 1)];
+    for (size_t i = targetTables_; indirect && i-- > 0;) {
+      const TargetEntry& entry = targetEntry(i, targetIndices_[i]);
+      if (entry.tag != targetTags_[i]) continue;
+      target = entry.target;
+      targetProvider = i;
+      break;
+    }
+  }
+  BranchPrediction prediction = {taken, target};
+
+  record.rasPush = false;
+  record.rasPop = false;
+  // Amend prediction based on branch type
+  if (type == BranchType::Unconditional) {
+    prediction.taken = true;
+  } else if (type == BranchType::Return) {
+    prediction.taken = true;
+    // Return branches can use the RAS if an entry is available
+    if (ras_.size() > 0) {
+      prediction.target = ras_.back();
+      // Record top of RAS used for target prediction
+      record.rasPop = true;
+      record.rasValue = ras_.back();
+      ras_.pop_back();
+    }
+  } else if (type == BranchType::SubroutineCall) {
+    prediction.taken = true;
+    // Subroutine call branches must push their associated return address to RAS
+    if (ras_.size() >= rasSize_) {
+      ras_.pop_front();
+    }
+    ras_.push_back(address + 4);
+    record.rasPush = true;
+  } else if (type == BranchType::Conditional) {
+    if (!prediction.taken) prediction.target = address + 4;
+  }
+
+  record.address = address;
+  record.prediction = prediction;
+  record.provider = provider;
+  record.providerTaken = providerTaken;
+  record.alternateTaken = alternateTaken;
+  record.indirect = indirect;
+  record.targetProvider = targetProvider;
+
+  pushHistory(prediction.taken, address);
+  return prediction;
+}
+
+void TagePredictor::update(uint64_t address, bool taken,
+                           uint64_t targetAddress, BranchType type) {
+  btb_[(address >> 2) & ((1ull << btbBits_) - 1)] = targetAddress;
+
+  // Find the oldest unresolved prediction of the branch
+  size_t slot = maxInFlight_;
+  for (size_t i = 0; i < inFlightCount_; i++) {
+    size_t candidate = (oldest_ + i) % maxInFlight_;
+    const Prediction& record = inFlight_[candidate];
+    if (record.address == address && !record.resolved && !record.squashed) {
+      slot = candidate;
+      break;
+    }
+  }
+
+  if (slot == maxInFlight_) {
+    // Branches supplied without a prediction, such as those streamed from the
+    // loop buffer, only train the base predictor
+    if (type == BranchType::Conditional) {
+      uint8_t& counter = base_[(address >> 2) & ((1ull << baseBits_) - 1)];
+      if (taken && counter < 3) counter++;
+      if (!taken && counter > 0) counter--;
+    }
+    return;
+  }
+
+  Prediction& record = inFlight_[slot];
+  record.resolved = true;
+  // Regenerate the indices and tags the prediction was made with
+  computeIndices(address, &savedFolds_[slot * folds_.size()],
+                 record.pathHistory);
+  if (type == BranchType::Conditional) trainDirection(record, taken);
+  if (record.indirect && taken) trainTarget(record, targetAddress);
+
+  bool mispredicted = record.prediction.taken != taken ||
+                      (taken && record.prediction.target != targetAddress);
+  if (mispredicted) {
+    // Roll back every younger prediction, which was made down the wrong path,
+    // leaving them to be matched by any flush of their branches
+    for (size_t i = inFlightCount_; i-- > 0;) {
+      size_t younger = (oldest_ + i) % maxInFlight_;
+      if (younger == slot) break;
+      Prediction& youngerRecord = inFlight_[younger];
+      if (youngerRecord.squashed) continue;
+      rewindRas(youngerRecord);
+      youngerRecord.squashed = true;
+    }
+    // Replace the predicted direction in the history with the outcome
+    restoreHistory(slot);
+    pushHistory(taken, address);
+  }
+
+  // Retire the resolved predictions at the oldest end of the ring; those
+  // rolled back remain until their flush arrives
+  while (inFlightCount_ > 0 && inFlight_[oldest_].resolved) {
+    oldest_ = (oldest_ + 1) % maxInFlight_;
+    inFlightCount_--;
+  }
+}
+
+void TagePredictor::flush(uint64_t address) {
+  // Find the youngest prediction of the flushed branch; a branch never
+  // predicted, or whose prediction has retired, leaves the state unchanged
+  size_t match = inFlightCount_;
+  while (match-- > 0) {
+    if (inFlight_[(oldest_ + match) % maxInFlight_].address == address) break;
+  }
+  if (match >= inFlightCount_) return;
+
+  // Discard predictions from the youngest until the match. Those rolled back
+  // by a misprediction have already been undone
+  while (inFlightCount_ > match) {
+    size_t slot = (oldest_ + inFlightCount_ - 1) % maxInFlight_;
+    const Prediction& record = inFlight_[slot];
+    if (!record.squashed) {
+      rewindRas(record);
+      restoreHistory(slot);
+    }
+    inFlightCount_--;
+  }
+}
+
+void TagePredictor::computeIndices(uint64_t address, const uint32_t* folds,
+                                   uint16_t path) {
+  uint64_t pc = address >> 2;
+  uint32_t tagMask = (1u << tagBits_) - 1;
+
+  uint32_t mask = (1u << tableBits_) - 1;
+  for (size_t i = 0; i < tables_; i++) {
+    // Mix in as much of the path history as the table's history covers
+    uint16_t length = folds_[i].length;
+    uint32_t pathBits = length < 16 ? path & ((1u << length) - 1) : path;
+    indices_[i] = (pc ^ (pc >> tableBits_) ^ folds[i] ^ pathBits ^
+                   (pathBits >> tableBits_)) &
+                  mask;
+    tags_[i] = (pc ^ folds[tables_ + i] ^ (folds[2 * tables_ + i] << 1)) &
+               tagMask;
+  }
+
+  const uint32_t* targetFolds = folds + 3 * tables_;
+  mask = (1u << targetTableBits_) - 1;
+  for (size_t i = 0; i < targetTables_; i++) {
+    targetIndices_[i] = (pc ^ (pc >> targetTableBits_) ^ targetFolds[i]) & mask;
+    targetTags_[i] = (pc ^ targetFolds[targetTables_ + i] ^
+                      (targetFolds[2 * targetTables_ + i] << 1)) &
+                     tagMask;
+  }
+}
+
+size_t TagePredictor::allocatePrediction() {
+  if (inFlightCount_ == maxInFlight_) {
+    // Discard the oldest prediction
+    oldest_ = (oldest_ + 1) % maxInFlight_;
+    inFlightCount_--;
+  }
+  size_t slot = (oldest_ + inFlightCount_) % maxInFlight_;
+  inFlightCount_++;
+
+  Prediction& record = inFlight_[slot];
+  record.historyLength = historyLength_;
+  record.pathHistory = pathHistory_;
+  record.resolved = false;
+  record.squashed = false;
+  uint32_t* saved = &savedFolds_[slot * folds_.size()];
+  for (size_t i = 0; i < folds_.size(); i++) saved[i] = folds_[i].value;
+  return slot;
+}
+
+void TagePredictor::pushHistory(bool taken, uint64_t address) {
+  uint64_t mask = history_.size() - 1;
+  historyLength_++;
+  history_[historyLength_ & mask] = taken;
+  for (FoldedHistory& fold : folds_) {
+    // Shift in the new bit, remove the bit leaving the history, then wrap the
+    // bit shifted out of the top back to the bottom
+    uint8_t oldest = history_[(historyLength_ - fold.length) & mask];
+    fold.value = (fold.value << 1) | taken;
+    fold.value ^= static_cast<uint32_t>(oldest) << (fold.length % fold.width);
+    fold.value ^= fold.value >> fold.width;
+    fold.value &= (1u << fold.width) - 1;
+  }
+  pathHistory_ = (pathHistory_ << 1) | ((address >> 2) & 1);
+}
+
+void TagePredictor::restoreHistory(size_t slot) {
+  const Prediction& record = inFlight_[slot];
+  historyLength_ = record.historyLength;
+  pathHistory_ = record.pathHistory;
+  const uint32_t* saved = &savedFolds_[slot * folds_.size()];
+  for (size_t i = 0; i < folds_.size(); i++) folds_[i].value = saved[i];
+}
+
+void TagePredictor::rewindRas(const Prediction& prediction) {
+  if (prediction.rasPop) {
+    // Push the target a return instruction used back onto the stack
+    if (ras_.size() >= rasSize_) {
+      ras_.pop_front();
+    }
+    ras_.push_back(prediction.rasValue);
+  } else if (prediction.rasPush) {
+    // Pop the return address a branch-and-link instruction pushed
+    if (ras_.size()) {
+      ras_.pop_back();
+    }
+  }
+}
+
+void TagePredictor::trainDirection(const Prediction& prediction, bool taken) {
+  // Periodically age the useful counters so that stale entries can be
+  // replaced
+  if (++updates_ % (1 << 18) == 0) {
+    for (TaggedEntry& entry : tagged_) entry.useful >>= 1;
+  }
+
+  int8_t provider = prediction.provider;
+  if (provider >= 0) {
+    TaggedEntry& entry = taggedEntry(provider, indices_[provider]);
+    bool newEntry =
+        (entry.counter == 0 || entry.counter == -1) && entry.useful == 0;
+    // Learn whether newly allocated entries or their alternates are more
+    // accurate
+    if (newEntry && prediction.providerTaken != prediction.alternateTaken) {
+      if (prediction.alternateTaken == taken) {
+        useAltOnNewAlloc_ = std::min<int8_t>(useAltOnNewAlloc_ + 1, 7);
+      } else {
+        useAltOnNewAlloc_ = std::max<int8_t>(useAltOnNewAlloc_ - 1, -8);
+      }
+    }
+    if (prediction.providerTaken != prediction.alternateTaken) {
+      if (prediction.providerTaken == taken) {
+        entry.useful = std::min<uint8_t>(entry.useful + 1, 3);
+      } else if (entry.useful > 0) {
+        entry.useful--;
+      }
+    }
+    if (taken && entry.counter < 3) entry.counter++;
+    if (!taken && entry.counter > -4) entry.counter--;
+  } else {
+    uint8_t& counter =
+        base_[(prediction.address >> 2) & ((1ull << baseBits_) - 1)];
+    if (taken && counter < 3) counter++;
+    if (!taken && counter > 0) counter--;
+  }
+
+  // Allocate an entry in a table with a longer history on a misprediction.
+  // Starting from a randomly chosen one of the next two tables spreads
+  // allocations across the tables
+  if (prediction.prediction.taken == taken) return;
+  size_t first = provider + 1;
+  if (first >= tables_) return;
+  size_t start = first;
+  if (start + 1 < tables_ && (nextRandom() & 1)) start++;
+  for (size_t i = start; i < tables_; i++) {
+    TaggedEntry& entry = taggedEntry(i, indices_[i]);
+    if (entry.useful != 0) continue;
+    entry.tag = tags_[i];
+    entry.counter = taken ? 0 : -1;
+    return;
+  }
+  // No entry could be replaced, so make them more likely to be next time
+  for (size_t i = first; i < tables_; i++) {
+    TaggedEntry& entry = taggedEntry(i, indices_[i]);
+    if (entry.useful > 0) entry.useful--;
+  }
+}
+
+void TagePredictor::trainTarget(const Prediction& prediction, uint64_t target) {
+  int8_t provider = prediction.targetProvider;
+  if (provider >= 0) {
+    TargetEntry& entry = targetEntry(provider, targetIndices_[provider]);
+    if (entry.target == target) {
+      entry.confidence = std::min<uint8_t>(entry.confidence + 1, 3);
+      entry.useful = 1;
+    } else if (entry.confidence > 0) {
+      entry.confidence--;
+    } else {
+      entry.target = target;
+      entry.useful = 0;
+    }
+  }
+
+  // Allocate an entry in a table with a longer history on a misprediction
+  if (prediction.prediction.target == target) return;
+  size_t first = provider + 1;
+  for (size_t i = first; i < targetTables_; i++) {
+    TargetEntry& entry = targetEntry(i, targetIndices_[i]);
+    if (entry.useful != 0) continue;
+    entry.tag = targetTags_[i];
+    entry.target = target;
+    entry.confidence = 0;
+    return;
+  }
+  for (size_t i = first; i < targetTables_; i++) {
+    targetEntry(i, targetIndices_[i]).useful = 0;
+  }
+}
+
+TagePredictor::TaggedEntry& TagePredictor::taggedEntry(size_t table,
+                                                       uint32_t index) {
+  return tagged_[(table << tableBits_) + index];
+}
+
+TagePredictor::TargetEntry& TagePredictor::targetEntry(size_t table,
+                                                       uint32_t index) {
+  return targets_[(table << targetTableBits_) + index];
+}
+
+uint32_t TagePredictor::nextRandom() {
+  // A 32-bit xorshift generator
+  random_ ^= random_ << 13;
+  random_ ^= random_ >> 17;
+  random_ ^= random_ << 5;
+  return random_;
+}
+
+}  // namespace simeng
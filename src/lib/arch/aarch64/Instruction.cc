@@ -131,6 +131,10 @@ bool Instruction::isLoad() const { return isInstruction(InsnType::isLoad); }
 
 bool Instruction::isBranch() const { return isInstruction(InsnType::isBranch); }
 
+bool Instruction::isAtomic() const {
+  return isInstruction(InsnType::isAtomic);
+}
+
 uint16_t Instruction::getGroup() const {
   // Use identifiers to decide instruction group
   // Set base
@@ -182,6 +186,24 @@ void Instruction::setExecutionInfo(const ExecutionInfo& info) {
   supportedPorts_ = info.ports;
 }
 
+IntrusivePtr<simeng::Instruction> Instruction::clone() const {
+  return makeIntrusive<Instruction>(*this);
+}
+
+void Instruction::reset() {
+  simeng::Instruction::reset();
+  exception_ = InstructionException::None;
+
+  sourceOperandsPending_ = 0;
+  for (uint16_t i = 0; i < sourceRegisterCount_; i++) {
+    if (sourceRegisters_[i] == RegisterType::ZERO_REGISTER && sourceValues_[i])
+      continue;
+    sourceValues_[i] = RegisterValue();
+    sourceOperandsPending_++;
+  }
+  for (size_t i = 0; i < results_.size(); i++) results_[i] = RegisterValue();
+}
+
 const InstructionMetadata& Instruction::getMetadata() const {
   return metadata_;
 }
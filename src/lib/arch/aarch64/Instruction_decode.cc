@@ -479,12 +479,23 @@ void Instruction::decode() {
     // LDADD* are considered to be both a load and a store
     if (metadata_.id >= ARM64_INS_LDADD && metadata_.id <= ARM64_INS_LDADDLH) {
       setInstructionType(InsnType::isLoad);
+      setInstructionType(InsnType::isAtomic);
     }
 
-    // CASAL* are considered to be both a load and a store
+    // CASAL* are considered to be both a load and a store, though the first
+    // operand is written with the value loaded
     if (metadata_.opcode == Opcode::AArch64_CASALW ||
         metadata_.opcode == Opcode::AArch64_CASALX) {
       setInstructionType(InsnType::isLoad);
+      setInstructionType(InsnType::isStoreAddress);
+      setInstructionType(InsnType::isStoreData);
+      setInstructionType(InsnType::isAtomic);
+    }
+
+    // Exclusive loads and stores
+    if (metadata_.id == ARM64_INS_LDXR || metadata_.id == ARM64_INS_LDAXR ||
+        metadata_.id == ARM64_INS_STXR || metadata_.id == ARM64_INS_STLXR) {
+      setInstructionType(InsnType::isAtomic);
     }
 
     if (isInstruction(InsnType::isStoreData)) {
@@ -75,6 +75,16 @@ void Instruction::execute() {
   const uint16_t VL_bits = SMenabled ? architecture_.getStreamingVectorLength()
                                      : architecture_.getVectorLength();
   executed_ = true;
+  // Exclusive loads and atomics reserve the memory they read, while exclusive
+  // stores only write memory if that reservation is still held
+  if (isInstruction(InsnType::isAtomic)) {
+    if (isInstruction(InsnType::isLoad)) {
+      architecture_.reserve(memoryAddresses_[0], memoryData_[0]);
+      holdsReservation_ = true;
+    } else {
+      holdsReservation_ = architecture_.holdsReservation(memoryAddresses_[0]);
+    }
+  }
   if (isMicroOp_) {
     switch (microOpcode_) {
       case MicroOpcode::LDR_ADDR: {
@@ -579,6 +589,7 @@ void Instruction::execute() {
         const uint32_t s = sourceValues_[0].get<uint32_t>();
         const uint32_t t = sourceValues_[1].get<uint32_t>();
         const uint32_t n = memoryData_[0].get<uint32_t>();
+        results_[0] = memoryData_[0].zeroExtend(4, 8);
         if (n == s) memoryData_[0] = t;
         break;
       }
@@ -587,6 +598,7 @@ void Instruction::execute() {
         const uint64_t s = sourceValues_[0].get<uint64_t>();
         const uint64_t t = sourceValues_[1].get<uint64_t>();
         const uint64_t n = memoryData_[0].get<uint64_t>();
+        results_[0] = memoryData_[0];
         if (n == s) memoryData_[0] = t;
         break;
       }
@@ -4918,8 +4930,9 @@ void Instruction::execute() {
       case Opcode::AArch64_STLXRX: {  // stlxr ws, xt, [xn]
         // STORE
         memoryData_[0] = sourceValues_[0];
-        // TODO: Implement atomic memory access
-        results_[0] = static_cast<uint64_t>(0);
+        // The status is 0 if the store succeeds, or 1 if the reservation has
+        // been lost
+        results_[0] = static_cast<uint64_t>(holdsReservation_ ? 0 : 1);
         break;
       }
       case Opcode::AArch64_STPDi:    // stp dt1, dt2, [xn, #imm]
@@ -5131,15 +5144,17 @@ void Instruction::execute() {
       case Opcode::AArch64_STXRW: {  // stxr ws, wt, [xn]
         // STORE
         memoryData_[0] = sourceValues_[0];
-        // TODO: Implement atomic memory access
-        results_[0] = static_cast<uint64_t>(0);
+        // The status is 0 if the store succeeds, or 1 if the reservation has
+        // been lost
+        results_[0] = static_cast<uint64_t>(holdsReservation_ ? 0 : 1);
         break;
       }
       case Opcode::AArch64_STXRX: {  // stxr ws, xt, [xn]
         // STORE
         memoryData_[0] = sourceValues_[0];
-        // TODO: Implement atomic memory access
-        results_[0] = static_cast<uint64_t>(0);
+        // The status is 0 if the store succeeds, or 1 if the reservation has
+        // been lost
+        results_[0] = static_cast<uint64_t>(holdsReservation_ ? 0 : 1);
         break;
       }
       case Opcode::AArch64_SUBSWri: {  // subs wd, wn, #imm
@@ -6,18 +6,9 @@ namespace simeng {
 namespace arch {
 namespace aarch64 {
 
-std::unordered_map<uint32_t, std::vector<Instruction>>
-    MicroDecoder::microDecodeCache_;
-std::forward_list<InstructionMetadata> MicroDecoder::microMetadataCache_;
-
 MicroDecoder::MicroDecoder(ryml::ConstNodeRef config)
     : instructionSplit_(config["Core"]["Micro-Operations"].as<bool>()) {}
 
-MicroDecoder::~MicroDecoder() {
-  microDecodeCache_.clear();
-  microMetadataCache_.clear();
-}
-
 bool MicroDecoder::detectOverlap(arm64_reg registerA, arm64_reg registerB) {
   // Early checks on equivalent register ISA names
   if (registerA == registerB) return true;
@@ -84,7 +75,7 @@ uint8_t MicroDecoder::decode(const Architecture& architecture, uint32_t word,
   if (!instructionSplit_) {
     // Instruction splitting not enabled so return macro-operation
     output.resize(num_ops);
-    output[0] = std::make_shared<Instruction>(macroOp);
+    output[0] = makeIntrusive<Instruction>(macroOp);
   } else {
     // Try and find instruction splitting entry in cache
     auto iter = microDecodeCache_.find(word);
@@ -605,7 +596,7 @@ uint8_t MicroDecoder::decode(const Architecture& architecture, uint32_t word,
           // No supported splitting for this Instruction so return
           // macro-operation
           output.resize(num_ops);
-          output[0] = std::make_shared<Instruction>(macroOp);
+          output[0] = makeIntrusive<Instruction>(macroOp);
           return num_ops;
         }
       }
@@ -615,7 +606,7 @@ uint8_t MicroDecoder::decode(const Architecture& architecture, uint32_t word,
     num_ops = iter->second.size();
     output.resize(num_ops);
     for (size_t uop = 0; uop < num_ops; uop++) {
-      output[uop] = std::make_shared<Instruction>(iter->second[uop]);
+      output[uop] = makeIntrusive<Instruction>(iter->second[uop]);
     }
   }
   return num_ops;
@@ -45,10 +45,16 @@ Architecture::Architecture(kernel::Linux& kernel, ryml::ConstNodeRef config)
 
   cs_option(capstoneHandle_, CS_OPT_DETAIL, CS_OPT_ON);
 
+  // Derive the register file structures from the supplied config
+  ArchInfo archInfo(config);
+  archRegStruct_ = archInfo.getArchRegStruct();
+  physRegStruct_ = archInfo.getPhysRegStruct();
+  physRegQuantities_ = archInfo.getPhysRegQuantities();
+
   // Generate zero-indexed system register map
-  for (size_t i = 0; i < config::SimInfo::getSysRegVec().size(); i++) {
-    systemRegisterMap_[config::SimInfo::getSysRegVec()[i]] =
-        systemRegisterMap_.size();
+  const std::vector<uint64_t>& sysRegs = archInfo.getSysRegEnums();
+  for (size_t i = 0; i < sysRegs.size(); i++) {
+    systemRegisterMap_[sysRegs[i]] = systemRegisterMap_.size();
   }
 
   cycleSystemReg_ = {
@@ -110,7 +116,7 @@ Architecture::Architecture(kernel::Linux& kernel, ryml::ConstNodeRef config)
 
   // ports entries in the groupExecutionInfo_ entries only apply for models
   // using the outoforder core archetype
-  if (config::SimInfo::getSimMode() == config::SimulationMode::Outoforder) {
+  if (config["Core"]["Simulation-Mode"].as<std::string>() == "outoforder") {
     // Create mapping between instructions groups and the ports that support
     // them
     for (size_t i = 0; i < config["Ports"].num_children(); i++) {
@@ -166,8 +172,8 @@ uint8_t Architecture::predecode(const void* ptr, uint16_t bytesAvailable,
     metadataCache_.emplace_front(metadata);
     output.resize(1);
     auto& uop = output[0];
-    uop = std::make_shared<Instruction>(*this, metadataCache_.front(),
-                                        InstructionException::MisalignedPC);
+    uop = makeIntrusive<Instruction>(*this, metadataCache_.front(),
+                                     InstructionException::MisalignedPC);
     uop->setInstructionAddress(instructionAddress);
     // Return non-zero value to avoid fatal error
     return 1;
@@ -254,13 +260,25 @@ uint8_t Architecture::predecode(const void* ptr, uint16_t bytesAvailable,
   auto& uop = output[0];
 
   // Retrieve the cached instruction and write to output
-  uop = std::make_shared<Instruction>(iter->second);
+  uop = makeIntrusive<Instruction>(iter->second);
 
   uop->setInstructionAddress(instructionAddress);
 
   return iter->second.getMetadata().getInsnLength();
 }
 
+void Architecture::predecodeFault(uint64_t instructionAddress,
+                                  MacroOp& output) const {
+  // No bytes were read, so the metadata records a single zero byte
+  uint8_t encoding = 0;
+  metadataCache_.emplace_front(InstructionMetadata(&encoding, 1));
+  output.resize(1);
+  auto& uop = output[0];
+  uop = makeIntrusive<Instruction>(*this, metadataCache_.front(),
+                                   InstructionException::InstructionAbort);
+  uop->setInstructionAddress(instructionAddress);
+}
+
 int32_t Architecture::getSystemRegisterTag(uint16_t reg) const {
   // Check below is done for speculative instructions that may be passed into
   // the function but will not be executed. If such invalid speculative
@@ -270,7 +288,7 @@ int32_t Architecture::getSystemRegisterTag(uint16_t reg) const {
 }
 
 std::shared_ptr<arch::ExceptionHandler> Architecture::handleException(
-    const std::shared_ptr<simeng::Instruction>& instruction, const Core& core,
+    const IntrusivePtr<simeng::Instruction>& instruction, const Core& core,
     memory::MemoryInterface& memory) const {
   return std::make_shared<ExceptionHandler>(instruction, core, memory, linux_);
 }
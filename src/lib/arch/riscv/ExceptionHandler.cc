@@ -1,5 +1,6 @@
 #include "simeng/arch/riscv/ExceptionHandler.hh"
 
+#include <cerrno>
 #include <iomanip>
 #include <iostream>
 
@@ -12,7 +13,7 @@ namespace arch {
 namespace riscv {
 
 ExceptionHandler::ExceptionHandler(
-    const std::shared_ptr<simeng::Instruction>& instruction, const Core& core,
+    const IntrusivePtr<simeng::Instruction>& instruction, const Core& core,
     memory::MemoryInterface& memory, kernel::Linux& linux_)
     : instruction_(*static_cast<Instruction*>(instruction.get())),
       core_(core),
@@ -21,7 +22,10 @@ ExceptionHandler::ExceptionHandler(
   resumeHandling_ = [this]() { return init(); };
 }
 
-bool ExceptionHandler::tick() { return resumeHandling_(); }
+bool ExceptionHandler::tick() {
+  std::lock_guard<std::mutex> lock(linux_.getMutex());
+  return resumeHandling_();
+}
 
 bool ExceptionHandler::init() {
   InstructionException exception = instruction_.getException();
@@ -357,10 +361,22 @@ bool ExceptionHandler::init() {
       }
       case 93: {  // exit
         auto exitCode = registerFileSet.get(R0).get<uint64_t>();
+        int64_t tid = core_.getThreadId();
         std::cout << "\n[SimEng:ExceptionHandler] Received exit syscall: "
-                     "terminating with exit code "
-                  << exitCode << std::endl;
-        return fatal();
+                     "thread "
+                  << tid << " terminating with exit code " << exitCode
+                  << std::endl;
+        // Clear the thread's clear_child_tid address to release any threads
+        // joining it
+        uint64_t clearChildTid = linux_.exitThread(tid);
+        stateChange = {ChangeType::REPLACEMENT, {}, {}};
+        if (clearChildTid != 0) {
+          stateChange.memoryAddresses.push_back({clearChildTid, 4});
+          stateChange.memoryAddressValues.push_back(static_cast<uint32_t>(0));
+        }
+        concludeSyscall(stateChange);
+        result_.threadExited = true;
+        return true;
       }
       case 94: {  // exit_group
         auto exitCode = registerFileSet.get(R0).get<uint64_t>();
@@ -371,22 +387,36 @@ bool ExceptionHandler::init() {
       }
       case 96: {  // set_tid_address
         uint64_t ptr = registerFileSet.get(R0).get<uint64_t>();
-        stateChange = {
-            ChangeType::REPLACEMENT, {R0}, {linux_.setTidAddress(ptr)}};
+        stateChange = {ChangeType::REPLACEMENT,
+                       {R0},
+                       {linux_.setTidAddress(core_.getThreadId(), ptr)}};
         break;
       }
       case 98: {  // futex
-        // TODO: Functionality temporarily omitted as it is unused within
-        // workloads regions of interest and not required for their simulation
+        uint64_t uaddr = registerFileSet.get(R0).get<uint64_t>();
         int op = registerFileSet.get(R1).get<int>();
-        if (op != 129) {
+        uint32_t val = registerFileSet.get(R2).get<uint32_t>();
+        uint64_t timeout = registerFileSet.get(R3).get<uint64_t>();
+        uint32_t val3 = registerFileSet.get(R5).get<uint32_t>();
+        bool waiting = false;
+        int64_t retval = linux_.futex(uaddr, op, val, timeout, val3, [&]() {
+          waiting = true;
+          return saveThread();
+        });
+        if (retval == -ENOSYS) {
           printException(instruction_);
           std::cout << "\n[SimEng:ExceptionHandler] Unsupported arguments for "
                        "syscall: "
                     << syscallId << std::endl;
           return fatal();
         }
-        stateChange = {ChangeType::REPLACEMENT, {R0}, {1ull}};
+        stateChange = {ChangeType::REPLACEMENT, {R0}, {retval}};
+        if (waiting) {
+          // The thread sleeps until woken, leaving the core free for another
+          concludeSyscall(stateChange);
+          result_.threadWaiting = true;
+          return true;
+        }
         break;
       }
       case 99: {  // set_robust_list
@@ -427,18 +457,16 @@ bool ExceptionHandler::init() {
         int64_t bitmask = linux_.schedGetAffinity(pid, cpusetsize, mask);
         // If returned bitmask is 0, assume an error
         if (bitmask > 0) {
-          // Currently, only a single CPU bitmask is supported
-          if (bitmask != 1) {
-            printException(instruction_);
-            std::cout << "\n[SimEng:ExceptionHandler] Unexpected CPU affinity "
-                         "mask returned in exception handler"
-                      << std::endl;
-            return fatal();
+          // Write the bytes of the mask needed to represent every CPU
+          uint8_t bytes = 1;
+          while (bytes < sizeof(bitmask) && (bitmask >> (8 * bytes)) != 0) {
+            bytes++;
           }
-          uint64_t retval = (pid == 0) ? 1 : 0;
+          uint64_t retval = (pid == 0) ? bytes : 0;
           stateChange = {ChangeType::REPLACEMENT, {R0}, {retval}};
-          stateChange.memoryAddresses.push_back({mask, 1});
-          stateChange.memoryAddressValues.push_back(bitmask);
+          stateChange.memoryAddresses.push_back({mask, bytes});
+          stateChange.memoryAddressValues.push_back(
+              RegisterValue(bitmask, bytes));
         } else {
           stateChange = {ChangeType::REPLACEMENT, {R0}, {-1ll}};
         }
@@ -534,7 +562,8 @@ bool ExceptionHandler::init() {
         stateChange = {ChangeType::REPLACEMENT, {R0}, {linux_.getegid()}};
         break;
       case 178:  // gettid
-        stateChange = {ChangeType::REPLACEMENT, {R0}, {linux_.gettid()}};
+        stateChange = {
+            ChangeType::REPLACEMENT, {R0}, {core_.getThreadId()}};
         break;
       case 179:  // sysinfo
         stateChange = {ChangeType::REPLACEMENT, {R0}, {0ull}};
@@ -561,6 +590,45 @@ bool ExceptionHandler::init() {
         stateChange = {ChangeType::REPLACEMENT, {R0}, {result}};
         break;
       }
+      case 220: {  // clone
+        uint64_t flags = registerFileSet.get(R0).get<uint64_t>();
+        uint64_t stackPtr = registerFileSet.get(R1).get<uint64_t>();
+        uint64_t parentTidPtr = registerFileSet.get(R2).get<uint64_t>();
+        uint64_t tls = registerFileSet.get(R3).get<uint64_t>();
+        uint64_t childTidPtr = registerFileSet.get(R4).get<uint64_t>();
+
+        // The child resumes from the same point as the parent, with a copy of
+        // its registers and a return value of 0
+        kernel::LinuxThreadContext thread = saveThread();
+        thread.tid = 0;
+        // Later entries take precedence when the changes are applied
+        auto& regs = thread.registers.modifiedRegisters;
+        auto& regValues = thread.registers.modifiedRegisterValues;
+        if (stackPtr != 0) {
+          regs.push_back({RegisterType::GENERAL, 2});
+          regValues.push_back(RegisterValue(stackPtr));
+        }
+        if (flags & kernel::Linux::LINUX_CLONE_SETTLS) {
+          regs.push_back({RegisterType::GENERAL, 4});
+          regValues.push_back(RegisterValue(tls));
+        }
+
+        int64_t tid = linux_.clone(flags, childTidPtr, std::move(thread));
+        stateChange = {ChangeType::REPLACEMENT, {R0}, {tid}};
+        if (tid > 0) {
+          if (flags & kernel::Linux::LINUX_CLONE_PARENT_SETTID) {
+            stateChange.memoryAddresses.push_back({parentTidPtr, 4});
+            stateChange.memoryAddressValues.push_back(
+                static_cast<uint32_t>(tid));
+          }
+          if (flags & kernel::Linux::LINUX_CLONE_CHILD_SETTID) {
+            stateChange.memoryAddresses.push_back({childTidPtr, 4});
+            stateChange.memoryAddressValues.push_back(
+                static_cast<uint32_t>(tid));
+          }
+        }
+        break;
+      }
       case 222: {  // mmap
         uint64_t addr = registerFileSet.get(R0).get<uint64_t>();
         size_t length = registerFileSet.get(R1).get<size_t>();
@@ -855,6 +923,26 @@ bool ExceptionHandler::concludeSyscall(ProcessStateChange& stateChange) {
   return true;
 }
 
+kernel::LinuxThreadContext ExceptionHandler::saveThread() const {
+  const auto& registerFileSet = core_.getArchitecturalRegisterFileSet();
+  kernel::LinuxThreadContext thread = {core_.getThreadId(),
+                                       instruction_.getInstructionAddress() + 4,
+                                       {ChangeType::REPLACEMENT, {}, {}}};
+  auto& regs = thread.registers.modifiedRegisters;
+  auto& regValues = thread.registers.modifiedRegisterValues;
+  const auto& regFileStruct = instruction_.getArchitecture().getArchRegStruct();
+  for (uint8_t type = 0; type < regFileStruct.size(); type++) {
+    for (uint16_t tag = 0; tag < regFileStruct[type].quantity; tag++) {
+      regs.push_back({type, tag});
+      regValues.push_back(registerFileSet.get({type, tag}));
+    }
+  }
+  // Later entries take precedence when the changes are applied
+  regs.push_back(R0);
+  regValues.push_back(RegisterValue(0ull));
+  return thread;
+}
+
 const ExceptionResult& ExceptionHandler::getResult() const { return result_; }
 
 void ExceptionHandler::printException(const Instruction& insn) const {
@@ -874,6 +962,9 @@ void ExceptionHandler::printException(const Instruction& insn) const {
     case InstructionException::MisalignedPC:
       std::cout << "misaligned program counter";
       break;
+    case InstructionException::InstructionAbort:
+      std::cout << "instruction abort";
+      break;
     case InstructionException::DataAbort:
       std::cout << "data abort";
       break;
@@ -926,6 +1017,8 @@ void ExceptionHandler::printException(const Instruction& insn) const {
 }
 
 bool ExceptionHandler::fatal() {
+  // A fatal exception terminates every thread of the process
+  linux_.exitGroup();
   result_ = {true, 0, {}};
   return true;
 }
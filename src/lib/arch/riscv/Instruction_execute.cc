@@ -180,6 +180,16 @@ void Instruction::execute() {
   // Implementation of rv64imafdc according to the v. 20191213 unprivileged spec
 
   executed_ = true;
+  // Load-reserved instructions and AMOs reserve the memory they read, while
+  // store-conditionals only write memory if that reservation is still held
+  if (isInstruction(InsnType::isAtomic)) {
+    if (isInstruction(InsnType::isLoad)) {
+      architecture_.reserve(memoryAddresses_[0], memoryData_[0]);
+      holdsReservation_ = true;
+    } else {
+      holdsReservation_ = architecture_.holdsReservation(memoryAddresses_[0]);
+    }
+  }
   switch (metadata_.opcode) {
     case Opcode::RISCV_LB: {  // LB rd,rs1,imm
       results_[0] =
@@ -560,13 +570,10 @@ void Instruction::execute() {
     }
 
       // Atomic Extension (A)
-      // TODO not implemented atomically
     case Opcode::RISCV_LR_W:  // LR.W rd,rs1
     case Opcode::RISCV_LR_W_AQ:
     case Opcode::RISCV_LR_W_RL:
     case Opcode::RISCV_LR_W_AQ_RL: {
-      // TODO set "reservation set" in memory, currently not needed as all
-      // codes are single threaded
       // TODO check that address is naturally aligned to operand size,
       //  if not raise address-misaligned/access-fault exception
       // TODO use aq and rl bits to prevent reordering with other memory
@@ -590,15 +597,14 @@ void Instruction::execute() {
     case Opcode::RISCV_SC_D_AQ:
     case Opcode::RISCV_SC_D_RL:
     case Opcode::RISCV_SC_D_AQ_RL: {
-      // TODO check "reservation set" hasn't been written to before performing
-      // store
-      // TODO write rd correctly based on whether sc succeeds
       // TODO check that address is naturally aligned to operand size,
       //  if not raise address-misaligned/access-fault exception
       // TODO use aq and rl bits to prevent reordering with other memory
       // operations
       memoryData_[0] = sourceValues_[0];
-      results_[0] = RegisterValue(static_cast<uint64_t>(0), 8);
+      // rd is 0 if the store succeeds, or 1 if the reservation has been lost
+      results_[0] =
+          RegisterValue(static_cast<uint64_t>(holdsReservation_ ? 0 : 1), 8);
       break;
     }
     case Opcode::RISCV_AMOSWAP_W:  // AMOSWAP.W rd,rs1,rs2
@@ -397,6 +397,21 @@ void ModelConfig::setExpectations(bool isDefault) {
   expectations_["Fetch"]["Loop-Detection-Threshold"].setValueBounds<uint16_t>(
       0, UINT16_MAX);
 
+  expectations_["Fetch"].addChild(ExpectationNode::createExpectation<uint16_t>(
+      0, "Fetch-Target-Queue-Size", true));
+  expectations_["Fetch"]["Fetch-Target-Queue-Size"].setValueBounds<uint16_t>(
+      0, 1024);
+
+  expectations_["Fetch"].addChild(ExpectationNode::createExpectation<uint16_t>(
+      1024, "Branch-Target-Buffer-Entries", true));
+  expectations_["Fetch"]["Branch-Target-Buffer-Entries"]
+      .setValueBounds<uint16_t>(1, UINT16_MAX);
+
+  expectations_["Fetch"].addChild(ExpectationNode::createExpectation<uint16_t>(
+      2, "Fetch-Targets-Per-Cycle", true));
+  expectations_["Fetch"]["Fetch-Targets-Per-Cycle"].setValueBounds<uint16_t>(
+      1, 16);
+
   // Process-Image
   expectations_.addChild(ExpectationNode::createExpectation("Process-Image"));
 
@@ -504,7 +519,7 @@ void ModelConfig::setExpectations(bool isDefault) {
   expectations_["Branch-Predictor"].addChild(
       ExpectationNode::createExpectation<std::string>("Perceptron", "Type"));
   expectations_["Branch-Predictor"]["Type"].setValueSet(
-      std::vector<std::string>{"Generic", "Perceptron"});
+      std::vector<std::string>{"Generic", "Perceptron", "TAGE"});
 
   expectations_["Branch-Predictor"].addChild(
       ExpectationNode::createExpectation<uint8_t>(8, "BTB-Tag-Bits"));
@@ -521,8 +536,9 @@ void ModelConfig::setExpectations(bool isDefault) {
   expectations_["Branch-Predictor"]["RAS-entries"].setValueBounds<uint16_t>(
       1, UINT16_MAX);
 
-  // The saturating counter bits and the fallback predictor
-  // are relevant to the GenericPredictor only
+  // The saturating counter bits and the fallback predictor are relevant to the
+  // GenericPredictor only, and the table geometry to the TagePredictor only.
+  // The PerceptronPredictor holds its global history in 64 bits
   if (!isDefault) {
     // Ensure the key "Branch-Predictor" exists before querying the associated
     // YAML node
@@ -544,6 +560,51 @@ void ModelConfig::setExpectations(bool isDefault) {
           expectations_["Branch-Predictor"]["Fallback-Static-Predictor"]
               .setValueSet(
                   std::vector<std::string>{"Always-Taken", "Always-Not-Taken"});
+        } else if (configTree_["Branch-Predictor"]["Type"].as<std::string>() ==
+                   "Perceptron") {
+          expectations_["Branch-Predictor"]["Global-History-Length"]
+              .setValueBounds<uint16_t>(1, 64);
+        } else if (configTree_["Branch-Predictor"]["Type"].as<std::string>() ==
+                   "TAGE") {
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint8_t>(12,
+                                                          "Base-Table-Bits"));
+          expectations_["Branch-Predictor"]["Base-Table-Bits"]
+              .setValueBounds<uint8_t>(1, 24);
+
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint8_t>(7, "Tagged-Tables"));
+          expectations_["Branch-Predictor"]["Tagged-Tables"]
+              .setValueBounds<uint8_t>(1, 16);
+
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint8_t>(
+                  10, "Tagged-Table-Bits"));
+          expectations_["Branch-Predictor"]["Tagged-Table-Bits"]
+              .setValueBounds<uint8_t>(1, 24);
+
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint8_t>(9, "Tag-Bits"));
+          expectations_["Branch-Predictor"]["Tag-Bits"].setValueBounds<uint8_t>(
+              2, 16);
+
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint16_t>(
+                  4, "Min-History-Length"));
+          expectations_["Branch-Predictor"]["Min-History-Length"]
+              .setValueBounds<uint16_t>(1, UINT16_MAX);
+
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint8_t>(4,
+                                                          "Indirect-Tables"));
+          expectations_["Branch-Predictor"]["Indirect-Tables"]
+              .setValueBounds<uint8_t>(0, 16);
+
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint8_t>(
+                  9, "Indirect-Table-Bits"));
+          expectations_["Branch-Predictor"]["Indirect-Table-Bits"]
+              .setValueBounds<uint8_t>(1, 24);
         }
       } else {
         std::cerr << "[SimEng:ModelConfig] Attempted to access config key "
@@ -570,7 +631,9 @@ void ModelConfig::setExpectations(bool isDefault) {
       ExpectationNode::createExpectation<std::string>("Flat",
                                                       "Interface-Type"));
   expectations_["L1-Data-Memory"]["Interface-Type"].setValueSet(
-      std::vector<std::string>{"Flat", "Fixed", "External"});
+      std::vector<std::string>{"Flat", "Fixed", "Cache", "External"});
+
+  addCacheExpectations("L1-Data-Memory", 65536, 4, 4, 8);
 
   // L1-Instruction-Memory
   expectations_.addChild(
@@ -580,7 +643,106 @@ void ModelConfig::setExpectations(bool isDefault) {
       ExpectationNode::createExpectation<std::string>("Flat",
                                                       "Interface-Type"));
   expectations_["L1-Instruction-Memory"]["Interface-Type"].setValueSet(
-      std::vector<std::string>{"Flat", "Fixed", "External"});
+      std::vector<std::string>{"Flat", "Fixed", "Cache", "External"});
+
+  addCacheExpectations("L1-Instruction-Memory", 65536, 4, 1, 8);
+
+  // L2-Cache; only used by the Cache Interface-Type, and absent if its Size is
+  // 0
+  expectations_.addChild(ExpectationNode::createExpectation("L2-Cache", true));
+  addCacheExpectations("L2-Cache", 0, 8, 12, 16);
+
+  // Last-Level-Cache; shared by all cores, and absent if its Size is 0
+  expectations_.addChild(
+      ExpectationNode::createExpectation("Last-Level-Cache", true));
+  addCacheExpectations("Last-Level-Cache", 0, 16, 36, 32);
+
+  // Main-Memory
+  expectations_.addChild(
+      ExpectationNode::createExpectation("Main-Memory", true));
+
+  expectations_["Main-Memory"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(100, "Access-Latency",
+                                                   true));
+  expectations_["Main-Memory"]["Access-Latency"].setValueBounds<uint16_t>(
+      1, UINT16_MAX);
+
+  // TLB; translations are free on either side whose Entries is 0
+  expectations_.addChild(ExpectationNode::createExpectation("TLB", true));
+
+  expectations_["TLB"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(4096, "Page-Size", true));
+  expectations_["TLB"]["Page-Size"].setValueSet(
+      std::vector<uint64_t>{4096, 16384, 65536, 2097152});
+
+  for (std::string level : {"Instruction", "Data", "L2"}) {
+    expectations_["TLB"].addChild(ExpectationNode::createExpectation<uint32_t>(
+        0, level + "-Entries", true));
+    expectations_["TLB"].addChild(ExpectationNode::createExpectation<uint16_t>(
+        level == "L2" ? 8 : 4, level + "-Associativity", true));
+    expectations_["TLB"][level + "-Associativity"].setValueBounds<uint16_t>(
+        1, UINT16_MAX);
+  }
+
+  expectations_["TLB"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(8, "L2-Latency", true));
+
+  expectations_["TLB"].addChild(ExpectationNode::createExpectation<uint16_t>(
+      30, "Page-Walk-Latency", true));
+  expectations_["TLB"]["Page-Walk-Latency"].setValueBounds<uint16_t>(
+      1, UINT16_MAX);
+
+  // Data-Prefetcher; trains on the loads made to a Cache L1-Data-Memory
+  expectations_.addChild(
+      ExpectationNode::createExpectation("Data-Prefetcher", true));
+
+  expectations_["Data-Prefetcher"].addChild(
+      ExpectationNode::createExpectation<bool>(false, "Next-Line", true));
+  expectations_["Data-Prefetcher"]["Next-Line"].setValueSet(
+      std::vector{false, true});
+
+  expectations_["Data-Prefetcher"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(1, "Next-Line-Degree",
+                                                   true));
+  expectations_["Data-Prefetcher"]["Next-Line-Degree"].setValueBounds<uint16_t>(
+      1, 64);
+
+  expectations_["Data-Prefetcher"].addChild(
+      ExpectationNode::createExpectation<bool>(false, "Stride", true));
+  expectations_["Data-Prefetcher"]["Stride"].setValueSet(
+      std::vector{false, true});
+
+  expectations_["Data-Prefetcher"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(64, "Stride-Table-Entries",
+                                                   true));
+  expectations_["Data-Prefetcher"]["Stride-Table-Entries"]
+      .setValueBounds<uint16_t>(1, UINT16_MAX);
+
+  expectations_["Data-Prefetcher"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(2, "Stride-Degree", true));
+  expectations_["Data-Prefetcher"]["Stride-Degree"].setValueBounds<uint16_t>(
+      1, 64);
+
+  expectations_["Data-Prefetcher"].addChild(
+      ExpectationNode::createExpectation<bool>(false, "Stream", true));
+  expectations_["Data-Prefetcher"]["Stream"].setValueSet(
+      std::vector{false, true});
+
+  expectations_["Data-Prefetcher"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(16, "Stream-Table-Entries",
+                                                   true));
+  expectations_["Data-Prefetcher"]["Stream-Table-Entries"]
+      .setValueBounds<uint16_t>(1, UINT16_MAX);
+
+  expectations_["Data-Prefetcher"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(8, "Stream-Distance", true));
+  expectations_["Data-Prefetcher"]["Stream-Distance"].setValueBounds<uint16_t>(
+      1, 256);
+
+  expectations_["Data-Prefetcher"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(2, "Stream-Degree", true));
+  expectations_["Data-Prefetcher"]["Stream-Degree"].setValueBounds<uint16_t>(
+      1, 64);
 
   // LSQ-L1-Interface
   expectations_.addChild(
@@ -635,6 +797,42 @@ void ModelConfig::setExpectations(bool isDefault) {
   expectations_["LSQ-L1-Interface"]["Permitted-Stores-Per-Cycle"]
       .setValueBounds<uint16_t>(1, UINT16_MAX);
 
+  // Memory-Dependence-Predictor; a store set predictor used by the outoforder
+  // core's LSQ, and absent if Store-Set-ID-Entries is 0
+  expectations_.addChild(
+      ExpectationNode::createExpectation("Memory-Dependence-Predictor", true));
+
+  expectations_["Memory-Dependence-Predictor"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(0, "Store-Set-ID-Entries",
+                                                   true));
+
+  expectations_["Memory-Dependence-Predictor"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(128, "Store-Sets", true));
+  expectations_["Memory-Dependence-Predictor"]["Store-Sets"]
+      .setValueBounds<uint16_t>(1, UINT16_MAX);
+
+  expectations_["Memory-Dependence-Predictor"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(1000000, "Clear-Interval",
+                                                   true));
+
+  // Micro-Op-Cache; a cache of pre-decoded instructions used by the outoforder
+  // core's fetch unit, and absent if Entries is 0
+  expectations_.addChild(
+      ExpectationNode::createExpectation("Micro-Op-Cache", true));
+
+  expectations_["Micro-Op-Cache"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(0, "Entries", true));
+
+  expectations_["Micro-Op-Cache"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(8, "Associativity", true));
+  expectations_["Micro-Op-Cache"]["Associativity"].setValueBounds<uint16_t>(
+      1, UINT16_MAX);
+
+  expectations_["Micro-Op-Cache"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(6, "Width", true));
+  expectations_["Micro-Op-Cache"]["Width"].setValueBounds<uint16_t>(
+      1, UINT16_MAX);
+
   // Ports
   expectations_.addChild(ExpectationNode::createExpectation("Ports"));
   expectations_["Ports"].addChild(
@@ -828,6 +1026,152 @@ void ModelConfig::setExpectations(bool isDefault) {
       ExpectationNode::createExpectation<uint64_t>(1, "Package-Count", true));
   expectations_["CPU-Info"]["Package-Count"].setValueBounds<uint64_t>(
       1, UINT16_MAX);
+
+  expectations_["CPU-Info"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(1, "Host-Threads", true));
+  expectations_["CPU-Info"]["Host-Threads"].setValueBounds<uint64_t>(
+      1, UINT16_MAX);
+
+  expectations_["CPU-Info"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(1, "Sync-Quantum", true));
+  expectations_["CPU-Info"]["Sync-Quantum"].setValueBounds<uint64_t>(
+      1, UINT32_MAX);
+
+  // Checkpoint
+  expectations_.addChild(
+      ExpectationNode::createExpectation("Checkpoint", true));
+
+  expectations_["Checkpoint"].addChild(
+      ExpectationNode::createExpectation<std::string>("", "Save-Path", true));
+
+  expectations_["Checkpoint"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(0, "Save-At-Instruction",
+                                                   true));
+  expectations_["Checkpoint"]["Save-At-Instruction"].setValueBounds<uint64_t>(
+      0, UINT64_MAX);
+
+  expectations_["Checkpoint"].addChild(
+      ExpectationNode::createExpectation<std::string>("", "Restore-Path",
+                                                      true));
+
+  // Sampling
+  expectations_.addChild(ExpectationNode::createExpectation("Sampling", true));
+
+  expectations_["Sampling"].addChild(
+      ExpectationNode::createExpectation<std::string>("None", "Mode", true));
+  expectations_["Sampling"]["Mode"].setValueSet(
+      std::vector<std::string>{"None", "Periodic", "SimPoint"});
+
+  expectations_["Sampling"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(10000000, "Interval-Length",
+                                                   true));
+  expectations_["Sampling"]["Interval-Length"].setValueBounds<uint64_t>(
+      1, UINT64_MAX);
+
+  expectations_["Sampling"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(10000, "Detail-Length",
+                                                   true));
+  expectations_["Sampling"]["Detail-Length"].setValueBounds<uint64_t>(
+      1, UINT64_MAX);
+
+  expectations_["Sampling"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(2000, "Warmup-Length",
+                                                   true));
+  expectations_["Sampling"]["Warmup-Length"].setValueBounds<uint64_t>(
+      0, UINT64_MAX);
+
+  expectations_["Sampling"].addChild(ExpectationNode::createExpectation<bool>(
+      true, "Functional-Warming", true));
+  expectations_["Sampling"]["Functional-Warming"].setValueSet(
+      std::vector{false, true});
+
+  expectations_["Sampling"].addChild(
+      ExpectationNode::createExpectation<std::string>("", "SimPoint-File",
+                                                      true));
+
+  expectations_["Sampling"].addChild(
+      ExpectationNode::createExpectation<std::string>("", "Weights-File",
+                                                      true));
+
+  expectations_["Sampling"].addChild(
+      ExpectationNode::createExpectation<std::string>("", "BBV-Path", true));
+
+  // Pipeline-Trace; a per-uop trace of the outoforder pipeline, written only
+  // if a Path is given
+  expectations_.addChild(
+      ExpectationNode::createExpectation("Pipeline-Trace", true));
+
+  expectations_["Pipeline-Trace"].addChild(
+      ExpectationNode::createExpectation<std::string>("", "Path", true));
+
+  expectations_["Pipeline-Trace"].addChild(
+      ExpectationNode::createExpectation<std::string>("Konata", "Format",
+                                                      true));
+  expectations_["Pipeline-Trace"]["Format"].setValueSet(
+      std::vector<std::string>{"Konata", "O3PipeView"});
+
+  expectations_["Pipeline-Trace"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(0, "Start-Cycle", true));
+  expectations_["Pipeline-Trace"]["Start-Cycle"].setValueBounds<uint64_t>(
+      0, UINT64_MAX);
+
+  expectations_["Pipeline-Trace"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(0, "Cycle-Count", true));
+  expectations_["Pipeline-Trace"]["Cycle-Count"].setValueBounds<uint64_t>(
+      0, UINT64_MAX);
+
+  expectations_["Pipeline-Trace"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(0, "Start-Instruction",
+                                                   true));
+  expectations_["Pipeline-Trace"]["Start-Instruction"]
+      .setValueBounds<uint64_t>(0, UINT64_MAX);
+
+  expectations_["Pipeline-Trace"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(100000, "Instruction-Count",
+                                                   true));
+  expectations_["Pipeline-Trace"]["Instruction-Count"]
+      .setValueBounds<uint64_t>(0, UINT64_MAX);
+}
+
+void ModelConfig::addCacheExpectations(std::string section, uint64_t size,
+                                       uint16_t associativity,
+                                       uint16_t hitLatency, uint16_t mshrs) {
+  // A Size of 0 is only permitted for the optional lower levels, where it
+  // marks the level as absent
+  expectations_[section].addChild(
+      ExpectationNode::createExpectation<uint64_t>(size, "Size", true));
+  expectations_[section]["Size"].setValueBounds<uint64_t>(size == 0 ? 0 : 1,
+                                                          UINT64_MAX);
+
+  expectations_[section].addChild(ExpectationNode::createExpectation<uint16_t>(
+      associativity, "Associativity", true));
+  expectations_[section]["Associativity"].setValueBounds<uint16_t>(1,
+                                                                   UINT16_MAX);
+
+  expectations_[section].addChild(
+      ExpectationNode::createExpectation<uint16_t>(64, "Line-Size", true));
+  expectations_[section]["Line-Size"].setValueBounds<uint16_t>(1, UINT16_MAX);
+
+  expectations_[section].addChild(ExpectationNode::createExpectation<uint16_t>(
+      hitLatency, "Hit-Latency", true));
+  expectations_[section]["Hit-Latency"].setValueBounds<uint16_t>(1,
+                                                                 UINT16_MAX);
+
+  expectations_[section].addChild(
+      ExpectationNode::createExpectation<uint16_t>(mshrs, "MSHRs", true));
+  expectations_[section]["MSHRs"].setValueBounds<uint16_t>(1, UINT16_MAX);
+
+  expectations_[section].addChild(
+      ExpectationNode::createExpectation<bool>(true, "Write-Back", true));
+
+  expectations_[section].addChild(
+      ExpectationNode::createExpectation<bool>(true, "Write-Allocate", true));
+
+  expectations_[section].addChild(
+      ExpectationNode::createExpectation<std::string>(
+          "LRU", "Replacement-Policy", true));
+  expectations_[section]["Replacement-Policy"].setValueSet(
+      std::vector<std::string>{"LRU", "FIFO", "Random"});
 }
 
 void ModelConfig::recursiveValidate(ExpectationNode expectation,
@@ -888,6 +1232,13 @@ void ModelConfig::recursiveValidate(ExpectationNode expectation,
       if (!result.valid)
         invalid_ << "\t- "
                  << hierarchyString + nodeKey + " " + result.message + "\n";
+      // An omitted optional section is populated with the defaults of its
+      // children
+      if (result.valid && child.isOptional() && child.getChildren().size() &&
+          !child.getChildren()[0].isWildcard()) {
+        rymlChild |= ryml::MAP;
+        recursiveValidate(child, rymlChild, hierarchyString + nodeKey + ":");
+      }
     }
   }
 }
@@ -903,6 +1254,20 @@ void ModelConfig::postValidation() {
                 "and Core-Count must be divisible by Package-Count\n";
   }
 
+  // A decoupled fetch unit buffers the blocks of a cycle's fetch targets
+  // alongside those of the previous cycle
+  if (configTree_["Fetch"]["Fetch-Target-Queue-Size"].as<uint16_t>() > 0) {
+    uint32_t blockSize =
+        configTree_["Fetch"]["Fetch-Block-Size"].as<uint16_t>();
+    uint32_t targets =
+        configTree_["Fetch"]["Fetch-Targets-Per-Cycle"].as<uint16_t>();
+    if (blockSize * (targets + 1) > 16384) {
+      invalid_ << "\t- Fetch-Block-Size multiplied by one more than "
+                  "Fetch-Targets-Per-Cycle must be at most 16384 when "
+                  "Fetch-Target-Queue-Size is non-zero\n";
+    }
+  }
+
   // Convert all instruction group strings to their corresponding group
   // numbers into another config option
   for (ryml::NodeRef node : configTree_["Ports"]) {
@@ -1043,14 +1408,124 @@ void ModelConfig::postValidation() {
                << l1dType << "\n";
   }
 
-  // Currently, only a Flat L1-Instruction-Memory:Interface-Type is supported
+  // Currently, only a Flat L1-Instruction-Memory:Interface-Type is supported,
+  // other than a Cache with the outoforder Simulation-Mode
   std::string l1iType =
       configTree_["L1-Instruction-Memory"]["Interface-Type"].as<std::string>();
-  if (l1iType != "Flat")
+  if (l1iType != "Flat" && !(l1iType == "Cache" && simMode == "outoforder"))
     invalid_ << "\t- Only a 'Flat' L1-Instruction-Memory Interface-Type is "
-                "supported. Interface-Type used is "
+                "supported, or a 'Cache' with the outoforder Simulation-Mode. "
+                "Interface-Type used is "
              << l1iType << "\n";
 
+  // Each cache level must divide into a power-of-two number of sets of
+  // power-of-two sized lines
+  for (std::string section : {"L1-Data-Memory", "L1-Instruction-Memory",
+                              "L2-Cache", "Last-Level-Cache"}) {
+    auto cache = configTree_[ryml::to_csubstr(section)];
+    uint64_t size = cache["Size"].as<uint64_t>();
+    uint64_t lineSize = cache["Line-Size"].as<uint64_t>();
+    uint64_t setSize = cache["Associativity"].as<uint64_t>() * lineSize;
+    if (size == 0) continue;
+    if (lineSize & (lineSize - 1))
+      invalid_ << "\t- " << section
+               << ":Line-Size must be a power of 2. Line-Size used is "
+               << lineSize << "\n";
+    uint64_t sets = size / setSize;
+    if (size % setSize != 0 || sets == 0 || (sets & (sets - 1)))
+      invalid_ << "\t- " << section
+               << ":Size must hold a power of 2 number of sets of "
+                  "Associativity * Line-Size bytes. Size used is "
+               << size << "\n";
+  }
+
+  // TLBs are modelled by the outoforder core's fetch unit and LSQ, and each
+  // level must divide into whole sets
+  bool tlbModelled = false;
+  auto tlb = configTree_["TLB"];
+  for (std::string level : {"Instruction", "Data", "L2"}) {
+    std::string entriesKey = level + "-Entries";
+    std::string waysKey = level + "-Associativity";
+    uint64_t entries = tlb[ryml::to_csubstr(entriesKey)].as<uint64_t>();
+    uint64_t ways = tlb[ryml::to_csubstr(waysKey)].as<uint64_t>();
+    if (entries == 0) continue;
+    tlbModelled = true;
+    if (entries % ways != 0)
+      invalid_ << "\t- TLB:" << level
+               << "-Entries must be a multiple of TLB:" << level
+               << "-Associativity. Entries used is " << entries << "\n";
+  }
+  if (tlbModelled && simMode != "outoforder")
+    invalid_ << "\t- TLBs may only be modelled with the outoforder "
+                "Simulation-Mode. Simulation-Mode used is "
+             << simMode << "\n";
+
+  // The memory dependence predictor is consulted by the outoforder core's LSQ
+  if (configTree_["Memory-Dependence-Predictor"]["Store-Set-ID-Entries"]
+              .as<uint64_t>() != 0 &&
+      simMode != "outoforder")
+    invalid_ << "\t- A Memory-Dependence-Predictor may only be modelled with "
+                "the outoforder Simulation-Mode. Simulation-Mode used is "
+             << simMode << "\n";
+
+  // The micro-op cache is consulted by the outoforder core's fetch unit, and
+  // must divide into whole sets
+  uint64_t microOpEntries =
+      configTree_["Micro-Op-Cache"]["Entries"].as<uint64_t>();
+  if (microOpEntries != 0) {
+    uint64_t ways =
+        configTree_["Micro-Op-Cache"]["Associativity"].as<uint64_t>();
+    if (microOpEntries % ways != 0)
+      invalid_ << "\t- Micro-Op-Cache:Entries must be a multiple of "
+                  "Micro-Op-Cache:Associativity. Entries used is "
+               << microOpEntries << "\n";
+    if (simMode != "outoforder")
+      invalid_ << "\t- A Micro-Op-Cache may only be modelled with the "
+                  "outoforder Simulation-Mode. Simulation-Mode used is "
+               << simMode << "\n";
+  }
+
+  // Prefetchers fill the L1 data cache, so require one to be modelled
+  auto prefetcher = configTree_["Data-Prefetcher"];
+  if ((prefetcher["Next-Line"].as<bool>() || prefetcher["Stride"].as<bool>() ||
+       prefetcher["Stream"].as<bool>()) &&
+      configTree_["L1-Data-Memory"]["Interface-Type"].as<std::string>() !=
+          "Cache")
+    invalid_ << "\t- A Data-Prefetcher may only be enabled with a 'Cache' "
+                "L1-Data-Memory Interface-Type\n";
+
+  // Sampled simulation switches a single thread between an emulation core and
+  // an outoforder core used for the detailed intervals
+  std::string samplingMode =
+      configTree_["Sampling"]["Mode"].as<std::string>();
+  if (samplingMode != "None") {
+    if (simMode != "outoforder")
+      invalid_ << "\t- Sampling may only be used with the outoforder "
+                  "Simulation-Mode. Simulation-Mode used is "
+               << simMode << "\n";
+    if (coreCount != 1)
+      invalid_ << "\t- Sampling may only be used with a Core-Count of 1\n";
+    if (configTree_["Checkpoint"]["Save-Path"].as<std::string>() != "")
+      invalid_ << "\t- A checkpoint cannot be saved during a sampled "
+                  "simulation\n";
+    if (samplingMode == "SimPoint" &&
+        configTree_["Sampling"]["SimPoint-File"].as<std::string>() == "")
+      invalid_ << "\t- A SimPoint-File must be provided with the SimPoint "
+                  "sampling Mode\n";
+  }
+
+  // The pipeline trace follows the uops of a single outoforder core
+  if (configTree_["Pipeline-Trace"]["Path"].as<std::string>() != "" &&
+      (simMode != "outoforder" || coreCount != 1))
+    invalid_ << "\t- A Pipeline-Trace Path may only be used with the "
+                "outoforder Simulation-Mode and a Core-Count of 1\n";
+
+  // Basic block vectors are profiled by a single emulation core
+  if (configTree_["Sampling"]["BBV-Path"].as<std::string>() != "" &&
+      (simMode != "emulation" || coreCount != 1))
+    invalid_ << "\t- A BBV-Path may only be used with the emulation "
+                "Simulation-Mode and a Core-Count of 1\n";
+
   if (isa_ == ISA::AArch64) {
     // Ensure LSQ-L1-Interface Load/Store Bandwidth is large enough to
     // accomodate a full vector load of the specified Vector-Length parameter
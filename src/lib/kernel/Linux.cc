@@ -17,6 +17,8 @@
 #include <cstring>
 #include <iostream>
 
+#include "simeng/memory/SharedMemory.hh"
+
 namespace simeng {
 namespace kernel {
 
@@ -30,7 +32,11 @@ void Linux::createProcess(const LinuxProcess& process) {
        .currentBrk = process.getHeapStart(),
        .initialStackPointer = process.getInitialStackPointer(),
        .mmapRegion = process.getMmapStart(),
-       .pageSize = process.getPageSize()});
+       .pageSize = process.getPageSize(),
+       .processImage = process.getProcessImage(),
+       .processImageSize = process.getProcessImageSize(),
+       .clearChildTids = {{0, 0}},
+       .nextTid = 1});
   processStates_.back().fileDescriptorTable.push_back(STDIN_FILENO);
   processStates_.back().fileDescriptorTable.push_back(STDOUT_FILENO);
   processStates_.back().fileDescriptorTable.push_back(STDERR_FILENO);
@@ -84,6 +90,187 @@ std::string Linux::getSpecialFile(const std::string filename) {
   return filename;
 }
 
+/** Write a list of memory allocations to `checkpoint`. Only the first link of
+ * each allocation's `vm_next` chain is consulted, so only it is recorded. */
+void checkpointAllocations(CheckpointWriter& checkpoint,
+                           const std::vector<vm_area_struct>& allocations) {
+  checkpoint.write<uint64_t>(allocations.size());
+  for (const auto& alloc : allocations) {
+    checkpoint.write(alloc.vm_start);
+    checkpoint.write(alloc.vm_end);
+    checkpoint.write<bool>(alloc.vm_next != NULL);
+    if (alloc.vm_next != NULL) {
+      checkpoint.write(alloc.vm_next->vm_start);
+      checkpoint.write(alloc.vm_next->vm_end);
+    }
+  }
+}
+
+/** Read a list of memory allocations written by `checkpointAllocations`. */
+void restoreAllocations(CheckpointReader& checkpoint,
+                        std::vector<vm_area_struct>& allocations) {
+  uint64_t count = 0;
+  checkpoint.read(count);
+  allocations.resize(count);
+  for (auto& alloc : allocations) {
+    bool hasNext = false;
+    checkpoint.read(alloc.vm_start);
+    checkpoint.read(alloc.vm_end);
+    checkpoint.read(hasNext);
+    alloc.vm_next = NULL;
+    if (hasNext) {
+      alloc.vm_next = std::make_shared<vm_area_struct>();
+      checkpoint.read(alloc.vm_next->vm_start);
+      checkpoint.read(alloc.vm_next->vm_end);
+    }
+  }
+}
+
+void Linux::checkpoint(CheckpointWriter& checkpoint) const {
+  assert(processStates_.size() == 1 && "Multiple processes not yet supported");
+  const LinuxProcessState& state = processStates_[0];
+  checkpoint.write(state.pid);
+  checkpoint.write(state.path);
+  checkpoint.write(state.startBrk);
+  checkpoint.write(state.currentBrk);
+  checkpoint.write(state.initialStackPointer);
+  checkpoint.write(state.mmapRegion);
+  checkpoint.write(state.pageSize);
+  checkpointAllocations(checkpoint, state.contiguousAllocations);
+  checkpointAllocations(checkpoint, state.nonContiguousAllocations);
+
+  checkpoint.write<uint64_t>(state.clearChildTids.size());
+  for (const auto& [tid, address] : state.clearChildTids) {
+    checkpoint.write(tid);
+    checkpoint.write(address);
+  }
+  checkpoint.write(state.nextTid);
+
+  // Host file descriptors are meaningless to a later process, so record enough
+  // to re-open each file instead. The standard streams are inherited as-is
+  checkpoint.write<uint64_t>(state.fileDescriptorTable.size());
+  for (int64_t hfd : state.fileDescriptorTable) {
+    checkpoint.write(hfd);
+    if (hfd <= STDERR_FILENO) continue;
+
+    char path[LINUX_PATH_MAX];
+    std::string link = "/proc/self/fd/" + std::to_string(hfd);
+    ssize_t length = ::readlink(link.c_str(), path, LINUX_PATH_MAX - 1);
+    checkpoint.write(std::string(path, std::max<ssize_t>(length, 0)));
+    checkpoint.write<int64_t>(::fcntl(hfd, F_GETFL));
+    checkpoint.write<int64_t>(::lseek(hfd, 0, SEEK_CUR));
+  }
+  checkpoint.write<uint64_t>(state.freeFileDescriptors.size());
+  for (int64_t fd : state.freeFileDescriptors) checkpoint.write(fd);
+
+  checkpoint.write<uint64_t>(pendingThreads_.size());
+  for (const auto& thread : pendingThreads_) {
+    checkpoint.write(thread.tid);
+    checkpoint.write(thread.pc);
+    checkpoint.write(thread.registers);
+  }
+  checkpoint.write<uint64_t>(futexWaiters_.size());
+  for (const auto& [address, waiters] : futexWaiters_) {
+    checkpoint.write(address);
+    checkpoint.write<uint64_t>(waiters.size());
+    for (const auto& waiter : waiters) {
+      checkpoint.write(waiter.thread.tid);
+      checkpoint.write(waiter.thread.pc);
+      checkpoint.write(waiter.thread.registers);
+      checkpoint.write(waiter.bitset);
+    }
+  }
+  checkpoint.write(exited_.load());
+}
+
+void Linux::restore(CheckpointReader& checkpoint) {
+  assert(processStates_.size() == 1 &&
+         "A process must be created before its state is restored");
+  LinuxProcessState& state = processStates_[0];
+  checkpoint.read(state.pid);
+  checkpoint.read(state.path);
+  checkpoint.read(state.startBrk);
+  checkpoint.read(state.currentBrk);
+  checkpoint.read(state.initialStackPointer);
+  checkpoint.read(state.mmapRegion);
+  checkpoint.read(state.pageSize);
+  restoreAllocations(checkpoint, state.contiguousAllocations);
+  restoreAllocations(checkpoint, state.nonContiguousAllocations);
+
+  uint64_t count = 0;
+  checkpoint.read(count);
+  state.clearChildTids.clear();
+  for (uint64_t i = 0; i < count; i++) {
+    int64_t tid = 0;
+    uint64_t address = 0;
+    checkpoint.read(tid);
+    checkpoint.read(address);
+    state.clearChildTids[tid] = address;
+  }
+  checkpoint.read(state.nextTid);
+
+  checkpoint.read(count);
+  state.fileDescriptorTable.resize(count);
+  for (int64_t& hfd : state.fileDescriptorTable) {
+    checkpoint.read(hfd);
+    if (hfd <= STDERR_FILENO) continue;
+
+    std::string path;
+    int64_t flags = 0;
+    int64_t offset = 0;
+    checkpoint.read(path);
+    checkpoint.read(flags);
+    checkpoint.read(offset);
+    // Re-open without any flags which would alter the file's contents
+    hfd = ::open(path.c_str(), flags & ~(O_CREAT | O_EXCL | O_TRUNC));
+    if (hfd < 0) {
+      std::cerr << "[SimEng:Linux] WARNING: unable to re-open checkpointed "
+                   "file '"
+                << path << "'; its descriptor will be treated as closed"
+                << std::endl;
+      continue;
+    }
+    if (offset > 0) ::lseek(hfd, offset, SEEK_SET);
+  }
+  checkpoint.read(count);
+  state.freeFileDescriptors.clear();
+  for (uint64_t i = 0; i < count; i++) {
+    int64_t fd = 0;
+    checkpoint.read(fd);
+    state.freeFileDescriptors.insert(fd);
+  }
+
+  checkpoint.read(count);
+  pendingThreads_.clear();
+  for (uint64_t i = 0; i < count; i++) {
+    LinuxThreadContext thread;
+    checkpoint.read(thread.tid);
+    checkpoint.read(thread.pc);
+    checkpoint.read(thread.registers);
+    pendingThreads_.push_back(std::move(thread));
+  }
+  checkpoint.read(count);
+  futexWaiters_.clear();
+  for (uint64_t i = 0; i < count; i++) {
+    uint64_t address = 0;
+    uint64_t waiterCount = 0;
+    checkpoint.read(address);
+    checkpoint.read(waiterCount);
+    auto& waiters = futexWaiters_[address];
+    for (uint64_t j = 0; j < waiterCount; j++) {
+      FutexWaiter waiter;
+      checkpoint.read(waiter.thread.tid);
+      checkpoint.read(waiter.thread.pc);
+      checkpoint.read(waiter.thread.registers);
+      checkpoint.read(waiter.bitset);
+      waiters.push_back(std::move(waiter));
+    }
+  }
+  bool exited;
+  checkpoint.read(exited);
+  exited_ = exited;
+}
+
 uint64_t Linux::getInitialStackPointer() const {
   assert(processStates_.size() > 0 &&
          "Attempted to retrieve a stack pointer before creating a process");
@@ -293,6 +480,95 @@ int64_t Linux::getrusage(int64_t who, rusage& out) {
   return retval;
 }
 
+int64_t Linux::clone(uint64_t flags, uint64_t childTidPtr,
+                     LinuxThreadContext thread) {
+  assert(processStates_.size() > 0);
+  // Only threads sharing the address space of the current process can be
+  // created
+  if (!(flags & LINUX_CLONE_VM) || !(flags & LINUX_CLONE_THREAD)) {
+    return -ENOSYS;
+  }
+
+  auto& state = processStates_[0];
+  thread.tid = state.nextTid++;
+  state.clearChildTids[thread.tid] =
+      (flags & LINUX_CLONE_CHILD_CLEARTID) ? childTidPtr : 0;
+  pendingThreads_.push_back(std::move(thread));
+  return pendingThreads_.back().tid;
+}
+
+bool Linux::hasPendingThreads() const { return !pendingThreads_.empty(); }
+
+LinuxThreadContext Linux::takePendingThread() {
+  assert(hasPendingThreads() && "No threads are waiting to be scheduled");
+  LinuxThreadContext thread = std::move(pendingThreads_.front());
+  pendingThreads_.pop_front();
+  return thread;
+}
+
+uint64_t Linux::exitThread(int64_t tid) {
+  assert(processStates_.size() > 0);
+  auto& clearChildTids = processStates_[0].clearChildTids;
+  auto entry = clearChildTids.find(tid);
+  if (entry == clearChildTids.end()) return 0;
+  uint64_t clearChildTid = entry->second;
+  clearChildTids.erase(entry);
+  if (clearChildTid != 0) futexWake(clearChildTid, 1, UINT32_MAX);
+  return clearChildTid;
+}
+
+void Linux::exitGroup() { exited_ = true; }
+
+bool Linux::hasExited() const { return exited_; }
+
+int64_t Linux::futex(uint64_t uaddr, int op, uint32_t val, uint64_t timeout,
+                     uint32_t val3,
+                     const std::function<LinuxThreadContext()>& saveCaller) {
+  assert(processStates_.size() > 0);
+  // Ignore the private and realtime clock modifiers
+  op &= ~(128 | 256);
+  bool wait = (op == 0 || op == 9);
+  if (!wait && op != 1 && op != 10) return -ENOSYS;
+
+  // Only the bitset variants take a bitset; the others match any waiter
+  uint32_t bitset = (op == 9 || op == 10) ? val3 : UINT32_MAX;
+  if (bitset == 0) return -EINVAL;
+  if (uaddr % 4 != 0) return -EINVAL;
+  if (!wait) return futexWake(uaddr, val, bitset);
+
+  // Syscalls are serialised, so the word cannot be released, and its waiters
+  // woken, between checking it and joining its queue
+  const LinuxProcessState& state = processStates_[0];
+  if (uaddr + 4 > state.processImageSize) return -EFAULT;
+  uint32_t word = memory::readShared(state.processImage.get() + uaddr, 4)
+                      .get<uint32_t>();
+  if (word != val) return -EAGAIN;
+  if (timeout != 0) return 0;
+
+  futexWaiters_[uaddr].push_back({saveCaller(), bitset});
+  return 0;
+}
+
+int64_t Linux::futexWake(uint64_t uaddr, uint32_t count, uint32_t bitset) {
+  auto entry = futexWaiters_.find(uaddr);
+  if (entry == futexWaiters_.end()) return 0;
+
+  auto& waiters = entry->second;
+  int64_t woken = 0;
+  for (auto waiter = waiters.begin();
+       waiter != waiters.end() && woken < count;) {
+    if (!(waiter->bitset & bitset)) {
+      waiter++;
+      continue;
+    }
+    pendingThreads_.push_back(std::move(waiter->thread));
+    waiter = waiters.erase(waiter);
+    woken++;
+  }
+  if (waiters.empty()) futexWaiters_.erase(entry);
+  return woken;
+}
+
 int64_t Linux::getpid() const {
   assert(processStates_.size() > 0);
   return processStates_[0].pid;
@@ -302,8 +578,6 @@ int64_t Linux::getuid() const { return 0; }
 int64_t Linux::geteuid() const { return 0; }
 int64_t Linux::getgid() const { return 0; }
 int64_t Linux::getegid() const { return 0; }
-// TODO update for multithreaded processes
-int64_t Linux::gettid() const { return 0; }
 
 int64_t Linux::gettimeofday(uint64_t systemTimer, timeval* tv, timeval* tz) {
   // TODO: Ideally this should get the system timer from the core directly
@@ -384,6 +658,7 @@ int64_t Linux::munmap(uint64_t addr, size_t length) {
             lps->contiguousAllocations[i].vm_next;
       }
       lps->contiguousAllocations.erase(lps->contiguousAllocations.begin() + i);
+      releaseMappedMemory(addr, length);
       return 0;
     }
   }
@@ -397,6 +672,7 @@ int64_t Linux::munmap(uint64_t addr, size_t length) {
       }
       lps->nonContiguousAllocations.erase(
           lps->nonContiguousAllocations.begin() + i);
+      releaseMappedMemory(addr, length);
       return 0;
     }
   }
@@ -404,6 +680,16 @@ int64_t Linux::munmap(uint64_t addr, size_t length) {
   return 0;
 }
 
+void Linux::releaseMappedMemory(uint64_t addr, size_t length) {
+  LinuxProcessState* lps = &processStates_[0];
+  if (!lps->processImage || addr >= lps->processImageSize) return;
+  // Unmapped pages read as zero once mapped again, as they would on Linux, and
+  // no longer hold host memory
+  uint64_t size = alignToBoundary(length, lps->pageSize);
+  size = std::min<uint64_t>(size, lps->processImageSize - addr);
+  releaseProcessMemory(lps->processImage.get(), addr, size);
+}
+
 uint64_t Linux::mmap(uint64_t addr, size_t length, int prot, int flags, int fd,
                      off_t offset) {
   LinuxProcessState* lps = &processStates_[0];
@@ -612,8 +898,10 @@ int64_t Linux::readv(int64_t fd, const void* iovdata, int iovcnt) {
 
 int64_t Linux::schedGetAffinity(pid_t pid, size_t cpusetsize, uint64_t mask) {
   if (mask != 0 && pid == 0) {
-    // Always return a bit mask of 1 to represent 1 available CPU
-    return 1;
+    // Return a bit mask representing every available CPU, up to the 63 which
+    // can be represented by a positive return value
+    uint16_t cpus = std::min<uint16_t>(coreCount_, 63);
+    return (1ll << cpus) - 1;
   }
   return -1;
 }
@@ -626,10 +914,10 @@ int64_t Linux::schedSetAffinity(pid_t pid, size_t cpusetsize, uint64_t mask) {
   if (cpusetsize == 0) return -EINVAL;
   return 0;
 }
-int64_t Linux::setTidAddress(uint64_t tidptr) {
+int64_t Linux::setTidAddress(int64_t tid, uint64_t tidptr) {
   assert(processStates_.size() > 0);
-  processStates_[0].clearChildTid = tidptr;
-  return processStates_[0].pid;
+  processStates_[0].clearChildTids[tid] = tidptr;
+  return tid;
 }
 
 int64_t Linux::write(int64_t fd, const void* buf, uint64_t count) {
@@ -1,6 +1,10 @@
 #include "simeng/kernel/LinuxProcess.hh"
 
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <cassert>
+#include <cerrno>
 #include <cstring>
 #include <iostream>
 
@@ -16,15 +20,55 @@ uint64_t alignToBoundary(uint64_t value, uint64_t boundary) {
   return value + (boundary - remainder);
 }
 
+std::shared_ptr<char> reserveProcessImage(uint64_t size) {
+  // Anonymous mappings are zero-filled on first access, and `MAP_NORESERVE`
+  // avoids committing swap space to the whole image up front
+  void* image =
+      ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (image == MAP_FAILED) {
+    std::cerr << "[SimEng:LinuxProcess] ProcessImage cannot be constructed "
+                 "successfully! Could not reserve "
+              << size << " bytes: " << strerror(errno) << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  return std::shared_ptr<char>(static_cast<char*>(image),
+                               [size](char* ptr) { ::munmap(ptr, size); });
+}
+
+void releaseProcessMemory(char* image, uint64_t offset, uint64_t size) {
+  // The image is aligned to a host page, but the range may not be; only the
+  // host pages it wholly covers can be replaced
+  static const uint64_t hostPageSize = sysconf(_SC_PAGESIZE);
+  uint64_t start = alignToBoundary(offset, hostPageSize);
+  uint64_t end = (offset + size) - ((offset + size) % hostPageSize);
+  if (start >= end) {
+    std::memset(image + offset, 0, size);
+    return;
+  }
+
+  std::memset(image + offset, 0, start - offset);
+  std::memset(image + end, 0, (offset + size) - end);
+  // Mapping fresh anonymous pages over the range frees the pages it replaces,
+  // whether they were anonymous or private copies of a checkpoint file
+  void* pages = ::mmap(image + start, end - start, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED,
+                       -1, 0);
+  if (pages == MAP_FAILED) {
+    // Leave the pages allocated, but still provide the zeroes expected of them
+    std::memset(image + start, 0, end - start);
+  }
+}
+
 LinuxProcess::LinuxProcess(const std::vector<std::string>& commandLine,
                            ryml::ConstNodeRef config)
     : STACK_SIZE(config["Process-Image"]["Stack-Size"].as<uint64_t>()),
       HEAP_SIZE(config["Process-Image"]["Heap-Size"].as<uint64_t>()),
+      CORE_COUNT(config["CPU-Info"]["Core-Count"].as<uint16_t>()),
       commandLine_(commandLine) {
   // Parse ELF file
   assert(commandLine.size() > 0);
-  char* unwrappedProcImgPtr;
-  Elf elf(commandLine[0], &unwrappedProcImgPtr);
+  Elf elf(commandLine[0]);
   if (!elf.isValid()) {
     return;
   }
@@ -47,24 +91,16 @@ LinuxProcess::LinuxProcess(const std::vector<std::string>& commandLine,
   // Calculate process image size, including heap + stack
   size_ = heapStart_ + HEAP_SIZE + STACK_SIZE;
 
-  char* temp = (char*)realloc(unwrappedProcImgPtr, size_ * sizeof(char));
-  if (temp == NULL) {
-    free(unwrappedProcImgPtr);
-    std::cerr << "[SimEng:LinuxProcess] ProcessImage cannot be constructed "
-                 "successfully! "
-                 "Reallocation failed."
-              << std::endl;
-    exit(EXIT_FAILURE);
-  }
-  unwrappedProcImgPtr = temp;
+  processImage_ = reserveProcessImage(size_);
+  elf.load(processImage_.get());
 
-  createStack(&unwrappedProcImgPtr);
-  processImage_ = std::shared_ptr<char>(unwrappedProcImgPtr, free);
+  createStack(processImage_.get());
 }
 
 LinuxProcess::LinuxProcess(span<char> instructions, ryml::ConstNodeRef config)
     : STACK_SIZE(config["Process-Image"]["Stack-Size"].as<uint64_t>()),
-      HEAP_SIZE(config["Process-Image"]["Heap-Size"].as<uint64_t>()) {
+      HEAP_SIZE(config["Process-Image"]["Heap-Size"].as<uint64_t>()),
+      CORE_COUNT(config["CPU-Info"]["Core-Count"].as<uint16_t>()) {
   // Set program command string to a relative path of "Default"
   commandLine_.push_back("Default\0");
 
@@ -79,11 +115,40 @@ LinuxProcess::LinuxProcess(span<char> instructions, ryml::ConstNodeRef config)
       alignToBoundary(heapStart_ + (HEAP_SIZE + STACK_SIZE) / 2, pageSize_);
 
   size_ = heapStart_ + HEAP_SIZE + STACK_SIZE;
-  char* unwrappedProcImgPtr = (char*)calloc(size_, sizeof(char));
-  std::copy(instructions.begin(), instructions.end(), unwrappedProcImgPtr);
+  processImage_ = reserveProcessImage(size_);
+  std::copy(instructions.begin(), instructions.end(), processImage_.get());
+
+  createStack(processImage_.get());
+}
+
+LinuxProcess::LinuxProcess(CheckpointReader& checkpoint,
+                           ryml::ConstNodeRef config)
+    : STACK_SIZE(config["Process-Image"]["Stack-Size"].as<uint64_t>()),
+      HEAP_SIZE(config["Process-Image"]["Heap-Size"].as<uint64_t>()),
+      CORE_COUNT(config["CPU-Info"]["Core-Count"].as<uint16_t>()) {
+  uint64_t argCount = 0;
+  checkpoint.read(argCount);
+  commandLine_.resize(argCount);
+  for (auto& arg : commandLine_) checkpoint.read(arg);
+  checkpoint.read(entryPoint_);
+  checkpoint.read(progHeaderTableAddress_);
+  checkpoint.read(numProgHeaders_);
+  checkpoint.read(progHeaderEntSize_);
+  checkpoint.read(heapStart_);
+  checkpoint.read(mmapStart_);
+  checkpoint.read(stackPointer_);
+  checkpoint.read(size_);
+
+  if (size_ != checkpoint.getImageSize()) {
+    std::cerr << "[SimEng:LinuxProcess] Checkpointed process image size does "
+                 "not match its layout"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
 
-  createStack(&unwrappedProcImgPtr);
-  processImage_ = std::shared_ptr<char>(unwrappedProcImgPtr, free);
+  // The stack already holds its initial state, so is not recreated
+  processImage_ = checkpoint.mapImage();
+  isValid_ = true;
 }
 
 LinuxProcess::~LinuxProcess() {}
@@ -110,7 +175,20 @@ uint64_t LinuxProcess::getEntryPoint() const { return entryPoint_; }
 
 uint64_t LinuxProcess::getInitialStackPointer() const { return stackPointer_; }
 
-void LinuxProcess::createStack(char** processImage) {
+void LinuxProcess::checkpoint(CheckpointWriter& checkpoint) const {
+  checkpoint.write<uint64_t>(commandLine_.size());
+  for (const auto& arg : commandLine_) checkpoint.write(arg);
+  checkpoint.write(entryPoint_);
+  checkpoint.write(progHeaderTableAddress_);
+  checkpoint.write(numProgHeaders_);
+  checkpoint.write(progHeaderEntSize_);
+  checkpoint.write(heapStart_);
+  checkpoint.write(mmapStart_);
+  checkpoint.write(stackPointer_);
+  checkpoint.write(size_);
+}
+
+void LinuxProcess::createStack(char* processImage) {
   // Decrement the stack pointer and populate with initial stack state
   // (https://www.win.tue.nl/~aeb/linux/hh/stack-layout.html)
   // The argv and env strings are added to the top of the stack first and the
@@ -133,7 +211,8 @@ void LinuxProcess::createStack(char** processImage) {
     stringBytes.push_back(0);
   }
   // Environment strings
-  std::vector<std::string> envStrings = {"OMP_NUM_THREADS=1"};
+  std::vector<std::string> envStrings = {"OMP_NUM_THREADS=" +
+                                         std::to_string(CORE_COUNT)};
   for (std::string& env : envStrings) {
     for (int i = 0; i < env.size(); i++) {
       stringBytes.push_back(env.c_str()[i]);
@@ -157,7 +236,7 @@ void LinuxProcess::createStack(char** processImage) {
       initialStackFrame.push_back(stackPointer_ + (i));  // argv/env ptr
       ptrCount++;
     }
-    (*processImage)[stackPointer_ + i] = stringBytes[i];
+    processImage[stackPointer_ + i] = stringBytes[i];
   }
 
   initialStackFrame.push_back(0);  // null terminator
@@ -193,7 +272,7 @@ void LinuxProcess::createStack(char** processImage) {
   // Copy initial stack frame to process memory
   char* stackFrameBytes = reinterpret_cast<char*>(initialStackFrame.data());
   std::copy(stackFrameBytes, stackFrameBytes + stackFrameSize,
-            (*processImage) + stackPointer_);
+            processImage + stackPointer_);
 }
 
 }  // namespace kernel
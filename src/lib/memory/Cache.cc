@@ -0,0 +1,261 @@
+#include "simeng/memory/Cache.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace simeng {
+
+namespace memory {
+
+Cache::Cache(const std::string& name, ryml::ConstNodeRef config,
+             std::shared_ptr<Cache> nextLevel, uint16_t memoryLatency,
+             bool shared)
+    : name_(name),
+      ways_(config["Associativity"].as<uint16_t>()),
+      lineSize_(config["Line-Size"].as<uint16_t>()),
+      hitLatency_(config["Hit-Latency"].as<uint16_t>()),
+      mshrCount_(config["MSHRs"].as<uint16_t>()),
+      writeBack_(config["Write-Back"].as<bool>()),
+      writeAllocate_(config["Write-Allocate"].as<bool>()),
+      nextLevel_(nextLevel),
+      memoryLatency_(memoryLatency),
+      shared_(shared) {
+  // The line size and number of sets are validated as powers of two, so a
+  // line's set is selected by masking its address
+  sets_ = config["Size"].as<uint64_t>() / (ways_ * lineSize_);
+  lineShift_ = 0;
+  while ((1ull << lineShift_) < lineSize_) lineShift_++;
+
+  std::string policy = config["Replacement-Policy"].as<std::string>();
+  if (policy == "FIFO") {
+    policy_ = ReplacementPolicy::FIFO;
+  } else if (policy == "Random") {
+    policy_ = ReplacementPolicy::Random;
+  } else {
+    policy_ = ReplacementPolicy::LRU;
+  }
+
+  tags_.resize(sets_ * ways_, ~0ull);
+  stamps_.resize(sets_ * ways_, 0);
+  readyAt_.resize(sets_ * ways_, 0);
+  dirty_.resize(sets_ * ways_, false);
+  prefetchSource_.resize(sets_ * ways_, 0);
+  mshrs_.reserve(mshrCount_);
+}
+
+uint64_t Cache::access(uint64_t address, bool write, uint64_t cycle) {
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (shared_) lock.lock();
+
+  uint64_t line = address >> lineShift_;
+  uint64_t set = line & (sets_ - 1);
+  uint64_t base = set * ways_;
+  int64_t way = findWay(set, line);
+
+  if (way >= 0) {
+    uint64_t index = base + way;
+    if (policy_ == ReplacementPolicy::LRU) stamps_[index] = cycle;
+    if (prefetchSource_[index] != 0) {
+      // The first demand access to a prefetched line makes the prefetch useful
+      usefulPrefetches_[prefetchSource_[index] - 1]++;
+      prefetchSource_[index] = 0;
+    }
+    if (write) {
+      if (writeBack_) {
+        dirty_[index] = true;
+      } else {
+        writeBelow(line, cycle + hitLatency_);
+      }
+    }
+    // A line whose fill is still outstanding completes with the fill
+    if (readyAt_[index] > cycle + hitLatency_) {
+      mshrHits_++;
+      return readyAt_[index];
+    }
+    hits_++;
+    return cycle + hitLatency_;
+  }
+
+  misses_++;
+  if (write && !writeAllocate_) {
+    // Writes are posted, so don't wait for the level below
+    writeBelow(line, cycle + hitLatency_);
+    return cycle + hitLatency_;
+  }
+
+  // Wait for an MSHR to become free
+  uint64_t sendAt = cycle + hitLatency_;
+  releaseMshrs(cycle);
+  if (mshrs_.size() >= mshrCount_) {
+    auto earliest = std::min_element(mshrs_.begin(), mshrs_.end());
+    sendAt = std::max(sendAt, *earliest);
+    mshrs_.erase(earliest);
+    mshrStalls_++;
+  }
+
+  uint64_t index = base + chooseVictim(set);
+  uint64_t readyAt = fill(index, line, sendAt, cycle);
+  dirty_[index] = write && writeBack_;
+  if (write && !writeBack_) writeBelow(line, readyAt);
+
+  return readyAt;
+}
+
+bool Cache::prefetch(uint64_t address, uint64_t cycle, uint8_t source) {
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (shared_) lock.lock();
+
+  uint64_t line = address >> lineShift_;
+  uint64_t set = line & (sets_ - 1);
+  if (findWay(set, line) >= 0) return false;
+
+  // Prefetches never delay demand misses, so are dropped if every MSHR is busy
+  releaseMshrs(cycle);
+  if (mshrs_.size() >= mshrCount_) return false;
+
+  uint64_t index = set * ways_ + chooseVictim(set);
+  fill(index, line, cycle + hitLatency_, cycle);
+  dirty_[index] = false;
+  prefetchSource_[index] = source;
+  if (usefulPrefetches_.size() < source) usefulPrefetches_.resize(source, 0);
+  return true;
+}
+
+void Cache::warm(uint64_t address, bool write, uint64_t cycle) {
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (shared_) lock.lock();
+
+  uint64_t line = address >> lineShift_;
+  uint64_t set = line & (sets_ - 1);
+  int64_t way = findWay(set, line);
+
+  if (way >= 0) {
+    uint64_t index = set * ways_ + way;
+    if (policy_ == ReplacementPolicy::LRU) stamps_[index] = cycle;
+    if (write) {
+      if (writeBack_) {
+        dirty_[index] = true;
+      } else if (nextLevel_) {
+        nextLevel_->warm(address, true, cycle);
+      }
+    }
+    return;
+  }
+
+  if (!write || writeAllocate_) {
+    uint64_t index = set * ways_ + chooseVictim(set);
+    if (tags_[index] != ~0ull && dirty_[index] && nextLevel_) {
+      nextLevel_->warm(tags_[index] << lineShift_, true, cycle);
+    }
+    if (nextLevel_) nextLevel_->warm(address, false, cycle);
+    tags_[index] = line;
+    stamps_[index] = cycle;
+    readyAt_[index] = cycle;
+    dirty_[index] = write && writeBack_;
+    prefetchSource_[index] = 0;
+    if (write && writeBack_) return;
+  }
+
+  // Writes which are neither allocated nor held pass to the level below
+  if (write && nextLevel_) nextLevel_->warm(address, true, cycle);
+}
+
+uint16_t Cache::getLineSize() const { return lineSize_; }
+
+uint64_t Cache::getMisses() const {
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (shared_) lock.lock();
+  return misses_;
+}
+
+uint64_t Cache::getUsefulPrefetches(uint8_t source) const {
+  std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+  if (shared_) lock.lock();
+  if (source == 0 || source > usefulPrefetches_.size()) return 0;
+  return usefulPrefetches_[source - 1];
+}
+
+void Cache::getStats(std::map<std::string, std::string>& stats) const {
+  {
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (shared_) lock.lock();
+
+    uint64_t accesses = hits_ + mshrHits_ + misses_;
+    float missRate =
+        accesses == 0 ? 0.0f : 100.0f * misses_ / static_cast<float>(accesses);
+    std::ostringstream missRateStr;
+    missRateStr << std::setprecision(3) << missRate << "%";
+
+    stats[name_ + ".hits"] = std::to_string(hits_);
+    stats[name_ + ".misses"] = std::to_string(misses_);
+    stats[name_ + ".mshrHits"] = std::to_string(mshrHits_);
+    stats[name_ + ".mshrStalls"] = std::to_string(mshrStalls_);
+    stats[name_ + ".writebacks"] = std::to_string(writebacks_);
+    stats[name_ + ".missrate"] = missRateStr.str();
+  }
+  if (nextLevel_) nextLevel_->getStats(stats);
+}
+
+int64_t Cache::findWay(uint64_t set, uint64_t line) const {
+  const uint64_t* tags = tags_.data() + set * ways_;
+  for (uint16_t way = 0; way < ways_; way++) {
+    if (tags[way] == line) return way;
+  }
+  return -1;
+}
+
+uint64_t Cache::chooseVictim(uint64_t set) {
+  uint64_t base = set * ways_;
+  // Fill invalid ways first
+  for (uint16_t way = 0; way < ways_; way++) {
+    if (tags_[base + way] == ~0ull) return way;
+  }
+
+  if (policy_ == ReplacementPolicy::Random) {
+    // xorshift64
+    randomState_ ^= randomState_ << 13;
+    randomState_ ^= randomState_ >> 7;
+    randomState_ ^= randomState_ << 17;
+    return randomState_ % ways_;
+  }
+
+  // Both LRU and FIFO evict the way with the oldest stamp; they differ only in
+  // whether hits refresh it
+  auto oldest = std::min_element(stamps_.begin() + base,
+                                 stamps_.begin() + base + ways_);
+  return oldest - (stamps_.begin() + base);
+}
+
+void Cache::releaseMshrs(uint64_t cycle) {
+  mshrs_.erase(
+      std::remove_if(mshrs_.begin(), mshrs_.end(),
+                     [cycle](uint64_t ready) { return ready <= cycle; }),
+      mshrs_.end());
+}
+
+uint64_t Cache::fill(uint64_t index, uint64_t line, uint64_t sendAt,
+                     uint64_t cycle) {
+  uint64_t readyAt =
+      nextLevel_ ? nextLevel_->access(line << lineShift_, false, sendAt)
+                 : sendAt + memoryLatency_;
+  mshrs_.push_back(readyAt);
+
+  if (tags_[index] != ~0ull && dirty_[index]) {
+    writebacks_++;
+    writeBelow(tags_[index], sendAt);
+  }
+  tags_[index] = line;
+  stamps_[index] = cycle;
+  readyAt_[index] = readyAt;
+  prefetchSource_[index] = 0;
+  return readyAt;
+}
+
+void Cache::writeBelow(uint64_t line, uint64_t cycle) {
+  // Main memory absorbs writes without affecting any timing
+  if (nextLevel_) nextLevel_->access(line << lineShift_, true, cycle);
+}
+
+}  // namespace memory
+}  // namespace simeng
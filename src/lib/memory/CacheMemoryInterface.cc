@@ -0,0 +1,183 @@
+#include "simeng/memory/CacheMemoryInterface.hh"
+
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "simeng/memory/SharedMemory.hh"
+
+namespace simeng {
+
+namespace memory {
+
+CacheMemoryInterface::CacheMemoryInterface(
+    char* memory, size_t size, std::shared_ptr<Cache> cache,
+    std::vector<std::unique_ptr<Prefetcher>> prefetchers)
+    : memory_(memory),
+      size_(size),
+      cache_(cache),
+      prefetchers_(std::move(prefetchers)),
+      prefetchesIssued_(prefetchers_.size(), 0) {}
+
+void CacheMemoryInterface::tick() {
+  tickCounter_++;
+
+  while (pendingRequests_.size() > 0) {
+    const auto& request = pendingRequests_.top();
+
+    if (request.readyAt > tickCounter_) {
+      // Earliest request isn't ready yet; end cycle
+      break;
+    }
+
+    if (!request.write) {
+      // Read: read data into `completedReads`
+      const auto& target = request.target;
+      if (target.address + target.size > size_ ||
+          target.address + target.size < target.address) {
+        // Read outside of memory; return an invalid value to signal a fault
+        completedReads_.push_back({target, RegisterValue(), request.requestId});
+      } else {
+        const char* ptr = memory_ + target.address;
+
+        // Copy the data at the requested memory address into a RegisterValue
+        completedReads_.push_back(
+            {target, readShared(ptr, target.size), request.requestId});
+      }
+    }
+
+    pendingRequests_.pop();
+  }
+}
+
+void CacheMemoryInterface::requestRead(const MemoryAccessTarget& target,
+                                       uint64_t requestId) {
+  uint64_t readyAt = accessLines(target, false);
+  pendingRequests_.push({readyAt, requestCount_++, false, target, requestId});
+}
+
+void CacheMemoryInterface::requestWrite(const MemoryAccessTarget& target,
+                                        const RegisterValue& data) {
+  if (target.address + target.size > size_) {
+    std::cerr << "[SimEng:CacheMemoryInterface] Attempted to write beyond "
+                 "memory limit."
+              << std::endl;
+    exit(1);
+  }
+  if (data) writeShared(memory_ + target.address, data, target.size);
+
+  uint64_t readyAt = accessLines(target, true);
+  pendingRequests_.push({readyAt, requestCount_++, true, target, 0});
+}
+
+const span<MemoryReadResult> CacheMemoryInterface::getCompletedReads() const {
+  return {const_cast<MemoryReadResult*>(completedReads_.data()),
+          completedReads_.size()};
+}
+
+void CacheMemoryInterface::clearCompletedReads() { completedReads_.clear(); }
+
+bool CacheMemoryInterface::hasPendingRequests() const {
+  return !pendingRequests_.empty();
+}
+
+uint64_t CacheMemoryInterface::getIdleTicks() const {
+  if (pendingRequests_.empty()) return UINT64_MAX;
+  // The earliest request completes in the tick which brings the counter up to
+  // its ready cycle
+  uint64_t readyAt = pendingRequests_.top().readyAt;
+  return readyAt > tickCounter_ ? readyAt - tickCounter_ - 1 : 0;
+}
+
+void CacheMemoryInterface::skipTicks(uint64_t ticks) {
+  assert(ticks <= getIdleTicks() && "Skipped a tick which completes a request");
+  tickCounter_ += ticks;
+}
+
+void CacheMemoryInterface::observeLoad(uint64_t pc,
+                                       const MemoryAccessTarget& target) {
+  for (size_t i = 0; i < prefetchers_.size(); i++) {
+    candidates_.clear();
+    prefetchers_[i]->observe(pc, target.address, candidates_);
+    for (uint64_t address : candidates_) {
+      // Don't prefetch beyond the process memory
+      if (address >= size_) continue;
+      if (cache_->prefetch(address, tickCounter_, i + 1))
+        prefetchesIssued_[i]++;
+    }
+  }
+}
+
+void CacheMemoryInterface::warm(uint64_t pc, const MemoryAccessTarget& target,
+                                bool write) {
+  if (target.address + target.size > size_) return;
+
+  uint64_t lineSize = cache_->getLineSize();
+  uint64_t first = target.address & ~(lineSize - 1);
+  uint64_t last = (target.address + std::max<uint16_t>(target.size, 1) - 1) &
+                  ~(lineSize - 1);
+  for (uint64_t line = first; line <= last; line += lineSize) {
+    cache_->warm(line, write, tickCounter_);
+  }
+
+  if (write) return;
+  for (const auto& prefetcher : prefetchers_) {
+    candidates_.clear();
+    prefetcher->observe(pc, target.address, candidates_);
+    for (uint64_t address : candidates_) {
+      if (address < size_) cache_->warm(address, false, tickCounter_);
+    }
+  }
+}
+
+std::map<std::string, std::string> CacheMemoryInterface::getStats() const {
+  std::map<std::string, std::string> stats;
+  cache_->getStats(stats);
+
+  // Misses the cache would have taken without prefetching are those it took,
+  // plus those removed by a useful prefetch
+  uint64_t unprefetchedMisses = cache_->getMisses();
+  for (size_t i = 0; i < prefetchers_.size(); i++) {
+    unprefetchedMisses += cache_->getUsefulPrefetches(i + 1);
+  }
+
+  for (size_t i = 0; i < prefetchers_.size(); i++) {
+    uint64_t useful = cache_->getUsefulPrefetches(i + 1);
+    float accuracy =
+        prefetchesIssued_[i] == 0
+            ? 0.0f
+            : 100.0f * useful / static_cast<float>(prefetchesIssued_[i]);
+    float coverage =
+        useful == 0 ? 0.0f
+                    : 100.0f * useful / static_cast<float>(unprefetchedMisses);
+    std::ostringstream accuracyStr;
+    accuracyStr << std::setprecision(3) << accuracy << "%";
+    std::ostringstream coverageStr;
+    coverageStr << std::setprecision(3) << coverage << "%";
+
+    std::string prefix = "prefetch." + prefetchers_[i]->getName();
+    stats[prefix + ".issued"] = std::to_string(prefetchesIssued_[i]);
+    stats[prefix + ".useful"] = std::to_string(useful);
+    stats[prefix + ".accuracy"] = accuracyStr.str();
+    stats[prefix + ".coverage"] = coverageStr.str();
+  }
+  return stats;
+}
+
+uint64_t CacheMemoryInterface::accessLines(const MemoryAccessTarget& target,
+                                           bool write) {
+  uint64_t lineSize = cache_->getLineSize();
+  uint64_t first = target.address & ~(lineSize - 1);
+  uint64_t last = (target.address + std::max<uint16_t>(target.size, 1) - 1) &
+                  ~(lineSize - 1);
+
+  uint64_t readyAt = tickCounter_;
+  for (uint64_t line = first; line <= last; line += lineSize) {
+    readyAt = std::max(readyAt, cache_->access(line, write, tickCounter_));
+  }
+  return readyAt;
+}
+
+}  // namespace memory
+}  // namespace simeng
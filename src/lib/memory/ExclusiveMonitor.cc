@@ -0,0 +1,126 @@
+#include "simeng/memory/ExclusiveMonitor.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "simeng/memory/SharedMemory.hh"
+
+namespace simeng {
+
+namespace memory {
+
+/** Atomically replace the `T` at `dest` with the first bytes of `data` if it
+ * still holds the first bytes of `expected`. */
+template <class T>
+bool compareAndSwap_(char* dest, const RegisterValue& expected,
+                     const RegisterValue& data) {
+  T value = expected.get<T>();
+  return __atomic_compare_exchange_n(reinterpret_cast<T*>(dest), &value,
+                                     data.get<T>(), false, __ATOMIC_SEQ_CST,
+                                     __ATOMIC_SEQ_CST);
+}
+
+ExclusiveMonitor::ExclusiveMonitor(char* memory, uint64_t memorySize,
+                                   uint16_t coreCount)
+    : memory_(memory), memorySize_(memorySize), reservations_(coreCount) {}
+
+void ExclusiveMonitor::reserve(uint16_t core, const MemoryAccessTarget& target,
+                               const RegisterValue& value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& reservation = reservations_[core];
+  if (!reservation.valid) {
+    reservation.valid = true;
+    activeReservations_.fetch_add(1, std::memory_order_release);
+  }
+  reservation.target = target;
+  reservation.value = value;
+}
+
+bool ExclusiveMonitor::holdsReservation(
+    uint16_t core, const MemoryAccessTarget& target) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto& reservation = reservations_[core];
+  return reservation.valid && reservation.target == target;
+}
+
+bool ExclusiveMonitor::store(uint16_t core, const MemoryAccessTarget& target,
+                             const RegisterValue& data) {
+  if (target.address + target.size > memorySize_) {
+    std::cerr << "[SimEng:ExclusiveMonitor] Attempted to write beyond memory "
+                 "limit."
+              << std::endl;
+    exit(1);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& reservation = reservations_[core];
+  bool held = reservation.valid && reservation.target == target;
+  bool written = held && compareAndWrite(target, reservation.value, data);
+  if (reservation.valid) clear(reservation);
+  if (written) clearOverlapping(core, target);
+  return written;
+}
+
+void ExclusiveMonitor::recordStore(uint16_t core,
+                                   const MemoryAccessTarget& target) {
+  if (activeReservations_.load(std::memory_order_acquire) == 0) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  clearOverlapping(core, target);
+}
+
+void ExclusiveMonitor::clearReservation(uint16_t core) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& reservation = reservations_[core];
+  if (reservation.valid) clear(reservation);
+}
+
+bool ExclusiveMonitor::compareAndWrite(const MemoryAccessTarget& target,
+                                       const RegisterValue& expected,
+                                       const RegisterValue& data) {
+  char* ptr = memory_ + target.address;
+  // Naturally aligned accesses of up to 8 bytes are single-copy atomic, so are
+  // compared and written in one step
+  if (target.size > 0 && target.address % target.size == 0) {
+    switch (target.size) {
+      case 1:
+        return compareAndSwap_<uint8_t>(ptr, expected, data);
+      case 2:
+        return compareAndSwap_<uint16_t>(ptr, expected, data);
+      case 4:
+        return compareAndSwap_<uint32_t>(ptr, expected, data);
+      case 8:
+        return compareAndSwap_<uint64_t>(ptr, expected, data);
+    }
+  }
+
+  // Otherwise other exclusive writes are held off by the lock, but a plain
+  // store landing between the comparison and the write goes undetected
+  RegisterValue current = readShared(ptr, target.size);
+  if (std::memcmp(current.getAsVector<char>(), expected.getAsVector<char>(),
+                  target.size) != 0)
+    return false;
+  writeShared(ptr, data, target.size);
+  return true;
+}
+
+void ExclusiveMonitor::clearOverlapping(uint16_t core,
+                                        const MemoryAccessTarget& target) {
+  uint64_t first = target.address & ~(granuleSize - 1);
+  uint64_t last = (target.address + std::max<uint16_t>(target.size, 1) - 1) &
+                  ~(granuleSize - 1);
+  for (uint16_t other = 0; other < reservations_.size(); other++) {
+    auto& reservation = reservations_[other];
+    if (other == core || !reservation.valid) continue;
+    uint64_t granule = reservation.target.address & ~(granuleSize - 1);
+    if (granule >= first && granule <= last) clear(reservation);
+  }
+}
+
+void ExclusiveMonitor::clear(Reservation& reservation) {
+  reservation.valid = false;
+  activeReservations_.fetch_sub(1, std::memory_order_release);
+}
+
+}  // namespace memory
+}  // namespace simeng
@@ -1,7 +1,10 @@
 #include "simeng/memory/FixedLatencyMemoryInterface.hh"
 
+#include <cassert>
 #include <iostream>
 
+#include "simeng/memory/SharedMemory.hh"
+
 namespace simeng {
 
 namespace memory {
@@ -33,9 +36,11 @@ void FixedLatencyMemoryInterface::tick() {
         exit(1);
       }
 
-      auto ptr = memory_ + target.address;
-      // Copy the data from the RegisterValue to memory
-      memcpy(ptr, request.data.getAsVector<char>(), target.size);
+      // Copy the data from the RegisterValue to memory, unless only the
+      // timing of the write was requested
+      if (request.data) {
+        writeShared(memory_ + target.address, request.data, target.size);
+      }
     } else {
       // Read: read data into `completedReads`
       if (target.address + target.size > size_ ||
@@ -47,7 +52,7 @@ void FixedLatencyMemoryInterface::tick() {
 
         // Copy the data at the requested memory address into a RegisterValue
         completedReads_.push_back(
-            {target, RegisterValue(ptr, target.size), request.requestId});
+            {target, readShared(ptr, target.size), request.requestId});
       }
     }
 
@@ -80,5 +85,18 @@ bool FixedLatencyMemoryInterface::hasPendingRequests() const {
   return !pendingRequests_.empty();
 }
 
+uint64_t FixedLatencyMemoryInterface::getIdleTicks() const {
+  if (pendingRequests_.empty()) return UINT64_MAX;
+  // The earliest request completes in the tick which brings the counter up to
+  // its ready cycle
+  uint64_t readyAt = pendingRequests_.front().readyAt;
+  return readyAt > tickCounter_ ? readyAt - tickCounter_ - 1 : 0;
+}
+
+void FixedLatencyMemoryInterface::skipTicks(uint64_t ticks) {
+  assert(ticks <= getIdleTicks() && "Skipped a tick which completes a request");
+  tickCounter_ += ticks;
+}
+
 }  // namespace memory
 }  // namespace simeng
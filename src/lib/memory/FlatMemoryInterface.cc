@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include "simeng/memory/SharedMemory.hh"
+
 namespace simeng {
 
 namespace memory {
@@ -20,8 +22,7 @@ void FlatMemoryInterface::requestRead(const MemoryAccessTarget& target,
   const char* ptr = memory_ + target.address;
 
   // Copy the data at the requested memory address into a RegisterValue
-  completedReads_.push_back(
-      {target, RegisterValue(ptr, target.size), requestId});
+  completedReads_.push_back({target, readShared(ptr, target.size), requestId});
 }
 
 void FlatMemoryInterface::requestWrite(const MemoryAccessTarget& target,
@@ -33,9 +34,9 @@ void FlatMemoryInterface::requestWrite(const MemoryAccessTarget& target,
     exit(1);
   }
 
-  auto ptr = memory_ + target.address;
-  // Copy the data from the RegisterValue to memory
-  memcpy(ptr, data.getAsVector<char>(), target.size);
+  // Copy the data from the RegisterValue to memory; a write without data has
+  // already been made
+  if (data) writeShared(memory_ + target.address, data, target.size);
 }
 
 const span<MemoryReadResult> FlatMemoryInterface::getCompletedReads() const {
@@ -47,7 +48,15 @@ void FlatMemoryInterface::clearCompletedReads() { completedReads_.clear(); }
 
 bool FlatMemoryInterface::hasPendingRequests() const { return false; }
 
+span<char> FlatMemoryInterface::getDirectMemory() const {
+  return {memory_, size_};
+}
+
 void FlatMemoryInterface::tick() {}
 
+uint64_t FlatMemoryInterface::getIdleTicks() const { return UINT64_MAX; }
+
+void FlatMemoryInterface::skipTicks(uint64_t ticks) {}
+
 }  // namespace memory
 }  // namespace simeng
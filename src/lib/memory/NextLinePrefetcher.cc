@@ -0,0 +1,25 @@
+#include "simeng/memory/NextLinePrefetcher.hh"
+
+namespace simeng {
+
+namespace memory {
+
+NextLinePrefetcher::NextLinePrefetcher(uint16_t lineSize,
+                                       ryml::ConstNodeRef config)
+    : lineSize_(lineSize),
+      degree_(config["Data-Prefetcher"]["Next-Line-Degree"].as<uint16_t>()) {}
+
+void NextLinePrefetcher::observe(uint64_t pc, uint64_t address,
+                                 std::vector<uint64_t>& prefetches) {
+  uint64_t line = address / lineSize_;
+  // Repeated loads from one line would only propose the same candidates again
+  if (line == lastLine_) return;
+  lastLine_ = line;
+
+  for (uint16_t i = 1; i <= degree_; i++) {
+    prefetches.push_back((line + i) * lineSize_);
+  }
+}
+
+}  // namespace memory
+}  // namespace simeng
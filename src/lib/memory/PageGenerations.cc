@@ -0,0 +1,45 @@
+#include "simeng/memory/PageGenerations.hh"
+
+#include <algorithm>
+
+namespace simeng {
+
+namespace memory {
+
+PageGenerations::PageGenerations(uint64_t memorySize)
+    : pageCount_((memorySize + pageSize - 1) / pageSize),
+      watched_(new std::atomic<bool>[pageCount_]),
+      generations_(new std::atomic<uint32_t>[pageCount_]) {
+  for (uint64_t page = 0; page < pageCount_; page++) {
+    watched_[page].store(false, std::memory_order_relaxed);
+    generations_[page].store(0, std::memory_order_relaxed);
+  }
+}
+
+uint32_t PageGenerations::watch(uint64_t page) {
+  if (page >= pageCount_) return 0;
+  if (!watched_[page].load(std::memory_order_relaxed))
+    watched_[page].store(true, std::memory_order_seq_cst);
+  return get(page);
+}
+
+uint32_t PageGenerations::get(uint64_t page) const {
+  if (page >= pageCount_) return 0;
+  return generations_[page].load(std::memory_order_acquire);
+}
+
+void PageGenerations::recordWrite(const MemoryAccessTarget& target) {
+  uint64_t firstPage = target.address / pageSize;
+  if (firstPage >= pageCount_) return;
+  uint64_t lastPage =
+      (target.address + std::max<uint16_t>(target.size, 1) - 1) / pageSize;
+  lastPage = std::min(lastPage, pageCount_ - 1);
+  for (uint64_t page = firstPage; page <= lastPage; page++) {
+    // Most writes are to data, which no core has cached as code
+    if (!watched_[page].load(std::memory_order_relaxed)) continue;
+    generations_[page].fetch_add(1, std::memory_order_release);
+  }
+}
+
+}  // namespace memory
+}  // namespace simeng
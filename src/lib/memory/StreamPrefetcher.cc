@@ -0,0 +1,69 @@
+#include "simeng/memory/StreamPrefetcher.hh"
+
+namespace simeng {
+
+namespace memory {
+
+StreamPrefetcher::StreamPrefetcher(uint16_t lineSize, ryml::ConstNodeRef config)
+    : lineSize_(lineSize),
+      distance_(config["Data-Prefetcher"]["Stream-Distance"].as<uint16_t>()),
+      degree_(config["Data-Prefetcher"]["Stream-Degree"].as<uint16_t>()),
+      streams_(
+          config["Data-Prefetcher"]["Stream-Table-Entries"].as<uint16_t>()) {}
+
+void StreamPrefetcher::observe(uint64_t pc, uint64_t address,
+                               std::vector<uint64_t>& prefetches) {
+  loads_++;
+  uint64_t line = address / lineSize_;
+
+  // Find the stream this load continues, or the entry to replace with a new
+  // stream
+  StreamTableEntry* victim = &streams_[0];
+  StreamTableEntry* stream = nullptr;
+  for (auto& entry : streams_) {
+    if (entry.valid) {
+      int64_t delta = static_cast<int64_t>(line - entry.lastLine);
+      if (delta >= -distance_ && delta <= distance_) {
+        stream = &entry;
+        break;
+      }
+    }
+    if (!entry.valid || (victim->valid && entry.lastUsed < victim->lastUsed)) {
+      victim = &entry;
+    }
+  }
+
+  if (stream == nullptr) {
+    *victim = {true, line, 0, 0, line, loads_};
+    return;
+  }
+
+  stream->lastUsed = loads_;
+  if (line == stream->lastLine) return;
+  int64_t direction = line > stream->lastLine ? 1 : -1;
+  stream->lastLine = line;
+  if (direction != stream->direction) {
+    // The stream has changed direction, so must be retrained
+    stream->direction = direction;
+    stream->confidence = 1;
+    stream->head = line;
+    return;
+  }
+  if (stream->confidence < 2) stream->confidence++;
+  if (stream->confidence < 2) return;
+
+  // Restart from the current line if the stream has overtaken the prefetches
+  int64_t ahead = static_cast<int64_t>(stream->head - line) * direction;
+  if (ahead < 0) stream->head = line;
+
+  // Extend the prefetched region up to `distance_` lines ahead of the stream
+  for (uint16_t i = 0; i < degree_; i++) {
+    uint64_t next = stream->head + direction;
+    if (static_cast<int64_t>(next - line) * direction > distance_) break;
+    prefetches.push_back(next * lineSize_);
+    stream->head = next;
+  }
+}
+
+}  // namespace memory
+}  // namespace simeng
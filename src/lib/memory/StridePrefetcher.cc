@@ -0,0 +1,50 @@
+#include "simeng/memory/StridePrefetcher.hh"
+
+namespace simeng {
+
+namespace memory {
+
+StridePrefetcher::StridePrefetcher(uint16_t lineSize, ryml::ConstNodeRef config)
+    : lineSize_(lineSize),
+      degree_(config["Data-Prefetcher"]["Stride-Degree"].as<uint16_t>()),
+      table_(config["Data-Prefetcher"]["Stride-Table-Entries"].as<uint16_t>()) {
+}
+
+void StridePrefetcher::observe(uint64_t pc, uint64_t address,
+                               std::vector<uint64_t>& prefetches) {
+  // Instructions are at least 2-byte aligned in every supported ISA
+  StrideTableEntry& entry = table_[(pc >> 1) % table_.size()];
+  if (entry.pc != pc) {
+    // Replace the entry of whichever load previously mapped here
+    entry = {pc, address, 0, 0};
+    return;
+  }
+
+  int64_t stride = static_cast<int64_t>(address - entry.lastAddress);
+  entry.lastAddress = address;
+  if (stride == 0) return;
+  if (stride == entry.stride) {
+    // The stride has repeated, so is predictable
+    if (entry.confidence < 3) entry.confidence++;
+  } else if (entry.confidence > 0) {
+    entry.confidence--;
+    return;
+  } else {
+    // Only retrain once the previous stride has lost all confidence
+    entry.stride = stride;
+    return;
+  }
+
+  // Propose each line reached by the next strides, skipping the current line
+  // and repeats when the stride is shorter than a line
+  uint64_t lastLine = address / lineSize_;
+  for (uint16_t i = 1; i <= degree_; i++) {
+    uint64_t line = (address + i * stride) / lineSize_;
+    if (line == lastLine) continue;
+    prefetches.push_back(line * lineSize_);
+    lastLine = line;
+  }
+}
+
+}  // namespace memory
+}  // namespace simeng
@@ -0,0 +1,98 @@
+#include "simeng/memory/Tlb.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace simeng {
+
+namespace memory {
+
+Tlb::Tlb(const std::string& name, uint32_t entries, uint16_t associativity,
+         uint16_t hitLatency, uint64_t pageSize, std::shared_ptr<Tlb> nextLevel,
+         uint16_t walkLatency)
+    : name_(name),
+      sets_(entries / associativity),
+      ways_(associativity),
+      hitLatency_(hitLatency),
+      nextLevel_(nextLevel),
+      walkLatency_(walkLatency) {
+  // Page sizes are validated as powers of two
+  pageShift_ = 0;
+  while ((1ull << pageShift_) < pageSize) pageShift_++;
+
+  pages_.resize(sets_ * ways_, ~0ull);
+  stamps_.resize(sets_ * ways_, 0);
+  readyAt_.resize(sets_ * ways_, 0);
+}
+
+uint64_t Tlb::translate(uint64_t address, uint64_t cycle) {
+  uint64_t page = address >> pageShift_;
+  uint64_t base = (page % sets_) * ways_;
+
+  for (uint16_t way = 0; way < ways_; way++) {
+    if (pages_[base + way] != page) continue;
+    stamps_[base + way] = cycle;
+    if (readyAt_[base + way] > cycle + hitLatency_) {
+      return readyAt_[base + way];
+    }
+    hits_++;
+    return cycle + hitLatency_;
+  }
+
+  misses_++;
+  uint64_t lookupAt = cycle + hitLatency_;
+  uint64_t readyAt = nextLevel_ ? nextLevel_->translate(address, lookupAt)
+                                : lookupAt + walkLatency_;
+
+  uint64_t index = chooseVictim(base);
+  pages_[index] = page;
+  stamps_[index] = cycle;
+  readyAt_[index] = readyAt;
+  return readyAt;
+}
+
+void Tlb::warm(uint64_t address, uint64_t cycle) {
+  uint64_t page = address >> pageShift_;
+  uint64_t base = (page % sets_) * ways_;
+
+  for (uint16_t way = 0; way < ways_; way++) {
+    if (pages_[base + way] != page) continue;
+    stamps_[base + way] = cycle;
+    return;
+  }
+
+  if (nextLevel_) nextLevel_->warm(address, cycle);
+  uint64_t index = chooseVictim(base);
+  pages_[index] = page;
+  stamps_[index] = cycle;
+  readyAt_[index] = cycle;
+}
+
+uint64_t Tlb::chooseVictim(uint64_t base) const {
+  // Fill an invalid way, or replace the least recently used
+  for (uint16_t way = 0; way < ways_; way++) {
+    if (pages_[base + way] == ~0ull) return base + way;
+  }
+  return std::min_element(stamps_.begin() + base,
+                          stamps_.begin() + base + ways_) -
+         stamps_.begin();
+}
+
+uint64_t Tlb::getPageSize() const { return 1ull << pageShift_; }
+
+void Tlb::getStats(std::map<std::string, std::string>& stats) const {
+  uint64_t lookups = hits_ + misses_;
+  float missRate =
+      lookups == 0 ? 0.0f : 100.0f * misses_ / static_cast<float>(lookups);
+  std::ostringstream missRateStr;
+  missRateStr << std::setprecision(3) << missRate << "%";
+
+  stats[name_ + ".hits"] = std::to_string(hits_);
+  stats[name_ + ".misses"] = std::to_string(misses_);
+  stats[name_ + ".missrate"] = missRateStr.str();
+  if (nextLevel_) nextLevel_->getStats(stats);
+}
+
+}  // namespace memory
+}  // namespace simeng
@@ -1,6 +1,8 @@
 #include "simeng/models/emulation/Core.hh"
 
-#include <cstring>
+#include <algorithm>
+
+#include "simeng/memory/SharedMemory.hh"
 
 namespace simeng {
 namespace models {
@@ -9,35 +11,62 @@ namespace emulation {
 /** The number of bytes fetched each cycle. */
 const uint8_t FETCH_SIZE = 4;
 
+/** The granularity, in bytes, at which writes invalidate translated code. */
+const uint64_t CODE_PAGE_SIZE = memory::PageGenerations::pageSize;
+
 Core::Core(memory::MemoryInterface& instructionMemory,
            memory::MemoryInterface& dataMemory, uint64_t entryPoint,
-           uint64_t programByteLength, const arch::Architecture& isa)
-    : simeng::Core(dataMemory, isa, config::SimInfo::getArchRegStruct()),
+           uint64_t programByteLength, const arch::Architecture& isa,
+           ryml::ConstNodeRef config)
+    : simeng::Core(dataMemory, isa, isa.getArchRegStruct(), config),
       instructionMemory_(instructionMemory),
+      directMemory_(dataMemory.getDirectMemory()),
       architecturalRegisterFileSet_(registerFileSet_),
       pc_(entryPoint),
-      programByteLength_(programByteLength) {
+      programByteLength_(programByteLength),
+      basicBlockAddress_(entryPoint) {
   // Pre-load the first instruction
-  instructionMemory_.requestRead({pc_, FETCH_SIZE});
+  requestFetch();
 
   // Query and apply initial state
   auto state = isa.getInitialState();
   applyStateChange(state);
+
+  std::string bbvPath = config["Sampling"]["BBV-Path"].as<std::string>();
+  if (!bbvPath.empty()) {
+    bbvProfiler_ = std::make_unique<BBVProfiler>(
+        bbvPath, config["Sampling"]["Interval-Length"].as<uint64_t>());
+  }
+}
+
+Core::~Core() {
+  if (bbvProfiler_)
+    bbvProfiler_->record(basicBlockAddress_,
+                         instructionsExecuted_ - basicBlockStart_);
+}
+
+void Core::tick() { advance(); }
+
+uint64_t Core::tickBlock() {
+  uint64_t start = ticks_;
+  while (advance()) {
+  }
+  return ticks_ - start;
 }
 
-void Core::tick() {
+bool Core::advance() {
   ticks_++;
 
-  if (hasHalted_) return;
+  if (hasHalted_) return false;
 
   if (pc_ >= programByteLength_) {
     hasHalted_ = true;
-    return;
+    return false;
   }
 
   if (exceptionHandler_ != nullptr) {
     processExceptionHandler();
-    return;
+    return false;
   }
 
   if (pendingReads_ > 0) {
@@ -58,46 +87,32 @@ void Core::tick() {
     }
 
     // More data pending, end cycle early
-    return;
+    return false;
   }
 
+  return step();
+}
+
+bool Core::step() {
   // Fetch
 
   // Determine if new uops are needed to be fetched
-  if (!microOps_.size()) {
-    // Find fetched memory that matches the current PC
-    const auto& fetched = instructionMemory_.getCompletedReads();
-    size_t fetchIndex;
-    for (fetchIndex = 0; fetchIndex < fetched.size(); fetchIndex++) {
-      if (fetched[fetchIndex].target.address == pc_) {
-        break;
-      }
-    }
-    if (fetchIndex == fetched.size()) {
-      // Need to wait for fetched instructions
-      return;
-    }
-
-    const auto& instructionBytes = fetched[fetchIndex].data;
-    auto bytesRead = isa_.predecode(instructionBytes.getAsVector<char>(),
-                                    FETCH_SIZE, pc_, macroOp_);
-
-    // Clear the fetched data
-    instructionMemory_.clearCompletedReads();
-
-    pc_ += bytesRead;
-
-    // Decode
-    for (size_t index = 0; index < macroOp_.size(); index++) {
-      microOps_.push(std::move(macroOp_[index]));
-    }
+  if (!microOps_.size() && !fetch()) {
+    // Need to wait for fetched instructions
+    return false;
   }
 
   auto& uop = microOps_.front();
 
   if (uop->exceptionEncountered()) {
     handleException(uop);
-    return;
+    return false;
+  }
+
+  // Keep an unexecuted copy of an exclusive store or atomic, to retry should
+  // its write through the exclusive monitor fail
+  if (uop->isAtomic() && uop->isStoreData() && isa_.hasExclusiveMonitor()) {
+    exclusiveRetry_ = uop->clone();
   }
 
   // Issue
@@ -115,9 +130,29 @@ void Core::tick() {
     previousAddresses_.clear();
     if (uop->exceptionEncountered()) {
       handleException(uop);
-      return;
+      return false;
     }
-    if (addresses.size() > 0) {
+    if (accessObserver_) {
+      for (const auto& target : addresses) {
+        accessObserver_(AccessType::Load, uop->getInstructionAddress(), target);
+      }
+    }
+    if (addresses.size() > 0 && directMemory_.size()) {
+      // Zero-latency memory; read the data directly and execute within this
+      // tick. Out-of-bounds reads supply an invalid value to signal a fault
+      for (auto const& target : addresses) {
+        RegisterValue data;
+        if (target.address + target.size <= directMemory_.size()) {
+          data = memory::readShared(directMemory_.data() + target.address,
+                                    target.size);
+        }
+        uop->supplyData(target.address, data);
+        // Store addresses for use by next store data operation
+        previousAddresses_.push_back(target);
+      }
+      execute(uop);
+      return canContinue();
+    } else if (addresses.size() > 0) {
       // Memory reads are required; request them, set `pendingReads_`
       // accordingly, and end the cycle early
       for (auto const& target : addresses) {
@@ -126,18 +161,18 @@ void Core::tick() {
         previousAddresses_.push_back(target);
       }
       pendingReads_ = addresses.size();
-      return;
+      return false;
     } else {
       // Early execution due to lacking addresses
       execute(uop);
-      return;
+      return canContinue();
     }
   } else if (uop->isStoreAddress()) {
     auto addresses = uop->generateAddresses();
     previousAddresses_.clear();
     if (uop->exceptionEncountered()) {
       handleException(uop);
-      return;
+      return false;
     }
     // Store addresses for use by next store data operation
     for (auto const& target : addresses) {
@@ -146,25 +181,317 @@ void Core::tick() {
     if (uop->isStoreData()) {
       execute(uop);
     } else {
-      // Fetch memory for next cycle
-      instructionMemory_.requestRead({pc_, FETCH_SIZE});
       microOps_.pop();
+      // Fetch memory for next cycle
+      if (!microOps_.size()) requestFetch();
     }
 
-    return;
+    return canContinue();
   }
 
   execute(uop);
   isa_.updateSystemTimerRegisters(&registerFileSet_, ticks_);
+  return canContinue();
+}
+
+bool Core::canContinue() const {
+  if (hasHalted_ || exceptionHandler_ != nullptr || pc_ >= programByteLength_)
+    return false;
+  // Only continue part-way through a macro-op or a translated block, such that
+  // `tickBlock()` processes at most one basic block
+  return microOps_.size() ||
+         (activeBlock_ != nullptr && blockIndex_ > 0 &&
+          blockIndex_ < activeBlock_->instructions.size());
+}
+
+bool Core::fetch() {
+  if (activeBlock_ != nullptr &&
+      blockIndex_ < activeBlock_->instructions.size()) {
+    // Supply the next translated instruction's micro-ops, ready to execute
+    // once more
+    const auto& insn = activeBlock_->instructions[blockIndex_++];
+    for (const auto& uop : insn.microOps) {
+      uop->reset();
+      microOps_.push(uop);
+    }
+    if (accessObserver_)
+      accessObserver_(AccessType::Fetch, pc_, {pc_, insn.size});
+    pc_ += insn.size;
+    translationHits_++;
+    return true;
+  }
+
+  // Find fetched memory that matches the current PC
+  const auto& fetched = instructionMemory_.getCompletedReads();
+  size_t fetchIndex;
+  for (fetchIndex = 0; fetchIndex < fetched.size(); fetchIndex++) {
+    if (fetched[fetchIndex].target.address == pc_) {
+      break;
+    }
+  }
+  if (fetchIndex == fetched.size()) {
+    return false;
+  }
+
+  const auto& instructionBytes = fetched[fetchIndex].data;
+  auto bytesRead = isa_.predecode(instructionBytes.getAsVector<char>(),
+                                  FETCH_SIZE, pc_, macroOp_);
+
+  // Clear the fetched data
+  instructionMemory_.clearCompletedReads();
+
+  // Record the decoding for future executions of this code
+  translate(pc_, bytesRead);
+  if (accessObserver_)
+    accessObserver_(AccessType::Fetch, pc_, {pc_, bytesRead});
+
+  pc_ += bytesRead;
+
+  // Decode
+  for (size_t index = 0; index < macroOp_.size(); index++) {
+    microOps_.push(std::move(macroOp_[index]));
+  }
+  return true;
+}
+
+void Core::requestFetch() {
+  BasicBlock* next = nullptr;
+  if (activeBlock_ != nullptr) {
+    // Instructions remaining in the active block are already decoded
+    if (blockIndex_ < activeBlock_->instructions.size()) return;
+
+    // Follow the link to the block which succeeded this one previously
+    if (activeBlock_->successor != nullptr &&
+        activeBlock_->successorAddress == pc_) {
+      next = activeBlock_->successor;
+    }
+  }
+
+  if (next == nullptr) {
+    auto iter = translationCache_.find(pc_);
+    if (iter != translationCache_.end()) {
+      next = &iter->second;
+      if (activeBlock_ != nullptr) linkSuccessor(*activeBlock_, next, pc_);
+    }
+  }
+
+  if (next != nullptr && isStale(*next)) next = nullptr;
+  activeBlock_ = next;
+  blockIndex_ = 0;
+  if (activeBlock_ != nullptr) return;
+
+  // Note the generations of the pages read before reading them, such that a
+  // write landing while they are read leaves the translation stale
+  fetchPages_.clear();
+  if (auto* generations = isa_.getPageGenerations()) {
+    uint64_t firstPage = pc_ / CODE_PAGE_SIZE;
+    uint64_t lastPage = (pc_ + FETCH_SIZE - 1) / CODE_PAGE_SIZE;
+    for (uint64_t page = firstPage; page <= lastPage; page++) {
+      fetchPages_.push_back({page, generations->watch(page)});
+    }
+  }
+  instructionMemory_.requestRead({pc_, FETCH_SIZE});
+}
+
+bool Core::isStale(const BasicBlock& block) {
+  auto* generations = isa_.getPageGenerations();
+  if (generations == nullptr) return false;
+
+  bool stale = false;
+  for (const auto& [page, generation] : block.pageGenerations) {
+    if (generations->get(page) == generation) continue;
+    // Another core or a syscall has written to the page; `block` itself may
+    // be discarded here, so is not referred to again
+    stale = true;
+    invalidatePages(page, page);
+    break;
+  }
+  return stale;
+}
+
+void Core::translate(uint64_t address, uint8_t size) {
+  // Resetting an instruction for reuse would discard an exception raised when
+  // decoding it, so such an instruction is decoded afresh each time instead
+  if (std::any_of(macroOp_.begin(), macroOp_.end(), [](const auto& uop) {
+        return uop->exceptionEncountered();
+      })) {
+    if (translating_) finaliseTranslation();
+    return;
+  }
+
+  if (!translating_) {
+    pendingBlock_ = BasicBlock();
+    pendingBlockAddress_ = address;
+    translating_ = true;
+  }
+
+  // Keep the decoded micro-ops for later executions of the block
+  TranslatedInstruction insn;
+  insn.size = size;
+  bool endsBlock = false;
+  for (size_t index = 0; index < macroOp_.size(); index++) {
+    insn.microOps.push_back(macroOp_[index]);
+    if (macroOp_[index]->isBranch()) endsBlock = true;
+  }
+  pendingBlock_.instructions.push_back(std::move(insn));
+  pendingBlock_.endAddress = address + size;
+
+  // Note the generation of each page read, keeping the earliest where the
+  // block has already read from it
+  uint64_t firstPage = address / CODE_PAGE_SIZE;
+  uint64_t lastPage =
+      (address + std::max<uint8_t>(size, 1) - 1) / CODE_PAGE_SIZE;
+  for (const auto& fetched : fetchPages_) {
+    if (fetched.first < firstPage || fetched.first > lastPage) continue;
+    auto& pages = pendingBlock_.pageGenerations;
+    if (std::none_of(pages.begin(), pages.end(), [&](const auto& entry) {
+          return entry.first == fetched.first;
+        }))
+      pages.push_back(fetched);
+  }
+
+  // A block ends at a branch, or where it would run into an already
+  // translated block
+  if (endsBlock || translationCache_.count(address + size)) {
+    finaliseTranslation();
+  }
+}
+
+void Core::finaliseTranslation() {
+  translating_ = false;
+  if (pendingBlock_.instructions.empty()) return;
+
+  // Register the block against each page it occupies
+  uint64_t firstPage = pendingBlockAddress_ / CODE_PAGE_SIZE;
+  uint64_t lastPage = (pendingBlock_.endAddress - 1) / CODE_PAGE_SIZE;
+  for (uint64_t page = firstPage; page <= lastPage; page++) {
+    codePages_[page].push_back(pendingBlockAddress_);
+  }
+
+  removeBlock(pendingBlockAddress_);
+  translationCache_[pendingBlockAddress_] = std::move(pendingBlock_);
+  blocksTranslated_++;
+}
+
+void Core::linkSuccessor(BasicBlock& block, BasicBlock* successor,
+                         uint64_t address) {
+  if (block.successor != nullptr) {
+    auto& previous = block.successor->predecessors;
+    previous.erase(std::find(previous.begin(), previous.end(), &block));
+  }
+  block.successor = successor;
+  block.successorAddress = address;
+  successor->predecessors.push_back(&block);
+}
+
+void Core::removeBlock(uint64_t address) {
+  auto iter = translationCache_.find(address);
+  if (iter == translationCache_.end()) return;
+  auto& block = iter->second;
+
+  // Unlink the block, such that no link outlives either end of it
+  if (block.successor != nullptr) {
+    auto& siblings = block.successor->predecessors;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), &block));
+  }
+  for (auto* predecessor : block.predecessors) {
+    predecessor->successor = nullptr;
+  }
+
+  // Any remaining instructions of the active block are re-fetched
+  if (&block == activeBlock_) activeBlock_ = nullptr;
+  translationCache_.erase(iter);
+}
+
+void Core::invalidateTranslations(const memory::MemoryAccessTarget& target) {
+  if (target.size == 0) return;
+  uint64_t endAddress = target.address + target.size;
+
+  // Abandon the in-progress translation if the write overlaps it
+  if (translating_ && target.address < pendingBlock_.endAddress &&
+      endAddress > pendingBlockAddress_) {
+    translating_ = false;
+  }
+
+  invalidatePages(target.address / CODE_PAGE_SIZE,
+                  (endAddress - 1) / CODE_PAGE_SIZE);
+}
+
+void Core::invalidatePages(uint64_t firstPage, uint64_t lastPage) {
+  if (codePages_.empty()) return;
+
+  for (uint64_t page = firstPage; page <= lastPage; page++) {
+    auto pageIter = codePages_.find(page);
+    if (pageIter == codePages_.end()) continue;
+
+    // A block may have already been removed via another page it spans
+    for (uint64_t blockAddress : pageIter->second) removeBlock(blockAddress);
+    codePages_.erase(pageIter);
+  }
 }
 
 bool Core::hasHalted() const { return hasHalted_; }
 
+uint64_t Core::getIdleTicks() const {
+  if (hasHalted_) return UINT64_MAX;
+  if (pc_ >= programByteLength_) return 0;
+  // An exception handler cannot start until the data memory has drained
+  if (exceptionHandler_ != nullptr) {
+    return dataMemory_.hasPendingRequests() ? UINT64_MAX : 0;
+  }
+  // A load waiting on memory can only continue once a read completes
+  if (pendingReads_ > 0 && dataMemory_.getCompletedReads().size() == 0)
+    return UINT64_MAX;
+  return 0;
+}
+
+void Core::skipTicks(uint64_t ticks) {
+  assert(getIdleTicks() > 0 && "Skipped a tick in which the core was active");
+  ticks_ += ticks;
+}
+
+void Core::schedule(int64_t tid, uint64_t pc,
+                    const arch::ProcessStateChange& registers) {
+  assert(hasHalted_ && "Attempted to schedule a thread onto a running core");
+  threadId_ = tid;
+  hasHalted_ = false;
+  pc_ = pc;
+
+  // The thread's first instruction starts a new basic block
+  if (bbvProfiler_) endBasicBlock();
+
+  // Discard any state left behind by the previous thread
+  microOps_ = {};
+  pendingReads_ = 0;
+  exceptionHandler_ = nullptr;
+  exclusiveRetry_ = nullptr;
+  activeBlock_ = nullptr;
+  translating_ = false;
+  instructionMemory_.clearCompletedReads();
+
+  applyStateChange(registers);
+  requestFetch();
+}
+
 const ArchitecturalRegisterFileSet& Core::getArchitecturalRegisterFileSet()
     const {
   return architecturalRegisterFileSet_;
 }
 
+bool Core::isBetweenInstructions() const {
+  return microOps_.empty() && exceptionHandler_ == nullptr &&
+         pendingReads_ == 0 && !dataMemory_.hasPendingRequests();
+}
+
+uint64_t Core::getProgramCounter() const { return pc_; }
+
+void Core::setAccessObserver(
+    std::function<void(AccessType type, uint64_t pc,
+                       const memory::MemoryAccessTarget& target)>
+        observer) {
+  accessObserver_ = std::move(observer);
+}
+
 uint64_t Core::getInstructionsRetiredCount() const {
   return instructionsExecuted_;
 }
@@ -172,10 +499,12 @@ uint64_t Core::getInstructionsRetiredCount() const {
 std::map<std::string, std::string> Core::getStats() const {
   return {{"cycles", std::to_string(ticks_)},
           {"retired", std::to_string(instructionsExecuted_)},
-          {"branch.executed", std::to_string(branchesExecuted_)}};
+          {"branch.executed", std::to_string(branchesExecuted_)},
+          {"translation.blocks", std::to_string(blocksTranslated_)},
+          {"translation.hits", std::to_string(translationHits_)}};
 };
 
-void Core::execute(std::shared_ptr<Instruction>& uop) {
+void Core::execute(IntrusivePtr<Instruction>& uop) {
   uop->execute();
 
   if (uop->exceptionEncountered()) {
@@ -183,10 +512,43 @@ void Core::execute(std::shared_ptr<Instruction>& uop) {
     return;
   }
 
-  if (uop->isStoreData()) {
+  if (uop->isStoreData() && uop->isAtomic() && isa_.hasExclusiveMonitor()) {
+    // Write through the exclusive monitor, retrying the instruction from the
+    // start if another core has written to the memory since it was read
+    if (!isa_.storeExclusive(*uop)) {
+      uop = std::move(exclusiveRetry_);
+      return;
+    }
+    exclusiveRetry_ = nullptr;
+    if (uop->holdsReservation()) {
+      for (const auto& target : previousAddresses_) {
+        if (accessObserver_)
+          accessObserver_(AccessType::Store, uop->getInstructionAddress(),
+                          target);
+        // The write is already made, so only its timing is requested
+        if (!directMemory_.size()) {
+          dataMemory_.requestWrite(target, RegisterValue());
+        }
+        invalidateTranslations(target);
+      }
+    }
+  } else if (uop->isStoreData()) {
     auto data = uop->getData();
     for (size_t i = 0; i < previousAddresses_.size(); i++) {
-      dataMemory_.requestWrite(previousAddresses_[i], data[i]);
+      const auto& target = previousAddresses_[i];
+      if (directMemory_.size() &&
+          target.address + target.size <= directMemory_.size()) {
+        memory::writeShared(directMemory_.data() + target.address, data[i],
+                            target.size);
+      } else {
+        // Leave out-of-bounds writes to the memory interface to report
+        dataMemory_.requestWrite(target, data[i]);
+      }
+      isa_.recordStore(target);
+      invalidateTranslations(target);
+      if (accessObserver_)
+        accessObserver_(AccessType::Store, uop->getInstructionAddress(),
+                        target);
     }
   } else if (uop->isBranch()) {
     pc_ = uop->getBranchAddress();
@@ -210,12 +572,19 @@ void Core::execute(std::shared_ptr<Instruction>& uop) {
 
   if (uop->isLastMicroOp()) instructionsExecuted_++;
 
-  // Fetch memory for next cycle
-  instructionMemory_.requestRead({pc_, FETCH_SIZE});
+  if (bbvProfiler_ && uop->isBranch()) endBasicBlock();
+
   microOps_.pop();
+
+  // Fetch memory for next cycle
+  if (!microOps_.size()) requestFetch();
 }
 
-void Core::handleException(const std::shared_ptr<Instruction>& instruction) {
+void Core::handleException(const IntrusivePtr<Instruction>& instruction) {
+  // An exception ends the basic block being translated
+  if (translating_) finaliseTranslation();
+  exclusiveRetry_ = nullptr;
+
   exceptionHandler_ = isa_.handleException(instruction, *this, dataMemory_);
   processExceptionHandler();
 }
@@ -243,15 +612,31 @@ void Core::processExceptionHandler() {
     std::cout << "[SimEng:Core] Halting due to fatal exception" << std::endl;
   } else {
     pc_ = result.instructionAddress;
+    for (const auto& target : result.stateChange.memoryAddresses) {
+      isa_.recordStore(target);
+      invalidateTranslations(target);
+    }
     applyStateChange(result.stateChange);
+    if (result.threadExited || result.threadWaiting) hasHalted_ = true;
   }
 
   // Clear the handler
   exceptionHandler_ = nullptr;
 
-  // Fetch memory for next cycle
-  instructionMemory_.requestRead({pc_, FETCH_SIZE});
+  // Execution resumes from a new address, discarding the remainder of any
+  // active translated block
+  activeBlock_ = nullptr;
   microOps_.pop();
+
+  // Fetch memory for next cycle
+  if (!microOps_.size()) requestFetch();
+}
+
+void Core::endBasicBlock() {
+  bbvProfiler_->record(basicBlockAddress_,
+                       instructionsExecuted_ - basicBlockStart_);
+  basicBlockAddress_ = pc_;
+  basicBlockStart_ = instructionsExecuted_;
 }
 
 }  // namespace emulation
@@ -12,17 +12,18 @@ namespace inorder {
 Core::Core(memory::MemoryInterface& instructionMemory,
            memory::MemoryInterface& dataMemory, uint64_t processMemorySize,
            uint64_t entryPoint, const arch::Architecture& isa,
-           BranchPredictor& branchPredictor)
-    : simeng::Core(dataMemory, isa, config::SimInfo::getArchRegStruct()),
+           BranchPredictor& branchPredictor, ryml::ConstNodeRef config)
+    : simeng::Core(dataMemory, isa, isa.getArchRegStruct(), config),
       architecturalRegisterFileSet_(registerFileSet_),
       fetchToDecodeBuffer_(1, {}),
       decodeToExecuteBuffer_(1, nullptr),
       completionSlots_(1, {1, nullptr}),
       fetchUnit_(fetchToDecodeBuffer_, instructionMemory, processMemorySize,
-                 entryPoint,
-                 config::SimInfo::getConfig()["Fetch"]["Fetch-Block-Size"]
-                     .as<uint16_t>(),
-                 isa, branchPredictor),
+                 entryPoint, config["Fetch"]["Fetch-Block-Size"].as<uint16_t>(),
+                 isa, branchPredictor, nullptr,
+                 config["Fetch"]["Fetch-Target-Queue-Size"].as<uint16_t>(),
+                 config["Fetch"]["Branch-Target-Buffer-Entries"].as<uint16_t>(),
+                 config["Fetch"]["Fetch-Targets-Per-Cycle"].as<uint16_t>()),
       decodeUnit_(fetchToDecodeBuffer_, decodeToExecuteBuffer_,
                   branchPredictor),
       executeUnit_(
@@ -78,6 +79,24 @@ void Core::tick() {
     return;
   }
 
+  if (failedExclusive_ != nullptr) {
+    // Another core wrote to the memory of an exclusive store or atomic between
+    // its read and write; discard it, along with younger uops, and fetch it
+    // again
+    fetchToDecodeBuffer_.fill({});
+    decodeToExecuteBuffer_.fill(nullptr);
+    decodeUnit_.purgeFlushed();
+    completionSlots_[0].fill(nullptr);
+
+    fetchUnit_.flushLoopBuffer();
+    fetchUnit_.updatePC(failedExclusive_->getInstructionAddress());
+    failedExclusive_ = nullptr;
+    flushes_++;
+
+    fetchUnit_.requestFromPC();
+    return;
+  }
+
   // Check for flush
   if (executeUnit_.shouldFlush()) {
     // Flush was requested at execute stage
@@ -133,6 +152,39 @@ bool Core::hasHalted() const {
           exceptionHandler_ == nullptr);
 }
 
+uint64_t Core::getIdleTicks() const {
+  if (hasHalted_) return UINT64_MAX;
+  // An exception handler cannot start until the data memory has drained
+  if (exceptionHandler_ != nullptr && dataMemory_.hasPendingRequests())
+    return UINT64_MAX;
+  return 0;
+}
+
+void Core::skipTicks(uint64_t ticks) {
+  assert(getIdleTicks() > 0 && "Skipped a tick in which the core was active");
+  ticks_ += ticks;
+}
+
+void Core::schedule(int64_t tid, uint64_t pc,
+                    const arch::ProcessStateChange& registers) {
+  assert(hasHalted_ && "Attempted to schedule a thread onto a running core");
+  threadId_ = tid;
+  hasHalted_ = false;
+
+  // Discard any state left behind by the previous thread
+  fetchToDecodeBuffer_.fill({});
+  decodeToExecuteBuffer_.fill(nullptr);
+  decodeUnit_.purgeFlushed();
+  completionSlots_[0].fill(nullptr);
+  exceptionGenerated_ = false;
+  exceptionHandler_ = nullptr;
+  failedExclusive_ = nullptr;
+
+  fetchUnit_.flushLoopBuffer();
+  fetchUnit_.updatePC(pc);
+  applyStateChange(registers);
+}
+
 const ArchitecturalRegisterFileSet& Core::getArchitecturalRegisterFileSet()
     const {
   return architecturalRegisterFileSet_;
@@ -167,7 +219,7 @@ std::map<std::string, std::string> Core::getStats() const {
           {"branch.missrate", branchMissRateStr.str()}};
 }
 
-void Core::raiseException(const std::shared_ptr<Instruction>& instruction) {
+void Core::raiseException(const IntrusivePtr<Instruction>& instruction) {
   exceptionGenerated_ = true;
   exceptionGeneratingInstruction_ = instruction;
 }
@@ -210,18 +262,24 @@ void Core::processExceptionHandler() {
   } else {
     fetchUnit_.flushLoopBuffer();
     fetchUnit_.updatePC(result.instructionAddress);
+    for (const auto& target : result.stateChange.memoryAddresses) {
+      isa_.recordStore(target);
+    }
     applyStateChange(result.stateChange);
+    if (result.threadExited || result.threadWaiting) hasHalted_ = true;
   }
 
   exceptionHandler_ = nullptr;
 }
 
-void Core::handleLoad(const std::shared_ptr<Instruction>& instruction) {
+void Core::handleLoad(const IntrusivePtr<Instruction>& instruction) {
   loadData(instruction);
   if (instruction->exceptionEncountered()) {
     raiseException(instruction);
     return;
   }
+  // A failed atomic is fetched again, so its results are discarded
+  if (instruction == failedExclusive_) return;
 
   forwardOperands(instruction->getDestinationRegisters(),
                   instruction->getResults());
@@ -229,7 +287,7 @@ void Core::handleLoad(const std::shared_ptr<Instruction>& instruction) {
   completionSlots_[0].getTailSlots()[0] = instruction;
 }
 
-void Core::loadData(const std::shared_ptr<Instruction>& instruction) {
+void Core::loadData(const IntrusivePtr<Instruction>& instruction) {
   const auto& addresses = instruction->getGeneratedAddresses();
   for (const auto& target : addresses) {
     dataMemory_.requestRead(target);
@@ -251,17 +309,30 @@ void Core::loadData(const std::shared_ptr<Instruction>& instruction) {
   }
 }
 
-void Core::storeData(const std::shared_ptr<Instruction>& instruction) {
+void Core::storeData(const IntrusivePtr<Instruction>& instruction) {
   if (instruction->isStoreAddress()) {
     auto addresses = instruction->getGeneratedAddresses();
     for (auto const& target : addresses) {
       previousAddresses_.push(target);
     }
   }
-  if (instruction->isStoreData()) {
+  if (instruction->isStoreData() && instruction->isAtomic() &&
+      isa_.hasExclusiveMonitor()) {
+    // Exclusive stores and atomics write through the exclusive monitor, with
+    // only the timing of the write left to the memory interface
+    bool written = isa_.storeExclusive(*instruction);
+    for (size_t i = 0; i < instruction->getData().size(); i++) {
+      if (written && instruction->holdsReservation()) {
+        dataMemory_.requestWrite(previousAddresses_.front(), RegisterValue());
+      }
+      previousAddresses_.pop();
+    }
+    if (!written) failedExclusive_ = instruction;
+  } else if (instruction->isStoreData()) {
     const auto data = instruction->getData();
     for (size_t i = 0; i < data.size(); i++) {
       dataMemory_.requestWrite(previousAddresses_.front(), data[i]);
+      isa_.recordStore(previousAddresses_.front());
       previousAddresses_.pop();
     }
   }
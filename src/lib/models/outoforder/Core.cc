@@ -10,16 +10,34 @@ namespace simeng {
 namespace models {
 namespace outoforder {
 
+/** Create the `level` TLB described by the TLB config section, backed by
+ * `nextLevel`. Returns null if the level has no entries. */
+std::shared_ptr<memory::Tlb> createTlb(const std::string& name,
+                                       const std::string& level,
+                                       uint16_t hitLatency,
+                                       std::shared_ptr<memory::Tlb> nextLevel,
+                                       ryml::ConstNodeRef config) {
+  ryml::ConstNodeRef tlb = config["TLB"];
+  std::string entriesKey = level + "-Entries";
+  std::string waysKey = level + "-Associativity";
+  uint32_t entries = tlb[ryml::to_csubstr(entriesKey)].as<uint32_t>();
+  if (entries == 0) return nullptr;
+  return std::make_shared<memory::Tlb>(
+      name, entries, tlb[ryml::to_csubstr(waysKey)].as<uint16_t>(), hitLatency,
+      tlb["Page-Size"].as<uint64_t>(), nextLevel,
+      tlb["Page-Walk-Latency"].as<uint16_t>());
+}
+
 Core::Core(memory::MemoryInterface& instructionMemory,
            memory::MemoryInterface& dataMemory, uint64_t processMemorySize,
            uint64_t entryPoint, const arch::Architecture& isa,
            BranchPredictor& branchPredictor,
            pipeline::PortAllocator& portAllocator, ryml::ConstNodeRef config)
-    : simeng::Core(dataMemory, isa, config::SimInfo::getPhysRegStruct()),
-      physicalRegisterStructures_(config::SimInfo::getPhysRegStruct()),
-      physicalRegisterQuantities_(config::SimInfo::getPhysRegQuantities()),
-      registerAliasTable_(config::SimInfo::getArchRegStruct(),
-                          physicalRegisterQuantities_),
+    : simeng::Core(dataMemory, isa, isa.getPhysRegStruct(), config),
+      instructionMemory_(instructionMemory),
+      physicalRegisterStructures_(isa.getPhysRegStruct()),
+      physicalRegisterQuantities_(isa.getPhysRegQuantities()),
+      registerAliasTable_(isa.getArchRegStruct(), physicalRegisterQuantities_),
       mappedRegisterFileSet_(registerFileSet_, registerAliasTable_),
       fetchToDecodeBuffer_(config["Pipeline-Widths"]["FrontEnd"].as<uint16_t>(),
                            {}),
@@ -32,15 +50,32 @@ Core::Core(memory::MemoryInterface& instructionMemory,
           config["Execution-Units"].num_children() +
               config["Pipeline-Widths"]["LSQ-Completion"].as<uint16_t>(),
           {1, nullptr}),
+      l2Tlb_(createTlb("l2tlb", "L2",
+                       config["TLB"]["L2-Latency"].as<uint16_t>(), nullptr,
+                       config)),
+      instructionTlb_(createTlb("itlb", "Instruction", 0, l2Tlb_, config)),
+      dataTlb_(createTlb("dtlb", "Data", 0, l2Tlb_, config)),
+      storeSetPredictor_(
+          config["Memory-Dependence-Predictor"]["Store-Set-ID-Entries"]
+                      .as<uint16_t>() == 0
+              ? nullptr
+              : std::make_unique<pipeline::StoreSetPredictor>(config)),
+      microOpCache_(config["Micro-Op-Cache"]["Entries"].as<uint16_t>() == 0
+                        ? nullptr
+                        : std::make_unique<pipeline::MicroOpCache>(config)),
       fetchUnit_(fetchToDecodeBuffer_, instructionMemory, processMemorySize,
                  entryPoint, config["Fetch"]["Fetch-Block-Size"].as<uint16_t>(),
-                 isa, branchPredictor),
+                 isa, branchPredictor, instructionTlb_.get(),
+                 config["Fetch"]["Fetch-Target-Queue-Size"].as<uint16_t>(),
+                 config["Fetch"]["Branch-Target-Buffer-Entries"].as<uint16_t>(),
+                 config["Fetch"]["Fetch-Targets-Per-Cycle"].as<uint16_t>(),
+                 microOpCache_.get()),
       decodeUnit_(fetchToDecodeBuffer_, decodeToRenameBuffer_, branchPredictor),
       renameUnit_(decodeToRenameBuffer_, renameToDispatchBuffer_,
                   reorderBuffer_, registerAliasTable_, loadStoreQueue_,
                   physicalRegisterStructures_.size()),
       dispatchIssueUnit_(renameToDispatchBuffer_, issuePorts_, registerFileSet_,
-                         portAllocator, physicalRegisterQuantities_),
+                         portAllocator, physicalRegisterQuantities_, config),
       writebackUnit_(
           completionSlots_, registerFileSet_,
           [this](auto insnId) { reorderBuffer_.commitMicroOps(insnId); }),
@@ -70,7 +105,8 @@ Core::Core(memory::MemoryInterface& instructionMemory,
           config["LSQ-L1-Interface"]["Permitted-Loads-Per-Cycle"]
               .as<uint16_t>(),
           config["LSQ-L1-Interface"]["Permitted-Stores-Per-Cycle"]
-              .as<uint16_t>()),
+              .as<uint16_t>(),
+          dataTlb_.get(), storeSetPredictor_.get(), &isa),
       portAllocator_(portAllocator),
       commitWidth_(config["Pipeline-Widths"]["Commit"].as<uint16_t>()) {
   for (size_t i = 0; i < config["Execution-Units"].num_children(); i++) {
@@ -86,7 +122,10 @@ Core::Core(memory::MemoryInterface& instructionMemory,
           dispatchIssueUnit_.forwardOperands(regs, values);
         },
         [this](auto uop) { loadStoreQueue_.startLoad(uop); },
-        [this](auto uop) { loadStoreQueue_.supplyStoreData(uop); },
+        [this](auto uop) {
+          loadStoreQueue_.startStore(uop);
+          loadStoreQueue_.supplyStoreData(uop);
+        },
         [](auto uop) { uop->setCommitReady(); }, branchPredictor,
         config["Execution-Units"][i]["Pipelined"].as<bool>(), blockingGroups);
   }
@@ -98,11 +137,40 @@ Core::Core(memory::MemoryInterface& instructionMemory,
   // Query and apply initial state
   auto state = isa.getInitialState();
   applyStateChange(state);
+
+  ryml::ConstNodeRef trace = config["Pipeline-Trace"];
+  std::string tracePath = trace["Path"].as<std::string>();
+  if (!tracePath.empty()) {
+    tracer_ = std::make_unique<pipeline::PipelineTracer>(
+        tracePath,
+        trace["Format"].as<std::string>() == "O3PipeView"
+            ? pipeline::PipelineTraceFormat::O3PipeView
+            : pipeline::PipelineTraceFormat::Konata,
+        trace["Start-Cycle"].as<uint64_t>(),
+        trace["Cycle-Count"].as<uint64_t>(),
+        trace["Start-Instruction"].as<uint64_t>(),
+        trace["Instruction-Count"].as<uint64_t>());
+  }
+
+  if (tracer_ || microOpCache_) {
+    reorderBuffer_.setCommitObserver([this](const auto& uop) {
+      if (tracer_) tracer_->record(uop, pipeline::PipelineEvent::Commit);
+      // Code overwritten by a committed store must be decoded again
+      if (microOpCache_ && uop->isStoreAddress()) {
+        for (const auto& target : uop->getGeneratedAddresses()) {
+          microOpCache_->invalidate(target.address, target.size);
+        }
+      }
+    });
+  }
 };
 
 void Core::tick() {
   ticks_++;
 
+  if (tracer_)
+    tracer_->tick(ticks_, reorderBuffer_.getInstructionsCommittedCount());
+
   if (hasHalted_) return;
 
   if (exceptionHandler_ != nullptr) {
@@ -121,6 +189,10 @@ void Core::tick() {
   fetchUnit_.tick();
   decodeUnit_.tick();
   renameUnit_.tick();
+  if (tracer_) {
+    auto slots = renameToDispatchBuffer_.getHeadSlots();
+    dispatchInput_.assign(slots, slots + renameToDispatchBuffer_.getWidth());
+  }
   dispatchIssueUnit_.tick();
   for (auto& eu : executionUnits_) {
     // Tick each execution unit
@@ -132,6 +204,8 @@ void Core::tick() {
   // Late tick for the dispatch/issue unit to issue newly ready uops
   dispatchIssueUnit_.issue();
 
+  if (tracer_) traceCycle();
+
   // Tick buffers
   // Each unit must have wiped the entries at the head of the buffer after use,
   // as these will now loop around and become the tail.
@@ -159,6 +233,48 @@ void Core::tick() {
   isa_.updateSystemTimerRegisters(&registerFileSet_, ticks_);
 }
 
+void Core::traceCycle() {
+  // Each stage has written the uops it processed to the tail of its output
+  auto fetched = fetchToDecodeBuffer_.getTailSlots();
+  for (size_t slot = 0; slot < fetchToDecodeBuffer_.getWidth(); slot++) {
+    for (size_t i = 0; i < fetched[slot].size(); i++) {
+      tracer_->fetch(fetched[slot][i], i);
+    }
+  }
+
+  auto decoded = decodeToRenameBuffer_.getTailSlots();
+  for (size_t slot = 0; slot < decodeToRenameBuffer_.getWidth(); slot++) {
+    if (decoded[slot] != nullptr)
+      tracer_->record(decoded[slot], pipeline::PipelineEvent::Decode);
+  }
+
+  auto renamed = renameToDispatchBuffer_.getTailSlots();
+  for (size_t slot = 0; slot < renameToDispatchBuffer_.getWidth(); slot++) {
+    if (renamed[slot] != nullptr)
+      tracer_->record(renamed[slot], pipeline::PipelineEvent::Rename);
+  }
+
+  // The dispatch/issue unit clears the slots of the uops it accepts
+  auto awaiting = renameToDispatchBuffer_.getHeadSlots();
+  for (size_t slot = 0; slot < dispatchInput_.size(); slot++) {
+    if (dispatchInput_[slot] != nullptr && awaiting[slot] == nullptr)
+      tracer_->record(dispatchInput_[slot], pipeline::PipelineEvent::Dispatch);
+  }
+  // Release the uops, so that those flushed are seen to leave the pipeline
+  dispatchInput_.clear();
+
+  for (auto& issuePort : issuePorts_) {
+    auto& uop = issuePort.getTailSlots()[0];
+    if (uop != nullptr) tracer_->record(uop, pipeline::PipelineEvent::Issue);
+  }
+
+  for (auto& completionSlot : completionSlots_) {
+    auto& uop = completionSlot.getTailSlots()[0];
+    if (uop != nullptr)
+      tracer_->record(uop, pipeline::PipelineEvent::Complete);
+  }
+}
+
 bool Core::hasHalted() const {
   if (hasHalted_) {
     return true;
@@ -194,6 +310,119 @@ bool Core::hasHalted() const {
   return true;
 }
 
+uint64_t Core::getIdleTicks() const {
+  if (hasHalted_) return UINT64_MAX;
+  // An exception handler cannot start until the data memory has drained
+  if (exceptionHandler_ != nullptr) {
+    return dataMemory_.hasPendingRequests() ? UINT64_MAX : 0;
+  }
+
+  // Otherwise, nothing may be ready to commit or flush, and every stage must
+  // be waiting on the next; only a completed memory read can then make
+  // progress
+  auto head = reorderBuffer_.getHead();
+  if ((head != nullptr && head->canCommit()) || reorderBuffer_.shouldFlush())
+    return 0;
+  if (!fetchUnit_.isIdle() || !decodeUnit_.isIdle() ||
+      !loadStoreQueue_.isIdle() || !writebackUnit_.isIdle() ||
+      !dispatchIssueUnit_.isIdle() || !renameUnit_.isIdle())
+    return 0;
+  for (const auto& eu : executionUnits_) {
+    if (!eu.isIdle()) return 0;
+  }
+  return UINT64_MAX;
+}
+
+void Core::skipTicks(uint64_t ticks) {
+  assert(getIdleTicks() > 0 && "Skipped a tick in which the core was active");
+  ticks_ += ticks;
+
+  if (tracer_)
+    tracer_->tick(ticks_, reorderBuffer_.getInstructionsCommittedCount());
+
+  if (hasHalted_ || exceptionHandler_ != nullptr) return;
+
+  portAllocator_.skipTicks(ticks);
+  fetchUnit_.skipTicks(ticks);
+  renameUnit_.skipTicks(ticks);
+  dispatchIssueUnit_.skipTicks(ticks);
+  for (auto& eu : executionUnits_) eu.skipTicks(ticks);
+  loadStoreQueue_.skipTicks(ticks);
+  isa_.updateSystemTimerRegisters(&registerFileSet_, ticks_);
+}
+
+void Core::schedule(int64_t tid, uint64_t pc,
+                    const arch::ProcessStateChange& registers) {
+  assert(hasHalted_ && "Attempted to schedule a thread onto a running core");
+  threadId_ = tid;
+  hasHalted_ = false;
+
+  // Idle cores hold no in-flight instructions; new cores have yet to fetch,
+  // and the exception which ended the previous thread flushed the pipeline
+  exceptionGenerated_ = false;
+  exceptionHandler_ = nullptr;
+
+  fetchUnit_.flushLoopBuffer();
+  fetchUnit_.updatePC(pc);
+  applyStateChange(registers);
+}
+
+std::optional<uint64_t> Core::suspend() {
+  if (hasHalted_ || exceptionHandler_ != nullptr) return std::nullopt;
+
+  // The oldest in-flight instruction is the next to commit, so its address is
+  // the architectural program counter. Earlier micro-ops of a partially
+  // committed macro-op cannot be undone, and the very first instruction has no
+  // older instruction to flush up to
+  auto head = reorderBuffer_.getHead();
+  if (head == nullptr || head->getMicroOpIndex() != 0 ||
+      head->getInstructionId() == 0)
+    return std::nullopt;
+  uint64_t pc = head->getInstructionAddress();
+
+  fetchToDecodeBuffer_.fill({});
+  fetchToDecodeBuffer_.stall(false);
+
+  decodeToRenameBuffer_.fill(nullptr);
+  decodeToRenameBuffer_.stall(false);
+
+  renameToDispatchBuffer_.fill(nullptr);
+  renameToDispatchBuffer_.stall(false);
+
+  for (auto& issuePort : issuePorts_) issuePort.fill(nullptr);
+  for (auto& completionSlot : completionSlots_) completionSlot.fill(nullptr);
+
+  // Rewind the register mappings of every uncommitted instruction
+  reorderBuffer_.flush(head->getInstructionId() - 1);
+  decodeUnit_.purgeFlushed();
+  dispatchIssueUnit_.purgeFlushed();
+  loadStoreQueue_.purgeFlushed();
+  for (auto& eu : executionUnits_) {
+    eu.purgeFlushed();
+  }
+
+  fetchUnit_.flushLoopBuffer();
+  fetchUnit_.updatePC(pc);
+  hasHalted_ = true;
+  return pc;
+}
+
+void Core::skipHaltedTicks(uint64_t ticks) {
+  assert(hasHalted_ && "Skipped halted ticks of a running core");
+  skipTicks(ticks);
+  fetchUnit_.skipHaltedTicks(ticks);
+  loadStoreQueue_.skipHaltedTicks(ticks);
+}
+
+void Core::warmFetch(const memory::MemoryAccessTarget& target) {
+  fetchUnit_.warm(target);
+}
+
+void Core::warmData(uint64_t pc, const memory::MemoryAccessTarget& target,
+                    bool write) {
+  loadStoreQueue_.warm(pc, target, write);
+}
+
 const ArchitecturalRegisterFileSet& Core::getArchitecturalRegisterFileSet()
     const {
   return mappedRegisterFileSet_;
@@ -236,28 +465,61 @@ std::map<std::string, std::string> Core::getStats() const {
   std::ostringstream branchMissRateStr;
   branchMissRateStr << std::setprecision(3) << branchMissRate << "%";
 
-  return {{"cycles", std::to_string(ticks_)},
-          {"retired", std::to_string(retired)},
-          {"ipc", ipcStr.str()},
-          {"flushes", std::to_string(flushes_)},
-          {"fetch.branchStalls", std::to_string(branchStalls)},
-          {"decode.earlyFlushes", std::to_string(earlyFlushes)},
-          {"rename.allocationStalls", std::to_string(allocationStalls)},
-          {"rename.robStalls", std::to_string(robStalls)},
-          {"rename.lqStalls", std::to_string(lqStalls)},
-          {"rename.sqStalls", std::to_string(sqStalls)},
-          {"dispatch.rsStalls", std::to_string(rsStalls)},
-          {"issue.frontendStalls", std::to_string(frontendStalls)},
-          {"issue.backendStalls", std::to_string(backendStalls)},
-          {"issue.portBusyStalls", std::to_string(portBusyStalls)},
-          {"branch.executed", std::to_string(totalBranchesExecuted)},
-          {"branch.mispredict", std::to_string(totalBranchMispredicts)},
-          {"branch.missrate", branchMissRateStr.str()},
-          {"lsq.loadViolations",
-           std::to_string(reorderBuffer_.getViolatingLoadsCount())}};
+  std::map<std::string, std::string> stats = {
+      {"cycles", std::to_string(ticks_)},
+      {"retired", std::to_string(retired)},
+      {"ipc", ipcStr.str()},
+      {"flushes", std::to_string(flushes_)},
+      {"fetch.branchStalls", std::to_string(branchStalls)},
+      {"decode.earlyFlushes", std::to_string(earlyFlushes)},
+      {"rename.allocationStalls", std::to_string(allocationStalls)},
+      {"rename.robStalls", std::to_string(robStalls)},
+      {"rename.lqStalls", std::to_string(lqStalls)},
+      {"rename.sqStalls", std::to_string(sqStalls)},
+      {"dispatch.rsStalls", std::to_string(rsStalls)},
+      {"issue.frontendStalls", std::to_string(frontendStalls)},
+      {"issue.backendStalls", std::to_string(backendStalls)},
+      {"issue.portBusyStalls", std::to_string(portBusyStalls)},
+      {"branch.executed", std::to_string(totalBranchesExecuted)},
+      {"branch.mispredict", std::to_string(totalBranchMispredicts)},
+      {"branch.missrate", branchMissRateStr.str()},
+      {"lsq.loadViolations",
+       std::to_string(reorderBuffer_.getViolatingLoadsCount())}};
+
+  // Include the statistics of any modelled cache hierarchy; levels shared by
+  // the instruction and data sides report the same values through each
+  for (const auto& memory : {&instructionMemory_, &dataMemory_}) {
+    for (const auto& [key, value] : memory->getStats()) stats[key] = value;
+  }
+
+  // Include the statistics of any modelled TLBs, and the cycles fetch and the
+  // LSQ waited for them
+  if (instructionTlb_) {
+    instructionTlb_->getStats(stats);
+    stats["fetch.translationStalls"] =
+        std::to_string(fetchUnit_.getTranslationStalls());
+  }
+  if (dataTlb_) {
+    dataTlb_->getStats(stats);
+    stats["lsq.translationStalls"] =
+        std::to_string(loadStoreQueue_.getTranslationStalls());
+  }
+  if (l2Tlb_) l2Tlb_->getStats(stats);
+
+  if (microOpCache_) microOpCache_->getStats(stats);
+
+  if (fetchUnit_.isDecoupled()) {
+    stats["fetch.btbMisses"] = std::to_string(fetchUnit_.getBtbMisses());
+  }
+
+  if (storeSetPredictor_) {
+    stats["lsq.predictedDependences"] =
+        std::to_string(loadStoreQueue_.getPredictedDependences());
+  }
+  return stats;
 }
 
-void Core::raiseException(const std::shared_ptr<Instruction>& instruction) {
+void Core::raiseException(const IntrusivePtr<Instruction>& instruction) {
   exceptionGenerated_ = true;
   exceptionGeneratingInstruction_ = instruction;
 }
@@ -312,7 +574,11 @@ void Core::processExceptionHandler() {
   } else {
     fetchUnit_.flushLoopBuffer();
     fetchUnit_.updatePC(result.instructionAddress);
+    for (const auto& target : result.stateChange.memoryAddresses) {
+      isa_.recordStore(target);
+    }
     applyStateChange(result.stateChange);
+    if (result.threadExited || result.threadWaiting) hasHalted_ = true;
   }
 
   exceptionHandler_ = nullptr;
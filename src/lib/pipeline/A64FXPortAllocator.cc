@@ -193,5 +193,9 @@ void A64FXPortAllocator::tick() {
   dispatchSlot_ = 0;
 }
 
+void A64FXPortAllocator::skipTicks(uint64_t ticks) {
+  if (ticks > 0) tick();
+}
+
 }  // namespace pipeline
 }  // namespace simeng
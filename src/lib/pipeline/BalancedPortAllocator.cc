@@ -44,5 +44,7 @@ void BalancedPortAllocator::setRSSizeGetter(
 
 void BalancedPortAllocator::tick() {}
 
+void BalancedPortAllocator::skipTicks(uint64_t ticks) {}
+
 }  // namespace pipeline
 }  // namespace simeng
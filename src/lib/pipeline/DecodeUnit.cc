@@ -6,7 +6,7 @@ namespace simeng {
 namespace pipeline {
 
 DecodeUnit::DecodeUnit(PipelineBuffer<MacroOp>& input,
-                       PipelineBuffer<std::shared_ptr<Instruction>>& output,
+                       PipelineBuffer<IntrusivePtr<Instruction>>& output,
                        BranchPredictor& predictor)
     : input_(input), output_(output), predictor_(predictor){};
 
@@ -89,6 +89,10 @@ void DecodeUnit::tick() {
   }
 }
 
+bool DecodeUnit::isIdle() const {
+  return output_.isStalled() && input_.isStalled() && !shouldFlush_;
+}
+
 bool DecodeUnit::shouldFlush() const { return shouldFlush_; }
 uint64_t DecodeUnit::getFlushAddress() const { return pc_; }
 uint64_t DecodeUnit::getEarlyFlushes() const { return earlyFlushes_; };
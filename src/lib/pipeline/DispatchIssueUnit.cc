@@ -6,34 +6,47 @@
 namespace simeng {
 namespace pipeline {
 
+namespace {
+
+/** The number of 64-bit words needed to hold `bits` bits. */
+size_t wordsFor(size_t bits) { return (bits + 63) / 64; }
+
+}  // namespace
+
 DispatchIssueUnit::DispatchIssueUnit(
-    PipelineBuffer<std::shared_ptr<Instruction>>& fromRename,
-    std::vector<PipelineBuffer<std::shared_ptr<Instruction>>>& issuePorts,
+    PipelineBuffer<IntrusivePtr<Instruction>>& fromRename,
+    std::vector<PipelineBuffer<IntrusivePtr<Instruction>>>& issuePorts,
     const RegisterFileSet& registerFileSet, PortAllocator& portAllocator,
     const std::vector<uint16_t>& physicalRegisterStructure,
     ryml::ConstNodeRef config)
     : input_(fromRename),
       issuePorts_(issuePorts),
       registerFileSet_(registerFileSet),
-      scoreboard_(physicalRegisterStructure.size()),
-      dependencyMatrix_(physicalRegisterStructure.size()),
       portAllocator_(portAllocator) {
-  // Initialise scoreboard
+  // Initialise scoreboard, giving each register an index across all types
+  uint32_t registerCount = 0;
   for (size_t type = 0; type < physicalRegisterStructure.size(); type++) {
-    scoreboard_[type].assign(physicalRegisterStructure[type], true);
-    dependencyMatrix_[type].resize(physicalRegisterStructure[type]);
+    registerOffsets_.push_back(registerCount);
+    registerCount += physicalRegisterStructure[type];
   }
+  scoreboard_.assign(registerCount, true);
   // Create set of reservation station structs with correct issue port
   // mappings
+  uint32_t entryCount = 0;
   for (size_t i = 0; i < config["Reservation-Stations"].num_children(); i++) {
     // Iterate over each reservation station in config
     auto reservation_station = config["Reservation-Stations"][i];
-    // Create ReservationStation struct to be stored
+    uint16_t capacity = reservation_station["Size"].as<uint16_t>();
+    // Create ReservationStation struct to be stored, with its entries
+    // beginning on a new bitmask word
     ReservationStation rs = {
-        reservation_station["Size"].as<uint16_t>(),
+        capacity,
         reservation_station["Dispatch-Rate"].as<uint16_t>(),
         0,
-        {}};
+        {},
+        entryCount,
+        std::vector<uint64_t>(wordsFor(capacity), 0)};
+    entryCount += wordsFor(capacity) * 64;
     // Resize rs port attribute to match what's defined in config file
     rs.ports.resize(reservation_station["Port-Nums"].num_children());
     for (size_t j = 0; j < reservation_station["Port-Nums"].num_children();
@@ -41,6 +54,7 @@ DispatchIssueUnit::DispatchIssueUnit(
       // Iterate over issue ports in config
       uint16_t issue_port = reservation_station["Port-Nums"][j].as<uint16_t>();
       rs.ports[j].issuePort = issue_port;
+      rs.ports[j].ready.assign(wordsFor(capacity), 0);
       // Add port mapping entry, resizing vector if needed
       if ((issue_port + 1) > portMapping_.size()) {
         portMapping_.resize((issue_port + 1));
@@ -49,8 +63,9 @@ DispatchIssueUnit::DispatchIssueUnit(
     }
     reservationStations_.push_back(rs);
   }
-  for (uint16_t i = 0; i < reservationStations_.size(); i++)
-    flushed_.emplace(i, std::initializer_list<std::shared_ptr<Instruction>>{});
+  entries_.resize(entryCount);
+  matrixWidth_ = entryCount / 64;
+  dependencyMatrix_.assign(registerCount * matrixWidth_, 0);
 
   dispatches_ = std::make_unique<uint16_t[]>(reservationStations_.size());
 }
@@ -92,8 +107,18 @@ void DispatchIssueUnit::tick() {
       return;
     }
 
-    // Assume the uop will be ready
-    bool ready = true;
+    // Claim the first free entry of the reservation station
+    size_t word = 0;
+    while (rs.occupied[word] == ~0ull) word++;
+    uint16_t entrySlot = word * 64 + __builtin_ctzll(~rs.occupied[word]);
+    uint64_t entryBit = 1ull << (entrySlot % 64);
+    uint32_t entryIndex = rs.offset + entrySlot;
+    rs.occupied[word] |= entryBit;
+    ReservationStationEntry& entry = entries_[entryIndex];
+    entry.uop = uop;
+    entry.port = port;
+    entry.age = dispatched_++;
+    entry.pendingOperands.clear();
 
     // Register read
     // Identify remaining missing registers and supply values
@@ -103,14 +128,16 @@ void DispatchIssueUnit::tick() {
 
       if (!uop->isOperandReady(i)) {
         // The operand hasn't already been supplied
-        if (scoreboard_[reg.type][reg.tag]) {
+        size_t regIndex = registerIndex(reg);
+        if (scoreboard_[regIndex]) {
           // The scoreboard says it's ready; read and supply the register value
           uop->supplyOperand(i, registerFileSet_.get(reg));
         } else {
-          // This register isn't ready yet. Register this uop to the dependency
-          // matrix for a more efficient lookup later
-          dependencyMatrix_[reg.type][reg.tag].push_back({uop, port, i});
-          ready = false;
+          // This register isn't ready yet. Mark this entry as waiting on it in
+          // the dependency matrix
+          entry.pendingOperands.push_back({reg, i});
+          dependencyMatrix_[regIndex * matrixWidth_ + entryIndex / 64] |=
+              entryBit;
         }
       }
     }
@@ -118,15 +145,15 @@ void DispatchIssueUnit::tick() {
     // Set scoreboard for all destination registers as not ready
     auto& destinationRegisters = uop->getDestinationRegisters();
     for (const auto& reg : destinationRegisters) {
-      scoreboard_[reg.type][reg.tag] = false;
+      scoreboard_[registerIndex(reg)] = false;
     }
 
     // Increment dispatches made and RS occupied entries size
     dispatches_[RS_Index]++;
     rs.currentSize++;
 
-    if (ready) {
-      rs.ports[RS_Port].ready.push_back(std::move(uop));
+    if (entry.pendingOperands.empty()) {
+      rs.ports[RS_Port].ready[word] |= entryBit;
     }
 
     input_.getHeadSlots()[slot] = nullptr;
@@ -135,22 +162,25 @@ void DispatchIssueUnit::tick() {
 
 void DispatchIssueUnit::issue() {
   int issued = 0;
-  // Check the ready queues, and issue an instruction from each if the
-  // corresponding port isn't blocked
+  // Check the ready entries, and issue the oldest to each port that isn't
+  // blocked
   for (size_t i = 0; i < issuePorts_.size(); i++) {
     ReservationStation& rs = reservationStations_[portMapping_[i].first];
-    auto& queue = rs.ports[portMapping_[i].second].ready;
+    auto& ready = rs.ports[portMapping_[i].second].ready;
+    int32_t slot = selectOldest(rs, ready);
     if (issuePorts_[i].isStalled()) {
-      if (queue.size() > 0) {
+      if (slot >= 0) {
         portBusyStalls_++;
       }
       continue;
     }
 
-    if (queue.size() > 0) {
-      auto& uop = queue.front();
-      issuePorts_[i].getTailSlots()[0] = std::move(uop);
-      queue.pop_front();
+    if (slot >= 0) {
+      uint64_t bit = 1ull << (slot % 64);
+      ready[slot / 64] &= ~bit;
+      rs.occupied[slot / 64] &= ~bit;
+      auto& entry = entries_[rs.offset + slot];
+      issuePorts_[i].getTailSlots()[0] = std::move(entry.uop);
 
       // Inform the port allocator that an instruction issued
       portAllocator_.issued(i);
@@ -172,6 +202,35 @@ void DispatchIssueUnit::issue() {
   }
 }
 
+bool DispatchIssueUnit::isIdle() const {
+  if (input_.isStalled()) return false;
+  for (size_t slot = 0; slot < input_.getWidth(); slot++) {
+    if (input_.getHeadSlots()[slot] != nullptr ||
+        input_.getTailSlots()[slot] != nullptr)
+      return false;
+  }
+  for (const auto& rs : reservationStations_) {
+    for (const auto& port : rs.ports) {
+      for (uint64_t word : port.ready) {
+        if (word != 0) return false;
+      }
+    }
+  }
+  return true;
+}
+
+void DispatchIssueUnit::skipTicks(uint64_t ticks) {
+  assert(isIdle() && "Skipped a tick in which the dispatch unit was active");
+  // Nothing can issue, so each tick stalls on whatever waits in the RS
+  for (const auto& rs : reservationStations_) {
+    if (rs.currentSize != 0) {
+      backendStalls_ += ticks;
+      return;
+    }
+  }
+  frontendStalls_ += ticks;
+}
+
 void DispatchIssueUnit::forwardOperands(const span<Register>& registers,
                                         const span<RegisterValue>& values) {
   assert(registers.size() == values.size() &&
@@ -180,72 +239,98 @@ void DispatchIssueUnit::forwardOperands(const span<Register>& registers,
   for (size_t i = 0; i < registers.size(); i++) {
     const auto& reg = registers[i];
     // Flag scoreboard as ready now result is available
-    scoreboard_[reg.type][reg.tag] = true;
-
-    // Supply the value to all dependent uops
-    auto& dependents = dependencyMatrix_[reg.type][reg.tag];
-    for (auto& entry : dependents) {
-      entry.uop->supplyOperand(entry.operandIndex, values[i]);
-      if (entry.uop->canExecute()) {
-        // Add the now-ready instruction to the relevant ready queue
-        auto rsInfo = portMapping_[entry.port];
-        reservationStations_[rsInfo.first].ports[rsInfo.second].ready.push_back(
-            std::move(entry.uop));
+    size_t regIndex = registerIndex(reg);
+    scoreboard_[regIndex] = true;
+
+    // Supply the value to all dependent uops, clearing the register's row of
+    // the dependency matrix as they are visited
+    uint64_t* dependents = &dependencyMatrix_[regIndex * matrixWidth_];
+    for (size_t word = 0; word < matrixWidth_; word++) {
+      while (dependents[word] != 0) {
+        uint32_t index = word * 64 + __builtin_ctzll(dependents[word]);
+        dependents[word] &= dependents[word] - 1;
+
+        auto& entry = entries_[index];
+        auto& pending = entry.pendingOperands;
+        for (size_t j = 0; j < pending.size();) {
+          if (pending[j].first == reg) {
+            entry.uop->supplyOperand(pending[j].second, values[i]);
+            pending[j] = pending.back();
+            pending.pop_back();
+          } else {
+            j++;
+          }
+        }
+
+        if (pending.empty()) {
+          // Flag the now-ready instruction in the relevant ready mask
+          auto rsInfo = portMapping_[entry.port];
+          auto& rs = reservationStations_[rsInfo.first];
+          uint32_t slot = index - rs.offset;
+          rs.ports[rsInfo.second].ready[slot / 64] |= 1ull << (slot % 64);
+        }
       }
     }
-
-    // Clear the dependency list
-    dependencyMatrix_[reg.type][reg.tag].clear();
   }
 }
 
 void DispatchIssueUnit::purgeFlushed() {
-  for (size_t i = 0; i < reservationStations_.size(); i++) {
-    // Search the ready queues for flushed instructions and remove them
-    auto& rs = reservationStations_[i];
-    for (auto& port : rs.ports) {
-      // Ready queue
-      auto readyIter = port.ready.begin();
-      while (readyIter != port.ready.end()) {
-        auto& uop = *readyIter;
-        if (uop->isFlushed()) {
-          portAllocator_.deallocate(port.issuePort);
-          readyIter = port.ready.erase(readyIter);
-          assert(rs.currentSize > 0);
-          rs.currentSize--;
-        } else {
-          readyIter++;
-        }
+  // Flushed instructions may be waiting on operands or ready to issue, so
+  // check every occupied entry
+  for (auto& rs : reservationStations_) {
+    if (rs.currentSize == 0) continue;
+    for (size_t word = 0; word < rs.occupied.size(); word++) {
+      uint64_t occupied = rs.occupied[word];
+      while (occupied != 0) {
+        uint16_t slot = word * 64 + __builtin_ctzll(occupied);
+        occupied &= occupied - 1;
+        if (entries_[rs.offset + slot].uop->isFlushed()) squash(rs, slot);
       }
     }
   }
+}
 
-  // Collect flushed instructions and remove them from the dependency matrix
-  for (auto& it : flushed_) it.second.clear();
-  for (auto& registerType : dependencyMatrix_) {
-    for (auto& dependencyList : registerType) {
-      auto it = dependencyList.begin();
-      while (it != dependencyList.end()) {
-        auto& entry = *it;
-        if (entry.uop->isFlushed()) {
-          auto rsIndex = portMapping_[entry.port].first;
-          if (!flushed_[rsIndex].count(entry.uop)) {
-            flushed_[rsIndex].insert(entry.uop);
-            portAllocator_.deallocate(entry.port);
-          }
-          it = dependencyList.erase(it);
-        } else {
-          it++;
-        }
-      }
-    }
+void DispatchIssueUnit::squash(ReservationStation& rs, uint16_t slot) {
+  uint32_t index = rs.offset + slot;
+  uint64_t bit = 1ull << (slot % 64);
+  auto& entry = entries_[index];
+
+  // Remove the entry from the dependency matrix and ready masks
+  for (const auto& operand : entry.pendingOperands) {
+    dependencyMatrix_[registerIndex(operand.first) * matrixWidth_ +
+                      index / 64] &= ~bit;
   }
+  entry.pendingOperands.clear();
+  rs.ports[portMapping_[entry.port].second].ready[slot / 64] &= ~bit;
+  rs.occupied[slot / 64] &= ~bit;
+
+  portAllocator_.deallocate(entry.port);
+  entry.uop = nullptr;
+  assert(rs.currentSize > 0);
+  rs.currentSize--;
+}
 
-  // Update reservation station size
-  for (uint8_t i = 0; i < reservationStations_.size(); i++) {
-    assert(reservationStations_[i].currentSize >= flushed_[i].size());
-    reservationStations_[i].currentSize -= flushed_[i].size();
+size_t DispatchIssueUnit::registerIndex(const Register& reg) const {
+  return registerOffsets_[reg.type] + reg.tag;
+}
+
+int32_t DispatchIssueUnit::selectOldest(
+    const ReservationStation& rs, const std::vector<uint64_t>& ready) const {
+  int32_t oldest = -1;
+  uint64_t oldestAge = 0;
+  for (size_t word = 0; word < ready.size(); word++) {
+    uint64_t candidates = ready[word];
+    while (candidates != 0) {
+      int32_t slot = word * 64 + __builtin_ctzll(candidates);
+      candidates &= candidates - 1;
+      uint64_t age = entries_[rs.offset + slot].age;
+      if (oldest < 0 || age < oldestAge) {
+        oldest = slot;
+        oldestAge = age;
+      }
+    }
   }
+  return oldest;
 }
 
 uint64_t DispatchIssueUnit::getRSStalls() const { return rsStalls_; }
@@ -7,12 +7,12 @@ namespace simeng {
 namespace pipeline {
 
 ExecuteUnit::ExecuteUnit(
-    PipelineBuffer<std::shared_ptr<Instruction>>& input,
-    PipelineBuffer<std::shared_ptr<Instruction>>& output,
+    PipelineBuffer<IntrusivePtr<Instruction>>& input,
+    PipelineBuffer<IntrusivePtr<Instruction>>& output,
     std::function<void(span<Register>, span<RegisterValue>)> forwardOperands,
-    std::function<void(const std::shared_ptr<Instruction>&)> handleLoad,
-    std::function<void(const std::shared_ptr<Instruction>&)> handleStore,
-    std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
+    std::function<void(const IntrusivePtr<Instruction>&)> handleLoad,
+    std::function<void(const IntrusivePtr<Instruction>&)> handleStore,
+    std::function<void(const IntrusivePtr<Instruction>&)> raiseException,
     BranchPredictor& predictor, bool pipelined,
     const std::vector<uint16_t>& blockingGroups)
     : input_(input),
@@ -99,7 +99,18 @@ void ExecuteUnit::tick() {
   }
 }
 
-void ExecuteUnit::execute(std::shared_ptr<Instruction>& uop) {
+bool ExecuteUnit::isIdle() const {
+  return pipeline_.empty() && operationsStalled_.empty() && !shouldFlush_ &&
+         !input_.isStalled() && input_.getHeadSlots()[0] == nullptr &&
+         input_.getTailSlots()[0] == nullptr;
+}
+
+void ExecuteUnit::skipTicks(uint64_t ticks) {
+  assert(isIdle() && "Skipped a tick in which an execute unit was active");
+  tickCounter_ += ticks;
+}
+
+void ExecuteUnit::execute(IntrusivePtr<Instruction>& uop) {
   assert(uop->canExecute() &&
          "Attempted to execute an instruction before it was ready");
 
@@ -7,24 +7,51 @@ FetchUnit::FetchUnit(PipelineBuffer<MacroOp>& output,
                      memory::MemoryInterface& instructionMemory,
                      uint64_t programByteLength, uint64_t entryPoint,
                      uint16_t blockSize, const arch::Architecture& isa,
-                     BranchPredictor& branchPredictor)
+                     BranchPredictor& branchPredictor,
+                     memory::Tlb* instructionTlb,
+                     uint16_t targetQueueSize, uint16_t btbEntries,
+                     uint16_t targetsPerCycle, MicroOpCache* microOpCache)
     : output_(output),
       pc_(entryPoint),
       instructionMemory_(instructionMemory),
       programByteLength_(programByteLength),
       isa_(isa),
       branchPredictor_(branchPredictor),
+      instructionTlb_(instructionTlb),
       blockSize_(blockSize),
-      blockMask_(~(blockSize_ - 1)) {
+      blockMask_(~(blockSize_ - 1)),
+      targetsPerCycle_(targetsPerCycle),
+      bufferCapacity_(2 * blockSize_),
+      microOpCache_(microOpCache) {
   assert(blockSize_ >= isa_.getMaxInstructionSize() &&
          "fetch block size must be larger than the largest instruction");
-  fetchBuffer_ = new uint8_t[2 * blockSize_];
+  if (targetQueueSize > 0) {
+    assert(btbEntries > 0 && targetsPerCycle_ > 0 &&
+           "a decoupled fetch unit requires a BTB and fetch targets per cycle");
+    targetQueue_.resize(targetQueueSize);
+    btb_.resize(btbEntries);
+    // Each queued target covers at most two blocks
+    blocks_.resize(2 * targetQueueSize + 2);
+    blockData_.resize(blocks_.size() * blockSize_);
+    predictionPc_ = entryPoint;
+    // Hold a cycle's targets alongside the instructions left from the last
+    bufferCapacity_ = (targetsPerCycle_ + 1) *
+                      (blockSize_ + isa_.getMaxInstructionSize());
+  }
+  fetchBuffer_ = new uint8_t[bufferCapacity_];
   requestFromPC();
 }
 
 FetchUnit::~FetchUnit() { delete[] fetchBuffer_; }
 
 void FetchUnit::tick() {
+  tickCounter_++;
+
+  if (isDecoupled()) {
+    tickDecoupled();
+    return;
+  }
+
   if (output_.isStalled()) {
     return;
   }
@@ -35,23 +62,12 @@ void FetchUnit::tick() {
 
   // If loop buffer has been filled, fill buffer to decode
   if (loopBufferState_ == LoopBufferState::SUPPLYING) {
-    auto outputSlots = output_.getTailSlots();
-    for (size_t slot = 0; slot < output_.getWidth(); slot++) {
-      auto& macroOp = outputSlots[slot];
-      auto bytesRead = isa_.predecode(&(loopBuffer_.front().encoding),
-                                      loopBuffer_.front().instructionSize,
-                                      loopBuffer_.front().address, macroOp);
-      assert(bytesRead != 0 && "predecode failure for loop buffer entry");
-
-      // Set prediction to recorded value during loop buffer filling
-      if (macroOp[0]->isBranch()) {
-        macroOp[0]->setBranchPrediction(loopBuffer_.front().prediction);
-      }
+    supplyFromLoopBuffer();
+    return;
+  }
 
-      // Cycle queue by moving front entry to back
-      loopBuffer_.push_back(loopBuffer_.front());
-      loopBuffer_.pop_front();
-    }
+  // Supply cached instructions without waiting on instruction memory
+  if (canBypassMemory() && supplyFromMicroOpCache()) {
     return;
   }
 
@@ -121,7 +137,7 @@ void FetchUnit::tick() {
     auto& macroOp = outputSlots[slot];
 
     auto bytesRead =
-        isa_.predecode(buffer + bufferOffset, bufferedBytes_, pc_, macroOp);
+        predecode(buffer + bufferOffset, bufferedBytes_, pc_, macroOp);
 
     // If predecode fails, bail and wait for more data
     if (bytesRead == 0) {
@@ -139,34 +155,9 @@ void FetchUnit::tick() {
       macroOp[0]->setBranchPrediction(prediction);
     }
 
-    if (loopBufferState_ == LoopBufferState::FILLING) {
-      // Record instruction fetch information in loop body
-      uint32_t encoding;
-      memcpy(&encoding, buffer + bufferOffset, sizeof(uint32_t));
-      loopBuffer_.push_back(
-          {encoding, bytesRead, pc_, macroOp[0]->getBranchPrediction()});
-
-      if (pc_ == loopBoundaryAddress_) {
-        if (macroOp[0]->isBranch() &&
-            !macroOp[0]->getBranchPrediction().taken) {
-          // loopBoundaryAddress_ has been fetched whilst filling the loop
-          // buffer BUT this is a branch, predicted to branch out of the loop
-          // being buffered. Stop filling the loop buffer and don't supply to
-          // decode
-          loopBufferState_ = LoopBufferState::IDLE;
-        } else {
-          // loopBoundaryAddress_ has been fetched whilst filling the loop
-          // buffer. Stop filling as loop body has been recorded and begin to
-          // supply decode unit with instructions from the loop buffer
-          loopBufferState_ = LoopBufferState::SUPPLYING;
-          bufferedBytes_ = 0;
-          break;
-        }
-      }
-    } else if (loopBufferState_ == LoopBufferState::WAITING &&
-               pc_ == loopBoundaryAddress_) {
-      // Once set loopBoundaryAddress_ is fetched, start to fill loop buffer
-      loopBufferState_ = LoopBufferState::FILLING;
+    if (updateLoopBuffer(macroOp, buffer + bufferOffset, bytesRead)) {
+      bufferedBytes_ = 0;
+      break;
     }
 
     assert(bytesRead <= bufferedBytes_ &&
@@ -212,6 +203,472 @@ void FetchUnit::tick() {
   instructionMemory_.clearCompletedReads();
 }
 
+void FetchUnit::tickDecoupled() {
+  if (hasHalted_) return;
+
+  receiveBlocks();
+
+  if (!output_.isStalled() && !faultSupplied_) {
+    if (loopBufferState_ == LoopBufferState::SUPPLYING) {
+      supplyFromLoopBuffer();
+    } else {
+      fetchTargets();
+    }
+  }
+
+  // The prediction stage runs ahead regardless of whether fetch progressed
+  predictFetchTarget();
+}
+
+void FetchUnit::supplyFromLoopBuffer() {
+  auto outputSlots = output_.getTailSlots();
+  for (size_t slot = 0; slot < output_.getWidth(); slot++) {
+    auto& macroOp = outputSlots[slot];
+    auto bytesRead = predecode(&(loopBuffer_.front().encoding),
+                               loopBuffer_.front().instructionSize,
+                               loopBuffer_.front().address, macroOp);
+    assert(bytesRead != 0 && "predecode failure for loop buffer entry");
+
+    // Set prediction to recorded value during loop buffer filling
+    if (macroOp[0]->isBranch()) {
+      macroOp[0]->setBranchPrediction(loopBuffer_.front().prediction);
+    }
+
+    // Cycle queue by moving front entry to back
+    loopBuffer_.push_back(loopBuffer_.front());
+    loopBuffer_.pop_front();
+  }
+}
+
+bool FetchUnit::updateLoopBuffer(const MacroOp& macroOp,
+                                 const uint8_t* encoding, uint16_t bytesRead) {
+  if (loopBufferState_ == LoopBufferState::FILLING) {
+    // Record instruction fetch information in loop body
+    uint32_t instructionEncoding;
+    memcpy(&instructionEncoding, encoding, sizeof(uint32_t));
+    loopBuffer_.push_back({instructionEncoding, bytesRead, pc_,
+                           macroOp[0]->getBranchPrediction()});
+
+    if (pc_ == loopBoundaryAddress_) {
+      if (macroOp[0]->isBranch() && !macroOp[0]->getBranchPrediction().taken) {
+        // loopBoundaryAddress_ has been fetched whilst filling the loop
+        // buffer BUT this is a branch, predicted to branch out of the loop
+        // being buffered. Stop filling the loop buffer and don't supply to
+        // decode
+        loopBufferState_ = LoopBufferState::IDLE;
+      } else {
+        // loopBoundaryAddress_ has been fetched whilst filling the loop
+        // buffer. Stop filling as loop body has been recorded and begin to
+        // supply decode unit with instructions from the loop buffer
+        loopBufferState_ = LoopBufferState::SUPPLYING;
+        return true;
+      }
+    }
+  } else if (loopBufferState_ == LoopBufferState::WAITING &&
+             pc_ == loopBoundaryAddress_) {
+    // Once set loopBoundaryAddress_ is fetched, start to fill loop buffer
+    loopBufferState_ = LoopBufferState::FILLING;
+  }
+  return false;
+}
+
+uint8_t FetchUnit::predecode(const void* ptr, uint16_t bytesAvailable,
+                             uint64_t address, MacroOp& output) {
+  if (microOpCache_ == nullptr) {
+    return isa_.predecode(ptr, bytesAvailable, address, output);
+  }
+
+  uint8_t bytesRead = microOpCache_->supply(address, bytesAvailable, output);
+  if (bytesRead == 0) {
+    bytesRead = isa_.predecode(ptr, bytesAvailable, address, output);
+    // Cache the micro-ops before any are given a branch prediction
+    if (bytesRead != 0) microOpCache_->fill(address, output, bytesRead);
+  }
+  return bytesRead;
+}
+
+bool FetchUnit::supplyFromMicroOpCache() {
+  // Memory is only bypassed while the loop buffer is idle, in which state it
+  // records nothing, so the instructions supplied need not pass through
+  // updateLoopBuffer. Once a loop boundary is registered, fetch reads memory
+  // again so that the loop buffer can record their encodings
+  assert(loopBufferState_ == LoopBufferState::IDLE &&
+         "micro-op cache bypass whilst the loop buffer is active");
+  auto outputSlots = output_.getTailSlots();
+  size_t width =
+      std::min<size_t>(output_.getWidth(), microOpCache_->getWidth());
+  size_t slot = 0;
+  while (slot < width) {
+    // Stop at the first uncached instruction without counting a miss, as it
+    // is looked up again when pre-decoded from memory
+    if (!microOpCache_->contains(pc_)) break;
+    auto& macroOp = outputSlots[slot];
+    auto bytesRead = microOpCache_->supply(pc_, UINT16_MAX, macroOp);
+    slot++;
+
+    BranchPrediction prediction = {false, 0};
+    if (macroOp[0]->isBranch()) {
+      prediction = branchPredictor_.predict(pc_, macroOp[0]->getBranchType(),
+                                            macroOp[0]->getKnownOffset());
+      macroOp[0]->setBranchPrediction(prediction);
+    }
+
+    if (!prediction.taken) {
+      pc_ += bytesRead;
+    } else {
+      pc_ = prediction.target;
+    }
+
+    if (pc_ >= programByteLength_) {
+      hasHalted_ = true;
+      break;
+    }
+
+    if (prediction.taken) {
+      if (slot < output_.getWidth()) {
+        branchStalls_++;
+      }
+      break;
+    }
+  }
+
+  if (slot == 0) return false;
+
+  // Any blocks read are no longer needed
+  instructionMemory_.clearCompletedReads();
+  return true;
+}
+
+bool FetchUnit::canBypassMemory() const {
+  // The loop buffer records the encodings of the instructions it will supply,
+  // so memory is read whilst it awaits or records a loop
+  return microOpCache_ != nullptr && !isDecoupled() && bufferedBytes_ == 0 &&
+         loopBufferState_ == LoopBufferState::IDLE &&
+         microOpCache_->contains(pc_);
+}
+
+void FetchUnit::fetchTargets() {
+  // Append the instructions of the targets whose blocks have arrived
+  for (uint16_t i = 0; i < targetsPerCycle_ && targetCount_ > 0; i++) {
+    const auto& target = queuedTarget(0);
+    if (fetchFaulted_ || !isTargetReady(target) ||
+        bufferedBytes_ + (target.end - target.start) > bufferCapacity_) {
+      break;
+    }
+    loadTarget();
+  }
+
+  if (bufferedBytes_ < isa_.getMinInstructionSize()) {
+    if (fetchFaulted_) supplyFetchFault(output_.getTailSlots()[0]);
+    return;
+  }
+
+  uint16_t bufferOffset = 0;
+  auto outputSlots = output_.getTailSlots();
+  for (size_t slot = 0; slot < output_.getWidth(); slot++) {
+    auto& macroOp = outputSlots[slot];
+
+    auto bytesRead =
+        predecode(fetchBuffer_ + bufferOffset, bufferedBytes_, pc_, macroOp);
+
+    // If predecode fails, wait for the next target to complete the instruction
+    if (bytesRead == 0) {
+      assert(bufferedBytes_ < isa_.getMaxInstructionSize() &&
+             "unexpected predecode failure");
+      // The rest of the instruction could not be read
+      if (fetchFaulted_) supplyFetchFault(macroOp);
+      break;
+    }
+
+    // Take the prediction made by the prediction stage. A branch it did not
+    // identify, or an identified branch which is not one, means the targets
+    // which followed were predicted down the wrong path
+    bool isBranch = macroOp[0]->isBranch();
+    bool identified = !bufferedPredictions_.empty() &&
+                      bufferedPredictions_.front().first == pc_;
+    bool resteer = isBranch != identified;
+    BranchPrediction prediction = {false, 0};
+    if (resteer) {
+      discardTargets();
+      BtbEntry& entry = btbEntry(pc_);
+      if (isBranch) {
+        btbMisses_++;
+        entry = {pc_, macroOp[0]->getBranchType(),
+                 macroOp[0]->getKnownOffset(), bytesRead};
+        prediction = branchPredictor_.predict(pc_, macroOp[0]->getBranchType(),
+                                              macroOp[0]->getKnownOffset());
+      } else {
+        entry.address = ~0ull;
+      }
+    } else if (isBranch) {
+      prediction = bufferedPredictions_.front().second;
+      bufferedPredictions_.pop_front();
+    }
+    if (isBranch) {
+      macroOp[0]->setBranchPrediction(prediction);
+    }
+
+    if (updateLoopBuffer(macroOp, fetchBuffer_ + bufferOffset, bytesRead)) {
+      // Predictions are not needed while the loop buffer supplies
+      discardTargets();
+      predicting_ = false;
+      bufferedBytes_ = 0;
+      break;
+    }
+
+    assert(bytesRead <= bufferedBytes_ &&
+           "Predecode consumed more bytes than were available");
+
+    bufferOffset += bytesRead;
+    bufferedBytes_ -= bytesRead;
+
+    if (!prediction.taken) {
+      pc_ += bytesRead;
+    } else {
+      pc_ = prediction.target;
+    }
+
+    if (pc_ >= programByteLength_) {
+      hasHalted_ = true;
+      break;
+    }
+
+    if (resteer) {
+      // Restart prediction after the corrected instruction; the data buffered
+      // after it is from the wrong path
+      predictionPc_ = pc_;
+      bufferedBytes_ = 0;
+      break;
+    }
+
+    if (bufferedBytes_ == 0) {
+      break;
+    }
+  }
+
+  if (bufferedBytes_ > 0) {
+    std::memmove(fetchBuffer_, fetchBuffer_ + bufferOffset, bufferedBytes_);
+  }
+}
+
+void FetchUnit::supplyFetchFault(MacroOp& output) {
+  isa_.predecodeFault(pc_, output);
+  bufferedBytes_ = 0;
+  fetchFaulted_ = false;
+  faultSupplied_ = true;
+}
+
+void FetchUnit::predictFetchTarget() {
+  if (!predicting_ || targetCount_ == targetQueue_.size() ||
+      predictionPc_ >= programByteLength_) {
+    return;
+  }
+
+  FetchTarget& target = queuedTarget(targetCount_);
+  target.start = predictionPc_;
+  target.requested = false;
+  target.predictions.clear();
+
+  // Predict each branch the BTB identifies in the rest of the block, ending
+  // the target after the first predicted taken
+  uint64_t blockEnd = (predictionPc_ & blockMask_) + blockSize_;
+  target.end = blockEnd;
+  predictionPc_ = blockEnd;
+  uint16_t step = isa_.getMinInstructionSize();
+  for (uint64_t address = target.start; address < blockEnd; address += step) {
+    const BtbEntry& entry = btbEntry(address);
+    if (entry.address != address) continue;
+
+    auto prediction =
+        branchPredictor_.predict(address, entry.type, entry.knownOffset);
+    target.predictions.push_back({address, prediction});
+    if (prediction.taken) {
+      target.end = address + entry.size;
+      predictionPc_ = prediction.target;
+      break;
+    }
+    address += entry.size - step;
+  }
+  targetCount_++;
+}
+
+void FetchUnit::prefetchTargets() {
+  uint16_t requests = 0;
+  for (size_t i = 0; i < targetCount_; i++) {
+    FetchTarget& target = queuedTarget(i);
+    if (target.requested) continue;
+
+    for (uint64_t address = target.start & blockMask_; address < target.end;
+         address += blockSize_) {
+      int index = findBlock(address);
+      if (index < 0) {
+        // Replace the least recently used block no queued target covers
+        for (size_t slot = 0; slot < blocks_.size(); slot++) {
+          bool covered = false;
+          for (size_t j = 0; j < targetCount_ && !covered; j++) {
+            const auto& queued = queuedTarget(j);
+            covered = blocks_[slot].address + blockSize_ > queued.start &&
+                      blocks_[slot].address < queued.end;
+          }
+          if (!covered &&
+              (index < 0 || blocks_[slot].lastUsed < blocks_[index].lastUsed)) {
+            index = slot;
+          }
+        }
+        assert(index >= 0 && "no fetch block available to replace");
+        blocks_[index] = {address, false, false, false, 0, tickCounter_};
+      }
+
+      FetchBlock& block = blocks_[index];
+      block.lastUsed = tickCounter_;
+      if (block.requested) continue;
+
+      // Hold the request, and those after it, back until the block's
+      // translation is available
+      if (instructionTlb_) {
+        if (block.translationReadyAt == 0) {
+          block.translationReadyAt =
+              instructionTlb_->translate(address, tickCounter_);
+        }
+        if (block.translationReadyAt > tickCounter_) {
+          translationStalls_++;
+          return;
+        }
+      }
+
+      if (requests == targetsPerCycle_) return;
+      instructionMemory_.requestRead({address, blockSize_});
+      block.requested = true;
+      requests++;
+    }
+    target.requested = true;
+  }
+}
+
+void FetchUnit::receiveBlocks() {
+  const auto& fetched = instructionMemory_.getCompletedReads();
+  for (const auto& read : fetched) {
+    int index = findBlock(read.target.address);
+    // Ignore reads of blocks since replaced, or already received
+    if (index < 0 || blocks_[index].ready) continue;
+
+    // A block which can't be read is held as faulted; only if fetch reaches
+    // it on the correct path is the fault raised
+    blocks_[index].ready = true;
+    if (!read.data) {
+      blocks_[index].faulted = true;
+      continue;
+    }
+    std::memcpy(blockData_.data() + index * blockSize_,
+                read.data.getAsVector<uint8_t>(), blockSize_);
+  }
+  instructionMemory_.clearCompletedReads();
+}
+
+bool FetchUnit::isTargetReady(const FetchTarget& target) const {
+  for (uint64_t address = target.start & blockMask_; address < target.end;
+       address += blockSize_) {
+    int index = findBlock(address);
+    if (index < 0 || !blocks_[index].ready) return false;
+  }
+  return true;
+}
+
+void FetchUnit::loadTarget() {
+  FetchTarget& target = queuedTarget(0);
+  for (uint64_t address = target.start; address < target.end;) {
+    uint64_t blockAddress = address & blockMask_;
+    uint64_t end = std::min(blockAddress + blockSize_, target.end);
+    int index = findBlock(blockAddress);
+    blocks_[index].lastUsed = tickCounter_;
+    // Instructions can't be fetched beyond a block which could not be read
+    if (blocks_[index].faulted) {
+      fetchFaulted_ = true;
+      break;
+    }
+    std::memcpy(fetchBuffer_ + bufferedBytes_,
+                blockData_.data() + index * blockSize_ +
+                    (address - blockAddress),
+                end - address);
+    bufferedBytes_ += end - address;
+    address = end;
+  }
+
+  bufferedPredictions_.insert(bufferedPredictions_.end(),
+                              target.predictions.begin(),
+                              target.predictions.end());
+  targetHead_ = (targetHead_ + 1) % targetQueue_.size();
+  targetCount_--;
+}
+
+void FetchUnit::discardTargets() {
+  // Flush the predictions youngest first, so the predictor can rewind them
+  for (size_t i = targetCount_; i > 0; i--) {
+    const auto& predictions = queuedTarget(i - 1).predictions;
+    for (auto it = predictions.rbegin(); it != predictions.rend(); it++) {
+      branchPredictor_.flush(it->first);
+    }
+  }
+  for (auto it = bufferedPredictions_.rbegin();
+       it != bufferedPredictions_.rend(); it++) {
+    branchPredictor_.flush(it->first);
+  }
+  targetCount_ = 0;
+  bufferedPredictions_.clear();
+  fetchFaulted_ = false;
+}
+
+int FetchUnit::findBlock(uint64_t address) const {
+  for (size_t slot = 0; slot < blocks_.size(); slot++) {
+    if (blocks_[slot].address == address) return slot;
+  }
+  return -1;
+}
+
+FetchUnit::BtbEntry& FetchUnit::btbEntry(uint64_t address) {
+  return btb_[(address / isa_.getMinInstructionSize()) % btb_.size()];
+}
+
+FetchUnit::FetchTarget& FetchUnit::queuedTarget(size_t index) {
+  return targetQueue_[(targetHead_ + index) % targetQueue_.size()];
+}
+
+const FetchUnit::FetchTarget& FetchUnit::queuedTarget(size_t index) const {
+  return targetQueue_[(targetHead_ + index) % targetQueue_.size()];
+}
+
+bool FetchUnit::isIdle() const {
+  if (hasHalted_) return true;
+  if (!output_.isStalled()) return false;
+  if (loopBufferState_ == LoopBufferState::SUPPLYING) return true;
+  if (!isDecoupled()) {
+    return bufferedBytes_ >= isa_.getMaxInstructionSize() || canBypassMemory();
+  }
+
+  // The prediction stage must also be unable to add a target, and every
+  // queued target's blocks must have been requested
+  if (predicting_ && targetCount_ < targetQueue_.size() &&
+      predictionPc_ < programByteLength_) {
+    return false;
+  }
+  for (size_t i = 0; i < targetCount_; i++) {
+    if (!queuedTarget(i).requested) return false;
+  }
+  return true;
+}
+
+void FetchUnit::skipTicks(uint64_t ticks) {
+  assert(isIdle() && "Skipped a tick in which the fetch unit was active");
+  tickCounter_ += ticks;
+}
+
+void FetchUnit::skipHaltedTicks(uint64_t ticks) { tickCounter_ += ticks; }
+
+void FetchUnit::warm(const memory::MemoryAccessTarget& target) {
+  if (instructionTlb_) instructionTlb_->warm(target.address, tickCounter_);
+  instructionMemory_.warm(target.address, target, false);
+}
+
 void FetchUnit::registerLoopBoundary(uint64_t branchAddress) {
   // Set branch which forms the loop as the loopBoundaryAddress_ and place loop
   // buffer in state to begin filling once the loopBoundaryAddress_ has been
@@ -226,19 +683,42 @@ void FetchUnit::updatePC(uint64_t address) {
   pc_ = address;
   bufferedBytes_ = 0;
   hasHalted_ = (pc_ >= programByteLength_);
+  // Any translation in progress was for the previous fetch stream
+  translationReadyAt_ = 0;
+
+  if (isDecoupled()) {
+    // The predictions not yet fetched are younger than any in the pipeline
+    discardTargets();
+    predictionPc_ = address;
+    predicting_ = true;
+    // Read faulted blocks afresh, should fetch return to them
+    faultSupplied_ = false;
+    for (auto& block : blocks_) {
+      if (block.faulted) block = {};
+    }
+  }
 }
 
 void FetchUnit::requestFromPC() {
   // Do nothing if supplying fetch stream from loop buffer
   if (loopBufferState_ == LoopBufferState::SUPPLYING) return;
 
-  // Do nothing if buffer already contains enough data
-  if (bufferedBytes_ >= isa_.getMaxInstructionSize()) return;
-
   // Do nothing if unit has halted to avoid invalid speculative memory reads
   // beyond the programByteLength_
   if (hasHalted_) return;
 
+  if (isDecoupled()) {
+    prefetchTargets();
+    return;
+  }
+
+  // Do nothing if buffer already contains enough data
+  if (bufferedBytes_ >= isa_.getMaxInstructionSize()) return;
+
+  // Do nothing if the next instructions will be supplied from the micro-op
+  // cache
+  if (canBypassMemory()) return;
+
   uint64_t blockAddress;
   if (bufferedBytes_ > 0) {
     // There's already some data in the buffer, so fetch the next block
@@ -249,11 +729,30 @@ void FetchUnit::requestFromPC() {
     blockAddress = pc_ & blockMask_;
   }
 
+  // Hold the request back until the block's translation is available
+  if (instructionTlb_) {
+    if (translationReadyAt_ == 0) {
+      translationReadyAt_ =
+          instructionTlb_->translate(blockAddress, tickCounter_);
+    }
+    if (translationReadyAt_ > tickCounter_) {
+      translationStalls_++;
+      return;
+    }
+    translationReadyAt_ = 0;
+  }
+
   instructionMemory_.requestRead({blockAddress, blockSize_});
 }
 
 uint64_t FetchUnit::getBranchStalls() const { return branchStalls_; }
 
+uint64_t FetchUnit::getTranslationStalls() const { return translationStalls_; }
+
+uint64_t FetchUnit::getBtbMisses() const { return btbMisses_; }
+
+bool FetchUnit::isDecoupled() const { return !targetQueue_.empty(); }
+
 void FetchUnit::flushLoopBuffer() {
   loopBuffer_.clear();
   loopBufferState_ = LoopBufferState::IDLE;
@@ -1,10 +1,10 @@
 #include "simeng/pipeline/LoadStoreQueue.hh"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstring>
 #include <iostream>
-#include <list>
 
 namespace simeng {
 namespace pipeline {
@@ -17,14 +17,32 @@ bool requestsOverlap(memory::MemoryAccessTarget a,
   return !(a.address + a.size <= b.address || b.address + b.size <= a.address);
 }
 
+/** The size of the aligned blocks of addresses stores are indexed by. */
+const uint64_t storeIndexBlockSize = 64;
+
+/** The source of bytes which aren't forwarded from a store. */
+const uint64_t memorySource = UINT64_MAX;
+
+/** Call `func` with each aligned index block `target` touches. */
+template <typename F>
+void forEachIndexBlock(const memory::MemoryAccessTarget& target, F func) {
+  uint64_t last = (target.address + std::max<uint16_t>(target.size, 1) - 1) /
+                  storeIndexBlockSize;
+  for (uint64_t block = target.address / storeIndexBlockSize; block <= last;
+       block++) {
+    func(block);
+  }
+}
+
 LoadStoreQueue::LoadStoreQueue(
     unsigned int maxCombinedSpace, memory::MemoryInterface& memory,
-    span<PipelineBuffer<std::shared_ptr<Instruction>>> completionSlots,
+    span<PipelineBuffer<IntrusivePtr<Instruction>>> completionSlots,
     std::function<void(span<Register>, span<RegisterValue>)> forwardOperands,
-    std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
+    std::function<void(const IntrusivePtr<Instruction>&)> raiseException,
     bool exclusive, uint16_t loadBandwidth, uint16_t storeBandwidth,
     uint16_t permittedRequests, uint16_t permittedLoads,
-    uint16_t permittedStores)
+    uint16_t permittedStores, memory::Tlb* dataTlb,
+    StoreSetPredictor* storeSetPredictor, const arch::Architecture* isa)
     : completionSlots_(completionSlots),
       forwardOperands_(forwardOperands),
       raiseException_(raiseException),
@@ -36,17 +54,21 @@ LoadStoreQueue::LoadStoreQueue(
       storeBandwidth_(storeBandwidth),
       totalLimit_(permittedRequests),
       // Set per-cycle limits for each request type
-      reqLimits_{permittedLoads, permittedStores} {};
+      reqLimits_{permittedLoads, permittedStores},
+      dataTlb_(dataTlb),
+      storeSetPredictor_(storeSetPredictor),
+      isa_(isa){};
 
 LoadStoreQueue::LoadStoreQueue(
     unsigned int maxLoadQueueSpace, unsigned int maxStoreQueueSpace,
     memory::MemoryInterface& memory,
-    span<PipelineBuffer<std::shared_ptr<Instruction>>> completionSlots,
+    span<PipelineBuffer<IntrusivePtr<Instruction>>> completionSlots,
     std::function<void(span<Register>, span<RegisterValue>)> forwardOperands,
-    std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
+    std::function<void(const IntrusivePtr<Instruction>&)> raiseException,
     bool exclusive, uint16_t loadBandwidth, uint16_t storeBandwidth,
     uint16_t permittedRequests, uint16_t permittedLoads,
-    uint16_t permittedStores)
+    uint16_t permittedStores, memory::Tlb* dataTlb,
+    StoreSetPredictor* storeSetPredictor, const arch::Architecture* isa)
     : completionSlots_(completionSlots),
       forwardOperands_(forwardOperands),
       raiseException_(raiseException),
@@ -59,7 +81,10 @@ LoadStoreQueue::LoadStoreQueue(
       storeBandwidth_(storeBandwidth),
       totalLimit_(permittedRequests),
       // Set per-cycle limits for each request type
-      reqLimits_{permittedLoads, permittedStores} {};
+      reqLimits_{permittedLoads, permittedStores},
+      dataTlb_(dataTlb),
+      storeSetPredictor_(storeSetPredictor),
+      isa_(isa){};
 
 unsigned int LoadStoreQueue::getLoadQueueSpace() const {
   if (combined_) {
@@ -93,14 +118,18 @@ unsigned int LoadStoreQueue::getCombinedSpace() const {
   return maxCombinedSpace_ - loadQueue_.size() - storeQueue_.size();
 }
 
-void LoadStoreQueue::addLoad(const std::shared_ptr<Instruction>& insn) {
+void LoadStoreQueue::addLoad(const IntrusivePtr<Instruction>& insn) {
   loadQueue_.push_back(insn);
 }
-void LoadStoreQueue::addStore(const std::shared_ptr<Instruction>& insn) {
+void LoadStoreQueue::addStore(const IntrusivePtr<Instruction>& insn) {
   storeQueue_.push_back({insn, {}});
+  if (storeSetPredictor_) {
+    storeSetPredictor_->addStore(insn->getInstructionAddress(),
+                                 insn->getSequenceId());
+  }
 }
 
-void LoadStoreQueue::startLoad(const std::shared_ptr<Instruction>& insn) {
+void LoadStoreQueue::startLoad(const IntrusivePtr<Instruction>& insn) {
   const auto& ld_addresses = insn->getGeneratedAddresses();
   if (ld_addresses.size() == 0) {
     // Early execution if not addresses need to be accessed
@@ -114,65 +143,140 @@ void LoadStoreQueue::startLoad(const std::shared_ptr<Instruction>& insn) {
 
     completedLoads_.push(insn);
   } else {
+    // Hold back a load predicted to depend on an older store until the store
+    // has generated its addresses
+    if (storeSetPredictor_) {
+      uint64_t storeSeqId =
+          storeSetPredictor_->predictDependence(insn->getInstructionAddress());
+      auto store = storeSeqId < insn->getSequenceId() ? findStore(storeSeqId)
+                                                      : nullptr;
+      if (store && !store->started) {
+        store->deferredLoads.push_back(insn);
+        predictedDependences_++;
+        return;
+      }
+    }
+
     // Create a speculative entry for the load
-    requestLoadQueue_[tickCounter_ + insn->getLSQLatency()].push_back(
-        {{}, insn});
-    // Store a reference to the reqAddresses queue for easy access
-    auto& reqAddrQueue = requestLoadQueue_[tickCounter_ + insn->getLSQLatency()]
-                             .back()
-                             .reqAddresses;
-    // Store load addresses temporarily so that conflictions are
-    // only registered once on most recent (program order) store
-    std::list<simeng::memory::MemoryAccessTarget> temp_load_addr(
-        ld_addresses.begin(), ld_addresses.end());
-
-    // Detect reordering conflicts
-    if (storeQueue_.size() > 0) {
-      uint64_t seqId = insn->getSequenceId();
-      for (auto itSt = storeQueue_.rbegin(); itSt != storeQueue_.rend();
-           itSt++) {
-        const auto& store = itSt->first;
-        // If entry is earlier in the program order than load, detect conflicts
-        if (store->getSequenceId() < seqId) {
-          const auto& str_addresses = store->getGeneratedAddresses();
-          // Iterate over possible matches between store and load addresses
-          for (const auto& str : str_addresses) {
-            auto itLd = temp_load_addr.begin();
-            while (itLd != temp_load_addr.end()) {
-              // If conflict exists, register in conflictionMap_ and delay
-              // load request(s) until conflicting store retires
-              if (itLd->address == str.address) {
-                // Load access size must be no larger than the store access size
-                // to ensure all data is encapsulated in the later forwarding
-                if (itLd->size <= str.size) {
-                  conflictionMap_[store->getSequenceId()][str.address]
-                      .push_back({insn, itLd->size});
-                } else {
-                  // To ensure load doesn't match on an earlier store, generate
-                  // load request for address
-                  reqAddrQueue.push(*itLd);
-                }
-                // Remove from temporary vector so the confliction can't be
-                // registered again
-                itLd = temp_load_addr.erase(itLd);
-              } else {
-                itLd++;
-              }
-            }
-          }
-        }
+    auto& reqAddresses =
+        requestLoadQueue_.insert(tickCounter_ + insn->getLSQLatency(), insn)
+            .reqAddresses;
+    // Forward the bytes written by older stores, and request any other bytes
+    // from memory
+    for (const auto& target : ld_addresses) {
+      auto entry = forwardFromStores(insn, target);
+      if (entry == nullptr || entry->awaitingMemory) {
+        reqAddresses.push_back(target);
       }
     }
-    // If addresses remain that had no conflictions, generate those load
-    // request(s)
-    for (const auto& ld_addr : temp_load_addr) reqAddrQueue.emplace(ld_addr);
 
     // Register active load
     requestedLoads_.emplace(insn->getSequenceId(), insn);
   }
 }
 
-void LoadStoreQueue::supplyStoreData(const std::shared_ptr<Instruction>& insn) {
+void LoadStoreQueue::startStore(const IntrusivePtr<Instruction>& insn) {
+  if (!insn->isStoreAddress()) return;
+  // Only index stores still in the store queue, once
+  uint64_t seqId = insn->getSequenceId();
+  auto store = findStore(seqId);
+  if (store == nullptr || store->insn != insn || store->started) return;
+  store->started = true;
+
+  // Younger loads read an exclusive write's memory instead, and are replayed
+  // by the commit-time violation check should it be written
+  if (!writesExclusively(*insn)) {
+    for (const auto& target : insn->getGeneratedAddresses()) {
+      forEachIndexBlock(target, [&](uint64_t block) {
+        auto& stores = storeIndex_[block];
+        if (stores.empty() || stores.back() != insn) stores.push_back(insn);
+      });
+    }
+  }
+
+  if (storeSetPredictor_) {
+    storeSetPredictor_->storeIssued(insn->getInstructionAddress(), seqId);
+  }
+
+  // Start the loads waiting for this store, which may now forward from it
+  auto loads = std::move(store->deferredLoads);
+  store->deferredLoads.clear();
+  for (const auto& load : loads) startLoad(load);
+}
+
+storeQueueEntry* LoadStoreQueue::findStore(uint64_t seqId) {
+  auto itSt = std::lower_bound(storeQueue_.begin(), storeQueue_.end(), seqId,
+                               [](const auto& entry, uint64_t seqId) {
+                                 return entry.insn->getSequenceId() < seqId;
+                               });
+  if (itSt == storeQueue_.end() || itSt->insn->getSequenceId() != seqId) {
+    return nullptr;
+  }
+  return &*itSt;
+}
+
+std::shared_ptr<forwardingEntry> LoadStoreQueue::forwardFromStores(
+    const IntrusivePtr<Instruction>& load,
+    const memory::MemoryAccessTarget& target) {
+  uint64_t seqId = load->getSequenceId();
+
+  // Gather the older stores writing to the blocks the access touches
+  std::vector<IntrusivePtr<Instruction>> stores;
+  forEachIndexBlock(target, [&](uint64_t block) {
+    const auto& itBlock = storeIndex_.find(block);
+    if (itBlock == storeIndex_.end()) return;
+    for (const auto& store : itBlock->second) {
+      if (store->getSequenceId() < seqId) stores.push_back(store);
+    }
+  });
+  if (stores.empty()) return nullptr;
+
+  // Visit the youngest stores first, so each byte is taken from the most
+  // recent store to write to it
+  std::sort(stores.begin(), stores.end(), [](const auto& a, const auto& b) {
+    return a->getSequenceId() > b->getSequenceId();
+  });
+  stores.erase(std::unique(stores.begin(), stores.end()), stores.end());
+
+  auto entry = std::make_shared<forwardingEntry>();
+  entry->load = load;
+  entry->target = target;
+  entry->sources.assign(target.size, memorySource);
+  entry->data.assign(target.size, 0);
+  uint16_t unassigned = target.size;
+  for (const auto& store : stores) {
+    uint64_t storeSeqId = store->getSequenceId();
+    bool supplies = false;
+    for (const auto& str : store->getGeneratedAddresses()) {
+      uint64_t begin = std::max(str.address, target.address);
+      uint64_t end =
+          std::min(str.address + str.size, target.address + target.size);
+      for (uint64_t address = begin; address < end; address++) {
+        auto& source = entry->sources[address - target.address];
+        if (source != memorySource) continue;
+        source = storeSeqId;
+        unassigned--;
+        supplies = true;
+      }
+    }
+    if (supplies) {
+      findStore(storeSeqId)->conflictions.push_back(entry);
+      entry->pendingSources++;
+    }
+    if (unassigned == 0) break;
+  }
+  if (entry->pendingSources == 0) return nullptr;
+
+  // Read the bytes no store writes to from memory
+  if (unassigned > 0) {
+    entry->awaitingMemory = true;
+    entry->pendingSources++;
+  }
+  forwardedLoads_[seqId].push_back(entry);
+  return entry;
+}
+
+void LoadStoreQueue::supplyStoreData(const IntrusivePtr<Instruction>& insn) {
   if (!insn->isStoreData()) return;
   // Get identifier values
   const uint64_t macroOpNum = insn->getInstructionId();
@@ -184,13 +288,13 @@ void LoadStoreQueue::supplyStoreData(const std::shared_ptr<Instruction>& insn) {
   // Find storeQueue_ entry which is linked to the store data operation
   auto itSt = storeQueue_.begin();
   while (itSt != storeQueue_.end()) {
-    auto& entry = itSt->first;
+    auto& entry = itSt->insn;
     // Pair entry and incoming store data operation with macroOp identifier and
     // microOp index value pre-determined in microDecoder
     if (entry->getInstructionId() == macroOpNum &&
         entry->getMicroOpIndex() == microOpNum) {
       // Supply data to be stored by operations
-      itSt->second = data;
+      itSt->data = data;
       break;
     } else {
       itSt++;
@@ -198,15 +302,19 @@ void LoadStoreQueue::supplyStoreData(const std::shared_ptr<Instruction>& insn) {
   }
 }
 
-bool LoadStoreQueue::commitStore(const std::shared_ptr<Instruction>& uop) {
+bool LoadStoreQueue::commitStore(const IntrusivePtr<Instruction>& uop) {
   assert(storeQueue_.size() > 0 &&
          "Attempted to commit a store from an empty queue");
-  assert(storeQueue_.front().first->getSequenceId() == uop->getSequenceId() &&
+  assert(storeQueue_.front().insn->getSequenceId() == uop->getSequenceId() &&
          "Attempted to commit a store that wasn't present at the front of the "
          "store queue");
 
+  // Ensure no load is left waiting for a store which never started
+  const auto& front = storeQueue_.front();
+  if (!front.started && !front.deferredLoads.empty()) startStore(uop);
+
   const auto& addresses = uop->getGeneratedAddresses();
-  span<const simeng::RegisterValue> data = storeQueue_.front().second;
+  span<const simeng::RegisterValue> data = storeQueue_.front().data;
 
   // Early exit if there's no addresses to process
   if (addresses.size() == 0) {
@@ -214,16 +322,24 @@ bool LoadStoreQueue::commitStore(const std::shared_ptr<Instruction>& uop) {
     return false;
   }
 
-  requestStoreQueue_[tickCounter_ + uop->getLSQLatency()].push_back({{}, uop});
+  auto& reqAddresses =
+      requestStoreQueue_.insert(tickCounter_ + uop->getLSQLatency(), uop)
+          .reqAddresses;
   // Submit request write to memory interface early as the architectural state
-  // considers the store to be retired and thus its operation complete
+  // considers the store to be retired and thus its operation complete. An
+  // exclusive write has already been made by `writeExclusive`, so only its
+  // timing is requested, if it wrote at all
+  bool exclusive = writesExclusively(*uop);
   for (size_t i = 0; i < addresses.size(); i++) {
-    memory_.requestWrite(addresses[i], data[i]);
+    if (!exclusive) {
+      memory_.requestWrite(addresses[i], data[i]);
+      if (isa_) isa_->recordStore(addresses[i]);
+    } else if (uop->holdsReservation()) {
+      memory_.requestWrite(addresses[i], RegisterValue());
+    }
     // Still add addresses to requestQueue_ to ensure contention of resources is
     // correctly simulated
-    requestStoreQueue_[tickCounter_ + uop->getLSQLatency()]
-        .back()
-        .reqAddresses.push(addresses[i]);
+    reqAddresses.push_back(addresses[i]);
   }
 
   // Check all loads that have requested memory
@@ -241,8 +357,11 @@ bool LoadStoreQueue::commitStore(const std::shared_ptr<Instruction>& uop) {
       for (const auto& storeReq : addresses) {
         // Iterate over load addresses
         for (const auto& loadReq : loadedAddresses) {
-          // Check for overlapping requests, and flush if discovered
-          if (requestsOverlap(storeReq, loadReq)) {
+          // Check for overlapping requests not forwarded from this store or a
+          // younger one, and flush if discovered
+          if (requestsOverlap(storeReq, loadReq) &&
+              !isForwarded(load.second, loadReq, storeReq,
+                           uop->getSequenceId())) {
             violatingLoad_ = load.second;
           }
         }
@@ -250,38 +369,44 @@ bool LoadStoreQueue::commitStore(const std::shared_ptr<Instruction>& uop) {
     }
   }
 
+  // Place the violating load in the store's set so it waits for the store
+  // next time
+  if (violatingLoad_ && storeSetPredictor_) {
+    storeSetPredictor_->train(violatingLoad_->getInstructionAddress(),
+                              uop->getInstructionAddress());
+  }
+
   // Resolve any conflicts caused by this store instruction
-  const auto& itSt = conflictionMap_.find(uop->getSequenceId());
-  if (itSt != conflictionMap_.end()) {
+  for (const auto& entry : storeQueue_.front().conflictions) {
+    const auto& target = entry->target;
+    // Later store accesses overwrite earlier ones
     for (size_t i = 0; i < addresses.size(); i++) {
-      const auto& itAddr = itSt->second.find(addresses[i].address);
-      if (itAddr != itSt->second.end()) {
-        for (const auto& pair : itAddr->second) {
-          const auto& load = pair.first;
-          load->supplyData(addresses[i].address,
-                           data[i].zeroExtend(
-                               std::min(pair.second, (uint16_t)data[i].size()),
-                               pair.second));
-          if (load->hasAllData()) {
-            // This load has completed
-            load->execute();
-            if (load->isStoreData()) {
-              supplyStoreData(load);
-            }
-            completedLoads_.push(load);
-          }
-        }
+      const char* bytes = data[i] ? data[i].getAsVector<char>() : nullptr;
+      uint64_t begin = std::max(addresses[i].address, target.address);
+      uint64_t end = std::min(addresses[i].address + addresses[i].size,
+                              target.address + target.size);
+      for (uint64_t address = begin; address < end; address++) {
+        if (entry->sources[address - target.address] != uop->getSequenceId())
+          continue;
+        uint64_t offset = address - addresses[i].address;
+        entry->data[address - target.address] =
+            offset < data[i].size() ? bytes[offset] : 0;
       }
     }
-    conflictionMap_.erase(itSt);
+    if (--entry->pendingSources == 0) supplyForwardedData(*entry);
   }
 
+  if (storeQueue_.front().started) unindexStore(uop);
   storeQueue_.pop_front();
 
   return violatingLoad_ != nullptr;
 }
 
-void LoadStoreQueue::commitLoad(const std::shared_ptr<Instruction>& uop) {
+bool LoadStoreQueue::writeExclusive(const Instruction& uop) {
+  return !writesExclusively(uop) || isa_->storeExclusive(uop);
+}
+
+void LoadStoreQueue::commitLoad(const IntrusivePtr<Instruction>& uop) {
   assert(loadQueue_.size() > 0 &&
          "Attempted to commit a load from an empty queue");
   assert(loadQueue_.front()->getSequenceId() == uop->getSequenceId() &&
@@ -293,6 +418,7 @@ void LoadStoreQueue::commitLoad(const std::shared_ptr<Instruction>& uop) {
     const auto& entry = *it;
     if (entry->isLoad()) {
       requestedLoads_.erase(entry->getSequenceId());
+      forwardedLoads_.erase(entry->getSequenceId());
       it = loadQueue_.erase(it);
       break;
     } else {
@@ -308,76 +434,51 @@ void LoadStoreQueue::purgeFlushed() {
     const auto& entry = *itLd;
     if (entry->isFlushed()) {
       requestedLoads_.erase(entry->getSequenceId());
+      forwardedLoads_.erase(entry->getSequenceId());
       itLd = loadQueue_.erase(itLd);
     } else {
       itLd++;
     }
   }
 
-  // Remove flushed stores from store queue and confliction queue if an entry
-  // exists
+  // Remove flushed stores from store queue and store index
   auto itSt = storeQueue_.begin();
   while (itSt != storeQueue_.end()) {
-    const auto& entry = itSt->first;
+    const auto& entry = itSt->insn;
     if (entry->isFlushed()) {
-      conflictionMap_.erase(entry->getSequenceId());
+      if (itSt->started) unindexStore(entry);
       itSt = storeQueue_.erase(itSt);
     } else {
       itSt++;
     }
   }
 
-  // Remove flushed loads from confliction queue
-  for (auto itCnflct = conflictionMap_.begin();
-       itCnflct != conflictionMap_.end(); itCnflct++) {
-    // Iterate over addresses of store
-    for (auto itAddr = itCnflct->second.begin();
-         itAddr != itCnflct->second.end(); itAddr++) {
-      // Iterate over vector of instructions conflicting with store address
-      auto pair = itAddr->second.begin();
-      while (pair != itAddr->second.end()) {
-        if (pair->first->isFlushed()) {
-          pair = itAddr->second.erase(pair);
-        } else {
-          pair++;
-        }
-      }
-    }
+  // Remove flushed loads from those awaiting data from, or held back by a
+  // predicted dependence on, each remaining store
+  for (auto& store : storeQueue_) {
+    auto& conflictions = store.conflictions;
+    conflictions.erase(std::remove_if(conflictions.begin(), conflictions.end(),
+                                      [](const auto& entry) {
+                                        return entry->load->isFlushed();
+                                      }),
+                       conflictions.end());
+    auto& loads = store.deferredLoads;
+    loads.erase(std::remove_if(
+                    loads.begin(), loads.end(),
+                    [](const auto& load) { return load->isFlushed(); }),
+                loads.end());
   }
 
-  // Remove flushed loads and stores from request queues
-  auto itLdReq = requestLoadQueue_.begin();
-  while (itLdReq != requestLoadQueue_.end()) {
-    auto itInsn = itLdReq->second.begin();
-    while (itInsn != itLdReq->second.end()) {
-      if (itInsn->insn->isFlushed()) {
-        itInsn = itLdReq->second.erase(itInsn);
-      } else {
-        itInsn++;
-      }
-    }
-    if (itLdReq->second.size() == 0) {
-      itLdReq = requestLoadQueue_.erase(itLdReq);
-    } else {
-      itLdReq++;
-    }
-  }
-  auto itStReq = requestStoreQueue_.begin();
-  while (itStReq != requestStoreQueue_.end()) {
-    auto itInsn = itStReq->second.begin();
-    while (itInsn != itStReq->second.end()) {
-      if (itInsn->insn->isFlushed()) {
-        itInsn = itStReq->second.erase(itInsn);
-      } else {
-        itInsn++;
-      }
-    }
-    if (itStReq->second.size() == 0) {
-      itStReq = requestStoreQueue_.erase(itStReq);
-    } else {
-      itStReq++;
-    }
+  // A translation awaited by a flushed request is abandoned, so the next
+  // request to issue looks up its own
+  if (translationInsn_ != nullptr && translationInsn_->isFlushed()) {
+    translationReadyAt_ = 0;
+    translationInsn_ = nullptr;
   }
+
+  // Remove flushed loads and stores from request queues
+  requestLoadQueue_.removeFlushed();
+  requestStoreQueue_.removeFlushed();
 }
 
 void LoadStoreQueue::tick() {
@@ -388,117 +489,110 @@ void LoadStoreQueue::tick() {
   std::array<uint16_t, 2> reqCounts = {0, 0};
   std::array<uint64_t, 2> dataTransferred = {0, 0};
   std::array<bool, 2> exceededLimits = {false, false};
-  auto itLoad = requestLoadQueue_.begin();
-  auto itStore = requestStoreQueue_.begin();
-  while (requestLoadQueue_.size() + requestStoreQueue_.size() > 0) {
-    // Choose which request type to schedule next
-    bool chooseLoad = false;
-    std::pair<bool, uint64_t> earliestLoad;
-    std::pair<bool, uint64_t> earliestStore;
-    // Determine if a load request can be scheduled
-    if (requestLoadQueue_.size() == 0 || exceededLimits[accessType::LOAD]) {
-      earliestLoad = {false, 0};
-    } else {
-      earliestLoad = {true, itLoad->first};
-    }
-    // Determine if a store request can be scheduled
-    if (requestStoreQueue_.size() == 0 || exceededLimits[accessType::STORE]) {
-      earliestStore = {false, 0};
-    } else {
-      earliestStore = {true, itStore->first};
-    }
+  requestLoadQueue_.advance(tickCounter_);
+  requestStoreQueue_.advance(tickCounter_);
+  while (true) {
+    // Determine which request types can be scheduled
+    bool loadReady =
+        requestLoadQueue_.hasReady() && !exceededLimits[accessType::LOAD];
+    bool storeReady =
+        requestStoreQueue_.hasReady() && !exceededLimits[accessType::STORE];
+    if (!loadReady && !storeReady) break;
+
     // Choose between available requests favouring those constructed earlier
     // (store requests on a tie)
-    if (earliestLoad.first) {
-      chooseLoad = !(earliestStore.first &&
-                     (earliestLoad.second >= earliestStore.second));
-    } else if (!earliestStore.first) {
-      break;
-    }
-
-    // Get next request to schedule
-    auto& itReq = chooseLoad ? itLoad : itStore;
-    auto itInsn = itReq->second.begin();
+    bool chooseLoad =
+        loadReady &&
+        !(storeReady && requestLoadQueue_.front().readyAt >=
+                            requestStoreQueue_.front().readyAt);
+
+    // Get next requests to schedule
+    auto& requests = chooseLoad ? requestLoadQueue_ : requestStoreQueue_;
+    uint64_t readyAt = requests.front().readyAt;
     auto bandwidth = chooseLoad ? loadBandwidth_ : storeBandwidth_;
 
-    // Check if earliest request is ready
-    if (itReq->first <= tickCounter_) {
-      // Identify request type
-      uint8_t isStore = 0;
-      if (!chooseLoad) {
-        isStore = 1;
-      }
-      // If LSQ only allows one type of request within a cycle, prevent other
-      // type from being scheduled
-      if (exclusive_) exceededLimits[!isStore] = true;
-
-      // Iterate over requests ready this cycle
-      while (itInsn != itReq->second.end()) {
-        // Schedule requests from the queue of addresses in
-        // request[Load|Store]Queue_ entry
-        auto& addressQueue = itInsn->reqAddresses;
-        while (addressQueue.size()) {
-          const simeng::memory::MemoryAccessTarget req =
-              addressQueue.front();  // Speculatively increment count of this
-                                     // request type
-          reqCounts[isStore]++;
-
-          // Ensure the limit on the number of permitted operations is adhered
-          // to
-          if (reqCounts[isStore] + reqCounts[!isStore] > totalLimit_) {
-            // No more requests can be scheduled this cycle
-            exceededLimits = {true, true};
-            itInsn = itReq->second.end();
-            break;
-          } else if (reqCounts[isStore] > reqLimits_[isStore]) {
-            // No more requests of this type can be scheduled this cycle
-            exceededLimits[isStore] = true;
-            // Remove speculative increment to ensure it doesn't count for
-            // comparisons against the totalLimit_
-            reqCounts[isStore]--;
-            itInsn = itReq->second.end();
-            break;
+    // Identify request type
+    uint8_t isStore = 0;
+    if (!chooseLoad) {
+      isStore = 1;
+    }
+    // If LSQ only allows one type of request within a cycle, prevent other
+    // type from being scheduled
+    if (exclusive_) exceededLimits[!isStore] = true;
+
+    // Iterate over requests which became ready on the same cycle
+    bool blocked = false;
+    while (!blocked && requests.hasReady() &&
+           requests.front().readyAt == readyAt) {
+      // Schedule requests from the addresses in the request[Load|Store]Queue_
+      // entry
+      auto& entry = requests.front();
+      while (entry.nextAddress < entry.reqAddresses.size()) {
+        const simeng::memory::MemoryAccessTarget req =
+            entry.reqAddresses[entry.nextAddress];
+
+        // Requests are issued in order, so one waiting for its translation
+        // holds back all those after it
+        if (dataTlb_) {
+          if (translationReadyAt_ == 0) {
+            translationReadyAt_ = translate(req);
+            translationInsn_ = entry.insn.get();
           }
-
-          // Ensure the limit on the data transferred per cycle is adhered to
-          assert(req.size <= bandwidth &&
-                 "Individual memory request from LoadStoreQueue exceeds L1 "
-                 "bandwidth set and thus will never be submitted");
-          dataTransferred[isStore] += req.size;
-          if (dataTransferred[isStore] > bandwidth) {
-            // No more requests can be scheduled this cycle
-            exceededLimits[isStore] = true;
-            itInsn = itReq->second.end();
+          if (translationReadyAt_ > tickCounter_) {
+            translationStalls_++;
+            exceededLimits = {true, true};
+            blocked = true;
             break;
           }
+          translationReadyAt_ = 0;
+          translationInsn_ = nullptr;
+        }
 
-          // Request a read from the memory interface if the requestQueue_
-          // entry represents a read
-          if (!isStore) {
-            memory_.requestRead(req, itInsn->insn->getSequenceId());
-          }
-
-          // Remove processed address from queue
-          addressQueue.pop();
+        // Speculatively increment count of this request type
+        reqCounts[isStore]++;
+
+        // Ensure the limit on the number of permitted operations is adhered
+        // to
+        if (reqCounts[isStore] + reqCounts[!isStore] > totalLimit_) {
+          // No more requests can be scheduled this cycle
+          exceededLimits = {true, true};
+          blocked = true;
+          break;
+        } else if (reqCounts[isStore] > reqLimits_[isStore]) {
+          // No more requests of this type can be scheduled this cycle
+          exceededLimits[isStore] = true;
+          // Remove speculative increment to ensure it doesn't count for
+          // comparisons against the totalLimit_
+          reqCounts[isStore]--;
+          blocked = true;
+          break;
         }
-        // Remove entry from vector if all of its requests have been
-        // scheduled
-        if (addressQueue.size() == 0) {
-          itInsn = itReq->second.erase(itInsn);
+
+        // Ensure the limit on the data transferred per cycle is adhered to
+        assert(req.size <= bandwidth &&
+               "Individual memory request from LoadStoreQueue exceeds L1 "
+               "bandwidth set and thus will never be submitted");
+        dataTransferred[isStore] += req.size;
+        if (dataTransferred[isStore] > bandwidth) {
+          // No more requests can be scheduled this cycle
+          exceededLimits[isStore] = true;
+          blocked = true;
+          break;
         }
-      }
 
-      // If all uops for currently selected cycle in request[Load|Store]Queue_
-      // have been scheduled, erase entry
-      if (itReq->second.size() == 0) {
-        if (chooseLoad) {
-          itReq = requestLoadQueue_.erase(itReq);
-        } else {
-          itReq = requestStoreQueue_.erase(itReq);
+        // Request a read from the memory interface if the requestQueue_
+        // entry represents a read
+        if (!isStore) {
+          memory_.requestRead(req, entry.insn->getSequenceId());
+          // Train any prefetchers on the demand load as it is issued
+          memory_.observeLoad(entry.insn->getInstructionAddress(), req);
         }
+
+        // Move on to the next address
+        entry.nextAddress++;
       }
-    } else {
-      break;
+      // Remove entry if all of its requests have been scheduled
+      if (!blocked) requests.popFront();
     }
   }
 
@@ -515,24 +609,34 @@ void LoadStoreQueue::tick() {
       continue;
     }
 
-    // Supply data to the instruction and execute if it is ready
-    const auto& load = itr->second;
-    load->supplyData(address, data);
-    if (load->hasAllData()) {
-      // This load has completed
-      load->execute();
-
-      if (load->exceptionEncountered()) {
-        // Exception; don't pass load to completedLoads_
-        raiseException_(load);
+    // Merge the data with that forwarded from stores if the access is only
+    // partially read from memory
+    const auto& itFwd = forwardedLoads_.find(response.requestId);
+    if (itFwd != forwardedLoads_.end()) {
+      auto itEntry = std::find_if(
+          itFwd->second.begin(), itFwd->second.end(), [&](const auto& entry) {
+            return entry->awaitingMemory && entry->target.address == address;
+          });
+      if (itEntry != itFwd->second.end()) {
+        auto& entry = **itEntry;
+        entry.awaitingMemory = false;
+        if (data) {
+          const char* bytes = data.getAsVector<char>();
+          for (size_t i = 0; i < entry.sources.size(); i++) {
+            if (entry.sources[i] == memorySource && i < data.size()) {
+              entry.data[i] = bytes[i];
+            }
+          }
+        } else {
+          entry.faulted = true;
+        }
+        if (--entry.pendingSources == 0) supplyForwardedData(entry);
         continue;
       }
-
-      if (load->isStoreData()) {
-        supplyStoreData(load);
-      }
-      completedLoads_.push(load);
     }
+
+    // Supply data to the instruction and execute if it is ready
+    supplyLoadData(itr->second, address, data);
   }
   memory_.clearCompletedReads();
 
@@ -558,10 +662,130 @@ void LoadStoreQueue::tick() {
   }
 }
 
-std::shared_ptr<Instruction> LoadStoreQueue::getViolatingLoad() const {
+bool LoadStoreQueue::isIdle() const {
+  return requestLoadQueue_.empty() && requestStoreQueue_.empty() &&
+         completedLoads_.empty() && memory_.getCompletedReads().size() == 0;
+}
+
+void LoadStoreQueue::skipTicks(uint64_t ticks) {
+  assert(isIdle() && "Skipped a tick in which the LSQ was active");
+  tickCounter_ += ticks;
+  // Bring the empty wheels up to date, so that they needn't grow to span the
+  // skipped cycles when a request is next inserted
+  requestLoadQueue_.advance(tickCounter_);
+  requestStoreQueue_.advance(tickCounter_);
+}
+
+void LoadStoreQueue::skipHaltedTicks(uint64_t ticks) {
+  tickCounter_ += ticks;
+  requestLoadQueue_.advance(tickCounter_);
+  requestStoreQueue_.advance(tickCounter_);
+}
+
+void LoadStoreQueue::warm(uint64_t pc, const memory::MemoryAccessTarget& target,
+                          bool write) {
+  if (dataTlb_) {
+    // Also warm the page the access ends in, if it spans two
+    uint64_t pageMask = ~(dataTlb_->getPageSize() - 1);
+    uint64_t end = target.address + std::max<uint16_t>(target.size, 1) - 1;
+    dataTlb_->warm(target.address, tickCounter_);
+    if ((end & pageMask) != (target.address & pageMask))
+      dataTlb_->warm(end, tickCounter_);
+  }
+  memory_.warm(pc, target, write);
+}
+
+uint64_t LoadStoreQueue::getPredictedDependences() const {
+  return predictedDependences_;
+}
+
+bool LoadStoreQueue::isForwarded(const IntrusivePtr<Instruction>& load,
+                                 const memory::MemoryAccessTarget& loadReq,
+                                 const memory::MemoryAccessTarget& storeReq,
+                                 uint64_t storeSeqId) const {
+  const auto& itFwd = forwardedLoads_.find(load->getSequenceId());
+  if (itFwd == forwardedLoads_.end()) return false;
+  for (const auto& entry : itFwd->second) {
+    if (entry->target.address != loadReq.address ||
+        entry->target.size != loadReq.size)
+      continue;
+    uint64_t begin = std::max(storeReq.address, loadReq.address);
+    uint64_t end = std::min(storeReq.address + storeReq.size,
+                            loadReq.address + loadReq.size);
+    for (uint64_t address = begin; address < end; address++) {
+      uint64_t source = entry->sources[address - loadReq.address];
+      if (source == memorySource || source < storeSeqId) return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+void LoadStoreQueue::supplyForwardedData(const forwardingEntry& entry) {
+  RegisterValue data;
+  if (!entry.faulted) {
+    data = RegisterValue(entry.data.data(), entry.target.size);
+  }
+  supplyLoadData(entry.load, entry.target.address, data);
+}
+
+void LoadStoreQueue::supplyLoadData(const IntrusivePtr<Instruction>& load,
+                                    uint64_t address,
+                                    const RegisterValue& data) {
+  load->supplyData(address, data);
+  if (!load->hasAllData()) return;
+
+  // This load has completed
+  load->execute();
+
+  if (load->exceptionEncountered()) {
+    // Exception; don't pass load to completedLoads_
+    raiseException_(load);
+    return;
+  }
+
+  if (load->isStoreData()) {
+    supplyStoreData(load);
+  }
+  completedLoads_.push(load);
+}
+
+void LoadStoreQueue::unindexStore(const IntrusivePtr<Instruction>& store) {
+  for (const auto& target : store->getGeneratedAddresses()) {
+    forEachIndexBlock(target, [&](uint64_t block) {
+      const auto& itBlock = storeIndex_.find(block);
+      if (itBlock == storeIndex_.end()) return;
+      auto& stores = itBlock->second;
+      stores.erase(std::remove(stores.begin(), stores.end(), store),
+                   stores.end());
+      if (stores.empty()) storeIndex_.erase(itBlock);
+    });
+  }
+}
+
+bool LoadStoreQueue::writesExclusively(const Instruction& uop) const {
+  return uop.isAtomic() && isa_ != nullptr && isa_->hasExclusiveMonitor();
+}
+
+IntrusivePtr<Instruction> LoadStoreQueue::getViolatingLoad() const {
   return violatingLoad_;
 }
 
+uint64_t LoadStoreQueue::getTranslationStalls() const {
+  return translationStalls_;
+}
+
+uint64_t LoadStoreQueue::translate(const memory::MemoryAccessTarget& target) {
+  uint64_t readyAt = dataTlb_->translate(target.address, tickCounter_);
+  // Also translate the page the request ends in, if it spans two
+  uint64_t pageMask = ~(dataTlb_->getPageSize() - 1);
+  uint64_t end = target.address + std::max<uint16_t>(target.size, 1) - 1;
+  if ((end & pageMask) != (target.address & pageMask)) {
+    readyAt = std::max(readyAt, dataTlb_->translate(end, tickCounter_));
+  }
+  return readyAt;
+}
+
 bool LoadStoreQueue::isCombined() const { return combined_; }
 
 }  // namespace pipeline
@@ -66,5 +66,7 @@ void M1PortAllocator::setRSSizeGetter(
 }
 
 void M1PortAllocator::tick() {}
+
+void M1PortAllocator::skipTicks(uint64_t ticks) {}
 }  // namespace pipeline
 }  // namespace simeng
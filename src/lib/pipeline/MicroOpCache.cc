@@ -0,0 +1,115 @@
+#include "simeng/pipeline/MicroOpCache.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+
+namespace simeng {
+namespace pipeline {
+
+MicroOpCache::MicroOpCache(ryml::ConstNodeRef config)
+    : ways_(config["Micro-Op-Cache"]["Associativity"].as<uint16_t>()),
+      width_(config["Micro-Op-Cache"]["Width"].as<uint16_t>()) {
+  uint16_t entries = config["Micro-Op-Cache"]["Entries"].as<uint16_t>();
+  sets_ = entries / ways_;
+  assert(sets_ > 0 && "micro-op cache must hold at least one set");
+  entries_.resize(sets_ * ways_);
+}
+
+uint8_t MicroOpCache::supply(uint64_t address, uint16_t bytesAvailable,
+                             MacroOp& output) {
+  size_t set = getSet(address);
+  for (size_t way = set; way < set + ways_; way++) {
+    Entry& entry = entries_[way];
+    if (entry.address != address) continue;
+    if (entry.size > bytesAvailable) break;
+
+    output.resize(entry.macroOp.size());
+    for (size_t i = 0; i < entry.macroOp.size(); i++) {
+      output[i] = entry.macroOp[i]->clone();
+    }
+    entry.lastUsed = ++accesses_;
+    hits_++;
+    return entry.size;
+  }
+  misses_++;
+  return 0;
+}
+
+bool MicroOpCache::contains(uint64_t address) const {
+  size_t set = getSet(address);
+  for (size_t way = set; way < set + ways_; way++) {
+    if (entries_[way].address == address) return true;
+  }
+  return false;
+}
+
+void MicroOpCache::fill(uint64_t address, const MacroOp& macroOp,
+                        uint8_t size) {
+  size_t set = getSet(address);
+  size_t victim = set;
+  for (size_t way = set; way < set + ways_; way++) {
+    if (entries_[way].address == address) {
+      victim = way;
+      break;
+    }
+    if (entries_[way].lastUsed < entries_[victim].lastUsed) victim = way;
+  }
+
+  Entry& entry = entries_[victim];
+  entry.address = address;
+  entry.size = size;
+  entry.lastUsed = ++accesses_;
+  entry.macroOp.resize(macroOp.size());
+  for (size_t i = 0; i < macroOp.size(); i++) {
+    entry.macroOp[i] = macroOp[i]->clone();
+  }
+}
+
+void MicroOpCache::invalidate(uint64_t address, uint16_t size) {
+  if (size == 0) return;
+  // Instructions are at most four bytes, so one overlapping the write starts
+  // in the word before it or a word it covers. Each word indexes one set, so
+  // a write spanning more words than there are sets checks each set once
+  uint64_t firstWord = (address >> 2) - ((address >> 2) > 0 ? 1 : 0);
+  uint64_t lastWord = (address + size - 1) >> 2;
+  uint64_t words = std::min<uint64_t>(lastWord - firstWord + 1, sets_);
+  uint64_t end = address + size;
+  for (uint64_t word = firstWord; word < firstWord + words; word++) {
+    size_t set = getSet(word << 2);
+    for (size_t way = set; way < set + ways_; way++) {
+      Entry& entry = entries_[way];
+      if (entry.address == ~0ull || entry.address >= end ||
+          entry.address + entry.size <= address)
+        continue;
+      entry.address = ~0ull;
+      entry.lastUsed = 0;
+      entry.macroOp.clear();
+      invalidations_++;
+    }
+  }
+}
+
+uint16_t MicroOpCache::getWidth() const { return width_; }
+
+void MicroOpCache::getStats(std::map<std::string, std::string>& stats) const {
+  uint64_t supplied = hits_ + misses_;
+  float missRate =
+      supplied == 0 ? 0.0f : 100.0f * misses_ / static_cast<float>(supplied);
+  std::ostringstream missRateStr;
+  missRateStr << std::setprecision(3) << missRate << "%";
+
+  stats["uopcache.hits"] = std::to_string(hits_);
+  stats["uopcache.misses"] = std::to_string(misses_);
+  stats["uopcache.missrate"] = missRateStr.str();
+  stats["uopcache.invalidations"] = std::to_string(invalidations_);
+}
+
+size_t MicroOpCache::getSet(uint64_t address) const {
+  // Index by word address, so that four-byte instructions use every set
+  return ((address >> 2) % sets_) * ways_;
+}
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -0,0 +1,243 @@
+#include "simeng/pipeline/PipelineTracer.hh"
+
+#include <array>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+
+namespace simeng {
+namespace pipeline {
+
+/** The Konata stage names of the events from fetch to completion. */
+static const char* konataStages[] = {"F", "Dc", "Rn", "Ds", "Is", "Cm"};
+
+/** The O3PipeView fields of the events from fetch to completion. */
+static const char* o3Stages[] = {"fetch",    "decode", "rename",
+                                 "dispatch", "issue",  "complete"};
+
+/** The number of gem5 ticks in a cycle, matching the default clock period
+ * assumed by gem5's o3-pipeview.py. */
+static constexpr uint64_t o3TicksPerCycle = 1000;
+
+PipelineTracer::PipelineTracer(const std::string& path,
+                               PipelineTraceFormat format, uint64_t startCycle,
+                               uint64_t cycleCount, uint64_t startInstruction,
+                               uint64_t instructionCount)
+    : path_(path),
+      binaryPath_(path + ".bin"),
+      format_(format),
+      output_(path),
+      binary_(binaryPath_, std::ios::binary | std::ios::trunc),
+      startCycle_(startCycle),
+      cycleCount_(cycleCount),
+      startInstruction_(startInstruction),
+      instructionCount_(instructionCount) {
+  if (!output_.is_open() || !binary_.is_open()) {
+    std::cerr << "[SimEng:PipelineTracer] Could not open "
+              << (output_.is_open() ? binaryPath_ : path_) << " for writing"
+              << std::endl;
+    exit(1);
+  }
+  records_.reserve(bufferedRecords_);
+}
+
+PipelineTracer::~PipelineTracer() { finish(); }
+
+void PipelineTracer::tick(uint64_t cycle, uint64_t retired) {
+  if (finished_) return;
+
+  // A uop held only by the tracer has been dropped from the pipeline, so was
+  // flushed during the previous cycle
+  for (size_t i = 0; i < traced_.size(); i++) {
+    auto& traced = traced_[i];
+    if (traced.uop != nullptr &&
+        (traced.uop->isFlushed() || traced.uop.use_count() == 1)) {
+      write(firstTracedId_ + i, PipelineEvent::Flush);
+      traced.uop = nullptr;
+    }
+  }
+  while (!traced_.empty() && traced_.front().uop == nullptr) {
+    traced_.pop_front();
+    firstTracedId_++;
+  }
+
+  // Cycles may be skipped, so the window may both open and close in one call
+  cycle_ = cycle;
+  if (!windowOpen_ && !windowClosed_ && cycle >= startCycle_ &&
+      retired >= startInstruction_) {
+    windowOpen_ = true;
+  }
+  if (windowOpen_ &&
+      ((cycleCount_ != 0 && cycle >= startCycle_ + cycleCount_) ||
+       (instructionCount_ != 0 &&
+        retired >= startInstruction_ + instructionCount_))) {
+    windowOpen_ = false;
+    windowClosed_ = true;
+  }
+}
+
+void PipelineTracer::fetch(const IntrusivePtr<Instruction>& uop,
+                           uint32_t microOpIndex) {
+  // Uops held in a stalled buffer are seen again; only trace them once
+  if (!windowOpen_ || uop->getTraceId() != 0) return;
+
+  uint64_t id = firstTracedId_ + traced_.size();
+  uop->setTraceId(id);
+  traced_.push_back({uop, PipelineEvent::Fetch});
+  write(id, PipelineEvent::Fetch, uop->getInstructionAddress(), microOpIndex);
+}
+
+void PipelineTracer::record(const IntrusivePtr<Instruction>& uop,
+                            PipelineEvent event) {
+  uint64_t id = uop->getTraceId();
+  if (finished_ || id < firstTracedId_) return;
+
+  auto& traced = traced_[id - firstTracedId_];
+  if (traced.uop == nullptr || event <= traced.last) return;
+  traced.last = event;
+  write(id, event);
+  if (event == PipelineEvent::Commit) traced.uop = nullptr;
+}
+
+uint64_t PipelineTracer::getTracedCount() const {
+  return firstTracedId_ - 1 + traced_.size();
+}
+
+void PipelineTracer::finish() {
+  if (finished_) return;
+  finished_ = true;
+  traced_.clear();
+
+  writeRecords();
+  binary_.close();
+  std::ifstream binary(binaryPath_, std::ios::binary);
+  if (format_ == PipelineTraceFormat::Konata) {
+    convertKonata(binary);
+  } else {
+    convertO3PipeView(binary);
+  }
+  binary.close();
+  output_.close();
+  std::remove(binaryPath_.c_str());
+}
+
+void PipelineTracer::write(uint64_t id, PipelineEvent event, uint64_t address,
+                           uint32_t microOpIndex) {
+  records_.push_back({cycle_, id, address, microOpIndex, event});
+  if (records_.size() == bufferedRecords_) writeRecords();
+}
+
+void PipelineTracer::writeRecords() {
+  binary_.write(reinterpret_cast<const char*>(records_.data()),
+                records_.size() * sizeof(Record));
+  records_.clear();
+}
+
+bool PipelineTracer::readRecord(std::ifstream& binary, Record& record) {
+  return static_cast<bool>(
+      binary.read(reinterpret_cast<char*>(&record), sizeof(Record)));
+}
+
+void PipelineTracer::convertKonata(std::ifstream& binary) {
+  output_ << "Kanata\t0004\n";
+
+  // Konata expects each stage to be ended before the next in its lane starts
+  std::unordered_map<uint64_t, PipelineEvent> stages;
+  uint64_t cycle = 0;
+  uint64_t retired = 0;
+  bool started = false;
+  Record record;
+  while (readRecord(binary, record)) {
+    if (!started) {
+      output_ << "C=\t" << record.cycle << "\n";
+      started = true;
+    } else if (record.cycle != cycle) {
+      output_ << "C\t" << record.cycle - cycle << "\n";
+    }
+    cycle = record.cycle;
+
+    // Konata numbers instructions consecutively from 0
+    uint64_t id = record.id - 1;
+    switch (record.event) {
+      case PipelineEvent::Fetch:
+        output_ << "I\t" << id << "\t" << id << "\t0\n";
+        output_ << "L\t" << id << "\t0\t0x" << std::hex << record.address
+                << std::dec;
+        if (record.microOpIndex != 0) output_ << " uop " << record.microOpIndex;
+        output_ << "\n";
+        output_ << "S\t" << id << "\t0\t" << konataStages[0] << "\n";
+        stages[id] = PipelineEvent::Fetch;
+        break;
+      case PipelineEvent::Commit:
+        output_ << "R\t" << id << "\t" << retired++ << "\t0\n";
+        stages.erase(id);
+        break;
+      case PipelineEvent::Flush:
+        output_ << "R\t" << id << "\t0\t1\n";
+        stages.erase(id);
+        break;
+      default: {
+        auto& stage = stages[id];
+        output_ << "E\t" << id << "\t0\t"
+                << konataStages[static_cast<uint8_t>(stage)] << "\n";
+        output_ << "S\t" << id << "\t0\t"
+                << konataStages[static_cast<uint8_t>(record.event)] << "\n";
+        stage = record.event;
+        break;
+      }
+    }
+  }
+}
+
+void PipelineTracer::convertO3PipeView(std::ifstream& binary) {
+  /** The events of a uop, gathered until it leaves the pipeline. */
+  struct Events {
+    uint64_t address;
+    uint32_t microOpIndex;
+    std::array<uint64_t, 6> cycles;
+  };
+
+  // gem5 marks the stages a uop never reached, and the retirement of a flushed
+  // uop, with a tick of 0
+  auto emit = [this](uint64_t id, const Events& events, uint64_t retired) {
+    output_ << "O3PipeView:" << o3Stages[0] << ":"
+            << events.cycles[0] * o3TicksPerCycle << ":0x" << std::hex
+            << std::setw(8) << std::setfill('0') << events.address << std::dec
+            << ":" << events.microOpIndex << ":" << id << ":\n";
+    for (size_t stage = 1; stage < events.cycles.size(); stage++) {
+      output_ << "O3PipeView:" << o3Stages[stage] << ":"
+              << events.cycles[stage] * o3TicksPerCycle << "\n";
+    }
+    output_ << "O3PipeView:retire:" << retired * o3TicksPerCycle
+            << ":store:0\n";
+  };
+
+  std::map<uint64_t, Events> inFlight;
+  Record record;
+  while (readRecord(binary, record)) {
+    if (record.event == PipelineEvent::Fetch) {
+      inFlight[record.id] = {record.address, record.microOpIndex, {}};
+      inFlight[record.id].cycles[0] = record.cycle;
+      continue;
+    }
+
+    auto iter = inFlight.find(record.id);
+    if (iter == inFlight.end()) continue;
+    if (record.event == PipelineEvent::Commit ||
+        record.event == PipelineEvent::Flush) {
+      emit(record.id, iter->second,
+           record.event == PipelineEvent::Commit ? record.cycle : 0);
+      inFlight.erase(iter);
+    } else {
+      iter->second.cycles[static_cast<uint8_t>(record.event)] = record.cycle;
+    }
+  }
+
+  // Uops still in flight when the trace ended are treated as flushed
+  for (const auto& [id, events] : inFlight) emit(id, events, 0);
+}
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -1,13 +1,14 @@
 #include "simeng/pipeline/RenameUnit.hh"
 
 #include <algorithm>
+#include <cassert>
 #include <iostream>
 
 namespace simeng {
 namespace pipeline {
 
-RenameUnit::RenameUnit(PipelineBuffer<std::shared_ptr<Instruction>>& fromDecode,
-                       PipelineBuffer<std::shared_ptr<Instruction>>& toDispatch,
+RenameUnit::RenameUnit(PipelineBuffer<IntrusivePtr<Instruction>>& fromDecode,
+                       PipelineBuffer<IntrusivePtr<Instruction>>& toDispatch,
                        ReorderBuffer& rob, RegisterAliasTable& rat,
                        LoadStoreQueue& lsq, uint16_t registerTypes)
     : input_(fromDecode),
@@ -66,7 +67,9 @@ void RenameUnit::tick() {
       }
     }
 
-    bool serialize = false;
+    // Exclusive and atomic accesses wait for older uops to commit, so that an
+    // exclusive store executes only after the exclusive load reserving it
+    bool serialize = uop->isAtomic();
 
     auto& destinationRegisters = uop->getDestinationRegisters();
     // Count the number of each type of destination registers needed, and ensure
@@ -127,6 +130,71 @@ void RenameUnit::tick() {
   }
 }
 
+bool RenameUnit::isIdle() const {
+  if (!input_.isStalled()) return false;
+  if (output_.isStalled()) return true;
+  return findStall() != Stall::None;
+}
+
+void RenameUnit::skipTicks(uint64_t ticks) {
+  assert(isIdle() && "Skipped a tick in which the rename unit was active");
+  // Nothing is counted while the output is stalled
+  if (output_.isStalled()) return;
+
+  switch (findStall()) {
+    case Stall::ROB:
+      robStalls_ += ticks;
+      break;
+    case Stall::LoadQueue:
+      lqStalls_ += ticks;
+      break;
+    case Stall::StoreQueue:
+      sqStalls_ += ticks;
+      break;
+    case Stall::Allocation:
+      allocationStalls_ += ticks;
+      break;
+    default:
+      break;
+  }
+}
+
+RenameUnit::Stall RenameUnit::findStall() const {
+  // Mirror the checks `tick` makes of the first uop it finds, in order
+  for (size_t slot = 0; slot < input_.getWidth(); slot++) {
+    const auto& uop = input_.getHeadSlots()[slot];
+    if (uop == nullptr) continue;
+
+    if (reorderBuffer_.getFreeSpace() == 0) return Stall::ROB;
+    if (uop->exceptionEncountered()) return Stall::None;
+    if (uop->isLoad() && lsq_.getLoadQueueSpace() == 0) {
+      return Stall::LoadQueue;
+    }
+    if (uop->isStoreAddress() && lsq_.getStoreQueueSpace() == 0) {
+      return Stall::StoreQueue;
+    }
+
+    bool serialize = uop->isAtomic();
+    const auto& destinations = uop->getDestinationRegisters();
+    for (size_t i = 0; i < destinations.size(); i++) {
+      uint8_t type = destinations[i].type;
+      if (!rat_.canRename(type)) {
+        serialize = true;
+        continue;
+      }
+      // Count this register along with the earlier ones of its type
+      unsigned int required = 1;
+      for (size_t j = 0; j < i; j++) required += destinations[j].type == type;
+      if (required > rat_.freeRegistersAvailable(type)) {
+        return Stall::Allocation;
+      }
+    }
+    if (serialize && reorderBuffer_.size() > 0) return Stall::Serialize;
+    return Stall::None;
+  }
+  return Stall::None;
+}
+
 uint64_t RenameUnit::getAllocationStalls() const { return allocationStalls_; }
 uint64_t RenameUnit::getROBStalls() const { return robStalls_; }
 
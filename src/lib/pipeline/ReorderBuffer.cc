@@ -9,7 +9,7 @@ namespace pipeline {
 
 ReorderBuffer::ReorderBuffer(
     unsigned int maxSize, RegisterAliasTable& rat, LoadStoreQueue& lsq,
-    std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
+    std::function<void(const IntrusivePtr<Instruction>&)> raiseException,
     std::function<void(uint64_t branchAddress)> sendLoopBoundary,
     BranchPredictor& predictor, uint16_t loopBufSize,
     uint16_t loopDetectionThreshold)
@@ -19,74 +19,85 @@ ReorderBuffer::ReorderBuffer(
       raiseException_(raiseException),
       sendLoopBoundary_(sendLoopBoundary),
       predictor_(predictor),
+      buffer_(maxSize),
+      groups_(maxSize),
       loopBufSize_(loopBufSize),
       loopDetectionThreshold_(loopDetectionThreshold) {}
 
-void ReorderBuffer::reserve(const std::shared_ptr<Instruction>& insn) {
-  assert(buffer_.size() < maxSize_ &&
+void ReorderBuffer::reserve(const IntrusivePtr<Instruction>& insn) {
+  assert(size() < maxSize_ &&
          "Attempted to reserve entry in reorder buffer when already full");
   insn->setSequenceId(seqId_);
   seqId_++;
   insn->setInstructionId(insnId_);
-  if (insn->isLastMicroOp()) insnId_++;
 
-  buffer_.push_back(insn);
+  // Start a new group unless this continues a partially reserved macro-op
+  if (groupCount_ == 0 || group(groupCount_ - 1).complete) {
+    group(groupCount_) = {insnId_, tail_, 0, 0, false};
+    groupCount_++;
+  }
+  auto& insnGroup = group(groupCount_ - 1);
+  insnGroup.size++;
+  if (insn->isLastMicroOp()) {
+    insnGroup.complete = true;
+    insnId_++;
+  }
+
+  at(tail_) = insn;
+  tail_++;
 }
 
 void ReorderBuffer::commitMicroOps(uint64_t insnId) {
-  if (buffer_.size()) {
-    size_t index = 0;
-    int firstOp = -1;
-    bool validForCommit = false;
-
-    // Find first instance of uop belonging to macro-op instruction
-    for (; index < buffer_.size(); index++) {
-      if (buffer_[index]->getInstructionId() == insnId) {
-        firstOp = index;
-        break;
-      }
-    }
+  size_t index = findGroup(insnId);
+  if (index == groupCount_) return;
+  auto& insnGroup = group(index);
 
-    if (firstOp > -1) {
-      // If found, see if all uops are committable
-      for (; index < buffer_.size(); index++) {
-        if (buffer_[index]->getInstructionId() != insnId) break;
-        if (!buffer_[index]->isWaitingCommit()) {
-          return;
-        } else if (buffer_[index]->isLastMicroOp()) {
-          // all microOps must be in ROB for the commit to be valid
-          validForCommit = true;
-        }
-      }
-      if (!validForCommit) return;
+  // All microOps must be in ROB for the commit to be valid
+  if (!insnGroup.complete) return;
 
-      // No early return thus all uops are committable
-      for (; firstOp < buffer_.size(); firstOp++) {
-        if (buffer_[firstOp]->getInstructionId() != insnId) break;
-        buffer_[firstOp]->setCommitReady();
-      }
-    }
+  // Micro-ops remain waiting once flagged, so resume from the first not yet
+  // seen waiting. Those already committed were necessarily waiting
+  while (insnGroup.waiting < insnGroup.size) {
+    uint64_t pos = insnGroup.first + insnGroup.waiting;
+    if (pos >= head_ && !at(pos)->isWaitingCommit()) return;
+    insnGroup.waiting++;
+  }
+
+  // All uops are committable
+  uint64_t end = insnGroup.first + insnGroup.size;
+  for (uint64_t pos = std::max(insnGroup.first, head_); pos < end; pos++) {
+    at(pos)->setCommitReady();
   }
-  return;
 }
 
 unsigned int ReorderBuffer::commit(uint64_t maxCommitSize) {
   shouldFlush_ = false;
-  size_t maxCommits =
-      std::min(static_cast<size_t>(maxCommitSize), buffer_.size());
+  size_t maxCommits = std::min(static_cast<size_t>(maxCommitSize),
+                               static_cast<size_t>(size()));
 
   unsigned int n;
   for (n = 0; n < maxCommits; n++) {
-    auto& uop = buffer_[0];
+    auto& uop = at(head_);
     if (!uop->canCommit()) {
       break;
     }
 
+    // An exclusive store or atomic is executed again, along with younger
+    // uops, if another core has written to its memory since it was read
+    if (uop->isStoreData() && uop->isAtomic() &&
+        !uop->exceptionEncountered() && !lsq_.writeExclusive(*uop)) {
+      shouldFlush_ = true;
+      flushAfter_ = uop->getInstructionId() - 1;
+      pc_ = uop->getInstructionAddress();
+      return n;
+    }
+
+    if (commitObserver_) commitObserver_(uop);
     if (uop->isLastMicroOp()) instructionsCommitted_++;
 
     if (uop->exceptionEncountered()) {
       raiseException_(uop);
-      buffer_.pop_front();
+      popHead();
       return n + 1;
     }
 
@@ -109,7 +120,7 @@ unsigned int ReorderBuffer::commit(uint64_t maxCommitSize) {
         flushAfter_ = load->getInstructionId() - 1;
         pc_ = load->getInstructionAddress();
 
-        buffer_.pop_front();
+        popHead();
         return n + 1;
       }
     }
@@ -149,7 +160,7 @@ unsigned int ReorderBuffer::commit(uint64_t maxCommitSize) {
                           0};
       }
     }
-    buffer_.pop_front();
+    popHead();
   }
 
   return n;
@@ -158,8 +169,8 @@ unsigned int ReorderBuffer::commit(uint64_t maxCommitSize) {
 void ReorderBuffer::flush(uint64_t afterInsnId) {
   // Iterate backwards from the tail of the queue to find and remove ops newer
   // than `afterInsnId`
-  while (!buffer_.empty()) {
-    auto& uop = buffer_.back();
+  while (tail_ > head_) {
+    auto& uop = at(tail_ - 1);
     if (uop->getInstructionId() <= afterInsnId) {
       break;
     }
@@ -177,7 +188,16 @@ void ReorderBuffer::flush(uint64_t afterInsnId) {
     if (uop->isBranch()) {
       predictor_.flush(uop->getInstructionAddress());
     }
-    buffer_.pop_back();
+    // Skip the ID of a partially reserved macro-op, whose remaining micro-ops
+    // will not arrive
+    insnId_ = std::max(insnId_, uop->getInstructionId() + 1);
+    uop = nullptr;
+    tail_--;
+  }
+
+  // Truncate the groups of the removed ops
+  while (groupCount_ > 0 && group(groupCount_ - 1).first >= tail_) {
+    groupCount_--;
   }
 
   // Reset branch counter and loop detection
@@ -185,12 +205,15 @@ void ReorderBuffer::flush(uint64_t afterInsnId) {
   loopDetected_ = false;
 }
 
-unsigned int ReorderBuffer::size() const { return buffer_.size(); }
+unsigned int ReorderBuffer::size() const { return tail_ - head_; }
 
-unsigned int ReorderBuffer::getFreeSpace() const {
-  return maxSize_ - buffer_.size();
+IntrusivePtr<Instruction> ReorderBuffer::getHead() const {
+  if (tail_ == head_) return nullptr;
+  return buffer_[head_ % maxSize_];
 }
 
+unsigned int ReorderBuffer::getFreeSpace() const { return maxSize_ - size(); }
+
 bool ReorderBuffer::shouldFlush() const { return shouldFlush_; }
 uint64_t ReorderBuffer::getFlushAddress() const { return pc_; }
 uint64_t ReorderBuffer::getFlushInsnId() const { return flushAfter_; }
@@ -203,5 +226,46 @@ uint64_t ReorderBuffer::getViolatingLoadsCount() const {
   return loadViolations_;
 }
 
+void ReorderBuffer::setCommitObserver(
+    std::function<void(const IntrusivePtr<Instruction>&)> observer) {
+  commitObserver_ = observer;
+}
+
+void ReorderBuffer::popHead() {
+  at(head_) = nullptr;
+  head_++;
+  // Retire the oldest group once all of its micro-ops have committed
+  const auto& oldest = group(0);
+  if (oldest.complete && oldest.first + oldest.size <= head_) {
+    groupHead_ = (groupHead_ + 1) % maxSize_;
+    groupCount_--;
+  }
+}
+
+IntrusivePtr<Instruction>& ReorderBuffer::at(uint64_t pos) {
+  return buffer_[pos % maxSize_];
+}
+
+MicroOpGroup& ReorderBuffer::group(uint64_t index) {
+  return groups_[(groupHead_ + index) % maxSize_];
+}
+
+size_t ReorderBuffer::findGroup(uint64_t insnId) {
+  // Instruction IDs of in-flight groups increase from the oldest, with gaps
+  // left by the groups removed by flushes
+  size_t low = 0;
+  size_t high = groupCount_;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (group(mid).insnId < insnId) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low < groupCount_ && group(low).insnId == insnId) return low;
+  return groupCount_;
+}
+
 }  // namespace pipeline
 }  // namespace simeng
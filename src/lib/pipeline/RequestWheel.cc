@@ -0,0 +1,98 @@
+#include "simeng/pipeline/RequestWheel.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace simeng {
+namespace pipeline {
+
+RequestWheel::RequestWheel(size_t slots) : slots_(slots) {
+  assert(slots > 0 && (slots & (slots - 1)) == 0 &&
+         "RequestWheel size must be a power of 2");
+}
+
+requestEntry& RequestWheel::insert(uint64_t readyAt,
+                                   const IntrusivePtr<Instruction>& insn) {
+  uint32_t index;
+  if (freeEntries_.empty()) {
+    index = entries_.size();
+    entries_.emplace_back();
+  } else {
+    index = freeEntries_.back();
+    freeEntries_.pop_back();
+  }
+  auto& entry = entries_[index];
+  entry.insn = insn;
+  entry.readyAt = readyAt;
+  size_++;
+
+  if (readyAt < nextCycle_) {
+    // The entry's cycle has already been passed, so it is ready immediately
+    ready_.push_back(index);
+    return entry;
+  }
+
+  // Grow the wheel until it spans the entry's cycle, redistributing the
+  // waiting entries to their new slots
+  while (readyAt - nextCycle_ >= slots_.size()) {
+    std::vector<std::vector<uint32_t>> slots(slots_.size() * 2);
+    for (uint64_t cycle = nextCycle_; cycle < nextCycle_ + slots_.size();
+         cycle++) {
+      for (uint32_t waiting : slots_[cycle & (slots_.size() - 1)]) {
+        slots[cycle & (slots.size() - 1)].push_back(waiting);
+      }
+    }
+    slots_ = std::move(slots);
+  }
+
+  slots_[readyAt & (slots_.size() - 1)].push_back(index);
+  return entry;
+}
+
+void RequestWheel::advance(uint64_t cycle) {
+  // Skip straight to the cycle if nothing is waiting in the slots between
+  if (ready_.size() == size_) nextCycle_ = std::max(nextCycle_, cycle);
+
+  while (nextCycle_ <= cycle) {
+    auto& slot = slots_[nextCycle_ & (slots_.size() - 1)];
+    ready_.insert(ready_.end(), slot.begin(), slot.end());
+    slot.clear();
+    nextCycle_++;
+  }
+}
+
+bool RequestWheel::hasReady() const { return !ready_.empty(); }
+
+requestEntry& RequestWheel::front() { return entries_[ready_.front()]; }
+
+void RequestWheel::popFront() {
+  release(ready_.front());
+  ready_.pop_front();
+}
+
+bool RequestWheel::empty() const { return size_ == 0; }
+
+void RequestWheel::removeFlushed() {
+  auto flushed = [this](uint32_t index) {
+    if (!entries_[index].insn->isFlushed()) return false;
+    release(index);
+    return true;
+  };
+  for (auto& slot : slots_) {
+    slot.erase(std::remove_if(slot.begin(), slot.end(), flushed), slot.end());
+  }
+  ready_.erase(std::remove_if(ready_.begin(), ready_.end(), flushed),
+               ready_.end());
+}
+
+void RequestWheel::release(uint32_t index) {
+  auto& entry = entries_[index];
+  entry.reqAddresses.clear();
+  entry.nextAddress = 0;
+  entry.insn = nullptr;
+  freeEntries_.push_back(index);
+  size_--;
+}
+
+}  // namespace pipeline
+}  // namespace simeng
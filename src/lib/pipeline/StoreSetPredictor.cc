@@ -0,0 +1,63 @@
+#include "simeng/pipeline/StoreSetPredictor.hh"
+
+#include <algorithm>
+
+namespace simeng {
+namespace pipeline {
+
+StoreSetPredictor::StoreSetPredictor(ryml::ConstNodeRef config)
+    : setIds_(config["Memory-Dependence-Predictor"]["Store-Set-ID-Entries"]
+                  .as<uint16_t>(),
+              invalidSet),
+      lastStores_(
+          config["Memory-Dependence-Predictor"]["Store-Sets"].as<uint16_t>(),
+          UINT64_MAX),
+      clearInterval_(config["Memory-Dependence-Predictor"]["Clear-Interval"]
+                         .as<uint64_t>()) {}
+
+void StoreSetPredictor::addStore(uint64_t pc, uint64_t seqId) {
+  uint16_t setId = getSetId(pc);
+  if (setId != invalidSet) lastStores_[setId] = seqId;
+}
+
+void StoreSetPredictor::storeIssued(uint64_t pc, uint64_t seqId) {
+  uint16_t setId = getSetId(pc);
+  if (setId != invalidSet && lastStores_[setId] == seqId) {
+    lastStores_[setId] = UINT64_MAX;
+  }
+}
+
+uint64_t StoreSetPredictor::predictDependence(uint64_t pc) {
+  // Periodically forget all sets, so that loads are not held back by
+  // dependences which no longer occur
+  if (clearInterval_ > 0 && ++predictions_ >= clearInterval_) {
+    predictions_ = 0;
+    std::fill(setIds_.begin(), setIds_.end(), invalidSet);
+  }
+
+  uint16_t setId = getSetId(pc);
+  return setId == invalidSet ? UINT64_MAX : lastStores_[setId];
+}
+
+void StoreSetPredictor::train(uint64_t loadPC, uint64_t storePC) {
+  uint16_t& loadSet = getSetId(loadPC);
+  uint16_t& storeSet = getSetId(storePC);
+  if (loadSet == invalidSet && storeSet == invalidSet) {
+    // Allocate a new set, identified by a hash of the store's address
+    loadSet = storeSet = (storePC >> 2) % lastStores_.size();
+  } else if (loadSet == invalidSet) {
+    loadSet = storeSet;
+  } else if (storeSet == invalidSet) {
+    storeSet = loadSet;
+  } else {
+    // Merge the two sets, keeping the smaller ID
+    loadSet = storeSet = std::min(loadSet, storeSet);
+  }
+}
+
+uint16_t& StoreSetPredictor::getSetId(uint64_t pc) {
+  return setIds_[(pc >> 2) % setIds_.size()];
+}
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -6,7 +6,7 @@ namespace simeng {
 namespace pipeline {
 
 WritebackUnit::WritebackUnit(
-    std::vector<PipelineBuffer<std::shared_ptr<Instruction>>>& completionSlots,
+    std::vector<PipelineBuffer<IntrusivePtr<Instruction>>>& completionSlots,
     RegisterFileSet& registerFileSet,
     std::function<void(uint64_t insnId)> flagMicroOpCommits)
     : completionSlots_(completionSlots),
@@ -40,6 +40,14 @@ void WritebackUnit::tick() {
   }
 }
 
+bool WritebackUnit::isIdle() const {
+  for (const auto& slot : completionSlots_) {
+    if (slot.getHeadSlots()[0] != nullptr || slot.getTailSlots()[0] != nullptr)
+      return false;
+  }
+  return true;
+}
+
 uint64_t WritebackUnit::getInstructionsWrittenCount() const {
   return instructionsWritten_;
 }
@@ -1,29 +1,105 @@
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <string>
 
+#include "simeng/Checkpoint.hh"
 #include "simeng/Core.hh"
 #include "simeng/CoreInstance.hh"
+#include "simeng/ParallelCoreDriver.hh"
+#include "simeng/SamplingDriver.hh"
 #include "simeng/config/SimInfo.hh"
 #include "simeng/memory/MemoryInterface.hh"
 #include "simeng/version.hh"
 
-/** Tick the provided core model until it halts. */
-uint64_t simulate(simeng::Core& core,
-                  simeng::memory::MemoryInterface& dataMemory,
-                  simeng::memory::MemoryInterface& instructionMemory) {
+/** Tick the provided cores until every thread of the simulated process has
+ * finished. If `checkpointPath` is non-empty, simulation instead ends once a
+ * checkpoint has been saved there, after at least `checkpointAt` instructions
+ * have retired. */
+uint64_t simulate(simeng::CoreInstance& coreInstance,
+                  const std::string& checkpointPath = "",
+                  uint64_t checkpointAt = 0) {
   uint64_t iterations = 0;
+  const auto& cores = coreInstance.getCores();
 
-  // Tick the core and memory interfaces until the program has halted
-  while (!core.hasHalted() || dataMemory.hasPendingRequests()) {
-    // Tick the core
-    core.tick();
+  // A lone emulation core whose memory completes each access immediately
+  // needs nothing ticked alongside it, so runs a basic block per iteration
+  simeng::models::emulation::Core* blockCore = nullptr;
+  if (cores.size() == 1 &&
+      coreInstance.getInstructionMemory(0)->getDirectMemory().size() &&
+      coreInstance.getDataMemory(0)->getDirectMemory().size()) {
+    blockCore =
+        dynamic_cast<simeng::models::emulation::Core*>(cores[0].get());
+  }
+
+  // Tick the cores and memory interfaces until the program has halted
+  while (true) {
+    bool pendingRequests = false;
+    for (size_t i = 0; i < cores.size(); i++) {
+      pendingRequests |= coreInstance.getDataMemory(i)->hasPendingRequests();
+    }
+    if (coreInstance.hasHalted() && !pendingRequests) break;
+
+    if (!checkpointPath.empty()) {
+      uint64_t retired = 0;
+      for (const auto& core : cores) {
+        retired += core->getInstructionsRetiredCount();
+      }
+      // Saving fails while a core is mid-instruction; retry next cycle
+      if (retired >= checkpointAt &&
+          coreInstance.saveCheckpoint(checkpointPath)) {
+        std::cout << "[SimEng] Saved checkpoint to " << checkpointPath
+                  << " after " << retired << " instructions" << std::endl;
+        break;
+      }
+    }
+
+    // Jump over any cycles in which no core or memory interface would do more
+    // than count the cycle. Nothing is skipped if all would idle forever, as
+    // the simulation could then never end
+    uint64_t idleTicks = UINT64_MAX;
+    for (size_t i = 0; i < cores.size() && idleTicks > 0; i++) {
+      idleTicks =
+          std::min({idleTicks, cores[i]->getIdleTicks(),
+                    coreInstance.getInstructionMemory(i)->getIdleTicks(),
+                    coreInstance.getDataMemory(i)->getIdleTicks()});
+    }
+    if (idleTicks > 0 && idleTicks != UINT64_MAX) {
+      for (size_t i = 0; i < cores.size(); i++) {
+        cores[i]->skipTicks(idleTicks);
+        coreInstance.getInstructionMemory(i)->skipTicks(idleTicks);
+        coreInstance.getDataMemory(i)->skipTicks(idleTicks);
+      }
+      iterations += idleTicks;
+      continue;
+    }
+
+    if (blockCore != nullptr) {
+      uint64_t ticks = blockCore->tickBlock();
+      // Bring the memory interfaces up to the core's cycle
+      coreInstance.getInstructionMemory(0)->skipTicks(ticks - 1);
+      coreInstance.getDataMemory(0)->skipTicks(ticks - 1);
+      coreInstance.getInstructionMemory(0)->tick();
+      coreInstance.getDataMemory(0)->tick();
+      coreInstance.scheduleThreads();
+      iterations += ticks;
+      continue;
+    }
+
+    // Tick the cores
+    for (const auto& core : cores) core->tick();
 
     // Tick memory
-    instructionMemory.tick();
-    dataMemory.tick();
+    for (size_t i = 0; i < cores.size(); i++) {
+      coreInstance.getInstructionMemory(i)->tick();
+      coreInstance.getDataMemory(i)->tick();
+    }
+
+    // Place any newly created threads onto idle cores
+    coreInstance.scheduleThreads();
 
     iterations++;
   }
@@ -70,19 +146,32 @@ int main(int argc, char** argv) {
     configFilePath = DEFAULT_STR;
   }
 
-  coreInstance =
-      std::make_unique<simeng::CoreInstance>(executablePath, executableArgs);
+  ryml::ConstNodeRef checkpointConfig =
+      simeng::config::SimInfo::getConfig()["Checkpoint"];
+  std::string restorePath = checkpointConfig["Restore-Path"].as<std::string>();
+  std::string savePath = checkpointConfig["Save-Path"].as<std::string>();
+  uint64_t saveAt = checkpointConfig["Save-At-Instruction"].as<uint64_t>();
+  std::string samplingMode =
+      simeng::config::SimInfo::getConfig()["Sampling"]["Mode"]
+          .as<std::string>();
+
+  if (restorePath.empty()) {
+    coreInstance =
+        std::make_unique<simeng::CoreInstance>(executablePath, executableArgs);
+  } else {
+    // Resume the process held in the checkpoint, ignoring any executable
+    simeng::CheckpointReader checkpoint(restorePath);
+    coreInstance = std::make_unique<simeng::CoreInstance>(checkpoint);
+    executablePath = "Restored from checkpoint " + restorePath;
+    executableArgs.clear();
+  }
 
   // Replace empty executablePath string with more useful content for
   // outputting
   if (executablePath == "") executablePath = DEFAULT_STR;
 
   // Get simulation objects needed to forward simulation
-  std::shared_ptr<simeng::Core> core = coreInstance->getCore();
-  std::shared_ptr<simeng::memory::MemoryInterface> dataMemory =
-      coreInstance->getDataMemory();
-  std::shared_ptr<simeng::memory::MemoryInterface> instructionMemory =
-      coreInstance->getInstructionMemory();
+  const auto& cores = coreInstance->getCores();
 
   // Output general simulation details
   std::cout << "[SimEng] Running in "
@@ -110,11 +199,44 @@ int main(int argc, char** argv) {
                    .as<uint16_t>()
             << std::endl;
 
+  uint16_t hostThreads =
+      simeng::config::SimInfo::getConfig()["CPU-Info"]["Host-Threads"]
+          .as<uint16_t>();
+  uint64_t syncQuantum =
+      simeng::config::SimInfo::getConfig()["CPU-Info"]["Sync-Quantum"]
+          .as<uint64_t>();
+  if (!savePath.empty()) {
+    std::cout << "[SimEng] Saving checkpoint to " << savePath << " after "
+              << saveAt << " instructions" << std::endl;
+  }
+  if (samplingMode != "None") {
+    std::cout << "[SimEng] Sampling: " << samplingMode
+              << " intervals, fast-forwarding in emulation mode" << std::endl;
+  }
+  if (cores.size() > 1 && hostThreads > 1 && savePath.empty()) {
+    std::cout << "[SimEng] Host threads: "
+              << std::min<size_t>(hostThreads, cores.size())
+              << " (synchronising every " << syncQuantum << " cycles)"
+              << std::endl;
+  }
+
   // Run simulation
   std::cout << "[SimEng] Starting...\n" << std::endl;
   uint64_t iterations = 0;
   auto startTime = std::chrono::high_resolution_clock::now();
-  iterations = simulate(*core, *dataMemory, *instructionMemory);
+  std::unique_ptr<simeng::SamplingDriver> samplingDriver;
+  if (samplingMode != "None") {
+    // Simulate only the sampled intervals in detail
+    samplingDriver = std::make_unique<simeng::SamplingDriver>(*coreInstance);
+    iterations = samplingDriver->run();
+  } else if (cores.size() > 1 && hostThreads > 1 && savePath.empty()) {
+    // Tick the cores concurrently, each on its own host thread
+    iterations =
+        simeng::ParallelCoreDriver(*coreInstance, hostThreads, syncQuantum)
+            .run();
+  } else {
+    iterations = simulate(*coreInstance, savePath, saveAt);
+  }
 
   // Get timing information
   auto endTime = std::chrono::high_resolution_clock::now();
@@ -122,12 +244,31 @@ int main(int argc, char** argv) {
       std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime)
           .count();
   double khz = (iterations / (static_cast<double>(duration) / 1000.0)) / 1000.0;
-  uint64_t retired = core->getInstructionsRetiredCount();
+  uint64_t retired = 0;
+  for (const auto& core : cores) retired += core->getInstructionsRetiredCount();
+  if (samplingDriver) {
+    retired += coreInstance->getFunctionalCore()->getInstructionsRetiredCount();
+  }
   double mips = (retired / (static_cast<double>(duration))) / 1000.0;
 
-  // Print stats
+  // Print stats. With multiple cores, each core's stats are prefixed with its
+  // ID, followed by the totals across all cores
   std::cout << std::endl;
-  auto stats = core->getStats();
+  std::map<std::string, std::string> stats;
+  if (samplingDriver) {
+    // Stats are estimated for the whole workload from the sampled intervals
+    stats = samplingDriver->getStats();
+  } else if (cores.size() == 1) {
+    stats = cores[0]->getStats();
+  } else {
+    for (size_t i = 0; i < cores.size(); i++) {
+      for (const auto& [key, value] : cores[i]->getStats()) {
+        stats["core" + std::to_string(i) + "." + key] = value;
+      }
+    }
+    stats["cycles"] = std::to_string(iterations);
+    stats["retired"] = std::to_string(retired);
+  }
   for (const auto& [key, value] : stats) {
     std::cout << "[SimEng] " << key << ": " << value << std::endl;
   }
@@ -44,19 +44,43 @@ TEST(ConfigTest, Default) {
       "'Micro-Operations': 0\n  'Vector-Length': 128\n  "
       "'Streaming-Vector-Length': 128\nFetch:\n  'Fetch-Block-Size': 32\n  "
       "'Loop-Buffer-Size': 32\n  'Loop-Detection-Threshold': "
-      "5\n'Process-Image':\n  'Heap-Size': 100000\n  'Stack-Size': "
+      "5\n  'Fetch-Target-Queue-Size': 0\n  'Branch-Target-Buffer-Entries': "
+      "1024\n  'Fetch-Targets-Per-Cycle': 2\n'Process-Image':\n  'Heap-Size': "
+      "100000\n  'Stack-Size': "
       "100000\n'Register-Set':\n  'GeneralPurpose-Count': 38\n  "
       "'FloatingPoint/SVE-Count': 38\n  'Predicate-Count': 17\n  "
       "'Conditional-Count': 1\n  'Matrix-Count': 1\n'Pipeline-Widths':\n  "
       "Commit: 1\n  FrontEnd: 1\n  'LSQ-Completion': 1\n'Queue-Sizes':\n  ROB: "
       "32\n  Load: 16\n  Store: 16\n'Branch-Predictor':\n  Type: Perceptron\n  "
       "'BTB-Tag-Bits': 8\n  'Global-History-Length': 8\n  'RAS-entries': "
-      "8\n'L1-Data-Memory':\n  'Interface-Type': "
-      "Flat\n'L1-Instruction-Memory':\n  'Interface-Type': "
-      "Flat\n'LSQ-L1-Interface':\n  'Access-Latency': 4\n  Exclusive: 0\n  "
+      "8\n'L1-Data-Memory':\n  'Interface-Type': Flat\n  Size: 65536\n  "
+      "Associativity: 4\n  'Line-Size': 64\n  'Hit-Latency': 4\n  MSHRs: "
+      "8\n  'Write-Back': 1\n  'Write-Allocate': 1\n  'Replacement-Policy': "
+      "LRU\n'L1-Instruction-Memory':\n  'Interface-Type': Flat\n  Size: "
+      "65536\n  Associativity: 4\n  'Line-Size': 64\n  'Hit-Latency': 1\n  "
+      "MSHRs: 8\n  'Write-Back': 1\n  'Write-Allocate': 1\n  "
+      "'Replacement-Policy': LRU\n'L2-Cache':\n  Size: 0\n  Associativity: "
+      "8\n  'Line-Size': 64\n  'Hit-Latency': 12\n  MSHRs: 16\n  "
+      "'Write-Back': 1\n  'Write-Allocate': 1\n  'Replacement-Policy': "
+      "LRU\n'Last-Level-Cache':\n  Size: 0\n  Associativity: 16\n  "
+      "'Line-Size': 64\n  'Hit-Latency': 36\n  MSHRs: 32\n  'Write-Back': "
+      "1\n  'Write-Allocate': 1\n  'Replacement-Policy': LRU\n'Main-Memory':"
+      "\n  'Access-Latency': 100\nTLB:\n  'Page-Size': 4096\n  "
+      "'Instruction-Entries': 0\n  'Instruction-Associativity': 4\n  "
+      "'Data-Entries': 0\n  'Data-Associativity': 4\n  'L2-Entries': 0\n  "
+      "'L2-Associativity': 8\n  'L2-Latency': 8\n  'Page-Walk-Latency': "
+      "30\n'Data-Prefetcher':\n  'Next-Line': 0\n  "
+      "'Next-Line-Degree': 1\n  Stride: 0\n  'Stride-Table-Entries': 64\n  "
+      "'Stride-Degree': 2\n  Stream: 0\n  'Stream-Table-Entries': 16\n  "
+      "'Stream-Distance': 8\n  'Stream-Degree': 2\n'LSQ-L1-Interface':\n  "
+      "'Access-Latency': "
+      "4\n  Exclusive: 0\n  "
       "'Load-Bandwidth': 32\n  'Store-Bandwidth': 32\n  "
       "'Permitted-Requests-Per-Cycle': 1\n  'Permitted-Loads-Per-Cycle': 1\n  "
-      "'Permitted-Stores-Per-Cycle': 1\nPorts:\n  0:\n    Portname: 0\n    "
+      "'Permitted-Stores-Per-Cycle': 1\n'Memory-Dependence-Predictor':\n  "
+      "'Store-Set-ID-Entries': 0\n  'Store-Sets': 128\n  'Clear-Interval': "
+      "1000000\n'Micro-Op-Cache':\n  Entries: 0\n  Associativity: 8\n  "
+      "Width: 6\nPorts:\n  0:\n    Portname: 0\n    "
       "'Instruction-Group-Support':\n      - ALL\n    "
       "'Instruction-Opcode-Support':\n      - 6343\n    "
       "'Instruction-Group-Support-Nums':\n      - "
@@ -71,7 +95,15 @@ TEST(ConfigTest, Default) {
       "/specialFiles/\n  'Core-Count': 1\n  'Socket-Count': 1\n  SMT: 1\n  "
       "BogoMIPS: 0\n  Features: ''\n  'CPU-Implementer': 0x0\n  "
       "'CPU-Architecture': 0\n  'CPU-Variant': 0x0\n  'CPU-Part': 0x0\n  "
-      "'CPU-Revision': 0\n  'Package-Count': 1\n";
+      "'CPU-Revision': 0\n  'Package-Count': 1\n  "
+      "'Host-Threads': 1\n  'Sync-Quantum': 1\nCheckpoint:\n  "
+      "'Save-Path': ''\n  'Save-At-Instruction': 0\n  'Restore-Path': "
+      "''\nSampling:\n  Mode: None\n  'Interval-Length': 10000000\n  "
+      "'Detail-Length': 10000\n  'Warmup-Length': 2000\n  "
+      "'Functional-Warming': 1\n  'SimPoint-File': "
+      "''\n  'Weights-File': ''\n  'BBV-Path': ''\n'Pipeline-Trace':\n  "
+      "Path: ''\n  Format: Konata\n  'Start-Cycle': 0\n  'Cycle-Count': 0\n  "
+      "'Start-Instruction': 0\n  'Instruction-Count': 100000\n";
   EXPECT_EQ(emittedConfig, expectedValues);
 
   // Generate default for rv64 ISA
@@ -99,18 +131,42 @@ TEST(ConfigTest, Default) {
       "'Clock-Frequency-GHz': 1\n  'Timer-Frequency-MHz': 100\n  "
       "'Micro-Operations': 0\nFetch:\n  'Fetch-Block-Size': 32\n  "
       "'Loop-Buffer-Size': 32\n  'Loop-Detection-Threshold': "
-      "5\n'Process-Image':\n  'Heap-Size': 100000\n  'Stack-Size': "
+      "5\n  'Fetch-Target-Queue-Size': 0\n  'Branch-Target-Buffer-Entries': "
+      "1024\n  'Fetch-Targets-Per-Cycle': 2\n'Process-Image':\n  'Heap-Size': "
+      "100000\n  'Stack-Size': "
       "100000\n'Register-Set':\n  'GeneralPurpose-Count': 38\n  "
       "'FloatingPoint-Count': 38\n'Pipeline-Widths':\n  Commit: 1\n  FrontEnd: "
       "1\n  'LSQ-Completion': 1\n'Queue-Sizes':\n  ROB: 32\n  Load: 16\n  "
       "Store: 16\n'Branch-Predictor':\n  Type: Perceptron\n  'BTB-Tag-Bits': "
       "8\n  'Global-History-Length': 8\n  'RAS-entries': "
-      "8\n'L1-Data-Memory':\n  'Interface-Type': "
-      "Flat\n'L1-Instruction-Memory':\n  'Interface-Type': "
-      "Flat\n'LSQ-L1-Interface':\n  'Access-Latency': 4\n  Exclusive: 0\n  "
+      "8\n'L1-Data-Memory':\n  'Interface-Type': Flat\n  Size: 65536\n  "
+      "Associativity: 4\n  'Line-Size': 64\n  'Hit-Latency': 4\n  MSHRs: "
+      "8\n  'Write-Back': 1\n  'Write-Allocate': 1\n  'Replacement-Policy': "
+      "LRU\n'L1-Instruction-Memory':\n  'Interface-Type': Flat\n  Size: "
+      "65536\n  Associativity: 4\n  'Line-Size': 64\n  'Hit-Latency': 1\n  "
+      "MSHRs: 8\n  'Write-Back': 1\n  'Write-Allocate': 1\n  "
+      "'Replacement-Policy': LRU\n'L2-Cache':\n  Size: 0\n  Associativity: "
+      "8\n  'Line-Size': 64\n  'Hit-Latency': 12\n  MSHRs: 16\n  "
+      "'Write-Back': 1\n  'Write-Allocate': 1\n  'Replacement-Policy': "
+      "LRU\n'Last-Level-Cache':\n  Size: 0\n  Associativity: 16\n  "
+      "'Line-Size': 64\n  'Hit-Latency': 36\n  MSHRs: 32\n  'Write-Back': "
+      "1\n  'Write-Allocate': 1\n  'Replacement-Policy': LRU\n'Main-Memory':"
+      "\n  'Access-Latency': 100\nTLB:\n  'Page-Size': 4096\n  "
+      "'Instruction-Entries': 0\n  'Instruction-Associativity': 4\n  "
+      "'Data-Entries': 0\n  'Data-Associativity': 4\n  'L2-Entries': 0\n  "
+      "'L2-Associativity': 8\n  'L2-Latency': 8\n  'Page-Walk-Latency': "
+      "30\n'Data-Prefetcher':\n  'Next-Line': 0\n  "
+      "'Next-Line-Degree': 1\n  Stride: 0\n  'Stride-Table-Entries': 64\n  "
+      "'Stride-Degree': 2\n  Stream: 0\n  'Stream-Table-Entries': 16\n  "
+      "'Stream-Distance': 8\n  'Stream-Degree': 2\n'LSQ-L1-Interface':\n  "
+      "'Access-Latency': "
+      "4\n  Exclusive: 0\n  "
       "'Load-Bandwidth': 32\n  'Store-Bandwidth': 32\n  "
       "'Permitted-Requests-Per-Cycle': 1\n  'Permitted-Loads-Per-Cycle': 1\n  "
-      "'Permitted-Stores-Per-Cycle': 1\nPorts:\n  0:\n    Portname: 0\n    "
+      "'Permitted-Stores-Per-Cycle': 1\n'Memory-Dependence-Predictor':\n  "
+      "'Store-Set-ID-Entries': 0\n  'Store-Sets': 128\n  'Clear-Interval': "
+      "1000000\n'Micro-Op-Cache':\n  Entries: 0\n  Associativity: 8\n  "
+      "Width: 6\nPorts:\n  0:\n    Portname: 0\n    "
       "'Instruction-Group-Support':\n      - ALL\n    "
       "'Instruction-Opcode-Support':\n      - 450\n    "
       "'Instruction-Group-Support-Nums':\n      - "
@@ -125,7 +181,15 @@ TEST(ConfigTest, Default) {
       "/specialFiles/\n  'Core-Count': 1\n  'Socket-Count': 1\n  SMT: 1\n  "
       "BogoMIPS: 0\n  Features: ''\n  'CPU-Implementer': 0x0\n  "
       "'CPU-Architecture': 0\n  'CPU-Variant': 0x0\n  'CPU-Part': 0x0\n  "
-      "'CPU-Revision': 0\n  'Package-Count': 1\n";
+      "'CPU-Revision': 0\n  'Package-Count': 1\n  "
+      "'Host-Threads': 1\n  'Sync-Quantum': 1\nCheckpoint:\n  "
+      "'Save-Path': ''\n  'Save-At-Instruction': 0\n  'Restore-Path': "
+      "''\nSampling:\n  Mode: None\n  'Interval-Length': 10000000\n  "
+      "'Detail-Length': 10000\n  'Warmup-Length': 2000\n  "
+      "'Functional-Warming': 1\n  'SimPoint-File': "
+      "''\n  'Weights-File': ''\n  'BBV-Path': ''\n'Pipeline-Trace':\n  "
+      "Path: ''\n  Format: Konata\n  'Start-Cycle': 0\n  'Cycle-Count': 0\n  "
+      "'Start-Instruction': 0\n  'Instruction-Count': 100000\n";
   EXPECT_EQ(emittedConfig, expectedValues);
 }
 
@@ -178,6 +242,14 @@ TEST(ConfigTest, FailedExpectation) {
             "{Core: {Simulation-Mode: wrong}}");
       },
       "- Core:Simulation-Mode wrong not in set");
+  ASSERT_DEATH(
+      {
+        simeng::config::SimInfo::addToConfig(
+            "{Branch-Predictor: {Type: Perceptron, Global-History-Length: "
+            "65}}");
+      },
+      "- Branch-Predictor:Global-History-Length 65 not in the bounds \\{1 to "
+      "64\\}");
   ASSERT_DEATH(
       {
         simeng::config::SimInfo::addToConfig(
@@ -4,6 +4,7 @@
 
 #include "simeng/GenericPredictor.hh"
 #include "simeng/PerceptronPredictor.hh"
+#include "simeng/TagePredictor.hh"
 #include "simeng/config/SimInfo.hh"
 #include "simeng/kernel/Linux.hh"
 #include "simeng/kernel/LinuxProcess.hh"
@@ -104,6 +105,8 @@ void RegressionTest::run(const char* source, const char* triple,
     predictor_ = std::make_unique<simeng::GenericPredictor>();
   } else if (predictorType == "Perceptron") {
     predictor_ = std::make_unique<simeng::PerceptronPredictor>();
+  } else if (predictorType == "TAGE") {
+    predictor_ = std::make_unique<simeng::TagePredictor>();
   }
 
   // Create the core model
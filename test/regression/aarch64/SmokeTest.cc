@@ -68,4 +68,58 @@ INSTANTIATE_TEST_SUITE_P(
                                       "{Interface-Type: Fixed}}")),
     paramToString);
 
+using SelfModifyingCode = AArch64RegressionTest;
+
+// Test that overwriting previously executed code causes it to be re-decoded.
+// Only the emulation core writes memory before fetching beyond the store, so
+// the pipelined models are not tested here
+TEST_P(SelfModifyingCode, overwriteExecutedBlock) {
+  RUN_AARCH64(R"(
+    mov x3, #0
+    adr x1, patch
+    b patch
+  patch:
+    movz x0, #7
+    add x3, x3, #1
+    cmp x3, #2
+    b.eq done
+    # Overwrite the instruction at `patch` with `movz x0, #42`
+    movz w2, #0x0540
+    movk w2, #0xD280, lsl #16
+    str w2, [x1]
+    b patch
+  done:
+  )");
+  EXPECT_EQ(getGeneralRegister<uint64_t>(0), 42u);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(3), 2u);
+}
+
+// Test that overwriting a block leaves no stale link to it from the block
+// which previously led into it
+TEST_P(SelfModifyingCode, overwriteSuccessorBlock) {
+  RUN_AARCH64(R"(
+    mov x3, #0
+    adr x1, target
+  loop:
+    add x3, x3, #1
+    b target
+  target:
+    movz x0, #7
+    cmp x3, #3
+    b.eq done
+    # Overwrite the instruction at `target` with `movz x0, #42`
+    movz w2, #0x0540
+    movk w2, #0xD280, lsl #16
+    str w2, [x1]
+    b loop
+  done:
+  )");
+  EXPECT_EQ(getGeneralRegister<uint64_t>(0), 42u);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(3), 3u);
+}
+
+INSTANTIATE_TEST_SUITE_P(AArch64, SelfModifyingCode,
+                         ::testing::Values(std::make_tuple(EMULATION, "{}")),
+                         paramToString);
+
 }  // namespace
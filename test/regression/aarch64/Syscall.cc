@@ -893,6 +893,23 @@ TEST_P(Syscall, fstat) {
   EXPECT_EQ(getMemoryValue<uint32_t>(process_->getHeapStart() + 124), 0ull);
 }
 
+TEST_P(Syscall, exit) {
+  RUN_AARCH64(R"(
+    # exit(2)
+    mov x0, #2
+    mov x8, #93
+    svc #0
+    # The exiting thread must not execute any further instructions
+    mov x21, #5
+  )");
+  // Set reference for stdout
+  std::string str =
+      "\n[SimEng:ExceptionHandler] Received exit syscall: thread 0 "
+      "terminating with exit code 2";
+  EXPECT_EQ(stdout_.substr(0, str.size()), str);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(21), 0);
+}
+
 TEST_P(Syscall, exit_group) {
   RUN_AARCH64(R"(
     # exit_group(1)
@@ -926,9 +943,86 @@ TEST_P(Syscall, set_tid_address) {
   EXPECT_EQ(getGeneralRegister<int64_t>(21), 0);
 }
 
-// TODO: write futex test
+TEST_P(Syscall, futex) {
+  // Reserve 4 bytes for the futex word
+  initialHeapData_.resize(4);
+  RUN_AARCH64(R"(
+    # Get heap address
+    mov x0, 0
+    mov x8, 214
+    svc #0
+    mov x20, x0
+
+    # futex(uaddr=x20, op=FUTEX_WAIT_PRIVATE, val=1), which fails as the word
+    # holds 0
+    mov x0, x20
+    mov x1, #128
+    mov x2, #1
+    mov x3, #0
+    mov x8, #98
+    svc #0
+    mov x21, x0
+
+    # futex(uaddr=x20, op=FUTEX_WAIT_PRIVATE, val=0, timeout=x20), which
+    # returns at once as timeouts aren't modelled
+    mov x0, x20
+    mov x1, #128
+    mov x2, #0
+    mov x3, x20
+    mov x8, #98
+    svc #0
+    mov x22, x0
+
+    # futex(uaddr=x20, op=FUTEX_WAKE_PRIVATE, val=1), with no thread waiting
+    mov x0, x20
+    mov x1, #129
+    mov x2, #1
+    mov x8, #98
+    svc #0
+    mov x23, x0
+  )");
+  EXPECT_EQ(getGeneralRegister<int64_t>(21), -EAGAIN);
+  EXPECT_EQ(getGeneralRegister<int64_t>(22), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(23), 0);
+}
+
 // TODO: write set_robust_list test
 
+TEST_P(Syscall, clone) {
+  // Reserve 8 bytes for the parent and child tids
+  initialHeapData_.resize(8);
+  RUN_AARCH64(R"(
+    # Get heap address
+    mov x0, 0
+    mov x8, 214
+    svc #0
+    mov x20, x0
+
+    # clone(flags=CLONE_VM|CLONE_FS|CLONE_FILES|CLONE_SIGHAND|CLONE_THREAD|
+    #   CLONE_SYSVSEM|CLONE_PARENT_SETTID|CLONE_CHILD_CLEARTID, stack=0,
+    #   parent_tid=x20, tls=0, child_tid=x20+4)
+    mov x0, #0x0f00
+    movk x0, #0x35, lsl #16
+    mov x1, #0
+    mov x2, x20
+    mov x3, #0
+    add x4, x20, #4
+    mov x8, #220
+    svc #0
+    mov x21, x0
+
+    # clone(flags=CLONE_VM, ...) without CLONE_THREAD is unsupported
+    mov x0, #0x100
+    mov x8, #220
+    svc #0
+    mov x22, x0
+  )");
+  // The child thread is queued for an idle core; only the parent runs here
+  EXPECT_EQ(getGeneralRegister<int64_t>(21), 1);
+  EXPECT_EQ(getMemoryValue<uint32_t>(process_->getHeapStart()), 1);
+  EXPECT_EQ(getGeneralRegister<int64_t>(22), -ENOSYS);
+}
+
 TEST_P(Syscall, clock_gettime) {
   // Reserve 32 bytes for time data
   initialHeapData_.resize(32);
@@ -22,8 +22,10 @@ TEST_P(InstComparison, casal) {
     mov w1, #0xDE
     mov w2, #100
     casal w1, w2, [x0]
+    mov w5, w1
 
     # Values equal
+    mov w1, #0xDE
     add x3, x0, #4
     casal w1, w2, [x3]
 
@@ -37,6 +39,9 @@ TEST_P(InstComparison, casal) {
             0xDEADBEEF);
   EXPECT_EQ(getMemoryValue<uint32_t>(getGeneralRegister<uint64_t>(3)), 100);
   EXPECT_EQ(getMemoryValue<uint32_t>(process_->getInitialStackPointer()), 89);
+  // The first register is written with the value read from memory
+  EXPECT_EQ(getGeneralRegister<uint64_t>(5), 0xDEADBEEF);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(1), 0xDE);
 
   // 64-bit
   initialHeapData_.resize(16);
@@ -54,8 +59,10 @@ TEST_P(InstComparison, casal) {
     mov x1, #0x4F
     mov x2, #101
     casal x1, x2, [x0]
+    mov x5, x1
 
     # Values equal
+    mov x1, #0x4F
     add x3, x0, #8
     casal x1, x2, [x3]
 
@@ -69,6 +76,8 @@ TEST_P(InstComparison, casal) {
             0xDEADBEEF);
   EXPECT_EQ(getMemoryValue<uint64_t>(getGeneralRegister<uint64_t>(3)), 101);
   EXPECT_EQ(getMemoryValue<uint64_t>(process_->getInitialStackPointer()), 76);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(5), 0xDEADBEEF);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(1), 0x4F);
 }
 
 // Test that NZCV flags are set correctly by the 32-bit cmn instruction
@@ -0,0 +1,130 @@
+#include <zlib.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "simeng/BBVProfiler.hh"
+#include "simeng/CoreInstance.hh"
+#include "simeng/config/SimulationContext.hh"
+
+namespace simeng {
+
+// Counts down from 16 before calling exit_group
+static const uint32_t program[] = {
+    0x321C03E0,  // orr w0, wzr, #16
+    0x320003E1,  // orr w1, wzr, #1
+    0x71000400,  // subs w0, w0, #1
+    0x54FFFFC1,  // b.ne -8
+    0xD2800000,  // mov x0, #0
+    0xD2800BC8,  // mov x8, #94
+    0xD4000001,  // svc #0
+};
+
+class BBVProfilerTest : public testing::Test {
+ protected:
+  void TearDown() override { std::remove(path.c_str()); }
+
+  /** Read the lines of the file at `path`, decompressing it if needed. */
+  std::vector<std::string> readLines(const std::string& path) {
+    std::vector<std::string> lines;
+    gzFile file = gzopen(path.c_str(), "rb");
+    char buffer[256];
+    while (gzgets(file, buffer, sizeof(buffer)) != nullptr) {
+      lines.push_back(buffer);
+    }
+    gzclose(file);
+    return lines;
+  }
+
+  std::string path =
+      (std::filesystem::temp_directory_path() / "simeng_bbv_test.bb").string();
+};
+
+// Tests that each interval covers exactly the interval length, splitting blocks
+// across interval boundaries
+TEST_F(BBVProfilerTest, splitsIntervals) {
+  {
+    BBVProfiler profiler(path, 10);
+    profiler.record(0x100, 4);
+    profiler.record(0x200, 8);
+    EXPECT_EQ(profiler.getIntervalCount(), 1);
+    profiler.record(0x100, 3);
+  }
+  auto lines = readLines(path);
+  ASSERT_EQ(lines.size(), 2);
+  EXPECT_EQ(lines[0], "T:1:4 :2:6 \n");
+  EXPECT_EQ(lines[1], "T:2:2 :1:3 \n");
+
+  // Uncompressed output is plain text
+  std::ifstream file(path);
+  std::string first;
+  std::getline(file, first);
+  EXPECT_EQ(first, "T:1:4 :2:6 ");
+}
+
+// Tests that a `.gz` output path produces gzip compressed output
+TEST_F(BBVProfilerTest, compressed) {
+  path += ".gz";
+  {
+    BBVProfiler profiler(path, 4);
+    profiler.record(0x100, 4);
+  }
+  // Check for the gzip magic number
+  std::ifstream file(path, std::ios::binary);
+  unsigned char magic[2] = {0, 0};
+  file.read(reinterpret_cast<char*>(magic), 2);
+  EXPECT_EQ(magic[0], 0x1F);
+  EXPECT_EQ(magic[1], 0x8B);
+
+  auto lines = readLines(path);
+  ASSERT_EQ(lines.size(), 1);
+  EXPECT_EQ(lines[0], "T:1:4 \n");
+}
+
+// Tests that the emulation core profiles every instruction it executes
+TEST_F(BBVProfilerTest, emulationCore) {
+  config::SimulationContext context;
+  context.addToConfig(
+      "{Core: {Simulation-Mode: emulation}, Sampling: {Interval-Length: 10, "
+      "BBV-Path: " +
+      path + "}}");
+
+  uint64_t retired = 0;
+  {
+    // The core instance takes ownership of the source buffer
+    char* source = new char[sizeof(program)];
+    std::memcpy(source, program, sizeof(program));
+    CoreInstance instance(source, sizeof(program), context.getConfig());
+    while (!instance.hasHalted()) {
+      instance.getCore()->tick();
+      instance.getInstructionMemory()->tick();
+      instance.getDataMemory()->tick();
+    }
+    retired = instance.getCore()->getInstructionsRetiredCount();
+  }
+
+  auto lines = readLines(path);
+  EXPECT_EQ(lines.size(), (retired + 9) / 10);
+
+  // The entry sequence, the loop body and the exit sequence form three blocks
+  uint64_t total = 0;
+  uint64_t blocks = 0;
+  for (const auto& line : lines) {
+    std::istringstream fields(line.substr(1));
+    char colon;
+    uint64_t id;
+    uint64_t count;
+    while (fields >> colon >> id >> colon >> count) {
+      total += count;
+      blocks = std::max(blocks, id);
+    }
+  }
+  EXPECT_EQ(total, retired);
+  EXPECT_EQ(blocks, 3);
+}
+
+}  // namespace simeng
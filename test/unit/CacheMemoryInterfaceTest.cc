@@ -0,0 +1,302 @@
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "simeng/CoreInstance.hh"
+#include "simeng/config/SimulationContext.hh"
+#include "simeng/memory/CacheMemoryInterface.hh"
+
+namespace simeng {
+namespace memory {
+
+class CacheMemoryInterfaceTest : public testing::Test {
+ protected:
+  /** Create a cache with the given geometry and timing, backed by `nextLevel`
+   * or by main memory with a latency of `memoryLatency`. */
+  std::shared_ptr<Cache> createCache(const std::string& name, uint64_t size,
+                                     uint16_t associativity, uint16_t latency,
+                                     uint16_t mshrs,
+                                     std::shared_ptr<Cache> nextLevel,
+                                     const std::string& options = "") {
+    ryml::Tree tree = ryml::parse_in_arena(ryml::to_csubstr(
+        "{Size: " + std::to_string(size) +
+        ", Associativity: " + std::to_string(associativity) +
+        ", Line-Size: 64, Hit-Latency: " + std::to_string(latency) +
+        ", MSHRs: " + std::to_string(mshrs) +
+        (options.empty() ? ", Write-Back: true, Write-Allocate: true, "
+                           "Replacement-Policy: LRU}"
+                         : ", " + options + "}")));
+    return std::make_shared<Cache>(name, tree.crootref(), nextLevel,
+                                   memoryLatency);
+  }
+
+  /** Tick `memory` until it has no pending requests, returning the number of
+   * ticks taken. */
+  uint64_t drain(MemoryInterface& memory) {
+    uint64_t ticks = 0;
+    while (memory.hasPendingRequests()) {
+      memory.tick();
+      ticks++;
+    }
+    return ticks;
+  }
+
+  static constexpr uint16_t memoryLatency = 10;
+
+  std::array<char, 4096> memoryData = {};
+};
+
+// Tests that a miss waits for main memory, after which the line hits
+TEST_F(CacheMemoryInterfaceTest, missThenHit) {
+  std::memcpy(memoryData.data() + 8, "\xEF\xBE\xAD\xDE", 4);
+  CacheMemoryInterface memory(memoryData.data(), memoryData.size(),
+                              createCache("l1d", 1024, 2, 2, 4, nullptr));
+
+  memory.requestRead({8, 4}, 1);
+  EXPECT_EQ(drain(memory), 2 + memoryLatency);
+  auto entries = memory.getCompletedReads();
+  ASSERT_EQ(entries.size(), 1);
+  EXPECT_EQ(entries[0].requestId, 1);
+  EXPECT_EQ(entries[0].data, RegisterValue(0xDEADBEEF, 4));
+  memory.clearCompletedReads();
+
+  // Another address on the same line hits
+  memory.requestRead({60, 4}, 2);
+  EXPECT_EQ(drain(memory), 2);
+
+  auto stats = memory.getStats();
+  EXPECT_EQ(stats["l1d.hits"], "1");
+  EXPECT_EQ(stats["l1d.misses"], "1");
+}
+
+// Tests that an access spanning two lines completes once both are available
+TEST_F(CacheMemoryInterfaceTest, splitAccess) {
+  CacheMemoryInterface memory(memoryData.data(), memoryData.size(),
+                              createCache("l1d", 1024, 2, 2, 4, nullptr));
+  memory.requestRead({60, 8});
+  EXPECT_EQ(drain(memory), 2 + memoryLatency);
+  EXPECT_EQ(memory.getStats()["l1d.misses"], "2");
+}
+
+// Tests that accesses to a line whose fill is outstanding complete with it
+TEST_F(CacheMemoryInterfaceTest, mshrHit) {
+  CacheMemoryInterface memory(memoryData.data(), memoryData.size(),
+                              createCache("l1d", 1024, 2, 2, 4, nullptr));
+  memory.requestRead({0, 8}, 1);
+  memory.tick();
+  memory.requestRead({8, 8}, 2);
+  EXPECT_EQ(drain(memory), 2 + memoryLatency - 1);
+  EXPECT_EQ(memory.getCompletedReads().size(), 2);
+
+  auto stats = memory.getStats();
+  EXPECT_EQ(stats["l1d.misses"], "1");
+  EXPECT_EQ(stats["l1d.mshrHits"], "1");
+}
+
+// Tests that misses beyond the number of MSHRs wait for one to become free
+TEST_F(CacheMemoryInterfaceTest, mshrLimit) {
+  CacheMemoryInterface memory(memoryData.data(), memoryData.size(),
+                              createCache("l1d", 1024, 2, 2, 1, nullptr));
+  memory.requestRead({0, 8}, 1);
+  memory.requestRead({64, 8}, 2);
+
+  uint64_t ticks = 0;
+  while (memory.getCompletedReads().size() == 0) {
+    memory.tick();
+    ticks++;
+  }
+  EXPECT_EQ(ticks, 2 + memoryLatency);
+  EXPECT_EQ(memory.getCompletedReads()[0].requestId, 1);
+  EXPECT_EQ(ticks + drain(memory), 2 * (2 + memoryLatency) - 2);
+  EXPECT_EQ(memory.getStats()["l1d.mshrStalls"], "1");
+}
+
+// Tests that an L1 miss which hits in the L2 takes the L2's latency
+TEST_F(CacheMemoryInterfaceTest, hierarchy) {
+  auto l2 = createCache("l2", 4096, 4, 6, 4, nullptr);
+  CacheMemoryInterface memory(memoryData.data(), memoryData.size(),
+                              createCache("l1d", 128, 2, 2, 4, l2));
+
+  // Fill both L1 ways of the single set, then evict the first line
+  for (uint64_t address : {0, 64, 128}) {
+    memory.requestRead({address, 8});
+    EXPECT_EQ(drain(memory), 2 + 6 + memoryLatency);
+  }
+  memory.requestRead({0, 8});
+  EXPECT_EQ(drain(memory), 2 + 6);
+
+  auto stats = memory.getStats();
+  EXPECT_EQ(stats["l1d.misses"], "4");
+  EXPECT_EQ(stats["l2.misses"], "3");
+  EXPECT_EQ(stats["l2.hits"], "1");
+}
+
+// Tests that the LRU and FIFO policies choose the expected victims
+TEST_F(CacheMemoryInterfaceTest, replacementPolicy) {
+  for (std::string policy : {"LRU", "FIFO"}) {
+    auto cache = createCache(
+        "l1d", 128, 2, 1, 4, nullptr,
+        "Write-Back: true, Write-Allocate: true, Replacement-Policy: " +
+            policy);
+    uint64_t cycle = 0;
+    for (uint64_t address : {0, 64, 0, 128, 0}) {
+      cycle = cache->access(address, false, cycle);
+    }
+
+    std::map<std::string, std::string> stats;
+    cache->getStats(stats);
+    // LRU evicts line 64, keeping the recently used line 0; FIFO evicts line 0
+    // as the first filled
+    EXPECT_EQ(stats["l1d.hits"], policy == "LRU" ? "2" : "1") << policy;
+  }
+}
+
+// Tests that dirty lines are written back when evicted, and that writes are
+// visible to later reads
+TEST_F(CacheMemoryInterfaceTest, writeBack) {
+  auto l2 = createCache("l2", 4096, 4, 6, 4, nullptr);
+  CacheMemoryInterface memory(memoryData.data(), memoryData.size(),
+                              createCache("l1d", 128, 2, 2, 4, l2));
+
+  memory.requestWrite({0, 4}, RegisterValue(0xDEADBEEF, 4));
+  memory.requestRead({0, 4}, 1);
+  drain(memory);
+  ASSERT_EQ(memory.getCompletedReads().size(), 1);
+  EXPECT_EQ(memory.getCompletedReads()[0].data, RegisterValue(0xDEADBEEF, 4));
+
+  memory.requestRead({64, 4});
+  memory.requestRead({128, 4});
+  drain(memory);
+  auto stats = memory.getStats();
+  EXPECT_EQ(stats["l1d.writebacks"], "1");
+  // The written back line is still held by the L2
+  EXPECT_EQ(stats["l2.hits"], "1");
+}
+
+// Tests that a write-through, no-write-allocate cache passes writes to the
+// level below without allocating them
+TEST_F(CacheMemoryInterfaceTest, writeThrough) {
+  auto l2 = createCache("l2", 4096, 4, 6, 4, nullptr);
+  CacheMemoryInterface memory(
+      memoryData.data(), memoryData.size(),
+      createCache("l1d", 128, 2, 2, 4, l2,
+                  "Write-Back: false, Write-Allocate: false, "
+                  "Replacement-Policy: LRU"));
+
+  memory.requestWrite({0, 4}, RegisterValue(0xDEADBEEF, 4));
+  EXPECT_EQ(drain(memory), 2);
+  // Wait for the L2 to allocate the written line
+  for (int i = 0; i < 6 + memoryLatency; i++) memory.tick();
+  memory.requestRead({0, 4});
+  EXPECT_EQ(drain(memory), 2 + 6);
+
+  auto stats = memory.getStats();
+  EXPECT_EQ(stats["l1d.misses"], "2");
+  EXPECT_EQ(stats["l1d.writebacks"], "0");
+  EXPECT_EQ(stats["l2.misses"], "1");
+  EXPECT_EQ(stats["l2.hits"], "1");
+}
+
+// Tests that warming fills lines through the hierarchy without timing or
+// counting the accesses, evicting dirty lines as a demand access would
+TEST_F(CacheMemoryInterfaceTest, warm) {
+  auto l2 = createCache("l2", 4096, 4, 6, 4, nullptr);
+  CacheMemoryInterface memory(memoryData.data(), memoryData.size(),
+                              createCache("l1d", 128, 2, 2, 4, l2));
+
+  // Warmed lines are held immediately, and an access spanning two lines
+  // warms both
+  memory.warm(0, {60, 8}, true);
+  EXPECT_FALSE(memory.hasPendingRequests());
+  memory.requestRead({0, 4});
+  memory.requestRead({64, 4});
+  EXPECT_EQ(drain(memory), 2);
+
+  // Evicting the dirty line leaves it in the L2
+  memory.warm(0, {128, 4}, false);
+  memory.warm(0, {256, 4}, false);
+  memory.requestRead({0, 4});
+  EXPECT_EQ(drain(memory), 2 + 6);
+
+  auto stats = memory.getStats();
+  EXPECT_EQ(stats["l1d.hits"], "2");
+  EXPECT_EQ(stats["l1d.misses"], "1");
+  EXPECT_EQ(stats["l1d.writebacks"], "0");
+  EXPECT_EQ(stats["l2.hits"], "1");
+  EXPECT_EQ(stats["l2.misses"], "0");
+
+  // Accesses beyond the process memory are ignored
+  memory.warm(0, {memoryData.size() - 2, 4}, false);
+  EXPECT_EQ(memory.getStats(), stats);
+}
+
+// Tests that the interface reports the ticks before its earliest request
+// completes, and that skipping them leaves the request to complete on the next
+// tick
+TEST_F(CacheMemoryInterfaceTest, idleTicks) {
+  auto cache = createCache("l1d", 1024, 2, 2, 4, nullptr);
+  CacheMemoryInterface memory(memoryData.data(), memoryData.size(), cache);
+  EXPECT_EQ(memory.getIdleTicks(), UINT64_MAX);
+
+  memory.requestRead({0, 8}, 1);
+  EXPECT_EQ(memory.getIdleTicks(), 2 + memoryLatency - 1);
+  memory.tick();
+  memory.requestRead({64, 8}, 2);
+  EXPECT_EQ(memory.getIdleTicks(), 2 + memoryLatency - 2);
+
+  memory.skipTicks(2 + memoryLatency - 2);
+  EXPECT_EQ(memory.getIdleTicks(), 0);
+  memory.tick();
+  ASSERT_EQ(memory.getCompletedReads().size(), 1);
+  EXPECT_EQ(memory.getCompletedReads()[0].requestId, 1);
+  // The second read completes on the following tick
+  EXPECT_EQ(memory.getIdleTicks(), 0);
+  memory.tick();
+  EXPECT_EQ(memory.getCompletedReads().size(), 2);
+  EXPECT_EQ(memory.getIdleTicks(), UINT64_MAX);
+}
+
+// Tests that an outoforder core runs correctly through cache hierarchies on
+// both the instruction and data sides, reporting their statistics
+TEST_F(CacheMemoryInterfaceTest, coreInstance) {
+  // Counts down from 64 before calling exit_group
+  const uint32_t program[] = {
+      0x321A03E0,  // orr w0, wzr, #64
+      0xF81F0FE0,  // str x0, [sp, #-16]!
+      0xF94003E1,  // ldr x1, [sp]
+      0x71000400,  // subs w0, w0, #1
+      0x54FFFFC1,  // b.ne -8
+      0xD2800000,  // mov x0, #0
+      0xD2800BC8,  // mov x8, #94
+      0xD4000001,  // svc #0
+  };
+
+  config::SimulationContext context;
+  context.addToConfig(
+      "{Core: {Simulation-Mode: outoforder}, L1-Data-Memory: {Interface-Type: "
+      "Cache, Size: 1024, Associativity: 2}, L1-Instruction-Memory: "
+      "{Interface-Type: Cache, Size: 1024, Associativity: 2}, L2-Cache: {Size: "
+      "8192}, Last-Level-Cache: {Size: 65536}}");
+
+  // The core instance takes ownership of the source buffer
+  char* source = new char[sizeof(program)];
+  std::memcpy(source, program, sizeof(program));
+  CoreInstance instance(source, sizeof(program), context.getConfig());
+  auto core = instance.getCore();
+  while (!instance.hasHalted() ||
+         instance.getDataMemory()->hasPendingRequests()) {
+    core->tick();
+    instance.getInstructionMemory()->tick();
+    instance.getDataMemory()->tick();
+  }
+
+  auto stats = core->getStats();
+  EXPECT_EQ(stats["retired"], std::to_string(2 + 3 * 64 + 3));
+  EXPECT_GT(std::stoull(stats["l1i.misses"]), 0);
+  EXPECT_GT(std::stoull(stats["l1d.hits"]), 0);
+  EXPECT_GT(std::stoull(stats["l2.misses"]), 0);
+  EXPECT_GT(std::stoull(stats["llc.misses"]), 0);
+}
+
+}  // namespace memory
+}  // namespace simeng
@@ -0,0 +1,110 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#include "ConfigInit.hh"
+#include "gtest/gtest.h"
+#include "simeng/Checkpoint.hh"
+#include "simeng/CoreInstance.hh"
+#include "simeng/config/SimulationContext.hh"
+
+namespace simeng {
+
+// Counts down from 16 before calling exit_group
+static const uint32_t program[] = {
+    0x321C03E0,  // orr w0, wzr, #16
+    0x320003E1,  // orr w1, wzr, #1
+    0x71000400,  // subs w0, w0, #1
+    0x54FFFFC1,  // b.ne -8
+    0xD2800000,  // mov x0, #0
+    0xD2800BC8,  // mov x8, #94
+    0xD4000001,  // svc #0
+};
+
+class CheckpointTest : public testing::Test {
+ protected:
+  void TearDown() override { std::remove(path.c_str()); }
+
+  /** Create a core instance running `program`. */
+  std::unique_ptr<CoreInstance> createCoreInstance() {
+    // The core instance takes ownership of the source buffer
+    char* source = new char[sizeof(program)];
+    std::memcpy(source, program, sizeof(program));
+    return std::make_unique<CoreInstance>(source, sizeof(program));
+  }
+
+  /** Tick every core and memory interface of `instance` for one cycle. */
+  void tick(CoreInstance& instance) {
+    for (const auto& core : instance.getCores()) core->tick();
+    for (size_t i = 0; i < instance.getCores().size(); i++) {
+      instance.getInstructionMemory(i)->tick();
+      instance.getDataMemory(i)->tick();
+    }
+    instance.scheduleThreads();
+  }
+
+  /** Tick `instance` until it halts. */
+  void run(CoreInstance& instance) {
+    while (!instance.hasHalted()) tick(instance);
+  }
+
+  ConfigInit configInit = ConfigInit(config::ISA::AArch64, "{}");
+
+  std::string path = (std::filesystem::temp_directory_path() /
+                      "simeng_checkpoint_test.ckpt")
+                         .string();
+};
+
+// Tests that a restored simulation completes the remainder of the program
+TEST_F(CheckpointTest, restoreResumesExecution) {
+  auto full = createCoreInstance();
+  run(*full);
+  uint64_t totalRetired = full->getCore()->getInstructionsRetiredCount();
+
+  auto original = createCoreInstance();
+  for (int i = 0; i < 8; i++) tick(*original);
+  while (!original->saveCheckpoint(path)) tick(*original);
+  uint64_t retiredBefore = original->getCore()->getInstructionsRetiredCount();
+  EXPECT_GT(retiredBefore, 0);
+  EXPECT_LT(retiredBefore, totalRetired);
+
+  CheckpointReader checkpoint(path);
+  EXPECT_EQ(checkpoint.getISA(), "AArch64");
+  CoreInstance restored(checkpoint);
+  run(restored);
+  EXPECT_EQ(retiredBefore + restored.getCore()->getInstructionsRetiredCount(),
+            totalRetired);
+}
+
+// Tests that a checkpoint taken in emulation mode can be restored into an
+// out-of-order core, and that restoring leaves the checkpoint unmodified
+TEST_F(CheckpointTest, restoreIntoOutOfOrderCore) {
+  auto original = createCoreInstance();
+  for (int i = 0; i < 8; i++) tick(*original);
+  while (!original->saveCheckpoint(path)) tick(*original);
+  uint64_t retiredBefore = original->getCore()->getInstructionsRetiredCount();
+
+  config::SimulationContext outoforder;
+  outoforder.generateDefault(config::ISA::AArch64, true);
+  outoforder.addToConfig("{Core: {Simulation-Mode: outoforder}}");
+
+  std::vector<uint64_t> retiredAfter;
+  for (int i = 0; i < 2; i++) {
+    CheckpointReader checkpoint(path);
+    CoreInstance restored(checkpoint, outoforder.getConfig());
+    run(restored);
+    retiredAfter.push_back(restored.getCore()->getInstructionsRetiredCount());
+
+    // Registers set before the checkpoint was taken are restored
+    EXPECT_EQ(restored.getCore()
+                  ->getArchitecturalRegisterFileSet()
+                  .get({0, 1})
+                  .get<uint64_t>(),
+              1);
+  }
+  EXPECT_GT(retiredBefore, 0);
+  EXPECT_GT(retiredAfter[0], 0);
+  EXPECT_EQ(retiredAfter[0], retiredAfter[1]);
+}
+
+}  // namespace simeng
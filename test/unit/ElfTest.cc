@@ -21,13 +21,11 @@ class ElfTest : public testing::Test {
   const uint16_t known_e_phnum = 6;
   const uint64_t known_phdrTableAddress = 4194368;
   const uint64_t known_processImageSize = 5040480;
-
-  char* unwrappedProcImgPtr;
 };
 
 // Test that a valid ELF file can be created
 TEST_F(ElfTest, validElf) {
-  Elf elf(knownElfFilePath, &unwrappedProcImgPtr);
+  Elf elf(knownElfFilePath);
 
   EXPECT_TRUE(elf.isValid());
   EXPECT_EQ(elf.getEntryPoint(), known_entryPoint);
@@ -39,15 +37,14 @@ TEST_F(ElfTest, validElf) {
 
 // Test that wrong filepath results in invalid ELF
 TEST_F(ElfTest, invalidElf) {
-  Elf elf(SIMENG_SOURCE_DIR "/test/bogus_file_path___--__--__",
-          &unwrappedProcImgPtr);
+  Elf elf(SIMENG_SOURCE_DIR "/test/bogus_file_path___--__--__");
   EXPECT_FALSE(elf.isValid());
 }
 
 // Test that non-ELF file is not accepted
 TEST_F(ElfTest, nonElf) {
   testing::internal::CaptureStderr();
-  Elf elf(SIMENG_SOURCE_DIR "/test/unit/ElfTest.cc", &unwrappedProcImgPtr);
+  Elf elf(SIMENG_SOURCE_DIR "/test/unit/ElfTest.cc");
   EXPECT_FALSE(elf.isValid());
   EXPECT_THAT(testing::internal::GetCapturedStderr(),
               HasSubstr("[SimEng:Elf] Elf magic does not match"));
@@ -56,8 +53,7 @@ TEST_F(ElfTest, nonElf) {
 // Check that 32-bit ELF is not accepted
 TEST_F(ElfTest, format32Elf) {
   testing::internal::CaptureStderr();
-  Elf elf(SIMENG_SOURCE_DIR "/test/unit/data/stream.rv32ima.elf",
-          &unwrappedProcImgPtr);
+  Elf elf(SIMENG_SOURCE_DIR "/test/unit/data/stream.rv32ima.elf");
   EXPECT_FALSE(elf.isValid());
   EXPECT_THAT(
       testing::internal::GetCapturedStderr(),
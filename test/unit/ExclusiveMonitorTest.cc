@@ -0,0 +1,126 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "simeng/memory/ExclusiveMonitor.hh"
+
+namespace {
+
+class ExclusiveMonitorTest : public testing::Test {
+ public:
+  ExclusiveMonitorTest() : monitor(memoryData.data(), memorySize, 2) {}
+
+ protected:
+  static constexpr uint16_t memorySize = 256;
+  alignas(8) std::array<char, memorySize> memoryData = {};
+
+  /** Read the 32-bit value at `address`. */
+  uint32_t read(uint64_t address) {
+    return *reinterpret_cast<uint32_t*>(memoryData.data() + address);
+  }
+
+  simeng::RegisterValue zero = {0u, 4};
+  simeng::RegisterValue value = {0xDEADBEEF, 4};
+  simeng::memory::MemoryAccessTarget target = {0, 4};
+
+  const std::string writeOverflowStr =
+      "Attempted to write beyond memory limit.";
+
+  simeng::memory::ExclusiveMonitor monitor;
+};
+
+// Test that a store succeeds while its reservation is held, and clears it.
+TEST_F(ExclusiveMonitorTest, StoreHoldingReservation) {
+  EXPECT_FALSE(monitor.holdsReservation(0, target));
+  monitor.reserve(0, target, zero);
+  EXPECT_TRUE(monitor.holdsReservation(0, target));
+  EXPECT_FALSE(monitor.holdsReservation(1, target));
+
+  EXPECT_TRUE(monitor.store(0, target, value));
+  EXPECT_EQ(read(0), 0xDEADBEEF);
+  EXPECT_FALSE(monitor.holdsReservation(0, target));
+
+  // Without a reservation, nothing is written
+  EXPECT_FALSE(monitor.store(0, target, zero));
+  EXPECT_EQ(read(0), 0xDEADBEEF);
+}
+
+// Test that a store recorded by another core to the same granule clears a
+// reservation, while stores by the same core or to other granules don't.
+TEST_F(ExclusiveMonitorTest, RecordedStores) {
+  monitor.reserve(0, target, zero);
+  monitor.recordStore(0, {8, 4});
+  monitor.recordStore(1, {64, 4});
+  EXPECT_TRUE(monitor.holdsReservation(0, target));
+
+  // A store spanning into the reserved granule clears it
+  monitor.recordStore(1, {60, 8});
+  EXPECT_FALSE(monitor.holdsReservation(0, target));
+  EXPECT_FALSE(monitor.store(0, target, value));
+  EXPECT_EQ(read(0), 0u);
+}
+
+// Test that a store fails if the memory no longer holds the value reserved,
+// as when written by another core before the store was recorded.
+TEST_F(ExclusiveMonitorTest, ValueChanged) {
+  monitor.reserve(0, target, zero);
+  memoryData[1] = 1;
+  EXPECT_FALSE(monitor.store(0, target, value));
+  EXPECT_EQ(read(0), 0x100u);
+  EXPECT_FALSE(monitor.holdsReservation(0, target));
+}
+
+// Test that a successful store clears other cores' reservations of the
+// granule, so only one of two competing stores succeeds.
+TEST_F(ExclusiveMonitorTest, CompetingStores) {
+  monitor.reserve(0, target, zero);
+  monitor.reserve(1, {4, 4}, zero);
+  EXPECT_TRUE(monitor.store(0, target, value));
+  EXPECT_FALSE(monitor.holdsReservation(1, {4, 4}));
+  EXPECT_FALSE(monitor.store(1, {4, 4}, value));
+  EXPECT_EQ(read(4), 0u);
+}
+
+// Test that an unaligned store compares and writes every byte.
+TEST_F(ExclusiveMonitorTest, UnalignedStore) {
+  monitor.reserve(0, {2, 4}, zero);
+  EXPECT_TRUE(monitor.store(0, {2, 4}, value));
+  EXPECT_EQ(read(0), 0xBEEF0000);
+  EXPECT_EQ(read(4), 0xDEADu);
+}
+
+// Test that clearing a core's reservation makes its store fail.
+TEST_F(ExclusiveMonitorTest, ClearReservation) {
+  monitor.reserve(1, target, zero);
+  monitor.clearReservation(1);
+  EXPECT_FALSE(monitor.holdsReservation(1, target));
+  EXPECT_FALSE(monitor.store(1, target, value));
+}
+
+// Test that cores incrementing a shared counter with retried exclusive
+// load/store pairs lose no increments.
+TEST_F(ExclusiveMonitorTest, ConcurrentIncrements) {
+  constexpr uint32_t increments = 10000;
+  auto increment = [&](uint16_t core) {
+    for (uint32_t i = 0; i < increments; i++) {
+      bool written = false;
+      while (!written) {
+        uint32_t current = __atomic_load_n(
+            reinterpret_cast<uint32_t*>(memoryData.data()), __ATOMIC_RELAXED);
+        monitor.reserve(core, target, {current, 4});
+        written = monitor.store(core, target, {current + 1, 4});
+      }
+    }
+  };
+  std::thread other(increment, 1);
+  increment(0);
+  other.join();
+  EXPECT_EQ(read(0), 2 * increments);
+}
+
+// Test that out-of-bounds stores are correctly handled.
+TEST_F(ExclusiveMonitorTest, OutOfBoundsStore) {
+  ASSERT_DEATH(monitor.store(0, {memorySize - 2, 4}, value),
+               writeOverflowStr);
+}
+
+}  // namespace
@@ -69,6 +69,17 @@ TEST_P(FixedLatencyMemoryInterfaceTest, FixedWriteData) {
   EXPECT_EQ(reinterpret_cast<uint32_t*>(memoryData.data())[0], 0xDEADBEEF);
 }
 
+// Test that a write without data takes n cycles but leaves memory untouched.
+TEST_P(FixedLatencyMemoryInterfaceTest, TimingOnlyWrite) {
+  memory.requestWrite(target, simeng::RegisterValue());
+  EXPECT_TRUE(memory.hasPendingRequests());
+
+  uint16_t latency = GetParam();
+  for (int n = 0; n < latency; n++) memory.tick();
+  EXPECT_FALSE(memory.hasPendingRequests());
+  EXPECT_EQ(reinterpret_cast<uint32_t*>(memoryData.data())[0], 0xABBACAFE);
+}
+
 // Test that out-of-bounds memory reads are correctly handled.
 TEST_P(FixedLatencyMemoryInterfaceTest, OutofBoundsRead) {
   // Create a target such that address + size will overflow
@@ -134,6 +145,34 @@ TEST_P(FixedLatencyMemoryInterfaceTest, OutofBoundsWrite_2) {
   ASSERT_DEATH(memory.tick(), writeOverflowStr);
 }
 
+// Test that the backing memory isn't exposed for direct access, as requests
+// don't complete with zero latency.
+TEST_P(FixedLatencyMemoryInterfaceTest, NoDirectMemory) {
+  EXPECT_TRUE(memory.getDirectMemory().empty());
+}
+
+// Test that the interface reports the ticks before its next request completes,
+// and that skipping them leaves the request to complete on the next tick.
+TEST_P(FixedLatencyMemoryInterfaceTest, IdleTicks) {
+  EXPECT_EQ(memory.getIdleTicks(), UINT64_MAX);
+
+  uint16_t latency = GetParam();
+  memory.requestRead(target, 1);
+  memory.tick();
+  memory.requestWrite(target, value);
+  EXPECT_EQ(memory.getIdleTicks(), latency - 2);
+
+  memory.skipTicks(latency - 2);
+  EXPECT_EQ(memory.getIdleTicks(), 0);
+  memory.tick();
+  EXPECT_EQ(memory.getCompletedReads().size(), 1);
+  // The write completes a tick after the read
+  EXPECT_EQ(memory.getIdleTicks(), 0);
+  memory.tick();
+  EXPECT_FALSE(memory.hasPendingRequests());
+  EXPECT_EQ(memory.getIdleTicks(), UINT64_MAX);
+}
+
 INSTANTIATE_TEST_SUITE_P(FixedLatencyMemoryInterfaceTests,
                          FixedLatencyMemoryInterfaceTest,
                          ::testing::Values<uint16_t>(2, 4));
@@ -42,6 +42,17 @@ TEST_F(FlatMemoryInterfaceTest, FixedWriteData) {
   EXPECT_EQ(reinterpret_cast<uint32_t*>(memoryData.data())[0], 0xDEADBEEF);
 }
 
+// Test that the backing memory is exposed for direct access.
+TEST_F(FlatMemoryInterfaceTest, DirectMemory) {
+  auto direct = memory.getDirectMemory();
+  EXPECT_EQ(direct.data(), memoryData.data());
+  EXPECT_EQ(direct.size(), memorySize);
+
+  // Writes through the interface are visible through direct access
+  memory.requestWrite(target, value);
+  EXPECT_EQ(reinterpret_cast<uint32_t*>(direct.data())[0], 0xDEADBEEF);
+}
+
 // Test that out-of-bounds memory reads are correctly handled.
 TEST_F(FlatMemoryInterfaceTest, OutofBoundsRead) {
   // Create a target such that address + size will overflow
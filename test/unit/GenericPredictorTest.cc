@@ -12,7 +12,7 @@ class GenericPredictorTest : public testing::Test {
 
  protected:
   MockInstruction* uop;
-  std::shared_ptr<Instruction> uopPtr;
+  IntrusivePtr<Instruction> uopPtr;
 };
 
 // Tests that a GenericPredictor will predict the correct direction on a
@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "simeng/IntrusivePtr.hh"
+
+namespace {
+
+using simeng::IntrusivePtr;
+using simeng::makeIntrusive;
+
+/** A counted object recording its destruction. */
+class Counted : public simeng::RefCounted {
+ public:
+  Counted(int& destroyed) : destroyed_(destroyed) {}
+  virtual ~Counted() { destroyed_++; }
+
+ private:
+  int& destroyed_;
+};
+
+class DerivedCounted : public Counted {
+ public:
+  using Counted::Counted;
+};
+
+// Tests that an object is deleted once its last handle is dropped
+TEST(IntrusivePtrTest, DeletedWithLastReference) {
+  int destroyed = 0;
+  auto first = makeIntrusive<Counted>(destroyed);
+  EXPECT_EQ(first.use_count(), 1);
+
+  IntrusivePtr<Counted> second = first;
+  EXPECT_EQ(first.use_count(), 2);
+  EXPECT_EQ(second, first);
+
+  first.reset();
+  EXPECT_FALSE(first);
+  EXPECT_EQ(first, nullptr);
+  EXPECT_EQ(second.use_count(), 1);
+  EXPECT_EQ(destroyed, 0);
+
+  // Assigning a handle to itself keeps the object alive
+  second = *&second;
+  EXPECT_EQ(destroyed, 0);
+
+  second = nullptr;
+  EXPECT_EQ(destroyed, 1);
+}
+
+// Tests that moving a handle transfers its reference, and that a handle to a
+// derived object converts to one to its base
+TEST(IntrusivePtrTest, MoveAndConvert) {
+  int destroyed = 0;
+  auto derived = makeIntrusive<DerivedCounted>(destroyed);
+  IntrusivePtr<Counted> base = derived;
+  EXPECT_EQ(base.use_count(), 2);
+
+  IntrusivePtr<Counted> moved = std::move(derived);
+  EXPECT_FALSE(derived);
+  EXPECT_EQ(moved.use_count(), 2);
+  EXPECT_EQ(moved.get(), base.get());
+
+  base = std::move(moved);
+  EXPECT_EQ(base.use_count(), 1);
+  base.reset();
+  EXPECT_EQ(destroyed, 1);
+}
+
+// Tests that a handle may be taken from a raw pointer to an object others
+// already reference, and that copies of an object start unreferenced
+TEST(IntrusivePtrTest, RawPointerAndCopies) {
+  int destroyed = 0;
+  Counted* raw = new Counted(destroyed);
+  IntrusivePtr<Counted> first(raw);
+  IntrusivePtr<Counted> second(raw);
+  EXPECT_EQ(first.use_count(), 2);
+
+  auto copy = makeIntrusive<Counted>(*first);
+  EXPECT_EQ(copy.use_count(), 1);
+  EXPECT_EQ(first.use_count(), 2);
+
+  first.reset();
+  second.reset();
+  EXPECT_EQ(destroyed, 1);
+  copy.reset();
+  EXPECT_EQ(destroyed, 2);
+}
+
+}  // namespace
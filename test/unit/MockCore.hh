@@ -13,6 +13,8 @@ class MockCore : public Core {
       : Core(dataMemory, isa, regFileStructure) {}
   MOCK_METHOD0(tick, void());
   MOCK_CONST_METHOD0(hasHalted, bool());
+  MOCK_METHOD3(schedule, void(int64_t tid, uint64_t pc,
+                              const arch::ProcessStateChange& registers));
   MOCK_CONST_METHOD0(getArchitecturalRegisterFileSet,
                      const ArchitecturalRegisterFileSet&());
   MOCK_CONST_METHOD0(getInstructionsRetiredCount, uint64_t());
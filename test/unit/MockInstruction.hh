@@ -34,6 +34,7 @@ class MockInstruction : public Instruction {
   MOCK_CONST_METHOD0(isStoreData, bool());
   MOCK_CONST_METHOD0(isLoad, bool());
   MOCK_CONST_METHOD0(isBranch, bool());
+  MOCK_CONST_METHOD0(isAtomic, bool());
   MOCK_CONST_METHOD0(getGroup, uint16_t());
 
   MOCK_CONST_METHOD0(getLSQLatency, uint16_t());
@@ -42,6 +43,8 @@ class MockInstruction : public Instruction {
 
   MOCK_METHOD1(setExecutionInfo, void(const ExecutionInfo& info));
 
+  MOCK_CONST_METHOD0(clone, IntrusivePtr<Instruction>());
+
   void setBranchResults(bool wasTaken, uint64_t targetAddress) {
     branchTaken_ = wasTaken;
     branchAddress_ = targetAddress;
@@ -64,6 +67,8 @@ class MockInstruction : public Instruction {
   void setIsMicroOp(bool isMicroOp) { isMicroOp_ = isMicroOp; }
 
   void setIsLastMicroOp(bool isLastOp) { isLastMicroOp_ = isLastOp; }
+
+  void setHoldsReservation(bool holds) { holdsReservation_ = holds; }
 };
 
 }  // namespace simeng
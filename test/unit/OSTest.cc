@@ -71,6 +71,63 @@ TEST_F(OSTest, processHex_stackPointer) {
   EXPECT_EQ(os.getInitialStackPointer(), proc_hex.getInitialStackPointer());
 }
 
+// Test that a futex wait sleeps only while the word holds the expected value,
+// and that a wake releases the sleeping thread to be scheduled again
+TEST_F(OSTest, futexWaitAndWake) {
+  os.createProcess(proc_hex);
+  uint64_t uaddr = proc_hex.getHeapStart();
+  uint32_t* word =
+      reinterpret_cast<uint32_t*>(proc_hex.getProcessImage().get() + uaddr);
+  *word = 5;
+
+  int saved = 0;
+  auto saveCaller = [&]() {
+    saved++;
+    return kernel::LinuxThreadContext{3, 0x40, {}};
+  };
+
+  // FUTEX_WAIT_PRIVATE on a word which no longer holds `val`
+  EXPECT_EQ(os.futex(uaddr, 128, 4, 0, 0, saveCaller), -EAGAIN);
+  EXPECT_EQ(saved, 0);
+
+  // FUTEX_WAIT_PRIVATE with a timeout returns at once
+  EXPECT_EQ(os.futex(uaddr, 128, 5, 0x1000, 0, saveCaller), 0);
+  EXPECT_EQ(saved, 0);
+
+  // FUTEX_WAIT_PRIVATE sleeps until woken
+  EXPECT_EQ(os.futex(uaddr, 128, 5, 0, 0, saveCaller), 0);
+  EXPECT_EQ(saved, 1);
+  EXPECT_FALSE(os.hasPendingThreads());
+
+  // FUTEX_WAKE_PRIVATE on another word wakes nothing
+  EXPECT_EQ(os.futex(uaddr + 4, 129, 1, 0, 0, saveCaller), 0);
+  EXPECT_FALSE(os.hasPendingThreads());
+
+  // FUTEX_WAKE_PRIVATE releases the sleeping thread, and no more
+  EXPECT_EQ(os.futex(uaddr, 129, 2, 0, 0, saveCaller), 1);
+  ASSERT_TRUE(os.hasPendingThreads());
+  kernel::LinuxThreadContext thread = os.takePendingThread();
+  EXPECT_EQ(thread.tid, 3);
+  EXPECT_EQ(thread.pc, 0x40);
+  EXPECT_EQ(os.futex(uaddr, 129, 1, 0, 0, saveCaller), 0);
+}
+
+// Test that a bitset wake only releases threads waiting with a shared bit
+TEST_F(OSTest, futexWakeBitset) {
+  os.createProcess(proc_hex);
+  uint64_t uaddr = proc_hex.getHeapStart();
+  auto saveCaller = [&]() { return kernel::LinuxThreadContext{1, 0, {}}; };
+
+  // FUTEX_WAIT_BITSET_PRIVATE on bit 0, woken by FUTEX_WAKE_BITSET_PRIVATE
+  EXPECT_EQ(os.futex(uaddr, 137, 0, 0, 0b01, saveCaller), 0);
+  EXPECT_EQ(os.futex(uaddr, 138, 1, 0, 0b10, saveCaller), 0);
+  EXPECT_EQ(os.futex(uaddr, 138, 1, 0, 0b11, saveCaller), 1);
+  EXPECT_TRUE(os.hasPendingThreads());
+
+  // A zero bitset is invalid
+  EXPECT_EQ(os.futex(uaddr, 137, 0, 0, 0, saveCaller), -EINVAL);
+}
+
 // createProcess
 // getInitialStackPointer
 
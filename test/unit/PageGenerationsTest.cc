@@ -0,0 +1,49 @@
+#include "gtest/gtest.h"
+#include "simeng/memory/PageGenerations.hh"
+
+namespace {
+
+using simeng::memory::PageGenerations;
+
+class PageGenerationsTest : public testing::Test {
+ public:
+  PageGenerationsTest() : generations(3 * PageGenerations::pageSize) {}
+
+ protected:
+  PageGenerations generations;
+};
+
+// Test that only writes to watched pages advance their generation.
+TEST_F(PageGenerationsTest, WatchedPages) {
+  generations.recordWrite({0, 8});
+  EXPECT_EQ(generations.watch(0), 0u);
+
+  generations.recordWrite({8, 8});
+  generations.recordWrite({PageGenerations::pageSize, 8});
+  EXPECT_EQ(generations.get(0), 1u);
+  EXPECT_EQ(generations.get(1), 0u);
+
+  // Watching a page again leaves its generation unchanged
+  EXPECT_EQ(generations.watch(0), 1u);
+}
+
+// Test that a write spanning two pages advances the generation of both.
+TEST_F(PageGenerationsTest, SpanningWrite) {
+  generations.watch(0);
+  generations.watch(1);
+  generations.recordWrite({PageGenerations::pageSize - 4, 8});
+  EXPECT_EQ(generations.get(0), 1u);
+  EXPECT_EQ(generations.get(1), 1u);
+}
+
+// Test that pages beyond the end of memory are ignored.
+TEST_F(PageGenerationsTest, OutOfBounds) {
+  generations.watch(2);
+  EXPECT_EQ(generations.watch(3), 0u);
+  generations.recordWrite({3 * PageGenerations::pageSize - 4, 8});
+  generations.recordWrite({5 * PageGenerations::pageSize, 8});
+  EXPECT_EQ(generations.get(2), 1u);
+  EXPECT_EQ(generations.get(3), 0u);
+}
+
+}  // namespace
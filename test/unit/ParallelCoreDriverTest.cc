@@ -0,0 +1,316 @@
+#include <cstring>
+
+#include "ConfigInit.hh"
+#include "gtest/gtest.h"
+#include "simeng/CoreInstance.hh"
+#include "simeng/ParallelCoreDriver.hh"
+#include "simeng/config/SimulationContext.hh"
+
+namespace simeng {
+
+// Counts down from 16 before calling exit_group
+static const uint32_t program[] = {
+    0x321C03E0,  // orr w0, wzr, #16
+    0x320003E1,  // orr w1, wzr, #1
+    0x71000400,  // subs w0, w0, #1
+    0x54FFFFC1,  // b.ne -8
+    0xD2800000,  // mov x0, #0
+    0xD2800BC8,  // mov x8, #94
+    0xD4000001,  // svc #0
+};
+
+class ParallelCoreDriverTest : public testing::Test {
+ protected:
+  /** Create a core instance running `program`. */
+  std::unique_ptr<CoreInstance> createCoreInstance() {
+    // The core instance takes ownership of the source buffer
+    char* source = new char[sizeof(program)];
+    std::memcpy(source, program, sizeof(program));
+    return std::make_unique<CoreInstance>(source, sizeof(program));
+  }
+
+  ConfigInit configInit = ConfigInit(config::ISA::AArch64,
+                                     "{CPU-Info: {Core-Count: 4}}");
+};
+
+// Tests that the cores run to completion, matching the results of ticking
+// them serially
+TEST_F(ParallelCoreDriverTest, matchesSerialSimulation) {
+  auto serial = createCoreInstance();
+  uint64_t serialCycles = 0;
+  while (!serial->hasHalted()) {
+    for (const auto& core : serial->getCores()) core->tick();
+    for (size_t i = 0; i < serial->getCores().size(); i++) {
+      serial->getInstructionMemory(i)->tick();
+      serial->getDataMemory(i)->tick();
+    }
+    serial->scheduleThreads();
+    serialCycles++;
+  }
+
+  auto parallel = createCoreInstance();
+  uint64_t parallelCycles = ParallelCoreDriver(*parallel, 2, 8).run();
+
+  EXPECT_TRUE(parallel->hasHalted());
+  EXPECT_EQ(parallelCycles, serialCycles);
+  for (size_t i = 0; i < parallel->getCores().size(); i++) {
+    EXPECT_EQ(parallel->getCores()[i]->getInstructionsRetiredCount(),
+              serial->getCores()[i]->getInstructionsRetiredCount());
+  }
+  EXPECT_GT(parallel->getCore()->getInstructionsRetiredCount(), 48);
+}
+
+// Tests that a thread created after the cores of a host thread have all halted
+// is placed onto a core whose clock kept pace with those still running, so
+// every core's statistics match those of ticking them serially
+TEST_F(ParallelCoreDriverTest, threadCreatedAfterHalting) {
+  // Counts down before cloning a thread, which counts down again
+  static const uint32_t lateClone[] = {
+      0xD2800513,  // mov x19, #40
+      0xF1000673,  // delay: subs x19, x19, #1
+      0x54FFFFE1,  // b.ne delay
+      0xD2A00020,  // mov x0, #0x10000
+      0xB2780000,  // orr x0, x0, #0x100
+      0xD2800001,  // mov x1, #0
+      0xD2800002,  // mov x2, #0
+      0xD2800003,  // mov x3, #0
+      0xD2800004,  // mov x4, #0
+      0xD2801B88,  // mov x8, #220
+      0xD4000001,  // svc #0
+      0xB4000080,  // cbz x0, child
+      0xD2800000,  // mov x0, #0
+      0xD2800BA8,  // mov x8, #93
+      0xD4000001,  // svc #0
+      0xD2800215,  // child: mov x21, #16
+      0xF10006B5,  // count: subs x21, x21, #1
+      0x54FFFFE1,  // b.ne count
+      0xD2800000,  // mov x0, #0
+      0xD2800BA8,  // mov x8, #93
+      0xD4000001,  // svc #0
+  };
+  auto createInstance = [&]() {
+    // The core instance takes ownership of the source buffer
+    char* source = new char[sizeof(lateClone)];
+    std::memcpy(source, lateClone, sizeof(lateClone));
+    return std::make_unique<CoreInstance>(source, sizeof(lateClone));
+  };
+
+  auto serial = createInstance();
+  uint64_t serialCycles = 0;
+  while (!serial->hasHalted()) {
+    for (const auto& core : serial->getCores()) core->tick();
+    for (size_t i = 0; i < serial->getCores().size(); i++) {
+      serial->getInstructionMemory(i)->tick();
+      serial->getDataMemory(i)->tick();
+    }
+    serial->scheduleThreads();
+    serialCycles++;
+  }
+
+  // The second host thread owns only cores which are halted until the clone,
+  // and a single-cycle quantum places the thread when serial ticking would
+  auto parallel = createInstance();
+  uint64_t parallelCycles = ParallelCoreDriver(*parallel, 2, 1).run();
+
+  EXPECT_EQ(parallelCycles, serialCycles);
+  for (size_t i = 0; i < parallel->getCores().size(); i++) {
+    EXPECT_EQ(parallel->getCores()[i]->getStats(),
+              serial->getCores()[i]->getStats())
+        << "core " << i;
+  }
+  EXPECT_GT(parallel->getCores()[1]->getInstructionsRetiredCount(), 2 * 16);
+}
+
+// Tests that requesting more host threads than cores is permitted
+TEST_F(ParallelCoreDriverTest, moreThreadsThanCores) {
+  auto parallel = createCoreInstance();
+  ParallelCoreDriver(*parallel, 16, 1).run();
+  EXPECT_TRUE(parallel->hasHalted());
+  EXPECT_GT(parallel->getCore()->getInstructionsRetiredCount(), 48);
+}
+
+// Tests that skipping the cycles an outoforder core spends waiting on memory
+// leaves every statistic as though each cycle were ticked
+TEST_F(ParallelCoreDriverTest, skippingMatchesTicking) {
+  // Loads from a new cache line every iteration, each missing to memory
+  static const uint32_t memoryBound[] = {
+      0xD2800400,  // mov x0, #32
+      0x910003E1,  // mov x1, sp
+      0xD1040021,  // sub x1, x1, #256
+      0xF9400022,  // ldr x2, [x1]
+      0x8B020063,  // add x3, x3, x2
+      0xF1000400,  // subs x0, x0, #1
+      0x54FFFF81,  // b.ne -16
+      0xD2800000,  // mov x0, #0
+      0xD2800BC8,  // mov x8, #94
+      0xD4000001,  // svc #0
+  };
+
+  config::SimulationContext context;
+  context.addToConfig(
+      "{Core: {Simulation-Mode: outoforder}, CPU-Info: {Core-Count: 1}, "
+      "L1-Data-Memory: {Interface-Type: Cache, Size: 1024, Associativity: 2}, "
+      "Main-Memory: {Access-Latency: 200}, TLB: {Data-Entries: 4}}");
+  auto createInstance = [&]() {
+    // The core instance takes ownership of the source buffer
+    char* source = new char[sizeof(memoryBound)];
+    std::memcpy(source, memoryBound, sizeof(memoryBound));
+    return std::make_unique<CoreInstance>(source, sizeof(memoryBound),
+                                          context.getConfig());
+  };
+
+  auto ticked = createInstance();
+  uint64_t tickedCycles = 0;
+  while (!ticked->hasHalted() ||
+         ticked->getDataMemory(0)->hasPendingRequests()) {
+    ticked->getCore()->tick();
+    ticked->getInstructionMemory(0)->tick();
+    ticked->getDataMemory(0)->tick();
+    tickedCycles++;
+  }
+
+  auto skipped = createInstance();
+  uint64_t skippedCycles = ParallelCoreDriver(*skipped, 1, 1000).run();
+
+  EXPECT_EQ(skippedCycles, tickedCycles);
+  EXPECT_EQ(skipped->getCore()->getStats(), ticked->getCore()->getStats());
+  EXPECT_EQ(ticked->getCore()->getStats()["retired"],
+            std::to_string(2 + 5 * 32 + 3));
+}
+
+// Tests that several outoforder cores, each splitting micro-ops, can run the
+// same code on separate host threads while racing on shared memory. Built with
+// SIMENG_SANITIZE_THREAD, this checks the host threads share no unguarded state
+TEST_F(ParallelCoreDriverTest, threadsShareMemory) {
+  // Clones three threads, then every thread repeatedly updates the same words
+  static const uint32_t sharedUpdates[] = {
+      0xD2800073,  // mov x19, #3
+      0x910003F4,  // mov x20, sp
+      0xD1080294,  // sub x20, x20, #512
+      0xD2A00020,  // clone: mov x0, #0x10000
+      0xB2780000,  // orr x0, x0, #0x100
+      0xD2800001,  // mov x1, #0
+      0xD2800002,  // mov x2, #0
+      0xD2800003,  // mov x3, #0
+      0xD2800004,  // mov x4, #0
+      0xD2801B88,  // mov x8, #220
+      0xD4000001,  // svc #0
+      0xB4000060,  // cbz x0, work
+      0xF1000673,  // subs x19, x19, #1
+      0x54FFFEC1,  // b.ne clone
+      0xD2800815,  // work: mov x21, #64
+      0xA9401A85,  // loop: ldp x5, x6, [x20]
+      0x910004A5,  // add x5, x5, #1
+      0x910008C6,  // add x6, x6, #2
+      0xA9001A85,  // stp x5, x6, [x20]
+      0xF9400A87,  // ldr x7, [x20, #16]
+      0x8B0500E7,  // add x7, x7, x5
+      0xF9000A87,  // str x7, [x20, #16]
+      0xF10006B5,  // subs x21, x21, #1
+      0x54FFFF01,  // b.ne loop
+      0xD2800000,  // mov x0, #0
+      0xD2800BA8,  // mov x8, #93
+      0xD4000001,  // svc #0
+  };
+
+  config::SimulationContext context;
+  context.addToConfig(
+      "{Core: {Simulation-Mode: outoforder, Micro-Operations: True}, "
+      "CPU-Info: {Core-Count: 4}}");
+  auto createInstance = [&]() {
+    // The core instance takes ownership of the source buffer
+    char* source = new char[sizeof(sharedUpdates)];
+    std::memcpy(source, sharedUpdates, sizeof(sharedUpdates));
+    return std::make_unique<CoreInstance>(source, sizeof(sharedUpdates),
+                                          context.getConfig());
+  };
+
+  auto serial = createInstance();
+  while (!serial->hasHalted()) {
+    for (const auto& core : serial->getCores()) core->tick();
+    for (size_t i = 0; i < serial->getCores().size(); i++) {
+      serial->getInstructionMemory(i)->tick();
+      serial->getDataMemory(i)->tick();
+    }
+    serial->scheduleThreads();
+  }
+
+  // The values loaded vary with the interleaving, but no branch depends on
+  // them, so each core retires as many instructions as when ticked serially
+  for (uint64_t quantum : {1, 16}) {
+    auto parallel = createInstance();
+    ParallelCoreDriver(*parallel, 4, quantum).run();
+    EXPECT_TRUE(parallel->hasHalted());
+    for (size_t i = 0; i < parallel->getCores().size(); i++) {
+      EXPECT_EQ(parallel->getCores()[i]->getInstructionsRetiredCount(),
+                serial->getCores()[i]->getInstructionsRetiredCount());
+      EXPECT_GT(parallel->getCores()[i]->getInstructionsRetiredCount(),
+                64 * 9);
+    }
+  }
+}
+
+// Tests that atomic adds and exclusive load/store pairs racing from several
+// cores lose no updates, for each core model
+TEST_F(ParallelCoreDriverTest, atomicsLoseNoUpdates) {
+  // Clones three threads, then every thread increments two heap counters 64
+  // times each; one with an atomic add, the other with an exclusive pair
+  static const uint32_t atomicUpdates[] = {
+      0xD2800000,  // mov x0, #0
+      0xD2801AC8,  // mov x8, #214
+      0xD4000001,  // svc #0
+      0xAA0003F4,  // mov x20, x0
+      0x91010018,  // add x24, x0, #64
+      0xD2800073,  // mov x19, #3
+      0xD2A00020,  // clone: mov x0, #0x10000
+      0xB2780000,  // orr x0, x0, #0x100
+      0xD2800001,  // mov x1, #0
+      0xD2800002,  // mov x2, #0
+      0xD2800003,  // mov x3, #0
+      0xD2800004,  // mov x4, #0
+      0xD2801B88,  // mov x8, #220
+      0xD4000001,  // svc #0
+      0xB4000060,  // cbz x0, work
+      0xF1000673,  // subs x19, x19, #1
+      0x54FFFEC1,  // b.ne clone
+      0xD2800815,  // work: mov x21, #64
+      0x52800036,  // mov w22, #1
+      0xB8760297,  // loop: ldaddl w22, w23, [x20]
+      0xC85FFF05,  // retry: ldaxr x5, [x24]
+      0x910004A5,  // add x5, x5, #1
+      0xC806FF05,  // stlxr w6, x5, [x24]
+      0x35FFFFA6,  // cbnz w6, retry
+      0xF10006B5,  // subs x21, x21, #1
+      0x54FFFF41,  // b.ne loop
+      0xD2800000,  // mov x0, #0
+      0xD2800BA8,  // mov x8, #93
+      0xD4000001,  // svc #0
+  };
+
+  for (std::string mode : {"emulation", "outoforder"}) {
+    for (uint64_t quantum : {1, 16}) {
+      config::SimulationContext context;
+      context.addToConfig("{Core: {Simulation-Mode: " + mode +
+                          "}, CPU-Info: {Core-Count: 4}}");
+      // The core instance takes ownership of the source buffer
+      char* source = new char[sizeof(atomicUpdates)];
+      std::memcpy(source, atomicUpdates, sizeof(atomicUpdates));
+      CoreInstance instance(source, sizeof(atomicUpdates),
+                            context.getConfig());
+
+      ParallelCoreDriver(instance, 4, quantum).run();
+      EXPECT_TRUE(instance.hasHalted());
+
+      const char* heap =
+          instance.getProcessImage().get() + instance.getHeapStart();
+      uint32_t added;
+      uint64_t incremented;
+      std::memcpy(&added, heap, sizeof(added));
+      std::memcpy(&incremented, heap + 64, sizeof(incremented));
+      EXPECT_EQ(added, 4 * 64) << mode << ", quantum " << quantum;
+      EXPECT_EQ(incremented, 4 * 64) << mode << ", quantum " << quantum;
+    }
+  }
+}
+
+}  // namespace simeng
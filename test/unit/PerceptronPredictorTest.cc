@@ -12,7 +12,7 @@ class PerceptronPredictorTest : public testing::Test {
 
  protected:
   MockInstruction* uop;
-  std::shared_ptr<Instruction> uopPtr;
+  IntrusivePtr<Instruction> uopPtr;
 };
 
 // Tests that the PerceptronPredictor will predict the correct direction on a
@@ -182,4 +182,128 @@ TEST_F(PerceptronPredictorTest, flush) {
   EXPECT_EQ(prediction.target, 12);
 }
 
+// Test that an update trains with the oldest outstanding prediction of the
+// branch, and that a flush rewinds the youngest
+TEST_F(PerceptronPredictorTest, updateAndFlushMatching) {
+  simeng::config::SimInfo::addToConfig(
+      "{Branch-Predictor: {Type: Perceptron, BTB-Tag-Bits: 11, "
+      "Global-History-Length: 4, RAS-entries: 10}}");
+  auto predictor = simeng::PerceptronPredictor();
+  // Predict the branch at 0x100 with histories 0b0 and 0b1
+  predictor.predict(0x100, BranchType::Unconditional, 0);
+  predictor.update(0x800, true, 0x900, BranchType::Conditional);
+  predictor.predict(0x100, BranchType::Unconditional, 0);
+  // Each update should set the target of the BTB entry indexed with the
+  // history of the prediction it resolves
+  predictor.update(0x100, true, 0xAB, BranchType::Unconditional);
+  predictor.update(0x100, true, 0xCD, BranchType::Unconditional);
+
+  // Clear the history, and read back the entry indexed with history 0b0
+  for (int i = 0; i < 4; i++) {
+    predictor.update(0x800, false, 0x900, BranchType::Conditional);
+  }
+  auto prediction = predictor.predict(0x100, BranchType::Unconditional, 0);
+  EXPECT_EQ(prediction.target, 0xAB);
+  // Read back the entry indexed with history 0b1
+  predictor.update(0x800, true, 0x900, BranchType::Conditional);
+  prediction = predictor.predict(0x100, BranchType::Unconditional, 0);
+  EXPECT_EQ(prediction.target, 0xCD);
+
+  // Pop two return addresses with the branch at 0x200
+  predictor.predict(8, BranchType::SubroutineCall, 8);
+  predictor.predict(24, BranchType::SubroutineCall, 8);
+  prediction = predictor.predict(0x200, BranchType::Return, 0);
+  EXPECT_EQ(prediction.target, 28);
+  prediction = predictor.predict(0x200, BranchType::Return, 0);
+  EXPECT_EQ(prediction.target, 12);
+  // Each flush should push back the address popped by the youngest prediction
+  // not yet flushed
+  predictor.flush(0x200);
+  prediction = predictor.predict(0x300, BranchType::Return, 0);
+  EXPECT_EQ(prediction.target, 12);
+  predictor.flush(0x300);
+  predictor.flush(0x200);
+  prediction = predictor.predict(0x300, BranchType::Return, 0);
+  EXPECT_EQ(prediction.target, 28);
+}
+
+// Test that predictions are still matched once the in-flight predictions have
+// wrapped around their storage, and after the oldest have been discarded
+TEST_F(PerceptronPredictorTest, inFlightWrapAround) {
+  simeng::config::SimInfo::addToConfig(
+      "{Branch-Predictor: {Type: Perceptron, BTB-Tag-Bits: 11, "
+      "Global-History-Length: 4, RAS-entries: 10}}");
+  auto predictor = simeng::PerceptronPredictor();
+  // Wrap around several times with resolved predictions
+  for (int i = 0; i < 3000; i++) {
+    predictor.predict(0x800, BranchType::Conditional, 0);
+    predictor.update(0x800, false, 0x900, BranchType::Conditional);
+  }
+  // Leave more predictions outstanding than can be held, discarding the oldest
+  for (int i = 0; i < 1500; i++) {
+    predictor.predict(0x1000 + 4 * i, BranchType::Conditional, 0);
+  }
+
+  predictor.predict(0x100, BranchType::Unconditional, 0);
+  predictor.update(0x800, true, 0x900, BranchType::Conditional);
+  predictor.predict(0x100, BranchType::Unconditional, 0);
+  predictor.update(0x100, true, 0xAB, BranchType::Unconditional);
+  predictor.update(0x100, true, 0xCD, BranchType::Unconditional);
+
+  for (int i = 0; i < 4; i++) {
+    predictor.update(0x800, false, 0x900, BranchType::Conditional);
+  }
+  auto prediction = predictor.predict(0x100, BranchType::Unconditional, 0);
+  EXPECT_EQ(prediction.target, 0xAB);
+  predictor.update(0x800, true, 0x900, BranchType::Conditional);
+  prediction = predictor.predict(0x100, BranchType::Unconditional, 0);
+  EXPECT_EQ(prediction.target, 0xCD);
+
+  // Rewind a return across the wrapped storage
+  predictor.predict(8, BranchType::SubroutineCall, 8);
+  prediction = predictor.predict(0x200, BranchType::Return, 0);
+  EXPECT_EQ(prediction.target, 12);
+  predictor.flush(0x200);
+  prediction = predictor.predict(0x300, BranchType::Return, 0);
+  EXPECT_EQ(prediction.target, 12);
+}
+
+// Test that a flushed prediction is no longer trained, and that the branch
+// re-predicted after the flush sees the same history and RAS as before it
+TEST_F(PerceptronPredictorTest, flushThenRepredict) {
+  simeng::config::SimInfo::addToConfig(
+      "{Branch-Predictor: {Type: Perceptron, BTB-Tag-Bits: 11, "
+      "Global-History-Length: 4, RAS-entries: 10}}");
+  auto predictor = simeng::PerceptronPredictor();
+  predictor.predict(8, BranchType::SubroutineCall, 8);
+  auto flushed = predictor.predict(0x200, BranchType::Return, 0);
+  predictor.flush(0x200);
+  auto prediction = predictor.predict(0x200, BranchType::Return, 0);
+  EXPECT_EQ(prediction.taken, flushed.taken);
+  EXPECT_EQ(prediction.target, flushed.target);
+  EXPECT_EQ(prediction.target, 12);
+
+  // Predict the branch at 0x100 with history 0b0, then flush it and re-predict
+  // it with history 0b1
+  flushed = predictor.predict(0x100, BranchType::Conditional, 0);
+  predictor.flush(0x100);
+  prediction = predictor.predict(0x100, BranchType::Conditional, 0);
+  EXPECT_EQ(prediction.taken, flushed.taken);
+  EXPECT_EQ(prediction.target, flushed.target);
+  predictor.flush(0x100);
+  predictor.update(0x800, true, 0x900, BranchType::Conditional);
+  predictor.predict(0x100, BranchType::Unconditional, 0);
+  // The update should resolve the re-prediction, not the flushed ones
+  predictor.update(0x100, true, 0xCD, BranchType::Unconditional);
+
+  for (int i = 0; i < 4; i++) {
+    predictor.update(0x800, false, 0x900, BranchType::Conditional);
+  }
+  prediction = predictor.predict(0x100, BranchType::Unconditional, 0);
+  EXPECT_EQ(prediction.target, 0);
+  predictor.update(0x800, true, 0x900, BranchType::Conditional);
+  prediction = predictor.predict(0x100, BranchType::Unconditional, 0);
+  EXPECT_EQ(prediction.target, 0xCD);
+}
+
 }  // namespace simeng
@@ -1,4 +1,5 @@
 #include <random>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -59,4 +60,53 @@ TEST(FixedPoolTest, GeneralUsage) {
   }
 }
 
+// Tests that memory released to a size class is recycled for the next
+// allocation of that class, and that large allocations bypass the pools
+TEST(SizeClassPoolTest, SizeClassReused) {
+  using simeng::SizeClassPool;
+  void* first = SizeClassPool::allocate(300);
+  SizeClassPool::deallocate(first, 300);
+
+  // Any size rounding up to the same class reuses the chunk
+  void* second = SizeClassPool::allocate(512);
+  EXPECT_EQ(second, first);
+
+  // A live chunk is not handed out again, nor one from another class
+  void* third = SizeClassPool::allocate(400);
+  EXPECT_NE(third, second);
+  void* small = SizeClassPool::allocate(40);
+  EXPECT_NE(small, second);
+  memset(small, 0, 40);
+  memset(third, 0, 400);
+
+  void* large = SizeClassPool::allocate(8192);
+  memset(large, 0, 8192);
+  SizeClassPool::deallocate(large, 8192);
+  SizeClassPool::deallocate(small, 40);
+  SizeClassPool::deallocate(third, 400);
+  SizeClassPool::deallocate(second, 512);
+}
+
+// Tests that the chunks released by a thread are reused by others once it has
+// exited, and that chunks may be released after their thread has exited
+TEST(ThreadPoolTest, ReusedAfterThreadExit) {
+  using Pool = simeng::threadPool_<48, 2>;
+  void* released = nullptr;
+  void* retained = nullptr;
+  std::thread([&] {
+    released = Pool::allocate();
+    retained = Pool::allocate();
+    Pool::deallocate(released);
+  }).join();
+  ASSERT_NE(released, nullptr);
+
+  void* reused = nullptr;
+  std::thread([&] {
+    reused = Pool::allocate();
+    Pool::deallocate(retained);
+    Pool::deallocate(reused);
+  }).join();
+  EXPECT_EQ(reused, released);
+}
+
 }  // namespace
@@ -0,0 +1,135 @@
+#include <array>
+
+#include "gtest/gtest.h"
+#include "simeng/memory/CacheMemoryInterface.hh"
+#include "simeng/memory/NextLinePrefetcher.hh"
+#include "simeng/memory/StreamPrefetcher.hh"
+#include "simeng/memory/StridePrefetcher.hh"
+
+namespace simeng {
+namespace memory {
+
+class PrefetcherTest : public testing::Test {
+ public:
+  PrefetcherTest()
+      : tree(ryml::parse_in_arena(
+            "{Data-Prefetcher: {Next-Line-Degree: 2, Stride-Table-Entries: 4, "
+            "Stride-Degree: 2, Stream-Table-Entries: 2, Stream-Distance: 4, "
+            "Stream-Degree: 2}, L1: {Size: 1024, Associativity: 2, Line-Size: "
+            "64, Hit-Latency: 2, MSHRs: 4, Write-Back: true, Write-Allocate: "
+            "true, Replacement-Policy: LRU}}")) {}
+
+ protected:
+  /** Observe a load with `prefetcher`, returning the lines it proposes. */
+  std::vector<uint64_t> observe(Prefetcher& prefetcher, uint64_t pc,
+                                uint64_t address) {
+    std::vector<uint64_t> prefetches;
+    prefetcher.observe(pc, address, prefetches);
+    return prefetches;
+  }
+
+  /** Tick `memory` until it has no pending requests. */
+  void drain(MemoryInterface& memory) {
+    while (memory.hasPendingRequests()) memory.tick();
+  }
+
+  ryml::Tree tree;
+
+  std::array<char, 4096> memoryData = {};
+};
+
+// Tests that the next lines are prefetched once per new line loaded from
+TEST_F(PrefetcherTest, nextLine) {
+  NextLinePrefetcher prefetcher(64, tree.crootref());
+  EXPECT_EQ(observe(prefetcher, 0, 8), std::vector<uint64_t>({64, 128}));
+  EXPECT_EQ(observe(prefetcher, 0, 16), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0, 200), std::vector<uint64_t>({256, 320}));
+}
+
+// Tests that a load is prefetched along its stride once the stride repeats,
+// and that interleaved loads are tracked separately
+TEST_F(PrefetcherTest, stride) {
+  StridePrefetcher prefetcher(64, tree.crootref());
+  EXPECT_EQ(observe(prefetcher, 0x10, 0), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0x14, 1000), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0x10, 128), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0x14, 976), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0x10, 256), std::vector<uint64_t>({384, 512}));
+  // Strides shorter than a line only propose the lines they move onto
+  EXPECT_EQ(observe(prefetcher, 0x14, 952), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0x14, 928), std::vector<uint64_t>({832}));
+
+  // A single irregular access loses confidence without retraining the stride
+  EXPECT_EQ(observe(prefetcher, 0x10, 400), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0x10, 528), std::vector<uint64_t>({640, 768}));
+}
+
+// Tests that a stream is prefetched ahead of once it has moved twice in one
+// direction, staying no more than the distance ahead
+TEST_F(PrefetcherTest, stream) {
+  StreamPrefetcher prefetcher(64, tree.crootref());
+  EXPECT_EQ(observe(prefetcher, 0, 64 * 100), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0, 64 * 99), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0, 64 * 98),
+            std::vector<uint64_t>({64 * 97, 64 * 96}));
+  EXPECT_EQ(observe(prefetcher, 0, 64 * 97),
+            std::vector<uint64_t>({64 * 95, 64 * 94}));
+  EXPECT_EQ(observe(prefetcher, 0, 64 * 96),
+            std::vector<uint64_t>({64 * 93, 64 * 92}));
+  // The stream is now the full distance ahead
+  EXPECT_EQ(observe(prefetcher, 0, 64 * 95),
+            std::vector<uint64_t>({64 * 91}));
+
+  // Loads far from the stream allocate new streams, replacing the least
+  // recently used
+  EXPECT_EQ(observe(prefetcher, 0, 0), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0, 64 * 50), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0, 64), std::vector<uint64_t>());
+  EXPECT_EQ(observe(prefetcher, 0, 128),
+            std::vector<uint64_t>({192, 256}));
+  EXPECT_EQ(observe(prefetcher, 0, 64 * 94), std::vector<uint64_t>());
+}
+
+// Tests that prefetched lines hit, and that each prefetcher's accuracy and
+// coverage are reported
+TEST_F(PrefetcherTest, stats) {
+  auto cache = std::make_shared<Cache>("l1d", tree.crootref()["L1"], nullptr, 10);
+  std::vector<std::unique_ptr<Prefetcher>> prefetchers;
+  prefetchers.push_back(
+      std::make_unique<NextLinePrefetcher>(64, tree.crootref()));
+  CacheMemoryInterface memory(memoryData.data(), memoryData.size(), cache,
+                              std::move(prefetchers));
+
+  // Load from lines 0, 1 and 3: the prefetches of lines 1 and 3 are used,
+  // while those of lines 2, 4 and 5 are not
+  for (uint64_t address : {0, 64, 192}) {
+    memory.requestRead({address, 8});
+    memory.observeLoad(0, {address, 8});
+    drain(memory);
+    // Wait for the prefetches to complete
+    for (int i = 0; i < 20; i++) memory.tick();
+  }
+
+  auto stats = memory.getStats();
+  EXPECT_EQ(stats["l1d.misses"], "1");
+  EXPECT_EQ(stats["l1d.hits"], "2");
+  EXPECT_EQ(stats["prefetch.nextline.issued"], "5");
+  EXPECT_EQ(stats["prefetch.nextline.useful"], "2");
+  EXPECT_EQ(stats["prefetch.nextline.accuracy"], "40%");
+  EXPECT_EQ(stats["prefetch.nextline.coverage"], "66.7%");
+}
+
+// Tests that prefetches are dropped rather than waiting for a free MSHR
+TEST_F(PrefetcherTest, mshrsFull) {
+  Cache cache("l1d", tree.crootref()["L1"], nullptr, 10);
+  for (uint64_t line = 0; line < 4; line++) {
+    EXPECT_TRUE(cache.prefetch(line * 64, 0, 1));
+  }
+  EXPECT_FALSE(cache.prefetch(256, 0, 1));
+  // Lines already held are not prefetched again
+  EXPECT_FALSE(cache.prefetch(0, 20, 1));
+  EXPECT_TRUE(cache.prefetch(256, 20, 1));
+}
+
+}  // namespace memory
+}  // namespace simeng
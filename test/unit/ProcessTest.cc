@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "ConfigInit.hh"
 #include "gtest/gtest.h"
 #include "simeng/kernel/LinuxProcess.hh"
@@ -88,6 +90,34 @@ TEST_F(ProcessTest, getProcessImageSize) {
   EXPECT_EQ(proc.getProcessImageSize(), 1079830880);
 }
 
+// Tests that the process image is zero-initialised, including the heap which
+// is never written by the loader
+TEST_F(ProcessTest, processImageZeroed) {
+  kernel::LinuxProcess proc = kernel::LinuxProcess(cmdLine);
+  EXPECT_TRUE(proc.isValid());
+  const char* image = proc.getProcessImage().get();
+  for (uint64_t address = proc.getHeapStart();
+       address < proc.getStackStart() - 4096; address += 1024 * 1024) {
+    EXPECT_EQ(image[address], 0);
+  }
+}
+
+// Tests that released process memory reads as zero, leaving its surroundings
+// intact, whether or not the range is aligned to host pages
+TEST_F(ProcessTest, releaseProcessMemory) {
+  const uint64_t size = 1024 * 1024;
+  auto image = kernel::reserveProcessImage(size);
+  std::memset(image.get(), 0xFF, size);
+
+  kernel::releaseProcessMemory(image.get(), 100, 200);
+  kernel::releaseProcessMemory(image.get(), 4096 - 8, 512 * 1024);
+  for (uint64_t i = 0; i < size; i++) {
+    bool released =
+        (i >= 100 && i < 300) || (i >= 4096 - 8 && i < 4096 - 8 + 512 * 1024);
+    ASSERT_EQ(image.get()[i], released ? 0 : static_cast<char>(0xFF)) << i;
+  }
+}
+
 TEST_F(ProcessTest, getEntryPoint) {
   kernel::LinuxProcess proc = kernel::LinuxProcess(cmdLine);
   EXPECT_TRUE(proc.isValid());
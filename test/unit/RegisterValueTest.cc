@@ -62,4 +62,57 @@ TEST(RegisterValueTest, Array) {
   EXPECT_EQ(ptr[2], 0);
   EXPECT_EQ(ptr[3], 0);
 }
+// Tests that copies of a large value share its data and outlive the original
+TEST(RegisterValueTest, LargeValueCopies) {
+  uint64_t arr[] = {1, 2, 3, 4};
+  auto original = std::make_unique<simeng::RegisterValue>(arr, 256);
+  simeng::RegisterValue copy = *original;
+  EXPECT_EQ(copy.getAsVector<uint64_t>(), original->getAsVector<uint64_t>());
+
+  simeng::RegisterValue assigned;
+  assigned = copy;
+  original.reset();
+  copy = simeng::RegisterValue(0, 8);
+
+  EXPECT_EQ(assigned.size(), 256);
+  auto ptr = assigned.getAsVector<uint64_t>();
+  EXPECT_EQ(ptr[0], 1);
+  EXPECT_EQ(ptr[3], 4);
+  EXPECT_EQ(ptr[4], 0);
+  EXPECT_EQ(copy.get<uint64_t>(), 0);
+}
+
+// Tests that moving a large value transfers its data without copying
+TEST(RegisterValueTest, LargeValueMove) {
+  uint64_t arr[] = {5, 6};
+  simeng::RegisterValue original = {arr, 64};
+  const uint64_t* data = original.getAsVector<uint64_t>();
+
+  simeng::RegisterValue moved = std::move(original);
+  EXPECT_EQ(moved.getAsVector<uint64_t>(), data);
+  EXPECT_EQ(moved.size(), 64);
+  EXPECT_EQ(moved.getAsVector<uint64_t>()[1], 6);
+}
+
+// Tests that the pooled memory of a large value is reclaimed once its last
+// copy is destroyed, and reused for the next value of a similar size
+TEST(RegisterValueTest, LargeValuePooled) {
+  const uint64_t* data;
+  {
+    auto value = simeng::RegisterValue(1, 200);
+    auto copy = value;
+    data = copy.getAsVector<uint64_t>();
+  }
+  auto reused = simeng::RegisterValue(2, 256);
+  EXPECT_EQ(reused.getAsVector<uint64_t>(), data);
+}
+
+// Tests that values larger than the largest pooled size are supported
+TEST(RegisterValueTest, OversizedValue) {
+  auto value = simeng::RegisterValue(0xAB, 1024);
+  auto copy = value.zeroExtend(1, 2048);
+  EXPECT_EQ(copy.size(), 2048);
+  EXPECT_EQ(copy.getAsVector<uint8_t>()[0], 0xAB);
+  EXPECT_EQ(copy.getAsVector<uint8_t>()[2047], 0);
+}
 }  // namespace
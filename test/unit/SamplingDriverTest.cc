@@ -0,0 +1,143 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "simeng/CoreInstance.hh"
+#include "simeng/SamplingDriver.hh"
+#include "simeng/config/SimulationContext.hh"
+
+namespace simeng {
+
+// Increments a counter held on the stack 4096 times, then calls exit_group if
+// it holds the expected value, or faults otherwise
+static const uint32_t program[] = {
+    0x321403E0,  // orr w0, wzr, #4096
+    0xF81F0FFF,  // str xzr, [sp, #-16]!
+                 // .loop:
+    0xF94003E3,  // ldr x3, [sp]
+    0x91000463,  // add x3, x3, #1
+    0xF90003E3,  // str x3, [sp]
+    0x71000400,  // subs w0, w0, #1
+    0x54FFFF81,  // b.ne .loop
+    0xF140047F,  // cmp x3, #4096
+    0x54000081,  // b.ne .fail
+    0xD2800000,  // mov x0, #0
+    0xD2800BC8,  // mov x8, #94
+    0xD4000001,  // svc #0
+                 // .fail:
+    0x00000000,  // udf #0
+};
+
+class SamplingDriverTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    std::remove(simPointPath.c_str());
+    std::remove(weightsPath.c_str());
+  }
+
+  /** Create a core instance running `program`, configured by `context`. */
+  std::unique_ptr<CoreInstance> createCoreInstance(
+      const config::SimulationContext& context) {
+    // The core instance takes ownership of the source buffer
+    char* source = new char[sizeof(program)];
+    std::memcpy(source, program, sizeof(program));
+    return std::make_unique<CoreInstance>(source, sizeof(program),
+                                          context.getConfig());
+  }
+
+  /** Run `program` to completion in emulation mode, returning the number of
+   * instructions retired. */
+  uint64_t runEmulation() {
+    config::SimulationContext context;
+    context.addToConfig("{Core: {Simulation-Mode: emulation}}");
+    auto instance = createCoreInstance(context);
+    while (!instance->hasHalted()) {
+      instance->getCore()->tick();
+      instance->getInstructionMemory()->tick();
+      instance->getDataMemory()->tick();
+    }
+    return instance->getCore()->getInstructionsRetiredCount();
+  }
+
+  std::string simPointPath =
+      (std::filesystem::temp_directory_path() / "simeng_sampling_test.simpts")
+          .string();
+  std::string weightsPath =
+      (std::filesystem::temp_directory_path() / "simeng_sampling_test.weights")
+          .string();
+};
+
+// Tests that a periodically sampled simulation runs the whole program
+// correctly, measuring an interval from each period
+TEST_F(SamplingDriverTest, periodic) {
+  config::SimulationContext context;
+  context.addToConfig(
+      "{Core: {Simulation-Mode: outoforder}, Sampling: {Mode: Periodic, "
+      "Interval-Length: 2000, Detail-Length: 500, Warmup-Length: 200}}");
+  auto instance = createCoreInstance(context);
+  ASSERT_NE(instance->getFunctionalCore(), nullptr);
+
+  SamplingDriver driver(*instance, context.getConfig());
+  driver.run();
+  auto stats = driver.getStats();
+
+  // Register and memory state survived every switch between cores, so the
+  // program exited normally having retired every instruction
+  EXPECT_EQ(std::stoull(stats["retired"]), runEmulation());
+  EXPECT_GE(std::stoull(stats["sampling.intervals"]), 9);
+  EXPECT_GT(std::stoull(stats["cycles"]), 0);
+  EXPECT_EQ(stats.count("sampling.cpi.error"), 1);
+
+  // Only the sampled intervals and their warm-up were simulated in detail
+  EXPECT_LT(std::stoull(stats["sampling.detailed"]),
+            std::stoull(stats["retired"]) / 2);
+  EXPECT_EQ(stats["sampling.warming"], "functional");
+}
+
+// Tests that without functional warming the program still runs correctly, and
+// the samples are reported as taken cold
+TEST_F(SamplingDriverTest, cold) {
+  config::SimulationContext context;
+  context.addToConfig(
+      "{Core: {Simulation-Mode: outoforder}, Sampling: {Mode: Periodic, "
+      "Interval-Length: 2000, Detail-Length: 500, Warmup-Length: 200, "
+      "Functional-Warming: false}}");
+  auto instance = createCoreInstance(context);
+
+  SamplingDriver driver(*instance, context.getConfig());
+  driver.run();
+  auto stats = driver.getStats();
+
+  EXPECT_EQ(std::stoull(stats["retired"]), runEmulation());
+  EXPECT_GE(std::stoull(stats["sampling.intervals"]), 9);
+  EXPECT_EQ(stats["sampling.warming"], "cold");
+}
+
+// Tests that the intervals chosen by SimPoint are measured and weighted
+TEST_F(SamplingDriverTest, simPoint) {
+  std::ofstream(simPointPath) << "3 0\n7 1\n";
+  std::ofstream(weightsPath) << "0.25 0\n0.75 1\n";
+
+  config::SimulationContext context;
+  context.addToConfig(
+      "{Core: {Simulation-Mode: outoforder}, Sampling: {Mode: SimPoint, "
+      "Interval-Length: 2000, Warmup-Length: 200, SimPoint-File: " +
+      simPointPath + ", Weights-File: " + weightsPath + "}}");
+  auto instance = createCoreInstance(context);
+
+  SamplingDriver driver(*instance, context.getConfig());
+  driver.run();
+  auto stats = driver.getStats();
+
+  EXPECT_EQ(std::stoull(stats["retired"]), runEmulation());
+  EXPECT_EQ(stats["sampling.intervals"], "2");
+  EXPECT_GT(std::stoull(stats["cycles"]), 0);
+  // Each SimPoint and its warm-up are simulated in detail, along with any
+  // instructions committed while draining the pipeline
+  EXPECT_GE(std::stoull(stats["sampling.detailed"]), 2 * 2200);
+  EXPECT_LT(std::stoull(stats["sampling.detailed"]), 2 * 2200 + 100);
+}
+
+}  // namespace simeng
@@ -0,0 +1,103 @@
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "simeng/CoreInstance.hh"
+#include "simeng/config/SimulationContext.hh"
+
+namespace simeng {
+
+// Counts down from 16 before calling exit_group
+static const uint32_t program[] = {
+    0x321C03E0,  // orr w0, wzr, #16
+    0x320003E1,  // orr w1, wzr, #1
+    0x71000400,  // subs w0, w0, #1
+    0x54FFFFC1,  // b.ne -8
+    0xD2800000,  // mov x0, #0
+    0xD2800BC8,  // mov x8, #94
+    0xD4000001,  // svc #0
+};
+
+class SimulationContextTest : public testing::Test {
+ protected:
+  /** Create a core instance running `program`, configured by `context`. */
+  std::unique_ptr<CoreInstance> createCoreInstance(
+      const config::SimulationContext& context) {
+    // The core instance takes ownership of the source buffer
+    char* source = new char[sizeof(program)];
+    std::memcpy(source, program, sizeof(program));
+    return std::make_unique<CoreInstance>(source, sizeof(program),
+                                          context.getConfig());
+  }
+
+  /** Tick every core and memory interface of `instance` for one cycle. */
+  void tick(CoreInstance& instance) {
+    for (const auto& core : instance.getCores()) core->tick();
+    for (size_t i = 0; i < instance.getCores().size(); i++) {
+      instance.getInstructionMemory(i)->tick();
+      instance.getDataMemory(i)->tick();
+    }
+    instance.scheduleThreads();
+  }
+};
+
+// Tests that contexts hold independent configs, leaving the SimInfo default
+// context untouched
+TEST_F(SimulationContextTest, independentConfigs) {
+  config::SimInfo::generateDefault(config::ISA::AArch64, true);
+
+  config::SimulationContext emulation;
+  emulation.generateDefault(config::ISA::AArch64, true);
+  emulation.addToConfig("{Core: {Simulation-Mode: emulation}}");
+
+  config::SimulationContext riscv;
+  riscv.generateDefault(config::ISA::RV64, true);
+  riscv.addToConfig("{CPU-Info: {Core-Count: 2, Package-Count: 2}}");
+
+  EXPECT_EQ(emulation.getSimMode(), config::SimulationMode::Emulation);
+  EXPECT_EQ(emulation.getISA(), config::ISA::AArch64);
+  EXPECT_EQ(riscv.getISA(), config::ISA::RV64);
+  EXPECT_EQ(riscv.getConfig()["CPU-Info"]["Core-Count"].as<uint16_t>(), 2);
+  EXPECT_EQ(emulation.getConfig()["CPU-Info"]["Core-Count"].as<uint16_t>(),
+            1);
+
+  EXPECT_EQ(config::SimInfo::getISA(), config::ISA::AArch64);
+  EXPECT_EQ(
+      config::SimInfo::getConfig()["CPU-Info"]["Core-Count"].as<uint16_t>(), 1);
+}
+
+// Tests that differently configured simulations can run side by side within
+// one process
+TEST_F(SimulationContextTest, concurrentSimulations) {
+  config::SimulationContext emulation;
+  emulation.generateDefault(config::ISA::AArch64, true);
+  emulation.addToConfig("{Core: {Simulation-Mode: emulation}}");
+
+  config::SimulationContext outoforder;
+  outoforder.generateDefault(config::ISA::AArch64, true);
+  outoforder.addToConfig(
+      "{Core: {Simulation-Mode: outoforder}, CPU-Info: {Core-Count: 2}}");
+
+  auto emulationInstance = createCoreInstance(emulation);
+  auto outoforderInstance = createCoreInstance(outoforder);
+  EXPECT_EQ(emulationInstance->getCores().size(), 1);
+  EXPECT_EQ(outoforderInstance->getCores().size(), 2);
+
+  // Interleave the two simulations cycle by cycle
+  while (!emulationInstance->hasHalted() || !outoforderInstance->hasHalted()) {
+    if (!emulationInstance->hasHalted()) tick(*emulationInstance);
+    if (!outoforderInstance->hasHalted()) tick(*outoforderInstance);
+  }
+
+  // Both models retire the same instruction stream
+  EXPECT_EQ(emulationInstance->getCore()->getInstructionsRetiredCount(),
+            outoforderInstance->getCore()->getInstructionsRetiredCount());
+  EXPECT_GT(emulationInstance->getCore()->getInstructionsRetiredCount(), 48);
+  EXPECT_EQ(
+      emulationInstance->getCore()->getStats().count("rename.allocationStalls"),
+      0);
+  EXPECT_EQ(outoforderInstance->getCore()->getStats().count(
+                "rename.allocationStalls"),
+            1);
+}
+
+}  // namespace simeng
@@ -0,0 +1,120 @@
+#include "gtest/gtest.h"
+#include "simeng/TagePredictor.hh"
+
+namespace simeng {
+
+class TagePredictorTest : public testing::Test {
+ public:
+  TagePredictorTest() {
+    simeng::config::SimInfo::addToConfig(
+        "{Branch-Predictor: {Type: TAGE, BTB-Tag-Bits: 11, "
+        "Global-History-Length: 64, RAS-entries: 5, Base-Table-Bits: 10, "
+        "Tagged-Tables: 4, Tagged-Table-Bits: 8, Tag-Bits: 8, "
+        "Min-History-Length: 4, Indirect-Tables: 2, Indirect-Table-Bits: 8}}");
+  }
+};
+
+// Tests that the TagePredictor will predict the correct direction on a miss
+TEST_F(TagePredictorTest, Miss) {
+  auto predictor = simeng::TagePredictor();
+  auto prediction = predictor.predict(0, BranchType::Conditional, 8);
+  EXPECT_TRUE(prediction.taken);
+  EXPECT_EQ(prediction.target, 8);
+  prediction = predictor.predict(8, BranchType::Unconditional, 0);
+  EXPECT_TRUE(prediction.taken);
+}
+
+// Tests that the TagePredictor will predict branch-and-link return pairs
+// correctly, and that flushing them rewinds the RAS
+TEST_F(TagePredictorTest, RAS) {
+  auto predictor = simeng::TagePredictor();
+  auto prediction = predictor.predict(8, BranchType::SubroutineCall, 8);
+  EXPECT_TRUE(prediction.taken);
+  EXPECT_EQ(prediction.target, 16);
+  prediction = predictor.predict(24, BranchType::Return, 0);
+  EXPECT_TRUE(prediction.taken);
+  EXPECT_EQ(prediction.target, 12);
+
+  predictor.flush(24);
+  prediction = predictor.predict(28, BranchType::Return, 0);
+  EXPECT_EQ(prediction.target, 12);
+}
+
+// Tests that a branch whose direction alternates is learnt from the global
+// history, and that flushing its prediction restores the history used
+TEST_F(TagePredictorTest, globalHistory) {
+  auto predictor = simeng::TagePredictor();
+  for (int i = 0; i < 200; i++) {
+    bool taken = i % 2;
+    auto prediction = predictor.predict(0x100, BranchType::Conditional, 0x40);
+    if (i >= 100) {
+      EXPECT_EQ(prediction.taken, taken) << i;
+    }
+    predictor.update(0x100, taken, taken ? 0x140 : 0x104,
+                     BranchType::Conditional);
+  }
+
+  auto prediction = predictor.predict(0x100, BranchType::Conditional, 0x40);
+  EXPECT_FALSE(prediction.taken);
+  predictor.flush(0x100);
+  prediction = predictor.predict(0x100, BranchType::Conditional, 0x40);
+  EXPECT_FALSE(prediction.taken);
+}
+
+// Tests that the target of an indirect branch is learnt from the direction of
+// the branch preceding it
+TEST_F(TagePredictorTest, indirectTarget) {
+  auto predictor = simeng::TagePredictor();
+  for (int i = 0; i < 200; i++) {
+    bool taken = (i / 3) % 2;
+    predictor.predict(0x200, BranchType::Conditional, 0x20);
+    predictor.update(0x200, taken, taken ? 0x220 : 0x204,
+                     BranchType::Conditional);
+
+    uint64_t target = taken ? 0x1000 : 0x2000;
+    auto prediction = predictor.predict(0x300, BranchType::Unconditional, 0);
+    if (i >= 100) {
+      EXPECT_EQ(prediction.target, target) << i;
+    }
+    predictor.update(0x300, true, target, BranchType::Unconditional);
+  }
+}
+
+// Tests that a misprediction rolls back the predictions made after the branch,
+// which a later flush then discards without rewinding them again
+TEST_F(TagePredictorTest, mispredictionRollback) {
+  auto predictor = simeng::TagePredictor();
+  predictor.predict(0x10, BranchType::SubroutineCall, 0x100);
+  auto prediction = predictor.predict(0x100, BranchType::Conditional, 0x40);
+  EXPECT_TRUE(prediction.taken);
+  // A call down the wrong path
+  predictor.predict(0x140, BranchType::SubroutineCall, 0x100);
+
+  predictor.update(0x100, false, 0x104, BranchType::Conditional);
+  prediction = predictor.predict(0x104, BranchType::Return, 0);
+  EXPECT_EQ(prediction.target, 0x14);
+
+  // Flushing the wrong path call also discards the younger return
+  predictor.flush(0x140);
+  prediction = predictor.predict(0x104, BranchType::Return, 0);
+  EXPECT_EQ(prediction.target, 0x14);
+}
+
+// Tests that flushing a branch with no prediction in flight, either never
+// predicted or retired once resolved, leaves the RAS and history unchanged
+TEST_F(TagePredictorTest, flushWithoutPrediction) {
+  auto predictor = simeng::TagePredictor();
+  predictor.predict(0x10, BranchType::SubroutineCall, 0x100);
+  predictor.flush(0x500);
+  auto prediction = predictor.predict(0x104, BranchType::Return, 0);
+  EXPECT_EQ(prediction.target, 0x14);
+
+  predictor.predict(0x20, BranchType::SubroutineCall, 0x100);
+  predictor.update(0x10, true, 0x110, BranchType::SubroutineCall);
+  predictor.update(0x104, true, 0x14, BranchType::Return);
+  predictor.flush(0x10);
+  prediction = predictor.predict(0x108, BranchType::Return, 0);
+  EXPECT_EQ(prediction.target, 0x24);
+}
+
+}  // namespace simeng
@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+#include "simeng/memory/Tlb.hh"
+
+namespace simeng {
+namespace memory {
+
+/** Retrieve the statistics of `tlb` and the levels below it. */
+std::map<std::string, std::string> getTlbStats(const Tlb& tlb) {
+  std::map<std::string, std::string> stats;
+  tlb.getStats(stats);
+  return stats;
+}
+
+// Tests that a miss walks the page table, after which the page hits
+TEST(TlbTest, missThenHit) {
+  Tlb tlb("dtlb", 4, 4, 0, 4096, nullptr, 30);
+  EXPECT_EQ(tlb.translate(0x1008, 10), 40);
+  // Another address on the same page hits once the walk completes
+  EXPECT_EQ(tlb.translate(0x1FF8, 40), 40);
+  // The next page misses
+  EXPECT_EQ(tlb.translate(0x2000, 50), 80);
+
+  auto stats = getTlbStats(tlb);
+  EXPECT_EQ(stats["dtlb.hits"], "1");
+  EXPECT_EQ(stats["dtlb.misses"], "2");
+  EXPECT_EQ(stats["dtlb.missrate"], "66.7%");
+}
+
+// Tests that lookups of a page whose walk is outstanding complete with it,
+// without being counted
+TEST(TlbTest, outstandingWalk) {
+  Tlb tlb("dtlb", 4, 4, 0, 4096, nullptr, 30);
+  EXPECT_EQ(tlb.translate(0x1000, 0), 30);
+  EXPECT_EQ(tlb.translate(0x1008, 5), 30);
+
+  auto stats = getTlbStats(tlb);
+  EXPECT_EQ(stats["dtlb.hits"], "0");
+  EXPECT_EQ(stats["dtlb.misses"], "1");
+}
+
+// Tests that a first-level miss which hits in the L2 TLB takes its latency,
+// and that the L2 TLB is shared by the levels above it
+TEST(TlbTest, hierarchy) {
+  auto l2 = std::make_shared<Tlb>("l2tlb", 16, 4, 8, 4096, nullptr, 30);
+  Tlb itlb("itlb", 2, 2, 0, 4096, l2, 30);
+  Tlb dtlb("dtlb", 2, 2, 0, 4096, l2, 30);
+
+  EXPECT_EQ(itlb.translate(0x1000, 0), 8 + 30);
+  // The data TLB finds the instruction TLB's page in the L2 TLB
+  EXPECT_EQ(dtlb.translate(0x1000, 100), 108);
+
+  // Fill both ways of the single data TLB set, evicting the first page
+  dtlb.translate(0x2000, 200);
+  dtlb.translate(0x3000, 300);
+  EXPECT_EQ(dtlb.translate(0x1000, 400), 408);
+
+  auto stats = getTlbStats(dtlb);
+  EXPECT_EQ(stats["dtlb.misses"], "4");
+  EXPECT_EQ(stats["l2tlb.hits"], "2");
+  EXPECT_EQ(stats["l2tlb.misses"], "3");
+}
+
+// Tests that the least recently used entry is replaced
+TEST(TlbTest, replacement) {
+  Tlb tlb("dtlb", 2, 2, 0, 4096, nullptr, 30);
+  tlb.translate(0x1000, 0);
+  tlb.translate(0x2000, 100);
+  tlb.translate(0x1000, 200);
+  // Replaces page 0x2000, which was used least recently
+  tlb.translate(0x3000, 300);
+  EXPECT_EQ(tlb.translate(0x1000, 400), 400);
+  EXPECT_EQ(tlb.translate(0x2000, 500), 530);
+}
+
+// Tests that warming installs a page as though its walk had long completed,
+// in the levels below as well, without counting any lookups
+TEST(TlbTest, warm) {
+  auto l2 = std::make_shared<Tlb>("l2tlb", 16, 4, 8, 4096, nullptr, 30);
+  Tlb tlb("dtlb", 2, 2, 0, 4096, l2, 30);
+  tlb.warm(0x1000, 0);
+  tlb.warm(0x2000, 100);
+  tlb.warm(0x1000, 200);
+  // Replaces page 0x2000, which was warmed least recently
+  tlb.warm(0x3000, 300);
+
+  EXPECT_EQ(tlb.translate(0x1000, 400), 400);
+  EXPECT_EQ(tlb.translate(0x3000, 400), 400);
+  // Page 0x2000 remains in the L2 TLB
+  EXPECT_EQ(tlb.translate(0x2000, 500), 508);
+
+  auto stats = getTlbStats(tlb);
+  EXPECT_EQ(stats["dtlb.hits"], "2");
+  EXPECT_EQ(stats["dtlb.misses"], "1");
+  EXPECT_EQ(stats["l2tlb.hits"], "1");
+  EXPECT_EQ(stats["l2tlb.misses"], "0");
+}
+
+// Tests that larger pages cover more of the address space per entry
+TEST(TlbTest, pageSizes) {
+  for (uint64_t pageSize : {4096, 16384, 65536, 2097152}) {
+    Tlb tlb("dtlb", 4, 4, 0, pageSize, nullptr, 30);
+    EXPECT_EQ(tlb.getPageSize(), pageSize);
+    for (uint64_t address = 0; address < 2097152; address += 4096) {
+      tlb.translate(address, 100);
+    }
+    auto stats = getTlbStats(tlb);
+    EXPECT_EQ(stats["dtlb.misses"], std::to_string(2097152 / pageSize))
+        << pageSize;
+  }
+}
+
+}  // namespace memory
+}  // namespace simeng
@@ -6,6 +6,7 @@
 #include "simeng/RegisterFileSet.hh"
 #include "simeng/arch/aarch64/Architecture.hh"
 #include "simeng/arch/riscv/Architecture.hh"
+#include "simeng/config/SimulationContext.hh"
 #include "simeng/span.hh"
 #include "simeng/version.hh"
 
@@ -119,6 +120,18 @@ TEST_F(AArch64ArchitectureTest, predecode) {
   EXPECT_EQ(output[0]->exceptionEncountered(), false);
 }
 
+// Test that an instruction which could not be fetched raises an instruction
+// abort
+TEST_F(AArch64ArchitectureTest, predecodeFault) {
+  MacroOp output;
+  arch->predecodeFault(0x40, output);
+  ASSERT_EQ(output.size(), 1);
+  Instruction* insn = reinterpret_cast<Instruction*>(output[0].get());
+  EXPECT_EQ(insn->getInstructionAddress(), 0x40);
+  EXPECT_EQ(insn->exceptionEncountered(), true);
+  EXPECT_EQ(insn->getException(), InstructionException::InstructionAbort);
+}
+
 TEST_F(AArch64ArchitectureTest, getSystemRegisterTag) {
   // Test incorrect system register will fail
   int32_t output = arch->getSystemRegisterTag(-1);
@@ -239,6 +252,50 @@ TEST_F(AArch64ArchitectureTest, get_set_SVCRVal) {
   EXPECT_EQ(arch->getSVCRval(), 3);
 }
 
+// Tests that micro-ops split by architectures built from different configs
+// each carry their own config's execution information
+TEST_F(AArch64ArchitectureTest, microOpsIsolatedBetweenConfigs) {
+  auto createContext = [](uint16_t loadLatency) {
+    auto context = std::make_unique<config::SimulationContext>();
+    context->generateDefault(config::ISA::AArch64, true);
+    context->addToConfig(
+        "{Core: {Simulation-Mode: outoforder, Micro-Operations: True}, "
+        "Latencies: {'0': {Instruction-Groups: [LOAD], Execution-Latency: " +
+        std::to_string(loadLatency) + ", Execution-Throughput: 1}}}");
+    return context;
+  };
+  auto fast = createContext(2);
+  auto slow = createContext(9);
+  Architecture fastArch(kernel, fast->getConfig());
+  Architecture slowArch(kernel, slow->getConfig());
+
+  // ldp x0, x1, [x2]
+  std::array<uint8_t, 4> ldpBytes = {0x40, 0x04, 0x40, 0xa9};
+  MacroOp fastUops;
+  MacroOp slowUops;
+  fastArch.predecode(ldpBytes.data(), ldpBytes.size(), 0x4, fastUops);
+  slowArch.predecode(ldpBytes.data(), ldpBytes.size(), 0x4, slowUops);
+
+  ASSERT_EQ(fastUops.size(), 2);
+  ASSERT_EQ(slowUops.size(), 2);
+  for (size_t i = 0; i < fastUops.size(); i++) {
+    EXPECT_EQ(fastUops[i]->getLatency(), 2);
+    EXPECT_EQ(slowUops[i]->getLatency(), 9);
+  }
+
+  // Destroying one architecture leaves the other's micro-ops intact
+  {
+    Architecture transient(kernel, fast->getConfig());
+    MacroOp uops;
+    transient.predecode(ldpBytes.data(), ldpBytes.size(), 0x4, uops);
+  }
+  slowUops = MacroOp();
+  slowArch.predecode(ldpBytes.data(), ldpBytes.size(), 0x4, slowUops);
+  ASSERT_EQ(slowUops.size(), 2);
+  EXPECT_EQ(slowUops[0]->getLatency(), 9);
+  EXPECT_TRUE(slowUops[0]->isLoad());
+}
+
 }  // namespace aarch64
 }  // namespace arch
 }  // namespace simeng
@@ -65,7 +65,7 @@ TEST_F(AArch64ExceptionHandlerTest, testSyscall) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   InstructionException exception = InstructionException::SupervisorCall;
-  std::shared_ptr<Instruction> insn = std::make_shared<Instruction>(
+  IntrusivePtr<Instruction> insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   insn->setInstructionAddress(insnAddr);
 
@@ -109,7 +109,7 @@ TEST_F(AArch64ExceptionHandlerTest, testSyscall) {
 // Test that `readStringThen()` operates as expected
 TEST_F(AArch64ExceptionHandlerTest, readStringThen) {
   // Create new mock instruction and ExceptionHandler
-  std::shared_ptr<MockInstruction> uopPtr(new MockInstruction);
+  IntrusivePtr<MockInstruction> uopPtr(new MockInstruction);
   ExceptionHandler handler(uopPtr, core, memory, kernel);
 
   // Initialise variables
@@ -203,7 +203,7 @@ TEST_F(AArch64ExceptionHandlerTest, readStringThen) {
 // away
 TEST_F(AArch64ExceptionHandlerTest, readStringThen_maxLen0) {
   // Create new mock instruction and ExceptionHandler
-  std::shared_ptr<MockInstruction> uopPtr(new MockInstruction);
+  IntrusivePtr<MockInstruction> uopPtr(new MockInstruction);
   ExceptionHandler handler(uopPtr, core, memory, kernel);
   size_t retVal = 100;
   char* buffer;
@@ -230,7 +230,7 @@ TEST_F(AArch64ExceptionHandlerTest, readStringThen_maxLen0) {
 // and no more string is fetched
 TEST_F(AArch64ExceptionHandlerTest, readStringThen_maxLenReached) {
   // Create new mock instruction and ExceptionHandler
-  std::shared_ptr<MockInstruction> uopPtr(new MockInstruction);
+  IntrusivePtr<MockInstruction> uopPtr(new MockInstruction);
   ExceptionHandler handler(uopPtr, core, memory, kernel);
 
   // Initialise variables
@@ -298,7 +298,7 @@ TEST_F(AArch64ExceptionHandlerTest, readStringThen_maxLenReached) {
 // Test that `readBufferThen()` operates as expected
 TEST_F(AArch64ExceptionHandlerTest, readBufferThen) {
   // Create new mock instruction and ExceptionHandler
-  std::shared_ptr<MockInstruction> uopPtr(new MockInstruction);
+  IntrusivePtr<MockInstruction> uopPtr(new MockInstruction);
   uopPtr->setSequenceId(5);
   ExceptionHandler handler(uopPtr, core, memory, kernel);
 
@@ -385,7 +385,7 @@ TEST_F(AArch64ExceptionHandlerTest, readBufferThen) {
 // Test that `readBufferThen()` calls then if length is 0
 TEST_F(AArch64ExceptionHandlerTest, readBufferThen_length0) {
   // Create new mock instruction and ExceptionHandler
-  std::shared_ptr<MockInstruction> uopPtr(new MockInstruction);
+  IntrusivePtr<MockInstruction> uopPtr(new MockInstruction);
   ExceptionHandler handler(uopPtr, core, memory, kernel);
 
   const size_t expectedVal = 10;
@@ -412,7 +412,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   InstructionException exception = InstructionException::EncodingUnallocated;
-  std::shared_ptr<Instruction> insn = std::make_shared<Instruction>(
+  IntrusivePtr<Instruction> insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_0(insn, core, memory, kernel);
@@ -432,7 +432,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::ExecutionNotYetImplemented;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_1(insn, core, memory, kernel);
@@ -451,7 +451,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::AliasNotYetImplemented;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_2(insn, core, memory, kernel);
@@ -469,7 +469,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::MisalignedPC;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_3(insn, core, memory, kernel);
@@ -488,7 +488,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::DataAbort;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_4(insn, core, memory, kernel);
@@ -507,7 +507,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::SupervisorCall;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_5(insn, core, memory, kernel);
@@ -527,7 +527,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::HypervisorCall;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_6(insn, core, memory, kernel);
@@ -547,7 +547,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::SecureMonitorCall;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_7(insn, core, memory, kernel);
@@ -565,7 +565,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::NoAvailablePort;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_8(insn, core, memory, kernel);
@@ -583,7 +583,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::UnmappedSysReg;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_9(insn, core, memory, kernel);
@@ -601,7 +601,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::StreamingModeUpdate;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_10(insn, core, memory, kernel);
@@ -619,7 +619,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::ZAregisterStatusUpdate;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_11(insn, core, memory, kernel);
@@ -637,7 +637,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::SMZAUpdate;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_12(insn, core, memory, kernel);
@@ -656,7 +656,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::ZAdisabled;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_13(insn, core, memory, kernel);
@@ -675,7 +675,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::SMdisabled;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_14(insn, core, memory, kernel);
@@ -694,7 +694,7 @@ TEST_F(AArch64ExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::None;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_15(insn, core, memory, kernel);
@@ -28,15 +28,15 @@ class PipelineDecodeUnitTest : public testing::Test {
 
  protected:
   PipelineBuffer<MacroOp> input;
-  PipelineBuffer<std::shared_ptr<Instruction>> output;
+  PipelineBuffer<IntrusivePtr<Instruction>> output;
   RegisterFileSet registerFileSet;
   MockBranchPredictor predictor;
   DecodeUnit decodeUnit;
 
   MockInstruction* uop;
-  std::shared_ptr<Instruction> uopPtr;
+  IntrusivePtr<Instruction> uopPtr;
   MockInstruction* uop2;
-  std::shared_ptr<Instruction> uop2Ptr;
+  IntrusivePtr<Instruction> uop2Ptr;
 
   std::vector<Register> sourceRegisters;
 };
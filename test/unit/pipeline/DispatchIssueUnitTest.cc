@@ -65,17 +65,17 @@ class PipelineDispatchIssueUnitTest : public testing::Test {
       {1, physRegQuants[3]}, {8, physRegQuants[4]},   {256, physRegQuants[5]}};
   RegisterFileSet regFile;
 
-  PipelineBuffer<std::shared_ptr<Instruction>> input;
-  std::vector<PipelineBuffer<std::shared_ptr<Instruction>>> output;
+  PipelineBuffer<IntrusivePtr<Instruction>> input;
+  std::vector<PipelineBuffer<IntrusivePtr<Instruction>>> output;
 
   MockPortAllocator portAlloc;
 
   simeng::pipeline::DispatchIssueUnit diUnit;
 
   MockInstruction* uop;
-  std::shared_ptr<Instruction> uopPtr;
+  IntrusivePtr<Instruction> uopPtr;
   MockInstruction* uop2;
-  std::shared_ptr<Instruction> uop2Ptr;
+  IntrusivePtr<Instruction> uop2Ptr;
 
   // As per a64fx.yaml
   const uint16_t EAGA = 5;    // Maps to RS index 2
@@ -229,10 +229,10 @@ TEST_F(PipelineDispatchIssueUnitTest, singleInstr_rsFull) {
   const std::vector<uint16_t> suppPorts = {EAGA};
 
   // Artificially fill Reservation station with index 2
-  std::vector<std::shared_ptr<MockInstruction>> insns(refRsSizes[RS_EAGA]);
+  std::vector<IntrusivePtr<MockInstruction>> insns(refRsSizes[RS_EAGA]);
   for (int i = 0; i < insns.size(); i++) {
     // Initialise instruction
-    insns[i] = std::make_shared<MockInstruction>();
+    insns[i] = makeIntrusive<MockInstruction>();
     // All expected calls to instruction during tick()
     EXPECT_CALL(*insns[i].get(), getSupportedPorts())
         .WillOnce(ReturnRef(suppPorts));
@@ -426,7 +426,6 @@ TEST_F(PipelineDispatchIssueUnitTest, createdependency_raw) {
   // Forward operand for register r0
   std::array<RegisterValue, 1> vals = {RegisterValue(6)};
   EXPECT_CALL(*uop2, supplyOperand(0, vals[0]));
-  EXPECT_CALL(*uop2, canExecute()).WillOnce(Return(true));
   diUnit.forwardOperands(span<Register>(srcRegs_2), vals);
 
   // Try issue again for instruction 2
@@ -559,6 +558,69 @@ TEST_F(PipelineDispatchIssueUnitTest, purgeFlushed) {
   EXPECT_EQ(diUnit.getRSStalls(), 0);
 }
 
+// Two instructions on the same port become ready in the opposite order to
+// their dispatch; ensure the older is issued first
+TEST_F(PipelineDispatchIssueUnitTest, issueOldestFirst) {
+  std::array<Register, 1> srcRegs_1 = {r0};
+  std::array<Register, 1> destRegs_1 = {r2};
+  std::array<Register, 1> srcRegs_2 = {r1};
+  std::array<Register, 0> destRegs_2 = {};
+  const std::vector<uint16_t> suppPorts = {EAGA};
+  std::array<RegisterValue, 1> vals = {RegisterValue(6)};
+
+  // Mark r0 and r1 as not ready, as if written by earlier instructions
+  std::array<Register, 2> producerDests = {r0, r1};
+  std::array<Register, 0> producerSrcs = {};
+  auto producer = makeIntrusive<MockInstruction>();
+  EXPECT_CALL(*producer, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*producer, getSourceRegisters())
+      .WillOnce(Return(span<Register>(producerSrcs)));
+  EXPECT_CALL(*producer, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(producerDests)));
+  EXPECT_CALL(portAlloc, allocate(suppPorts)).WillRepeatedly(Return(EAGA));
+  EXPECT_CALL(portAlloc, issued(EAGA)).Times(3);
+  input.getHeadSlots()[0] = producer;
+  diUnit.tick();
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], producer);
+  output[EAGA].getTailSlots()[0] = nullptr;
+
+  // Dispatch the two dependent instructions
+  EXPECT_CALL(*uop, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*uop, getSourceRegisters())
+      .WillOnce(Return(span<Register>(srcRegs_1)));
+  EXPECT_CALL(*uop, isOperandReady(0)).WillOnce(Return(false));
+  EXPECT_CALL(*uop, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(destRegs_1)));
+  input.getHeadSlots()[0] = uopPtr;
+  diUnit.tick();
+
+  EXPECT_CALL(*uop2, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*uop2, getSourceRegisters())
+      .WillOnce(Return(span<Register>(srcRegs_2)));
+  EXPECT_CALL(*uop2, isOperandReady(0)).WillOnce(Return(false));
+  EXPECT_CALL(*uop2, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(destRegs_2)));
+  input.getHeadSlots()[0] = uop2Ptr;
+  diUnit.tick();
+
+  // Wake the younger instruction before the older
+  EXPECT_CALL(*uop2, supplyOperand(0, vals[0]));
+  diUnit.forwardOperands(span<Register>(srcRegs_2), vals);
+  EXPECT_CALL(*uop, supplyOperand(0, vals[0]));
+  diUnit.forwardOperands(span<Register>(srcRegs_1), vals);
+
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], uopPtr);
+  output[EAGA].getTailSlots()[0] = nullptr;
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], uop2Ptr);
+
+  std::vector<uint64_t> rsSizes;
+  diUnit.getRSSizes(rsSizes);
+  EXPECT_EQ(rsSizes, refRsSizes);
+}
+
 // Test based on a64fx config file reservation staion configuration
 TEST_F(PipelineDispatchIssueUnitTest, getRSSizes) {
   std::vector<uint64_t> rsSizes;
@@ -18,7 +18,7 @@ class MockExecutionHandlers {
  public:
   MOCK_METHOD2(forwardOperands,
                void(const span<Register>, const span<RegisterValue>));
-  MOCK_METHOD1(raiseException, void(std::shared_ptr<Instruction> instruction));
+  MOCK_METHOD1(raiseException, void(IntrusivePtr<Instruction> instruction));
 };
 
 class PipelineExecuteUnitTest : public testing::Test {
@@ -44,8 +44,8 @@ class PipelineExecuteUnitTest : public testing::Test {
         thirdUopPtr(thirdUop) {}
 
  protected:
-  PipelineBuffer<std::shared_ptr<Instruction>> input;
-  PipelineBuffer<std::shared_ptr<Instruction>> output;
+  PipelineBuffer<IntrusivePtr<Instruction>> input;
+  PipelineBuffer<IntrusivePtr<Instruction>> output;
   MockBranchPredictor predictor;
   MockExecutionHandlers executionHandlers;
 
@@ -55,9 +55,9 @@ class PipelineExecuteUnitTest : public testing::Test {
   MockInstruction* secondUop;
   MockInstruction* thirdUop;
 
-  std::shared_ptr<Instruction> uopPtr;
-  std::shared_ptr<Instruction> secondUopPtr;
-  std::shared_ptr<Instruction> thirdUopPtr;
+  IntrusivePtr<Instruction> uopPtr;
+  IntrusivePtr<Instruction> secondUopPtr;
+  IntrusivePtr<Instruction> thirdUopPtr;
 };
 
 // Tests that the execution unit processes nothing if no instruction is present
@@ -167,7 +167,7 @@ TEST_F(PipelineExecuteUnitTest, ExceptionDoesNotExecute) {
   EXPECT_CALL(*uop, execute()).Times(0);
 
   EXPECT_CALL(executionHandlers,
-              raiseException(Property(&std::shared_ptr<Instruction>::get, uop)))
+              raiseException(Property(&IntrusivePtr<Instruction>::get, uop)))
       .Times(1);
 
   executeUnit.tick();
@@ -184,7 +184,7 @@ TEST_F(PipelineExecuteUnitTest, ExecutionException) {
   }));
 
   EXPECT_CALL(executionHandlers,
-              raiseException(Property(&std::shared_ptr<Instruction>::get, uop)))
+              raiseException(Property(&IntrusivePtr<Instruction>::get, uop)))
       .Times(1);
 
   executeUnit.tick();
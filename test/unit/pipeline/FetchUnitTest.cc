@@ -17,6 +17,7 @@ using ::testing::AtLeast;
 using ::testing::DoAll;
 using ::testing::Field;
 using ::testing::Gt;
+using ::testing::Invoke;
 using ::testing::Lt;
 using ::testing::Ne;
 using ::testing::Return;
@@ -61,9 +62,9 @@ class PipelineFetchUnitTest
   FetchUnit fetchUnit;
 
   MockInstruction* uop;
-  std::shared_ptr<Instruction> uopPtr;
+  IntrusivePtr<Instruction> uopPtr;
   MockInstruction* uop2;
-  std::shared_ptr<Instruction> uopPtr2;
+  IntrusivePtr<Instruction> uopPtr2;
 };
 
 // Tests that ticking a fetch unit attempts to predecode from the correct
@@ -744,6 +745,339 @@ TEST_P(PipelineFetchUnitTest, invalidMinBytesreadsDontComplete) {
   }
 }
 
+// Tests that a fetch block isn't requested until its translation is available
+TEST_P(PipelineFetchUnitTest, translationStall) {
+  ON_CALL(isa, getMaxInstructionSize()).WillByDefault(Return(insnMaxSizeBytes));
+  ON_CALL(isa, getMinInstructionSize()).WillByDefault(Return(insnMinSizeBytes));
+  ON_CALL(memory, getCompletedReads())
+      .WillByDefault(Return(span<memory::MemoryReadResult>()));
+
+  // The page walk begins as the first block is requested on construction
+  memory::Tlb instructionTlb("itlb", 4, 4, 0, 4096, nullptr, 3);
+  EXPECT_CALL(memory, requestRead(_, _)).Times(0);
+  FetchUnit translatedFetchUnit(output, memory, 1024, 0, blockSize, isa,
+                                predictor, &instructionTlb);
+  for (int i = 0; i < 2; i++) {
+    translatedFetchUnit.tick();
+    translatedFetchUnit.requestFromPC();
+  }
+
+  EXPECT_CALL(memory,
+              requestRead(Field(&memory::MemoryAccessTarget::address, 0), _))
+      .Times(1);
+  translatedFetchUnit.tick();
+  translatedFetchUnit.requestFromPC();
+  EXPECT_EQ(translatedFetchUnit.getTranslationStalls(), 3);
+}
+
+// Tests that a decoupled fetch unit re-steers its prediction stage once it
+// pre-decodes a branch missing from the BTB, and that once the branch is
+// identified, fetch continues past it within the same cycle
+TEST_P(PipelineFetchUnitTest, decoupledBtbMiss) {
+  ON_CALL(isa, getMaxInstructionSize()).WillByDefault(Return(insnMaxSizeBytes));
+  ON_CALL(isa, getMinInstructionSize()).WillByDefault(Return(insnMinSizeBytes));
+
+  // A branch at 4, taken to 64, amongst non-branch instructions
+  MacroOp nonBranch = {uopPtr};
+  MacroOp branch = {uopPtr2};
+  ON_CALL(isa, predecode(_, _, _, _))
+      .WillByDefault(DoAll(SetArgReferee<3>(nonBranch), Return(4)));
+  ON_CALL(isa, predecode(_, _, 4, _))
+      .WillByDefault(DoAll(SetArgReferee<3>(branch), Return(4)));
+  ON_CALL(*uop, isBranch()).WillByDefault(Return(false));
+  ON_CALL(*uop2, isBranch()).WillByDefault(Return(true));
+  ON_CALL(*uop2, getBranchType())
+      .WillByDefault(Return(BranchType::Unconditional));
+  ON_CALL(*uop2, getKnownOffset()).WillByDefault(Return(60));
+  BranchPrediction taken = {true, 64};
+  EXPECT_CALL(predictor, predict(4, BranchType::Unconditional, 60))
+      .Times(2)
+      .WillRepeatedly(Return(taken));
+  EXPECT_CALL(predictor, flush(_)).Times(0);
+
+  memory::MemoryReadResult reads[] = {
+      {{0, blockSize}, RegisterValue(0, blockSize), 1},
+      {{64, blockSize}, RegisterValue(0, blockSize), 1}};
+  ON_CALL(memory, getCompletedReads())
+      .WillByDefault(Return(span<memory::MemoryReadResult>(reads, 2)));
+  EXPECT_CALL(memory, requestRead(_, _)).Times(AnyNumber());
+
+  PipelineBuffer<MacroOp> wideOutput(4, {});
+  FetchUnit decoupledFetchUnit(wideOutput, memory, 1024, 0, blockSize, isa,
+                               predictor, nullptr, 4, 16, 2);
+  EXPECT_TRUE(decoupledFetchUnit.isDecoupled());
+
+  // The first block is queued by the prediction stage, then requested
+  EXPECT_CALL(memory,
+              requestRead(Field(&memory::MemoryAccessTarget::address, 0), _))
+      .Times(1);
+  decoupledFetchUnit.tick();
+  decoupledFetchUnit.requestFromPC();
+
+  // Fetch finds the branch at 4, predicting it and re-steering to 64
+  EXPECT_CALL(memory,
+              requestRead(Field(&memory::MemoryAccessTarget::address, 64), _))
+      .Times(1);
+  decoupledFetchUnit.tick();
+  decoupledFetchUnit.requestFromPC();
+  EXPECT_EQ(decoupledFetchUnit.getBtbMisses(), 1);
+  EXPECT_EQ(wideOutput.getTailSlots()[1].size(), 1);
+  EXPECT_EQ(wideOutput.getTailSlots()[2].size(), 0);
+
+  // Returning to 0, the prediction stage queues the branch's target from the
+  // BTB whilst fetch is stalled. Both blocks are already held
+  decoupledFetchUnit.updatePC(0);
+  wideOutput.fill({});
+  wideOutput.stall(true);
+  for (int i = 0; i < 2; i++) {
+    decoupledFetchUnit.tick();
+    decoupledFetchUnit.requestFromPC();
+  }
+
+  // Fetch then continues past the taken branch
+  wideOutput.stall(false);
+  for (uint64_t address : {0, 4, 64, 68}) {
+    EXPECT_CALL(isa, predecode(_, _, address, _)).Times(1);
+  }
+  decoupledFetchUnit.tick();
+  EXPECT_EQ(decoupledFetchUnit.getBtbMisses(), 1);
+  EXPECT_EQ(wideOutput.getTailSlots()[3].size(), 1);
+}
+
+// Tests that a decoupled fetch unit holds a block whose read faulted, raising
+// the fault once the target covering it reaches the head of the queue, and
+// requesting the block afresh once the PC is updated
+TEST_P(PipelineFetchUnitTest, decoupledReadFault) {
+  ON_CALL(isa, getMaxInstructionSize()).WillByDefault(Return(insnMaxSizeBytes));
+  ON_CALL(isa, getMinInstructionSize()).WillByDefault(Return(insnMinSizeBytes));
+  MacroOp nonBranch = {uopPtr};
+  ON_CALL(isa, predecode(_, _, _, _))
+      .WillByDefault(DoAll(SetArgReferee<3>(nonBranch), Return(4)));
+  ON_CALL(*uop, isBranch()).WillByDefault(Return(false));
+  MacroOp fault = {uopPtr2};
+
+  memory::MemoryReadResult read = {{0, blockSize}, RegisterValue(), 1};
+  ON_CALL(memory, getCompletedReads())
+      .WillByDefault(Return(span<memory::MemoryReadResult>(&read, 1)));
+
+  PipelineBuffer<MacroOp> wideOutput(4, {});
+  FetchUnit decoupledFetchUnit(wideOutput, memory, 1024, 0, blockSize, isa,
+                               predictor, nullptr, 4, 16, 2);
+
+  // Following blocks are requested as the prediction stage runs ahead
+  EXPECT_CALL(memory, requestRead(_, _)).Times(AnyNumber());
+  EXPECT_CALL(memory,
+              requestRead(Field(&memory::MemoryAccessTarget::address, 0), _))
+      .Times(1);
+  decoupledFetchUnit.tick();
+  decoupledFetchUnit.requestFromPC();
+
+  // The faulting block's target is at the head, so the fault is supplied in
+  // place of its first instruction
+  EXPECT_CALL(isa, predecode(_, _, _, _)).Times(0);
+  EXPECT_CALL(isa, predecodeFault(0, _)).WillOnce(SetArgReferee<1>(fault));
+  decoupledFetchUnit.tick();
+  decoupledFetchUnit.requestFromPC();
+  EXPECT_EQ(wideOutput.getTailSlots()[0].size(), 1);
+  EXPECT_EQ(wideOutput.getTailSlots()[0][0], uopPtr2);
+  EXPECT_EQ(wideOutput.getTailSlots()[1].size(), 0);
+
+  // Nothing more is fetched until the PC is updated
+  wideOutput.fill({});
+  decoupledFetchUnit.tick();
+  decoupledFetchUnit.requestFromPC();
+  EXPECT_EQ(wideOutput.getTailSlots()[0].size(), 0);
+
+  // Once the PC is updated, the block is requested afresh
+  read.data = RegisterValue(0, blockSize);
+  decoupledFetchUnit.updatePC(0);
+  EXPECT_CALL(memory,
+              requestRead(Field(&memory::MemoryAccessTarget::address, 0), _))
+      .Times(1);
+  decoupledFetchUnit.tick();
+  decoupledFetchUnit.requestFromPC();
+
+  EXPECT_CALL(isa, predecode(_, _, _, _)).Times(AtLeast(1));
+  decoupledFetchUnit.tick();
+  EXPECT_EQ(wideOutput.getTailSlots()[0].size(), 1);
+  EXPECT_EQ(wideOutput.getTailSlots()[0][0], uopPtr);
+}
+
+// Tests that a block whose read faulted only raises the fault once the
+// instructions fetched before it have been supplied
+TEST_P(PipelineFetchUnitTest, decoupledReadFaultAfterInstructions) {
+  ON_CALL(isa, getMaxInstructionSize()).WillByDefault(Return(insnMaxSizeBytes));
+  ON_CALL(isa, getMinInstructionSize()).WillByDefault(Return(insnMinSizeBytes));
+  MacroOp nonBranch = {uopPtr};
+  ON_CALL(isa, predecode(_, _, _, _))
+      .WillByDefault(DoAll(SetArgReferee<3>(nonBranch), Return(4)));
+  ON_CALL(*uop, isBranch()).WillByDefault(Return(false));
+  MacroOp fault = {uopPtr2};
+
+  // The block at 0 is read, but the one following it faults
+  memory::MemoryReadResult reads[] = {
+      {{0, blockSize}, RegisterValue(0, blockSize), 1},
+      {{16, blockSize}, RegisterValue(), 1}};
+  ON_CALL(memory, getCompletedReads())
+      .WillByDefault(Return(span<memory::MemoryReadResult>(reads, 2)));
+  EXPECT_CALL(memory, requestRead(_, _)).Times(AnyNumber());
+
+  PipelineBuffer<MacroOp> wideOutput(8, {});
+  FetchUnit decoupledFetchUnit(wideOutput, memory, 1024, 0, blockSize, isa,
+                               predictor, nullptr, 4, 16, 2);
+  decoupledFetchUnit.tick();
+  decoupledFetchUnit.requestFromPC();
+
+  // The first block's instructions are supplied whilst the next is requested
+  for (uint64_t address : {0, 4, 8, 12}) {
+    EXPECT_CALL(isa, predecode(_, _, address, _)).Times(1);
+  }
+  EXPECT_CALL(isa, predecodeFault(_, _)).Times(0);
+  decoupledFetchUnit.tick();
+  decoupledFetchUnit.requestFromPC();
+  EXPECT_EQ(wideOutput.getTailSlots()[3].size(), 1);
+  EXPECT_EQ(wideOutput.getTailSlots()[4].size(), 0);
+
+  // The fault is then raised for the instruction at 16
+  wideOutput.fill({});
+  EXPECT_CALL(isa, predecodeFault(16, _)).WillOnce(SetArgReferee<1>(fault));
+  decoupledFetchUnit.tick();
+  EXPECT_EQ(wideOutput.getTailSlots()[0].size(), 1);
+  EXPECT_EQ(wideOutput.getTailSlots()[0][0], uopPtr2);
+  EXPECT_EQ(wideOutput.getTailSlots()[1].size(), 0);
+}
+
+// Tests that an instruction held in the micro-op cache is supplied from it
+// without being requested from memory or pre-decoded again
+TEST_P(PipelineFetchUnitTest, supplyFromMicroOpCache) {
+  ON_CALL(isa, getMaxInstructionSize()).WillByDefault(Return(insnMaxSizeBytes));
+  ON_CALL(isa, getMinInstructionSize()).WillByDefault(Return(insnMinSizeBytes));
+  ON_CALL(*uop, isBranch()).WillByDefault(Return(false));
+  // The cache holds a copy of the pre-decoded micro-op, which it copies again
+  // to supply
+  ON_CALL(*uop, clone()).WillByDefault(Return(uopPtr2));
+  ON_CALL(*uop2, clone()).WillByDefault(Invoke([]() {
+    return makeIntrusive<MockInstruction>();
+  }));
+  MacroOp macroOp = {uopPtr};
+  ON_CALL(isa, predecode(_, _, _, _))
+      .WillByDefault(DoAll(SetArgReferee<3>(macroOp), Return(4)));
+
+  memory::MemoryReadResult read = {
+      {0, blockSize}, RegisterValue(0, blockSize), 1};
+  ON_CALL(memory, getCompletedReads())
+      .WillByDefault(Return(span<memory::MemoryReadResult>(&read, 1)));
+
+  ryml::Tree tree = ryml::parse_in_arena(
+      "{Micro-Op-Cache: {Entries: 16, Associativity: 2, Width: 4}}");
+  MicroOpCache cache(tree.crootref());
+  EXPECT_CALL(memory, requestRead(_, _)).Times(1);
+  FetchUnit cachedFetchUnit(output, memory, 1024, 0, blockSize, isa, predictor,
+                            nullptr, 0, 0, 1, &cache);
+
+  // The first fetch pre-decodes the instruction, filling the cache
+  EXPECT_CALL(isa, predecode(_, _, 0, _)).Times(1);
+  cachedFetchUnit.tick();
+  EXPECT_TRUE(cache.contains(0));
+
+  // Returning to it, the instruction is supplied from the cache alone
+  cachedFetchUnit.updatePC(0);
+  EXPECT_CALL(memory, requestRead(_, _)).Times(0);
+  EXPECT_CALL(isa, predecode(_, _, _, _)).Times(0);
+  cachedFetchUnit.requestFromPC();
+  output.getTailSlots()[0] = {};
+  cachedFetchUnit.tick();
+  EXPECT_EQ(output.getTailSlots()[0].size(), 1);
+
+  std::map<std::string, std::string> stats;
+  cache.getStats(stats);
+  EXPECT_EQ(stats["uopcache.hits"], "1");
+  EXPECT_EQ(stats["uopcache.misses"], "1");
+}
+
+// Tests that memory is only bypassed for cached instructions while the loop
+// buffer is idle, and that once a loop boundary is registered the cached
+// instructions are read from memory again and recorded by the loop buffer
+TEST_P(PipelineFetchUnitTest, microOpCacheLoopBuffer) {
+  ON_CALL(isa, getMaxInstructionSize()).WillByDefault(Return(insnMaxSizeBytes));
+  ON_CALL(isa, getMinInstructionSize()).WillByDefault(Return(insnMinSizeBytes));
+  // The cache's copies can themselves be copied, keeping whether they are
+  // branches
+  std::function<IntrusivePtr<Instruction>(bool)> makeCopy =
+      [&makeCopy](bool isBranch) {
+        auto copy = makeIntrusive<MockInstruction>();
+        ON_CALL(*copy, isBranch()).WillByDefault(Return(isBranch));
+        ON_CALL(*copy, clone()).WillByDefault(Invoke([&makeCopy, isBranch]() {
+          return makeCopy(isBranch);
+        }));
+        return IntrusivePtr<Instruction>(copy);
+      };
+  ON_CALL(*uop, isBranch()).WillByDefault(Return(false));
+  ON_CALL(*uop, clone()).WillByDefault(Invoke([&]() {
+    return makeCopy(false);
+  }));
+  ON_CALL(*uop2, isBranch()).WillByDefault(Return(true));
+  ON_CALL(*uop2, clone()).WillByDefault(Invoke([&]() {
+    return makeCopy(true);
+  }));
+
+  // A loop of three instructions and a branch back to the start
+  MacroOp mOp = {uopPtr};
+  MacroOp mOp2 = {uopPtr2};
+  ON_CALL(isa, predecode(_, _, Ne(0xC), _))
+      .WillByDefault(DoAll(SetArgReferee<3>(mOp), Return(4)));
+  ON_CALL(isa, predecode(_, _, 0xC, _))
+      .WillByDefault(DoAll(SetArgReferee<3>(mOp2), Return(4)));
+  ON_CALL(predictor, predict(_, _, _))
+      .WillByDefault(Return(BranchPrediction({true, 0x0})));
+  memory::MemoryReadResult read = {
+      {0, blockSize}, RegisterValue(0xFFFF, blockSize), 1};
+  ON_CALL(memory, getCompletedReads())
+      .WillByDefault(Return(span<memory::MemoryReadResult>(&read, 1)));
+
+  ryml::Tree tree = ryml::parse_in_arena(
+      "{Micro-Op-Cache: {Entries: 16, Associativity: 2, Width: 4}}");
+  MicroOpCache cache(tree.crootref());
+  FetchUnit cachedFetchUnit(output, memory, 1024, 0, blockSize, isa, predictor,
+                            nullptr, 0, 0, 1, &cache);
+
+  // The first iteration is pre-decoded from memory, filling the cache
+  EXPECT_CALL(isa, predecode(_, _, _, _)).Times(4);
+  for (int i = 0; i < 4; i++) cachedFetchUnit.tick();
+  EXPECT_TRUE(cache.contains(0xC));
+
+  // Whilst the loop buffer is idle, memory is bypassed
+  EXPECT_CALL(memory, requestRead(_, _)).Times(0);
+  cachedFetchUnit.requestFromPC();
+  cachedFetchUnit.tick();
+  EXPECT_EQ(output.getTailSlots()[0].size(), 1);
+
+  // Once a loop boundary is registered, memory is read again, and the loop
+  // is recorded by the loop buffer, still supplied by the cache
+  cachedFetchUnit.updatePC(0);
+  cachedFetchUnit.registerLoopBoundary(0xC);
+  EXPECT_CALL(memory, requestRead(_, _)).Times(1);
+  cachedFetchUnit.requestFromPC();
+  // One iteration to reach the loop boundary, and one to record the loop
+  for (int i = 0; i < 8; i++) cachedFetchUnit.tick();
+
+  // The loop buffer now supplies the loop without reading memory
+  EXPECT_CALL(memory, requestRead(_, _)).Times(0);
+  EXPECT_CALL(memory, getCompletedReads()).Times(0);
+  cachedFetchUnit.requestFromPC();
+  for (int i = 0; i < 4; i++) {
+    output.getTailSlots()[0] = {};
+    cachedFetchUnit.tick();
+    ASSERT_EQ(output.getTailSlots()[0].size(), 1);
+    EXPECT_EQ(output.getTailSlots()[0][0]->isBranch(), i == 3);
+  }
+
+  std::map<std::string, std::string> stats;
+  cache.getStats(stats);
+  EXPECT_EQ(stats["uopcache.misses"], "4");
+  EXPECT_EQ(stats["uopcache.hits"], "13");
+}
+
 INSTANTIATE_TEST_SUITE_P(PipelineFetchUnitTests, PipelineFetchUnitTest,
                          ::testing::Values(std::pair(2, 4), std::pair(4, 4)));
 
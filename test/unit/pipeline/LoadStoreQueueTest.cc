@@ -65,7 +65,9 @@ class LoadStoreQueueTest : public ::testing::TestWithParam<bool> {
                           uint16_t storeBandwidth = UINT16_MAX,
                           uint16_t permittedRequests = UINT16_MAX,
                           uint16_t permittedLoads = UINT16_MAX,
-                          uint16_t permittedStores = UINT16_MAX) {
+                          uint16_t permittedStores = UINT16_MAX,
+                          memory::Tlb* dataTlb = nullptr,
+                          StoreSetPredictor* storeSetPredictor = nullptr) {
     if (GetParam()) {
       // Combined queue
       return LoadStoreQueue(
@@ -75,7 +77,8 @@ class LoadStoreQueueTest : public ::testing::TestWithParam<bool> {
             forwardOperandsHandler.forwardOperands(registers, values);
           },
           [](auto uop) {}, exclusive, loadBandwidth, storeBandwidth,
-          permittedRequests, permittedLoads, permittedStores);
+          permittedRequests, permittedLoads, permittedStores, dataTlb,
+          storeSetPredictor);
     } else {
       // Split queue
       return LoadStoreQueue(
@@ -85,7 +88,8 @@ class LoadStoreQueueTest : public ::testing::TestWithParam<bool> {
             forwardOperandsHandler.forwardOperands(registers, values);
           },
           [](auto uop) {}, exclusive, loadBandwidth, storeBandwidth,
-          permittedRequests, permittedLoads, permittedStores);
+          permittedRequests, permittedLoads, permittedStores, dataTlb,
+          storeSetPredictor);
     }
   }
 
@@ -120,7 +124,7 @@ class LoadStoreQueueTest : public ::testing::TestWithParam<bool> {
     return queue.commitStore(storeUopPtr);
   }
 
-  std::vector<pipeline::PipelineBuffer<std::shared_ptr<Instruction>>>
+  std::vector<pipeline::PipelineBuffer<IntrusivePtr<Instruction>>>
       completionSlots;
 
   std::vector<memory::MemoryAccessTarget> addresses;
@@ -137,11 +141,11 @@ class LoadStoreQueueTest : public ::testing::TestWithParam<bool> {
   MockInstruction* storeUop2;
   MockInstruction* loadStoreUop;
 
-  std::shared_ptr<Instruction> loadUopPtr;
-  std::shared_ptr<Instruction> loadUopPtr2;
-  std::shared_ptr<MockInstruction> storeUopPtr;
-  std::shared_ptr<MockInstruction> storeUopPtr2;
-  std::shared_ptr<MockInstruction> loadStoreUopPtr;
+  IntrusivePtr<Instruction> loadUopPtr;
+  IntrusivePtr<Instruction> loadUopPtr2;
+  IntrusivePtr<MockInstruction> storeUopPtr;
+  IntrusivePtr<MockInstruction> storeUopPtr2;
+  IntrusivePtr<MockInstruction> loadStoreUopPtr;
 
   MockForwardOperandsHandler forwardOperandsHandler;
 
@@ -820,6 +824,7 @@ TEST_P(LoadStoreQueueTest, FlushDuringConfliction) {
   queue.addLoad(loadUopPtr);
   queue.addLoad(loadUopPtr2);
 
+  queue.startStore(storeUopPtr);
   queue.startLoad(loadUopPtr);
   loadUop->setExecuted(true);
   loadUop->setCommitReady();
@@ -840,9 +845,9 @@ TEST_P(LoadStoreQueueTest, FlushDuringConfliction) {
   queue.tick();
 }
 
-// Test that a load access exactly conflicting on a store access (matching
-// address and access size no larger) gets its data supplied when the store
-// commits
+// Test that a load access wholly written by a store access gets its data
+// supplied when the store commits, while accesses the store only partly writes
+// also read memory
 TEST_P(LoadStoreQueueTest, SupplyDataToConfliction) {
   auto queue = getQueue();
 
@@ -880,14 +885,15 @@ TEST_P(LoadStoreQueueTest, SupplyDataToConfliction) {
   queue.addStore(storeUopPtr);
   queue.addLoad(loadUopPtr);
 
-  // Supply store data so the store can commit
+  // Generate the store's addresses and supply its data so the store can commit
+  queue.startStore(storeUopPtr);
   queue.supplyStoreData(storeUopPtr);
 
   // Start the load so the confliction can be registered
   queue.startLoad(loadUopPtr);
 
-  // Two of the accesses don't exactly conflict so they should generate memory
-  // accesses
+  // Two of the accesses aren't wholly written by the store so they should
+  // generate memory accesses
   EXPECT_CALL(dataMemory, requestRead(loadAddresses[1], 1)).Times(1);
   EXPECT_CALL(dataMemory, requestRead(loadAddresses[2], 1)).Times(1);
   queue.tick();
@@ -898,7 +904,237 @@ TEST_P(LoadStoreQueueTest, SupplyDataToConfliction) {
               supplyData(loadAddresses[0].address,
                          Property(&RegisterValue::get<uint8_t>, storeData[0])))
       .Times(1);
-  queue.commitStore(storeUopPtr);
+  // The load read every byte the store writes from it, so the store's commit
+  // is no violation
+  EXPECT_FALSE(queue.commitStore(storeUopPtr));
+}
+
+// Test that an access partly written by a store merges the store's bytes with
+// those read from memory
+TEST_P(LoadStoreQueueTest, PartialForwarding) {
+  auto queue = getQueue();
+
+  storeUop->setSequenceId(0);
+  storeUop->setInstructionId(0);
+  loadUop->setSequenceId(1);
+  loadUop->setInstructionId(1);
+
+  // The store writes the upper two bytes of the load's access
+  std::vector<memory::MemoryAccessTarget> storeAddresses = {{2, 2}};
+  span<const memory::MemoryAccessTarget> storeAddressesSpan = {
+      storeAddresses.data(), storeAddresses.size()};
+  std::vector<RegisterValue> storeData = {static_cast<uint16_t>(0xAABB)};
+  span<const RegisterValue> storeDataSpan = {storeData.data(),
+                                             storeData.size()};
+  ON_CALL(*storeUop, getGeneratedAddresses())
+      .WillByDefault(Return(storeAddressesSpan));
+  ON_CALL(*storeUop, getData()).WillByDefault(Return(storeDataSpan));
+
+  std::vector<memory::MemoryAccessTarget> loadAddresses = {{0, 4}};
+  span<const memory::MemoryAccessTarget> loadAddressesSpan = {
+      loadAddresses.data(), loadAddresses.size()};
+  ON_CALL(*loadUop, getGeneratedAddresses())
+      .WillByDefault(Return(loadAddressesSpan));
+
+  queue.addStore(storeUopPtr);
+  queue.addLoad(loadUopPtr);
+  queue.startStore(storeUopPtr);
+  queue.supplyStoreData(storeUopPtr);
+  queue.startLoad(loadUopPtr);
+
+  // The whole access is read from memory, completing before the store commits
+  memory::MemoryReadResult completedRead = {
+      loadAddresses[0], RegisterValue(static_cast<uint32_t>(0x11223344)), 1};
+  span<memory::MemoryReadResult> completedReads = {&completedRead, 1};
+  EXPECT_CALL(dataMemory, requestRead(loadAddresses[0], 1)).Times(1);
+  EXPECT_CALL(dataMemory, getCompletedReads())
+      .WillOnce(Return(completedReads))
+      .WillRepeatedly(Return(span<memory::MemoryReadResult>()));
+  EXPECT_CALL(*loadUop, supplyData(_, _)).Times(0);
+  queue.tick();
+
+  // The store's bytes replace those read from memory
+  EXPECT_CALL(*loadUop, supplyData(0, Property(&RegisterValue::get<uint32_t>,
+                                               0xAABB3344)))
+      .Times(1);
+  EXPECT_FALSE(queue.commitStore(storeUopPtr));
+}
+
+// Test that an access written by several stores takes each byte from the
+// youngest older store to write it
+TEST_P(LoadStoreQueueTest, MultipleStoreForwarding) {
+  auto queue = getQueue();
+
+  storeUop->setSequenceId(0);
+  storeUop->setInstructionId(0);
+  storeUop2->setSequenceId(1);
+  storeUop2->setInstructionId(1);
+  loadUop->setSequenceId(2);
+  loadUop->setInstructionId(2);
+
+  // The first store writes bytes 0 to 3, and the second bytes 2 and 3
+  std::vector<memory::MemoryAccessTarget> storeAddresses = {{0, 4}};
+  span<const memory::MemoryAccessTarget> storeAddressesSpan = {
+      storeAddresses.data(), storeAddresses.size()};
+  std::vector<RegisterValue> storeData = {static_cast<uint32_t>(0x11223344)};
+  span<const RegisterValue> storeDataSpan = {storeData.data(),
+                                             storeData.size()};
+  ON_CALL(*storeUop, getGeneratedAddresses())
+      .WillByDefault(Return(storeAddressesSpan));
+  ON_CALL(*storeUop, getData()).WillByDefault(Return(storeDataSpan));
+
+  std::vector<memory::MemoryAccessTarget> storeAddresses2 = {{2, 2}};
+  span<const memory::MemoryAccessTarget> storeAddressesSpan2 = {
+      storeAddresses2.data(), storeAddresses2.size()};
+  std::vector<RegisterValue> storeData2 = {static_cast<uint16_t>(0xAABB)};
+  span<const RegisterValue> storeDataSpan2 = {storeData2.data(),
+                                              storeData2.size()};
+  ON_CALL(*storeUop2, isStoreAddress()).WillByDefault(Return(true));
+  ON_CALL(*storeUop2, isStoreData()).WillByDefault(Return(true));
+  ON_CALL(*storeUop2, getGeneratedAddresses())
+      .WillByDefault(Return(storeAddressesSpan2));
+  ON_CALL(*storeUop2, getData()).WillByDefault(Return(storeDataSpan2));
+
+  std::vector<memory::MemoryAccessTarget> loadAddresses = {{0, 4}};
+  span<const memory::MemoryAccessTarget> loadAddressesSpan = {
+      loadAddresses.data(), loadAddresses.size()};
+  ON_CALL(*loadUop, getGeneratedAddresses())
+      .WillByDefault(Return(loadAddressesSpan));
+
+  queue.addStore(storeUopPtr);
+  queue.addStore(storeUopPtr2);
+  queue.addLoad(loadUopPtr);
+  // Generate the stores' addresses out of program order
+  queue.startStore(storeUopPtr2);
+  queue.startStore(storeUopPtr);
+  queue.supplyStoreData(storeUopPtr);
+  queue.supplyStoreData(storeUopPtr2);
+  queue.startLoad(loadUopPtr);
+
+  // Every byte is forwarded, so memory is not read
+  EXPECT_CALL(dataMemory, requestRead(_, _)).Times(0);
+  queue.tick();
+
+  // The data is supplied once both stores have committed
+  EXPECT_CALL(*loadUop, supplyData(_, _)).Times(0);
+  EXPECT_FALSE(queue.commitStore(storeUopPtr));
+  EXPECT_CALL(*loadUop, supplyData(0, Property(&RegisterValue::get<uint32_t>,
+                                               0xAABB3344)))
+      .Times(1);
+  EXPECT_FALSE(queue.commitStore(storeUopPtr2));
+}
+
+// Tests that requests are held back until their translation is available
+TEST_P(LoadStoreQueueTest, TranslationStall) {
+  memory::Tlb dataTlb("dtlb", 4, 4, 0, 4096, nullptr, 5);
+  auto queue = getQueue(false, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX,
+                        UINT16_MAX, &dataTlb);
+  loadUop->setSequenceId(1);
+  loadUop->setLSQLatency(1);
+  queue.addLoad(loadUopPtr);
+  queue.startLoad(loadUopPtr);
+
+  // The page walk begins when the request is first ready to issue
+  EXPECT_CALL(dataMemory, requestRead(_, _)).Times(0);
+  for (int i = 0; i < 5; i++) queue.tick();
+
+  EXPECT_CALL(dataMemory, requestRead(addresses[0], 1)).Times(1);
+  queue.tick();
+  EXPECT_EQ(queue.getTranslationStalls(), 5);
+
+  std::map<std::string, std::string> stats;
+  dataTlb.getStats(stats);
+  EXPECT_EQ(stats["dtlb.misses"], "1");
+  EXPECT_EQ(stats["dtlb.hits"], "0");
+}
+
+// Tests that a request flushed while waiting for its translation doesn't pass
+// its translation on to the next request to issue
+TEST_P(LoadStoreQueueTest, FlushDuringTranslationStall) {
+  memory::Tlb dataTlb("dtlb", 4, 4, 0, 4096, nullptr, 5);
+  auto queue = getQueue(false, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX,
+                        UINT16_MAX, &dataTlb);
+  std::vector<memory::MemoryAccessTarget> addresses2 = {{8192, 1}};
+  ON_CALL(*loadUop2, isLoad()).WillByDefault(Return(true));
+  ON_CALL(*loadUop2, getGeneratedAddresses())
+      .WillByDefault(Return(span<const memory::MemoryAccessTarget>(
+          addresses2.data(), addresses2.size())));
+  loadUop->setSequenceId(1);
+  loadUop->setLSQLatency(1);
+  loadUop2->setSequenceId(2);
+  loadUop2->setLSQLatency(1);
+
+  // Flush the first load part way through its page walk
+  EXPECT_CALL(dataMemory, requestRead(_, _)).Times(0);
+  queue.addLoad(loadUopPtr);
+  queue.startLoad(loadUopPtr);
+  queue.tick();
+  queue.tick();
+  loadUop->setFlushed();
+  queue.purgeFlushed();
+
+  // Once the abandoned walk would have completed, a load to another page
+  // must still wait for its own
+  for (int i = 0; i < 5; i++) queue.tick();
+  queue.addLoad(loadUopPtr2);
+  queue.startLoad(loadUopPtr2);
+  uint64_t stalls = queue.getTranslationStalls();
+  for (int i = 0; i < 5; i++) queue.tick();
+
+  EXPECT_CALL(dataMemory, requestRead(addresses2[0], _)).Times(1);
+  queue.tick();
+  EXPECT_EQ(queue.getTranslationStalls() - stalls, 5);
+}
+
+// Tests that a load which caused a violation waits for the next instance of
+// the store to generate its addresses, and then forwards from it
+TEST_P(LoadStoreQueueTest, PredictedDependence) {
+  ryml::Tree config = ryml::parse_in_arena(
+      "{Memory-Dependence-Predictor: {Store-Set-ID-Entries: 64, Store-Sets: "
+      "16, Clear-Interval: 0}}");
+  StoreSetPredictor predictor(config.crootref());
+  auto queue = getQueue(false, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX,
+                        UINT16_MAX, nullptr, &predictor);
+
+  storeUop->setInstructionAddress(0x100);
+  storeUop2->setInstructionAddress(0x100);
+  loadUop->setInstructionAddress(0x108);
+  loadUop2->setInstructionAddress(0x108);
+  ON_CALL(*storeUop2, isStoreAddress()).WillByDefault(Return(true));
+  ON_CALL(*storeUop2, isStoreData()).WillByDefault(Return(true));
+  ON_CALL(*storeUop2, getGeneratedAddresses())
+      .WillByDefault(Return(addressesSpan));
+  ON_CALL(*storeUop2, getData()).WillByDefault(Return(dataSpan));
+  ON_CALL(*loadUop2, isLoad()).WillByDefault(Return(true));
+  ON_CALL(*loadUop2, getGeneratedAddresses())
+      .WillByDefault(Return(addressesSpan));
+
+  // The first load reads memory ahead of the store, causing a violation
+  EXPECT_TRUE(executeRAWSequence(queue));
+  EXPECT_CALL(dataMemory, requestRead(addresses[0], 1)).Times(1);
+  queue.tick();
+  queue.commitLoad(loadUopPtr);
+  EXPECT_EQ(queue.getPredictedDependences(), 0);
+
+  // The next instance of the load waits for the store's addresses
+  storeUop2->setSequenceId(2);
+  loadUop2->setSequenceId(3);
+  queue.addStore(storeUopPtr2);
+  queue.addLoad(loadUopPtr2);
+  queue.startLoad(loadUopPtr2);
+  EXPECT_EQ(queue.getPredictedDependences(), 1);
+  EXPECT_CALL(dataMemory, requestRead(_, _)).Times(0);
+  queue.tick();
+
+  // Once the store has generated its addresses, the load forwards from it
+  queue.startStore(storeUopPtr2);
+  queue.supplyStoreData(storeUopPtr2);
+  queue.tick();
+  EXPECT_CALL(*loadUop2,
+              supplyData(addresses[0].address,
+                         Property(&RegisterValue::get<uint8_t>, data[0])))
+      .Times(1);
+  EXPECT_FALSE(queue.commitStore(storeUopPtr2));
 }
 
 INSTANTIATE_TEST_SUITE_P(LoadStoreQueueTests, LoadStoreQueueTest,
@@ -0,0 +1,108 @@
+#include "../MockInstruction.hh"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "simeng/pipeline/MicroOpCache.hh"
+
+using ::testing::Return;
+
+namespace simeng {
+namespace pipeline {
+
+class MicroOpCacheTest : public testing::Test {
+ public:
+  MicroOpCacheTest()
+      : tree(ryml::parse_in_arena(
+            "{Micro-Op-Cache: {Entries: 4, Associativity: 2, Width: 4}}")),
+        uop(new MockInstruction),
+        uopPtr(uop),
+        copy(new MockInstruction),
+        copyPtr(copy),
+        suppliedPtr(makeIntrusive<MockInstruction>()) {
+    // The cache copies the micro-ops filled, and copies those to supply them
+    ON_CALL(*uop, clone()).WillByDefault(Return(copyPtr));
+    ON_CALL(*copy, clone()).WillByDefault(Return(suppliedPtr));
+  }
+
+ protected:
+  ryml::Tree tree;
+
+  MockInstruction* uop;
+  IntrusivePtr<Instruction> uopPtr;
+  MockInstruction* copy;
+  IntrusivePtr<Instruction> copyPtr;
+  IntrusivePtr<Instruction> suppliedPtr;
+};
+
+// Tests that a filled instruction is supplied as copies of its micro-ops, and
+// that lookups are counted as hits or misses by whether they supplied it
+TEST_F(MicroOpCacheTest, fillThenSupply) {
+  MicroOpCache cache(tree.crootref());
+  MacroOp output;
+  EXPECT_FALSE(cache.contains(0x100));
+  EXPECT_EQ(cache.supply(0x100, 4, output), 0);
+
+  EXPECT_CALL(*uop, clone()).Times(2);
+  cache.fill(0x100, {uopPtr, uopPtr}, 4);
+  EXPECT_TRUE(cache.contains(0x100));
+  EXPECT_EQ(cache.getWidth(), 4);
+
+  // An instruction larger than the bytes available isn't supplied
+  EXPECT_EQ(cache.supply(0x100, 2, output), 0);
+  EXPECT_EQ(cache.supply(0x100, 4, output), 4);
+  ASSERT_EQ(output.size(), 2);
+  EXPECT_EQ(output[0], suppliedPtr);
+  EXPECT_EQ(output[1], suppliedPtr);
+
+  std::map<std::string, std::string> stats;
+  cache.getStats(stats);
+  EXPECT_EQ(stats["uopcache.hits"], "1");
+  EXPECT_EQ(stats["uopcache.misses"], "2");
+  EXPECT_EQ(stats["uopcache.missrate"], "66.7%");
+}
+
+// Tests that the least recently used instruction of a set is replaced
+TEST_F(MicroOpCacheTest, replacement) {
+  MicroOpCache cache(tree.crootref());
+  MacroOp output;
+  // 0x100, 0x108, and 0x110 share a set of the two sets
+  cache.fill(0x100, {uopPtr}, 4);
+  cache.fill(0x108, {uopPtr}, 4);
+  cache.supply(0x100, 4, output);
+  cache.fill(0x110, {uopPtr}, 4);
+
+  EXPECT_TRUE(cache.contains(0x100));
+  EXPECT_FALSE(cache.contains(0x108));
+  EXPECT_TRUE(cache.contains(0x110));
+  // The other set is unaffected
+  cache.fill(0x104, {uopPtr}, 4);
+  EXPECT_TRUE(cache.contains(0x100));
+  EXPECT_TRUE(cache.contains(0x104));
+}
+
+// Tests that a write invalidates only the instructions it overlaps
+TEST_F(MicroOpCacheTest, invalidate) {
+  MicroOpCache cache(tree.crootref());
+  cache.fill(0x100, {uopPtr}, 4);
+  cache.fill(0x104, {uopPtr}, 4);
+  cache.fill(0x108, {uopPtr}, 4);
+
+  // A write ending within the first byte of an instruction overlaps it
+  cache.invalidate(0xFE, 3);
+  EXPECT_FALSE(cache.contains(0x100));
+  EXPECT_TRUE(cache.contains(0x104));
+
+  // A write starting within the last byte of an instruction overlaps it
+  cache.invalidate(0x107, 1);
+  EXPECT_FALSE(cache.contains(0x104));
+  EXPECT_TRUE(cache.contains(0x108));
+
+  cache.invalidate(0x10C, 4);
+  EXPECT_TRUE(cache.contains(0x108));
+
+  std::map<std::string, std::string> stats;
+  cache.getStats(stats);
+  EXPECT_EQ(stats["uopcache.invalidations"], "2");
+}
+
+}  // namespace pipeline
+}  // namespace simeng
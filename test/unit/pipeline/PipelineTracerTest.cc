@@ -0,0 +1,130 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "../MockInstruction.hh"
+#include "gtest/gtest.h"
+#include "simeng/pipeline/PipelineTracer.hh"
+
+namespace simeng {
+namespace pipeline {
+
+class PipelineTracerTest : public testing::Test {
+ public:
+  PipelineTracerTest()
+      : uop(makeIntrusive<MockInstruction>()),
+        uop2(makeIntrusive<MockInstruction>()) {
+    uop->setInstructionAddress(0x100);
+    uop2->setInstructionAddress(0x104);
+  }
+
+ protected:
+  void TearDown() override { std::remove(path.c_str()); }
+
+  /** Read the whole of the trace written. */
+  std::string readTrace() {
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+  }
+
+  std::string path =
+      (std::filesystem::temp_directory_path() / "simeng_trace_test.log")
+          .string();
+
+  IntrusivePtr<Instruction> uop;
+  IntrusivePtr<Instruction> uop2;
+};
+
+// Tests that stages, commits, and uops dropped from the pipeline are written
+// in Konata's format, ignoring events repeated by a stalled stage
+TEST_F(PipelineTracerTest, konata) {
+  PipelineTracer tracer(path, PipelineTraceFormat::Konata, 0, 0, 0, 0);
+  tracer.tick(1, 0);
+  tracer.fetch(uop, 0);
+  tracer.fetch(uop2, 1);
+
+  tracer.tick(2, 0);
+  tracer.record(uop, PipelineEvent::Decode);
+  tracer.record(uop, PipelineEvent::Decode);
+  // The second uop is discarded by the pipeline in this cycle
+  uop2.reset();
+
+  tracer.tick(3, 0);
+  tracer.record(uop, PipelineEvent::Commit);
+  EXPECT_EQ(tracer.getTracedCount(), 2);
+  tracer.finish();
+
+  EXPECT_EQ(readTrace(),
+            "Kanata\t0004\n"
+            "C=\t1\n"
+            "I\t0\t0\t0\nL\t0\t0\t0x100\nS\t0\t0\tF\n"
+            "I\t1\t1\t0\nL\t1\t0\t0x104 uop 1\nS\t1\t0\tF\n"
+            "C\t1\n"
+            "E\t0\t0\tF\nS\t0\t0\tDc\n"
+            "R\t1\t0\t1\n"
+            "C\t1\n"
+            "R\t0\t0\t0\n");
+  EXPECT_FALSE(std::filesystem::exists(path + ".bin"));
+}
+
+// Tests that only uops fetched within the cycle window are traced, and are
+// followed beyond it, written in gem5's O3PipeView format
+TEST_F(PipelineTracerTest, o3PipeViewCycleWindow) {
+  PipelineTracer tracer(path, PipelineTraceFormat::O3PipeView, 2, 1, 0, 0);
+  tracer.tick(1, 0);
+  tracer.fetch(uop, 0);
+
+  tracer.tick(2, 0);
+  tracer.fetch(uop2, 0);
+  tracer.record(uop, PipelineEvent::Decode);
+
+  tracer.tick(3, 0);
+  tracer.fetch(makeIntrusive<MockInstruction>(), 0);
+  tracer.record(uop2, PipelineEvent::Issue);
+
+  tracer.tick(4, 0);
+  tracer.record(uop2, PipelineEvent::Commit);
+  EXPECT_EQ(tracer.getTracedCount(), 1);
+  tracer.finish();
+
+  EXPECT_EQ(readTrace(),
+            "O3PipeView:fetch:2000:0x00000104:0:1:\n"
+            "O3PipeView:decode:0\n"
+            "O3PipeView:rename:0\n"
+            "O3PipeView:dispatch:0\n"
+            "O3PipeView:issue:3000\n"
+            "O3PipeView:complete:0\n"
+            "O3PipeView:retire:4000:store:0\n");
+}
+
+// Tests that the instruction window opens and closes with the number of
+// instructions retired
+TEST_F(PipelineTracerTest, instructionWindow) {
+  PipelineTracer tracer(path, PipelineTraceFormat::Konata, 0, 0, 5, 2);
+  tracer.tick(1, 4);
+  tracer.fetch(uop, 0);
+  EXPECT_EQ(tracer.getTracedCount(), 0);
+
+  tracer.tick(2, 5);
+  tracer.fetch(uop, 0);
+  EXPECT_EQ(tracer.getTracedCount(), 1);
+
+  tracer.tick(3, 7);
+  tracer.fetch(uop2, 0);
+  EXPECT_EQ(tracer.getTracedCount(), 1);
+}
+
+// Tests that a window lying entirely within skipped cycles traces nothing
+TEST_F(PipelineTracerTest, skippedWindow) {
+  PipelineTracer tracer(path, PipelineTraceFormat::Konata, 2, 3, 0, 0);
+  tracer.tick(1, 0);
+  tracer.tick(10, 0);
+  tracer.fetch(uop, 0);
+  EXPECT_EQ(tracer.getTracedCount(), 0);
+}
+
+}  // namespace pipeline
+}  // namespace simeng
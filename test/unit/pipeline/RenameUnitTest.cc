@@ -47,12 +47,12 @@ class RenameUnitTest : public testing::Test {
   const unsigned int robSize = 8;
   const unsigned int lsqQueueSize = 10;
 
-  PipelineBuffer<std::shared_ptr<Instruction>> input;
-  PipelineBuffer<std::shared_ptr<Instruction>> output;
+  PipelineBuffer<IntrusivePtr<Instruction>> input;
+  PipelineBuffer<IntrusivePtr<Instruction>> output;
 
   MockMemoryInterface memory;
   MockBranchPredictor predictor;
-  span<PipelineBuffer<std::shared_ptr<Instruction>>> completionSlots;
+  span<PipelineBuffer<IntrusivePtr<Instruction>>> completionSlots;
 
   RegisterAliasTable rat;
   LoadStoreQueue lsq;
@@ -64,9 +64,9 @@ class RenameUnitTest : public testing::Test {
   MockInstruction* uop2;
   MockInstruction* uop3;
 
-  std::shared_ptr<Instruction> uopPtr;
-  std::shared_ptr<Instruction> uop2Ptr;
-  std::shared_ptr<Instruction> uop3Ptr;
+  IntrusivePtr<Instruction> uopPtr;
+  IntrusivePtr<Instruction> uop2Ptr;
+  IntrusivePtr<Instruction> uop3Ptr;
 };
 
 // Test the correct functionality when input buffer and unit is empty
@@ -193,6 +193,40 @@ TEST_F(RenameUnitTest, noFreeRegs) {
   EXPECT_EQ(renameUnit.getStoreQueueStalls(), 0);
 }
 
+// Tests that a stalled unit is idle, and that skipping ticks counts the stall
+// each would have recorded
+TEST_F(RenameUnitTest, skipStalledTicks) {
+  for (int i = 0; i < physRegCounts[0] - archRegFileStruct[0].quantity; i++) {
+    rat.allocate(r0);
+  }
+
+  input.getHeadSlots()[0] = uopPtr;
+  std::array<Register, 1> destRegs = {r0};
+  ON_CALL(*uop, getDestinationRegisters())
+      .WillByDefault(Return(span<Register>(destRegs)));
+  ON_CALL(*uop, isLoad()).WillByDefault(Return(false));
+  ON_CALL(*uop, isStoreAddress()).WillByDefault(Return(false));
+
+  // The input is yet to be stalled by the allocation failure
+  EXPECT_FALSE(renameUnit.isIdle());
+  renameUnit.tick();
+  EXPECT_TRUE(renameUnit.isIdle());
+
+  renameUnit.skipTicks(5);
+  EXPECT_EQ(renameUnit.getAllocationStalls(), 6);
+
+  // Nothing is counted while the output is stalled
+  output.stall(true);
+  EXPECT_TRUE(renameUnit.isIdle());
+  renameUnit.skipTicks(5);
+  EXPECT_EQ(renameUnit.getAllocationStalls(), 6);
+
+  // Once a register is freed the uop may be renamed
+  output.stall(false);
+  rat.commit(r0);
+  EXPECT_FALSE(renameUnit.isIdle());
+}
+
 // Tests that when ROB is full, no renaming occurs
 TEST_F(RenameUnitTest, fullROB) {
   // Pre-fill ROB
@@ -1,8 +1,10 @@
+#include "../MockArchitecture.hh"
 #include "../MockBranchPredictor.hh"
 #include "../MockInstruction.hh"
 #include "../MockMemoryInterface.hh"
 #include "gtest/gtest.h"
 #include "simeng/Instruction.hh"
+#include "simeng/memory/ExclusiveMonitor.hh"
 #include "simeng/pipeline/LoadStoreQueue.hh"
 #include "simeng/pipeline/ReorderBuffer.hh"
 
@@ -16,7 +18,7 @@ namespace pipeline {
 
 class MockExceptionHandler {
  public:
-  MOCK_METHOD1(raiseException, void(std::shared_ptr<Instruction> instruction));
+  MOCK_METHOD1(raiseException, void(IntrusivePtr<Instruction> instruction));
 };
 
 class ReorderBufferTest : public testing::Test {
@@ -55,9 +57,9 @@ class ReorderBufferTest : public testing::Test {
   MockInstruction* uop2;
   MockInstruction* uop3;
 
-  std::shared_ptr<Instruction> uopPtr;
-  std::shared_ptr<Instruction> uopPtr2;
-  std::shared_ptr<Instruction> uopPtr3;
+  IntrusivePtr<Instruction> uopPtr;
+  IntrusivePtr<Instruction> uopPtr2;
+  IntrusivePtr<Instruction> uopPtr3;
 
   MockMemoryInterface dataMemory;
 
@@ -108,6 +110,21 @@ TEST_F(ReorderBufferTest, Commit) {
   EXPECT_EQ(reorderBuffer.getInstructionsCommittedCount(), 1);
 }
 
+// Tests that the commit observer is called with each committed instruction
+TEST_F(ReorderBufferTest, CommitObserver) {
+  std::vector<IntrusivePtr<Instruction>> observed;
+  reorderBuffer.setCommitObserver(
+      [&observed](const auto& insn) { observed.push_back(insn); });
+  reorderBuffer.reserve(uopPtr);
+  reorderBuffer.reserve(uopPtr2);
+  uop->setCommitReady();
+
+  reorderBuffer.commit(2);
+
+  ASSERT_EQ(observed.size(), 1);
+  EXPECT_EQ(observed[0], uopPtr);
+}
+
 // Tests that the reorder buffer won't commit an instruction if it's not ready
 TEST_F(ReorderBufferTest, CommitNotReady) {
   reorderBuffer.reserve(uopPtr);
@@ -290,6 +307,131 @@ TEST_F(ReorderBufferTest, commitMicroOps) {
   EXPECT_EQ(reorderBuffer.size(), 0);
 }
 
+// Tests that micro-op groups are found once the ROB has wrapped around, and
+// that the IDs of instructions removed by a flush are not reused
+TEST_F(ReorderBufferTest, commitMicroOpsWrapped) {
+  // Fill and drain most of the ROB so that later entries wrap around
+  for (int i = 0; i < maxROBSize - 1; i++) {
+    auto insn = makeIntrusive<MockInstruction>();
+    reorderBuffer.reserve(insn);
+    insn->setCommitReady();
+    EXPECT_EQ(reorderBuffer.commit(1), 1);
+  }
+
+  // Reserve a split macro-op followed by a younger instruction
+  uop->setIsMicroOp(true);
+  uop->setIsLastMicroOp(false);
+  uop2->setIsMicroOp(true);
+  uop2->setIsLastMicroOp(true);
+  reorderBuffer.reserve(uopPtr);
+  reorderBuffer.reserve(uopPtr2);
+  reorderBuffer.reserve(uopPtr3);
+  uint64_t insnId = uopPtr->getInstructionId();
+  EXPECT_EQ(uopPtr2->getInstructionId(), insnId);
+  EXPECT_EQ(uopPtr3->getInstructionId(), insnId + 1);
+
+  // Flushing the younger instruction leaves a gap in the IDs
+  reorderBuffer.flush(insnId);
+  EXPECT_TRUE(uopPtr3->isFlushed());
+  auto insn = makeIntrusive<MockInstruction>();
+  reorderBuffer.reserve(insn);
+  EXPECT_EQ(insn->getInstructionId(), insnId + 2);
+
+  uop->setWaitingCommit();
+  reorderBuffer.commitMicroOps(insnId);
+  EXPECT_FALSE(uopPtr->canCommit());
+  uop2->setWaitingCommit();
+  reorderBuffer.commitMicroOps(insnId);
+  EXPECT_TRUE(uopPtr->canCommit());
+  EXPECT_TRUE(uopPtr2->canCommit());
+  EXPECT_FALSE(insn->canCommit());
+
+  EXPECT_EQ(reorderBuffer.commit(3), 2);
+  EXPECT_EQ(reorderBuffer.getHead(), insn);
+
+  // The group after the gap is still found from its ID
+  insn->setWaitingCommit();
+  reorderBuffer.commitMicroOps(insnId + 2);
+  EXPECT_TRUE(insn->canCommit());
+}
+
+// Tests that an exclusive store whose reservation was lost after it executed
+// flushes itself and younger instructions, and that those reserved to retry
+// them are given new IDs rather than those flushed
+TEST_F(ReorderBufferTest, exclusiveRetryFlush) {
+  kernel::Linux linux(
+      config::SimInfo::getConfig()["CPU-Info"]["Special-File-Dir-Path"]
+          .as<std::string>());
+  MockArchitecture isa(linux);
+  memory::ExclusiveMonitor monitor(memory, sizeof(memory), 2);
+  isa.setExclusiveMonitor(&monitor, 0);
+  LoadStoreQueue exclusiveLsq(
+      maxLSQLoads, maxLSQStores, dataMemory, {nullptr, 0},
+      [](auto registers, auto values) {}, [](auto uop) {}, false, UINT16_MAX,
+      UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX, nullptr, nullptr, &isa);
+  ReorderBuffer rob(
+      maxROBSize, rat, exclusiveLsq, [](auto insn) {},
+      [](auto branchAddress) {}, predictor, 4, 2);
+
+  // Commit an older instruction
+  auto older = makeIntrusive<MockInstruction>();
+  rob.reserve(older);
+  older->setCommitReady();
+  EXPECT_EQ(rob.commit(1), 1);
+
+  // Reserve an exclusive store which held its reservation when executed,
+  // followed by a younger instruction
+  const memory::MemoryAccessTarget target = {16, 4};
+  span<const memory::MemoryAccessTarget> targetSpan = {&target, 1};
+  RegisterValue data = RegisterValue(0xABCD, 4);
+  span<const RegisterValue> dataSpan = {&data, 1};
+  ON_CALL(*uop, isStoreData()).WillByDefault(Return(true));
+  ON_CALL(*uop, isAtomic()).WillByDefault(Return(true));
+  ON_CALL(*uop, getGeneratedAddresses()).WillByDefault(Return(targetSpan));
+  ON_CALL(*uop, getData()).WillByDefault(Return(dataSpan));
+  uop->setHoldsReservation(true);
+  rob.reserve(uopPtr);
+  rob.reserve(uopPtr2);
+  uint64_t storeId = uopPtr->getInstructionId();
+  uopPtr->setCommitReady();
+  uopPtr2->setCommitReady();
+
+  // Another core writes to the reserved memory before the store commits, so
+  // the store and younger instructions must be executed again
+  monitor.reserve(0, target, RegisterValue(0, 4));
+  monitor.recordStore(1, target);
+  EXPECT_EQ(rob.commit(2), 0);
+  EXPECT_TRUE(rob.shouldFlush());
+  EXPECT_EQ(rob.getFlushInsnId(), storeId - 1);
+  rob.flush(rob.getFlushInsnId());
+  EXPECT_TRUE(uopPtr->isFlushed());
+  EXPECT_TRUE(uopPtr2->isFlushed());
+  EXPECT_EQ(rob.size(), 0);
+
+  // Reserve the store again, having lost its reservation when re-executed,
+  // and the younger instruction
+  auto retryStore = makeIntrusive<MockInstruction>();
+  ON_CALL(*retryStore, isStoreData()).WillByDefault(Return(true));
+  ON_CALL(*retryStore, isAtomic()).WillByDefault(Return(true));
+  auto retryYounger = makeIntrusive<MockInstruction>();
+  rob.reserve(retryStore);
+  rob.reserve(retryYounger);
+  EXPECT_GT(retryStore->getInstructionId(), uopPtr2->getInstructionId());
+  EXPECT_GT(retryYounger->getInstructionId(), retryStore->getInstructionId());
+
+  // Late notifications for the flushed store no longer match any instruction
+  retryStore->setWaitingCommit();
+  rob.commitMicroOps(storeId);
+  EXPECT_FALSE(retryStore->canCommit());
+  rob.commitMicroOps(retryStore->getInstructionId());
+  EXPECT_TRUE(retryStore->canCommit());
+
+  retryYounger->setCommitReady();
+  EXPECT_EQ(rob.commit(2), 2);
+  EXPECT_FALSE(rob.shouldFlush());
+  EXPECT_EQ(rob.getInstructionsCommittedCount(), 3);
+}
+
 // Test that a detected violating load in the lsq leads to a flush
 TEST_F(ReorderBufferTest, violatingLoad) {
   const uint64_t strAddr = 16;
@@ -321,8 +463,9 @@ TEST_F(ReorderBufferTest, violatingLoad) {
   EXPECT_EQ(reorderBuffer.size(), 2);
 
   // Start load "Out of order"
+  // The store hasn't started, so isn't forwarded from
   EXPECT_CALL(*uop2, getGeneratedAddresses()).Times(1);
-  EXPECT_CALL(*uop, getGeneratedAddresses()).Times(1);
+  EXPECT_CALL(*uop, getGeneratedAddresses()).Times(0);
   lsq.startLoad(uopPtr2);
 
   // Set store "ready to commit" so that violation gets detected
@@ -0,0 +1,87 @@
+#include "../MockInstruction.hh"
+#include "gtest/gtest.h"
+#include "simeng/pipeline/RequestWheel.hh"
+
+namespace simeng {
+namespace pipeline {
+
+class RequestWheelTest : public testing::Test {
+ public:
+  RequestWheelTest() {
+    for (int i = 0; i < 4; i++) {
+      uops.push_back(makeIntrusive<MockInstruction>());
+      uops.back()->setSequenceId(i);
+    }
+  }
+
+ protected:
+  /** Advance `wheel` to `cycle`, returning the sequence IDs of the entries
+   * ready, and removing them. */
+  std::vector<uint64_t> drain(RequestWheel& wheel, uint64_t cycle) {
+    std::vector<uint64_t> ready;
+    wheel.advance(cycle);
+    while (wheel.hasReady()) {
+      ready.push_back(wheel.front().insn->getSequenceId());
+      wheel.popFront();
+    }
+    return ready;
+  }
+
+  std::vector<IntrusivePtr<MockInstruction>> uops;
+};
+
+// Tests that entries become ready on their cycle, in cycle then insertion
+// order
+TEST_F(RequestWheelTest, order) {
+  RequestWheel wheel(4);
+  wheel.insert(3, uops[0]);
+  wheel.insert(2, uops[1]);
+  wheel.insert(3, uops[2]);
+  EXPECT_EQ(drain(wheel, 1), std::vector<uint64_t>());
+  wheel.advance(2);
+  wheel.advance(3);
+  EXPECT_EQ(drain(wheel, 3), std::vector<uint64_t>({1, 0, 2}));
+  EXPECT_TRUE(wheel.empty());
+
+  // Entries for a cycle already passed are ready immediately
+  wheel.insert(1, uops[3]);
+  EXPECT_TRUE(wheel.hasReady());
+  EXPECT_EQ(drain(wheel, 3), std::vector<uint64_t>({3}));
+}
+
+// Tests that the wheel grows to hold entries beyond its span, keeping those
+// already waiting on their cycles
+TEST_F(RequestWheelTest, grow) {
+  RequestWheel wheel(2);
+  wheel.insert(1, uops[0]);
+  wheel.insert(9, uops[1]);
+  wheel.insert(4, uops[2]);
+  EXPECT_EQ(drain(wheel, 1), std::vector<uint64_t>({0}));
+  EXPECT_EQ(drain(wheel, 8), std::vector<uint64_t>({2}));
+  EXPECT_EQ(drain(wheel, 9), std::vector<uint64_t>({1}));
+}
+
+// Tests that entries stay ready until removed, and that flushed entries are
+// removed whether ready or not
+TEST_F(RequestWheelTest, removeFlushed) {
+  RequestWheel wheel(4);
+  wheel.insert(0, uops[0]).reqAddresses.push_back({0, 8});
+  wheel.insert(0, uops[1]);
+  wheel.insert(2, uops[2]);
+  wheel.advance(1);
+  EXPECT_EQ(wheel.front().reqAddresses.size(), 1);
+  wheel.advance(2);
+  EXPECT_EQ(wheel.front().insn->getSequenceId(), 0);
+
+  uops[0]->setFlushed();
+  uops[2]->setFlushed();
+  wheel.removeFlushed();
+  EXPECT_EQ(drain(wheel, 3), std::vector<uint64_t>({1}));
+  EXPECT_TRUE(wheel.empty());
+
+  // Recycled entries start without addresses
+  EXPECT_EQ(wheel.insert(5, uops[3]).reqAddresses.size(), 0);
+}
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -0,0 +1,65 @@
+#include "gtest/gtest.h"
+#include "simeng/pipeline/StoreSetPredictor.hh"
+
+namespace simeng {
+namespace pipeline {
+
+class StoreSetPredictorTest : public testing::Test {
+ public:
+  StoreSetPredictorTest()
+      : tree(ryml::parse_in_arena(
+            "{Memory-Dependence-Predictor: {Store-Set-ID-Entries: 1024, "
+            "Store-Sets: 16, Clear-Interval: 8}}")) {}
+
+ protected:
+  ryml::Tree tree;
+};
+
+// Tests that loads are predicted independent until they violate against a
+// store, after which they depend on its most recent in-flight instance
+TEST_F(StoreSetPredictorTest, train) {
+  StoreSetPredictor predictor(tree.crootref());
+  predictor.addStore(0x100, 1);
+  EXPECT_EQ(predictor.predictDependence(0x200), UINT64_MAX);
+
+  predictor.train(0x200, 0x100);
+  predictor.addStore(0x100, 5);
+  predictor.addStore(0x100, 7);
+  EXPECT_EQ(predictor.predictDependence(0x200), 7);
+
+  // Once the store generates its addresses the load need not wait
+  predictor.storeIssued(0x100, 7);
+  EXPECT_EQ(predictor.predictDependence(0x200), UINT64_MAX);
+  // An older instance issuing doesn't affect a younger one
+  predictor.addStore(0x100, 9);
+  predictor.storeIssued(0x100, 5);
+  EXPECT_EQ(predictor.predictDependence(0x200), 9);
+}
+
+// Tests that a load violating against stores from two sets merges them
+TEST_F(StoreSetPredictorTest, merge) {
+  StoreSetPredictor predictor(tree.crootref());
+  predictor.train(0x200, 0x100);
+  predictor.train(0x300, 0x104);
+  predictor.train(0x200, 0x104);
+
+  // Both stores now share the load's set, so it waits for either
+  predictor.addStore(0x100, 3);
+  EXPECT_EQ(predictor.predictDependence(0x200), 3);
+  predictor.addStore(0x104, 4);
+  EXPECT_EQ(predictor.predictDependence(0x200), 4);
+}
+
+// Tests that the store sets are forgotten after the clear interval
+TEST_F(StoreSetPredictorTest, clear) {
+  StoreSetPredictor predictor(tree.crootref());
+  predictor.train(0x200, 0x100);
+  predictor.addStore(0x100, 1);
+  for (int i = 0; i < 7; i++) {
+    EXPECT_EQ(predictor.predictDependence(0x200), 1);
+  }
+  EXPECT_EQ(predictor.predictDependence(0x200), UINT64_MAX);
+}
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -25,11 +25,11 @@ class PipelineWritebackUnitTest : public testing::Test {
         writebackUnit(input, registerFileSet, [](auto insnId) {}) {}
 
  protected:
-  std::vector<PipelineBuffer<std::shared_ptr<Instruction>>> input;
+  std::vector<PipelineBuffer<IntrusivePtr<Instruction>>> input;
   RegisterFileSet registerFileSet;
 
   MockInstruction* uop;
-  std::shared_ptr<Instruction> uopPtr;
+  IntrusivePtr<Instruction> uopPtr;
   WritebackUnit writebackUnit;
 };
 
@@ -96,6 +96,18 @@ TEST_F(RiscVArchitectureTest, predecode) {
   EXPECT_EQ(output[0]->exceptionEncountered(), false);
 }
 
+// Test that an instruction which could not be fetched raises an instruction
+// abort
+TEST_F(RiscVArchitectureTest, predecodeFault) {
+  MacroOp output;
+  arch->predecodeFault(0x40, output);
+  ASSERT_EQ(output.size(), 1);
+  Instruction* insn = reinterpret_cast<Instruction*>(output[0].get());
+  EXPECT_EQ(insn->getInstructionAddress(), 0x40);
+  EXPECT_EQ(insn->exceptionEncountered(), true);
+  EXPECT_EQ(insn->getException(), InstructionException::InstructionAbort);
+}
+
 TEST_F(RiscVArchitectureTest, getSystemRegisterTag) {
   // Test incorrect system register will fail
   int32_t output = arch->getSystemRegisterTag(-1);
@@ -61,7 +61,7 @@ TEST_F(RiscVExceptionHandlerTest, testSyscall) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   InstructionException exception = InstructionException::SupervisorCall;
-  std::shared_ptr<Instruction> insn = std::make_shared<Instruction>(
+  IntrusivePtr<Instruction> insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   insn->setInstructionAddress(insnAddr);
 
@@ -108,7 +108,7 @@ TEST_F(RiscVExceptionHandlerTest, testSyscall) {
 // Test that `readStringThen()` operates as expected
 TEST_F(RiscVExceptionHandlerTest, readStringThen) {
   // Create new mock instruction and ExceptionHandler
-  std::shared_ptr<MockInstruction> uopPtr(new MockInstruction);
+  IntrusivePtr<MockInstruction> uopPtr(new MockInstruction);
   ExceptionHandler handler(uopPtr, core, memory, kernel);
 
   // Initialise variables
@@ -202,7 +202,7 @@ TEST_F(RiscVExceptionHandlerTest, readStringThen) {
 // away
 TEST_F(RiscVExceptionHandlerTest, readStringThen_maxLen0) {
   // Create new mock instruction and ExceptionHandler
-  std::shared_ptr<MockInstruction> uopPtr(new MockInstruction);
+  IntrusivePtr<MockInstruction> uopPtr(new MockInstruction);
   ExceptionHandler handler(uopPtr, core, memory, kernel);
   size_t retVal = 100;
   char* buffer;
@@ -229,7 +229,7 @@ TEST_F(RiscVExceptionHandlerTest, readStringThen_maxLen0) {
 // and no more string is fetched
 TEST_F(RiscVExceptionHandlerTest, readStringThen_maxLenReached) {
   // Create new mock instruction and ExceptionHandler
-  std::shared_ptr<MockInstruction> uopPtr(new MockInstruction);
+  IntrusivePtr<MockInstruction> uopPtr(new MockInstruction);
   ExceptionHandler handler(uopPtr, core, memory, kernel);
 
   // Initialise variables
@@ -297,7 +297,7 @@ TEST_F(RiscVExceptionHandlerTest, readStringThen_maxLenReached) {
 // Test that `readBufferThen()` operates as expected
 TEST_F(RiscVExceptionHandlerTest, readBufferThen) {
   // Create new mock instruction and ExceptionHandler
-  std::shared_ptr<MockInstruction> uopPtr(new MockInstruction);
+  IntrusivePtr<MockInstruction> uopPtr(new MockInstruction);
   uopPtr->setSequenceId(5);
   ExceptionHandler handler(uopPtr, core, memory, kernel);
 
@@ -384,7 +384,7 @@ TEST_F(RiscVExceptionHandlerTest, readBufferThen) {
 // Test that `readBufferThen()` calls then if length is 0
 TEST_F(RiscVExceptionHandlerTest, readBufferThen_length0) {
   // Create new mock instruction and ExceptionHandler
-  std::shared_ptr<MockInstruction> uopPtr(new MockInstruction);
+  IntrusivePtr<MockInstruction> uopPtr(new MockInstruction);
   ExceptionHandler handler(uopPtr, core, memory, kernel);
 
   const size_t expectedVal = 10;
@@ -411,7 +411,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   InstructionException exception = InstructionException::EncodingUnallocated;
-  std::shared_ptr<Instruction> insn = std::make_shared<Instruction>(
+  IntrusivePtr<Instruction> insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_0(insn, core, memory, kernel);
@@ -431,7 +431,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::ExecutionNotYetImplemented;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_1(insn, core, memory, kernel);
@@ -450,7 +450,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::AliasNotYetImplemented;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_2(insn, core, memory, kernel);
@@ -468,7 +468,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::MisalignedPC;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_3(insn, core, memory, kernel);
@@ -487,7 +487,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::DataAbort;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_4(insn, core, memory, kernel);
@@ -506,7 +506,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::SupervisorCall;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_5(insn, core, memory, kernel);
@@ -526,7 +526,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::HypervisorCall;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_6(insn, core, memory, kernel);
@@ -546,7 +546,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::SecureMonitorCall;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_7(insn, core, memory, kernel);
@@ -564,7 +564,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::NoAvailablePort;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_8(insn, core, memory, kernel);
@@ -582,7 +582,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::IllegalInstruction;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_9(insn, core, memory, kernel);
@@ -600,7 +600,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::PipelineFlush;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_10(insn, core, memory, kernel);
@@ -618,7 +618,7 @@ TEST_F(RiscVExceptionHandlerTest, printException) {
   arch.predecode(validInstrBytes.data(), validInstrBytes.size(), insnAddr,
                  uops);
   exception = InstructionException::None;
-  insn = std::make_shared<Instruction>(
+  insn = makeIntrusive<Instruction>(
       arch, static_cast<Instruction*>(uops[0].get())->getMetadata(), exception);
   // Create ExceptionHandler
   ExceptionHandler handler_11(insn, core, memory, kernel);